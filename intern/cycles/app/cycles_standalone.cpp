@@ -4,6 +4,9 @@
 
 #include <stdio.h>
 
+#include <fstream>
+#include <iostream>
+
 #include "device/device.h"
 #include "scene/camera.h"
 #include "scene/integrator.h"
@@ -49,6 +52,7 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  string batch_filepath;
 } options;
 
 static void session_print(const string &str)
@@ -124,6 +128,12 @@ static void scene_init()
 
   /* Calculate Viewplane */
   options.scene->camera->compute_auto_viewplane();
+
+  /* Objects are expected to move between frames in batch mode, so use BVH which can be refitted
+   * instead of being fully rebuilt. */
+  if (!options.batch_filepath.empty()) {
+    options.scene->params.bvh_type = BVH_TYPE_DYNAMIC;
+  }
 }
 
 static void session_init()
@@ -159,8 +169,92 @@ static void session_init()
   pass->set_name(ustring(options.output_pass.c_str()));
   pass->set_type(PASS_COMBINED);
 
-  options.session->reset(options.session_params, session_buffer_params());
-  options.session->start();
+  /* In batch mode rendering is started for every frame of the batch. */
+  if (options.batch_filepath.empty()) {
+    options.session->reset(options.session_params, session_buffer_params());
+    options.session->start();
+  }
+}
+
+/* Batch mode: render a sequence of frames, applying scene updates between frames. The session is
+ * kept alive, so that kernels, images, shaders and geometry which did not change are not loaded
+ * and built again for every frame.
+ *
+ * Every line of the batch file contains a file path of the XML scene update and the file path of
+ * the output image. Empty lines and lines starting with # are ignored. */
+static void batch_render()
+{
+  std::ifstream file;
+  std::istream *stream = &std::cin;
+
+  if (options.batch_filepath != "-") {
+    file.open(options.batch_filepath);
+    if (!file.is_open()) {
+      fprintf(stderr, "Failed to open batch file \"%s\"\n", options.batch_filepath.c_str());
+      return;
+    }
+    stream = &file;
+  }
+
+  int num_frames = 0;
+  double total_time = 0.0;
+
+  string line;
+  while (std::getline(*stream, line)) {
+    vector<string> tokens;
+    string_split(tokens, line);
+
+    if (tokens.empty() || tokens[0][0] == '#') {
+      continue;
+    }
+    if (tokens.size() != 2) {
+      fprintf(stderr, "Invalid batch line \"%s\"\n", line.c_str());
+      continue;
+    }
+
+    const string &update_filepath = tokens[0];
+    const string &output_filepath = tokens[1];
+
+    const double time_start = time_dt();
+
+    {
+      thread_scoped_lock scene_lock(options.scene->mutex);
+
+      xml_read_update_file(options.scene, update_filepath.c_str());
+
+      Camera *camera = options.scene->camera;
+      camera->set_full_width(options.width);
+      camera->set_full_height(options.height);
+      camera->compute_auto_viewplane();
+    }
+
+    options.session->set_output_driver(
+        make_unique<OIIOOutputDriver>(output_filepath, options.output_pass, session_print));
+
+    options.session->reset(options.session_params, session_buffer_params());
+    options.session->start();
+    options.session->wait();
+
+    if (options.session->progress.get_cancel()) {
+      break;
+    }
+
+    const double frame_time = time_dt() - time_start;
+    total_time += frame_time;
+    ++num_frames;
+
+    if (!options.quiet) {
+      session_print(string_printf("Frame %d rendered in %.2f seconds", num_frames, frame_time));
+      printf("\n");
+    }
+  }
+
+  if (!options.quiet && num_frames) {
+    printf("Rendered %d frames in %.2f seconds (%.2f seconds per frame)\n",
+           num_frames,
+           total_time,
+           total_time / num_frames);
+  }
 }
 
 static void session_exit()
@@ -414,6 +508,10 @@ static void options_parse(int argc, const char **argv)
              "--output %s",
              &options.output_filepath,
              "File path to write output image",
+             "--batch %s",
+             &options.batch_filepath,
+             "Render frames listed in the file (- for stdin), keeping the scene in memory. Every "
+             "line contains a scene update XML file and an output image file",
              "--threads %d",
              &options.session_params.threads,
              "CPU Rendering Threads",
@@ -494,6 +592,10 @@ static void options_parse(int argc, const char **argv)
   options.session_params.background = true;
 #endif
 
+  if (!options.batch_filepath.empty()) {
+    options.session_params.background = true;
+  }
+
   if (options.session_params.tile_size > 0) {
     options.session_params.use_auto_tile = true;
   }
@@ -549,7 +651,12 @@ int main(int argc, const char **argv)
   if (options.session_params.background) {
 #endif
     session_init();
-    options.session->wait();
+    if (!options.batch_filepath.empty()) {
+      batch_render();
+    }
+    else {
+      options.session->wait();
+    }
     session_exit();
 #ifdef WITH_CYCLES_STANDALONE_GUI
   }
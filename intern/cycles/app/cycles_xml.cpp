@@ -47,8 +47,10 @@ struct XMLReadState : public XMLReader {
   string base;       /* Base path to current file. */
   float dicing_rate; /* Current dicing rate. */
   Object *object;    /* Current object. */
+  bool is_update;    /* Reading an update of an already loaded scene. */
 
-  XMLReadState() : scene(NULL), smooth(false), shader(NULL), dicing_rate(1.0f), object(NULL)
+  XMLReadState()
+      : scene(NULL), smooth(false), shader(NULL), dicing_rate(1.0f), object(NULL), is_update(false)
   {
     tfm = transform_identity();
   }
@@ -222,6 +224,31 @@ static void xml_read_alembic(XMLReadState &state, xml_node graph_node)
 }
 #endif
 
+/* Update */
+
+/* When reading an update, nodes which already exist in the scene are matched by name and modified
+ * in-place instead of being added again. Unnamed nodes are never matched. */
+template<typename T>
+static T *xml_find_update_node(const XMLReadState &state, const vector<T *> &nodes, xml_node node)
+{
+  if (!state.is_update) {
+    return nullptr;
+  }
+
+  const ustring name(node.attribute("name").value());
+  if (name.empty()) {
+    return nullptr;
+  }
+
+  foreach (T *existing, nodes) {
+    if (existing->name == name) {
+      return existing;
+    }
+  }
+
+  return nullptr;
+}
+
 /* Shader */
 
 static void xml_read_shader_graph(XMLReadState &state, Shader *shader, xml_node graph_node)
@@ -387,7 +414,13 @@ static void xml_read_shader_graph(XMLReadState &state, Shader *shader, xml_node
 
 static void xml_read_shader(XMLReadState &state, xml_node node)
 {
-  Shader *shader = new Shader();
+  Shader *shader = xml_find_update_node(state, state.scene->shaders, node);
+  if (shader) {
+    xml_read_shader_graph(state, shader, node);
+    return;
+  }
+
+  shader = new Shader();
   xml_read_shader_graph(state, shader, node);
   state.scene->shaders.push_back(shader);
 }
@@ -649,7 +682,15 @@ static void xml_read_mesh(const XMLReadState &state, xml_node node)
 
 static void xml_read_light(XMLReadState &state, xml_node node)
 {
-  Light *light = new Light();
+  Light *light = xml_find_update_node(state, state.scene->lights, node);
+  if (light) {
+    light->set_shader(state.shader);
+    xml_read_node(state, light, node);
+    light->tag_update(state.scene);
+    return;
+  }
+
+  light = new Light();
 
   light->set_shader(state.shader);
   xml_read_node(state, light, node);
@@ -747,6 +788,15 @@ static void xml_read_object(XMLReadState &state, xml_node node)
 {
   Scene *scene = state.scene;
 
+  /* Objects which already exist in the scene only get their transform and settings updated. */
+  Object *existing_object = xml_find_update_node(state, scene->objects, node);
+  if (existing_object) {
+    existing_object->set_tfm(state.tfm);
+    xml_read_node(state, existing_object, node);
+    existing_object->tag_update(scene);
+    return;
+  }
+
   /* create mesh */
   Mesh *mesh = new Mesh();
   scene->geometry.push_back(mesh);
@@ -851,7 +901,7 @@ static void xml_read_include(XMLReadState &state, const string &src)
 
 /* File */
 
-void xml_read_file(Scene *scene, const char *filepath)
+static void xml_read_file(Scene *scene, const char *filepath, const bool is_update)
 {
   XMLReadState state;
 
@@ -861,10 +911,21 @@ void xml_read_file(Scene *scene, const char *filepath)
   state.smooth = false;
   state.dicing_rate = 1.0f;
   state.base = path_dirname(filepath);
+  state.is_update = is_update;
 
   xml_read_include(state, path_filename(filepath));
+}
+
+void xml_read_file(Scene *scene, const char *filepath)
+{
+  xml_read_file(scene, filepath, false);
 
   scene->params.bvh_type = BVH_TYPE_STATIC;
 }
 
+void xml_read_update_file(Scene *scene, const char *filepath)
+{
+  xml_read_file(scene, filepath, true);
+}
+
 CCL_NAMESPACE_END
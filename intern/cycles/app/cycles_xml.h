@@ -11,6 +11,11 @@ class Scene;
 
 void xml_read_file(Scene *scene, const char *filepath);
 
+/* Apply an update to an already loaded scene.
+ * Objects with a name matching an existing object update that object instead of creating a new
+ * one, everything else is read the same way as by `xml_read_file()`. */
+void xml_read_update_file(Scene *scene, const char *filepath);
+
 /* macros for importing */
 #define RAD2DEGF(_rad) ((_rad) * (float)(180.0 / M_PI))
 #define DEG2RADF(_deg) ((_deg) * (float)(M_PI / 180.0))
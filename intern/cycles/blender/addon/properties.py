@@ -426,6 +426,18 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_denoising_input_passes,
         default='RGB_ALBEDO_NORMAL',
     )
+    use_denoising_max_memory: BoolProperty(
+        name="Limit Denoising Memory",
+        description="Limit memory used by OpenImageDenoise on CPU, denoising large images in overlapping tiles",
+        default=False,
+    )
+    denoising_max_memory: IntProperty(
+        name="Denoising Memory Limit",
+        description="Approximate memory limit for OpenImageDenoise on CPU, in megabytes. "
+        "Lower values reduce peak memory usage at the cost of slower denoising",
+        min=128, max=65536,
+        default=2048,
+    )
     denoising_use_gpu: BoolProperty(
         name="Denoise on GPU",
         description="Perform denoising on GPU devices configured in the system tab in the user preferences. This is significantly faster than on CPU, but requires additional GPU memory. When large scenes need more GPU memory, this option can be disabled",
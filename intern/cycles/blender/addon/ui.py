@@ -346,6 +346,12 @@ class CYCLES_RENDER_PT_sampling_render_denoise(CyclesButtonsPanel, Panel):
             row.active = has_oidn_gpu_devices(context)
             row.prop(cscene, "denoising_use_gpu", text="Use GPU")
 
+            row = col.row(heading="Memory Limit", align=True)
+            row.prop(cscene, "use_denoising_max_memory", text="")
+            sub = row.row()
+            sub.active = cscene.use_denoising_max_memory
+            sub.prop(cscene, "denoising_max_memory", text="")
+
 
 class CYCLES_RENDER_PT_sampling_path_guiding(CyclesButtonsPanel, Panel):
     bl_label = "Path Guiding"
@@ -511,6 +511,7 @@ void BlenderSync::sync_integrator(BL::ViewLayer &b_view_layer,
     integrator->set_use_denoise_pass_normal(denoise_params.use_pass_normal);
     integrator->set_denoiser_prefilter(denoise_params.prefilter);
     integrator->set_denoiser_quality(denoise_params.quality);
+    integrator->set_denoise_max_memory(denoise_params.max_memory);
   }
 
   /* UPDATE_NONE as we don't want to tag the integrator as modified (this was done by the
@@ -1017,6 +1018,9 @@ DenoiseParams BlenderSync::get_denoise_params(BL::Scene &b_scene,
         cscene, "denoising_prefilter", DENOISER_PREFILTER_NUM, DENOISER_PREFILTER_NONE);
     denoising.quality = (DenoiserQuality)get_enum(
         cscene, "denoising_quality", DENOISER_QUALITY_NUM, DENOISER_QUALITY_HIGH);
+    if (get_boolean(cscene, "use_denoising_max_memory")) {
+      denoising.max_memory = get_int(cscene, "denoising_max_memory");
+    }
 
     input_passes = (DenoiserInput)get_enum(
         cscene, "denoising_input_passes", DENOISER_INPUT_NUM, DENOISER_INPUT_RGB_ALBEDO_NORMAL);
@@ -13,7 +13,9 @@
 
 #include "util/algorithm.h"
 #include "util/boundbox.h"
+#include "util/tbb.h"
 #include "util/types.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -90,63 +92,40 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
     bin_bounds[i][0] = bin_bounds[i][1] = bin_bounds[i][2] = BoundBox::empty;
   }
 
-  /* map geometry to bins, unrolled once */
-  {
-    int64_t i;
-
-    for (i = 0; i < int64_t(size()) - 1; i += 2) {
-      prefetch_L2(&prims[start() + i + 8]);
-
-      /* map even and odd primitive to bin */
-      const BVHReference &prim0 = prims[start() + i + 0];
-      const BVHReference &prim1 = prims[start() + i + 1];
-
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      BoundBox bounds1 = get_prim_bounds(prim1);
-
-      int4 bin0 = get_bin(bounds0);
-      int4 bin1 = get_bin(bounds1);
-
-      /* increase bounds for bins for even primitive */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
-
-      /* increase bounds of bins for odd primitive */
-      int b10 = (int)extract<0>(bin1);
-      bin_count[b10][0]++;
-      bin_bounds[b10][0].grow(bounds1);
-      int b11 = (int)extract<1>(bin1);
-      bin_count[b11][1]++;
-      bin_bounds[b11][1].grow(bounds1);
-      int b12 = (int)extract<2>(bin1);
-      bin_count[b12][2]++;
-      bin_bounds[b12][2].grow(bounds1);
-    }
-
-    /* for uneven number of primitives */
-    if (i < int64_t(size())) {
-      /* map primitive to bin */
-      const BVHReference &prim0 = prims[start() + i];
-      BoundBox bounds0 = get_prim_bounds(prim0);
-      int4 bin0 = get_bin(bounds0);
-
-      /* increase bounds of bins */
-      int b00 = (int)extract<0>(bin0);
-      bin_count[b00][0]++;
-      bin_bounds[b00][0].grow(bounds0);
-      int b01 = (int)extract<1>(bin0);
-      bin_count[b01][1]++;
-      bin_bounds[b01][1].grow(bounds0);
-      int b02 = (int)extract<2>(bin0);
-      bin_count[b02][2]++;
-      bin_bounds[b02][2].grow(bounds0);
+  /* map geometry to bins */
+  if (size() < PARALLEL_MIN_SIZE) {
+    bin_primitives(prims, start(), end(), bin_bounds, bin_count);
+  }
+  else {
+    /* Bin from multiple threads into thread local bins and merge them afterwards. Merging only
+     * involves integer sums and min/max of bounds, so the result does not depend on scheduling. */
+    struct Bins {
+      BoundBox bounds[MAX_BINS][4];
+      int4 count[MAX_BINS];
+    };
+    const size_t bins_num = num_bins;
+    enumerable_thread_specific<Bins> thread_bins([bins_num]() {
+      Bins bins;
+      for (size_t i = 0; i < bins_num; i++) {
+        bins.count[i] = make_int4(0);
+        bins.bounds[i][0] = bins.bounds[i][1] = bins.bounds[i][2] = BoundBox::empty;
+      }
+      return bins;
+    });
+
+    parallel_for(blocked_range<size_t>(start(), end(), PARALLEL_GRAIN_SIZE),
+                 [&](const blocked_range<size_t> &r) {
+                   Bins &bins = thread_bins.local();
+                   bin_primitives(prims, r.begin(), r.end(), bins.bounds, bins.count);
+                 });
+
+    for (const Bins &bins : thread_bins) {
+      for (size_t i = 0; i < num_bins; i++) {
+        bin_count[i] = bin_count[i] + bins.count[i];
+        bin_bounds[i][0].grow(bins.bounds[i][0]);
+        bin_bounds[i][1].grow(bins.bounds[i][1]);
+        bin_bounds[i][2].grow(bins.bounds[i][2]);
+      }
     }
   }
 
@@ -211,6 +190,193 @@ BVHObjectBinning::BVHObjectBinning(const BVHRange &job,
   leafSAH = bounds_.half_area() * blocks(size());
 }
 
+void BVHObjectBinning::bin_primitives(const BVHReference *prims,
+                                      size_t begin,
+                                      size_t end,
+                                      BoundBox (*bin_bounds)[4],
+                                      int4 *bin_count) const
+{
+  /* map geometry to bins, unrolled once */
+  int64_t i;
+
+  for (i = int64_t(begin); i < int64_t(end) - 1; i += 2) {
+    prefetch_L2(&prims[i + 8]);
+
+    /* map even and odd primitive to bin */
+    const BVHReference &prim0 = prims[i + 0];
+    const BVHReference &prim1 = prims[i + 1];
+
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    BoundBox bounds1 = get_prim_bounds(prim1);
+
+    int4 bin0 = get_bin(bounds0);
+    int4 bin1 = get_bin(bounds1);
+
+    /* increase bounds for bins for even primitive */
+    int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+
+    /* increase bounds of bins for odd primitive */
+    int b10 = (int)extract<0>(bin1);
+    bin_count[b10][0]++;
+    bin_bounds[b10][0].grow(bounds1);
+    int b11 = (int)extract<1>(bin1);
+    bin_count[b11][1]++;
+    bin_bounds[b11][1].grow(bounds1);
+    int b12 = (int)extract<2>(bin1);
+    bin_count[b12][2]++;
+    bin_bounds[b12][2].grow(bounds1);
+  }
+
+  /* for uneven number of primitives */
+  if (i < int64_t(end)) {
+    /* map primitive to bin */
+    const BVHReference &prim0 = prims[i];
+    BoundBox bounds0 = get_prim_bounds(prim0);
+    int4 bin0 = get_bin(bounds0);
+
+    /* increase bounds of bins */
+    int b00 = (int)extract<0>(bin0);
+    bin_count[b00][0]++;
+    bin_bounds[b00][0].grow(bounds0);
+    int b01 = (int)extract<1>(bin0);
+    bin_count[b01][1]++;
+    bin_bounds[b01][1].grow(bounds0);
+    int b02 = (int)extract<2>(bin0);
+    bin_count[b02][2]++;
+    bin_bounds[b02][2].grow(bounds0);
+  }
+}
+
+size_t BVHObjectBinning::split_parallel(BVHReference *prims,
+                                        BoundBox &lgeom_bounds,
+                                        BoundBox &lcent_bounds,
+                                        BoundBox &rgeom_bounds,
+                                        BoundBox &rcent_bounds) const
+{
+  /* Fixed size blocks, so that the order of primitives after partitioning is deterministic. */
+  struct Block {
+    size_t num_left = 0;
+    BoundBox lgeom_bounds = BoundBox::empty;
+    BoundBox lcent_bounds = BoundBox::empty;
+    BoundBox rgeom_bounds = BoundBox::empty;
+    BoundBox rcent_bounds = BoundBox::empty;
+  };
+
+  const size_t N = size();
+  const size_t num_blocks = divide_up(N, size_t(PARALLEL_GRAIN_SIZE));
+  vector<Block> blocks(num_blocks);
+
+  /* Partition every block in place. */
+  parallel_for(size_t(0), num_blocks, [&](size_t b) {
+    Block &block = blocks[b];
+    BVHReference *block_begin = prims + start() + b * PARALLEL_GRAIN_SIZE;
+    BVHReference *block_end = prims + start() + min(N, (b + 1) * PARALLEL_GRAIN_SIZE);
+    BVHReference *block_mid = std::partition(
+        block_begin, block_end, [&](const BVHReference &prim) { return is_left(prim); });
+    block.num_left = block_mid - block_begin;
+
+    for (const BVHReference *prim = block_begin; prim < block_mid; prim++) {
+      block.lgeom_bounds.grow(prim->bounds());
+      block.lcent_bounds.grow(prim->bounds().center2());
+    }
+    for (const BVHReference *prim = block_mid; prim < block_end; prim++) {
+      block.rgeom_bounds.grow(prim->bounds());
+      block.rcent_bounds.grow(prim->bounds().center2());
+    }
+  });
+
+  size_t num_left = 0;
+  for (const Block &block : blocks) {
+    num_left += block.num_left;
+  }
+  if (num_left == 0 || num_left == N) {
+    return num_left;
+  }
+
+  /* Every block is now a left and a right part. Right parts before the split position and left
+   * parts after it are misplaced, and there are as many misplaced primitives of each kind.
+   * Collect them as ranges, with the number of misplaced primitives in the ranges before. */
+  struct MisplacedRange {
+    size_t begin;
+    size_t end;
+    size_t offset;
+  };
+  vector<MisplacedRange> misplaced_left, misplaced_right;
+  size_t num_misplaced_left = 0, num_misplaced_right = 0;
+
+  for (size_t b = 0; b < num_blocks; b++) {
+    const Block &block = blocks[b];
+    const size_t block_begin = b * PARALLEL_GRAIN_SIZE;
+    const size_t block_mid = block_begin + block.num_left;
+    const size_t block_end = min(N, (b + 1) * PARALLEL_GRAIN_SIZE);
+
+    const size_t left_begin = max(block_begin, num_left);
+    if (left_begin < block_mid) {
+      misplaced_left.push_back({left_begin, block_mid, num_misplaced_left});
+      num_misplaced_left += block_mid - left_begin;
+    }
+    const size_t right_end = min(block_end, num_left);
+    if (block_mid < right_end) {
+      misplaced_right.push_back({block_mid, right_end, num_misplaced_right});
+      num_misplaced_right += right_end - block_mid;
+    }
+
+    lgeom_bounds.grow(block.lgeom_bounds);
+    lcent_bounds.grow(block.lcent_bounds);
+    rgeom_bounds.grow(block.rgeom_bounds);
+    rcent_bounds.grow(block.rcent_bounds);
+  }
+  assert(num_misplaced_left == num_misplaced_right);
+
+  /* Swap the n-th misplaced left primitive with the n-th misplaced right one, which moves all
+   * primitives to their side without temporary storage. */
+  auto find_range = [](const vector<MisplacedRange> &ranges, const size_t n) {
+    return size_t(std::upper_bound(ranges.begin(),
+                                   ranges.end(),
+                                   n,
+                                   [](const size_t value, const MisplacedRange &range) {
+                                     return value < range.offset;
+                                   }) -
+                  ranges.begin() - 1);
+  };
+
+  parallel_for(blocked_range<size_t>(0, num_misplaced_left, PARALLEL_GRAIN_SIZE),
+               [&](const blocked_range<size_t> &r) {
+                 size_t l = find_range(misplaced_left, r.begin());
+                 size_t k = find_range(misplaced_right, r.begin());
+                 for (size_t n = r.begin(); n < r.end();) {
+                   const MisplacedRange &left = misplaced_left[l];
+                   const MisplacedRange &right = misplaced_right[k];
+                   const size_t left_index = left.begin + (n - left.offset);
+                   const size_t right_index = right.begin + (n - right.offset);
+                   const size_t count = min(r.end() - n,
+                                            min(left.end - left_index, right.end - right_index));
+
+                   std::swap_ranges(prims + start() + left_index,
+                                    prims + start() + left_index + count,
+                                    prims + start() + right_index);
+
+                   n += count;
+                   if (left_index + count == left.end) {
+                     l++;
+                   }
+                   if (right_index + count == right.end) {
+                     k++;
+                   }
+                 }
+               });
+
+  return num_left;
+}
+
 void BVHObjectBinning::split(BVHReference *prims,
                              BVHObjectBinning &left_o,
                              BVHObjectBinning &right_o) const
@@ -222,6 +388,17 @@ void BVHObjectBinning::split(BVHReference *prims,
   BoundBox lcent_bounds = BoundBox::empty;
   BoundBox rcent_bounds = BoundBox::empty;
 
+  if (N >= PARALLEL_MIN_SIZE) {
+    const size_t num_left = split_parallel(
+        prims, lgeom_bounds, lcent_bounds, rgeom_bounds, rcent_bounds);
+    if (num_left != 0 && num_left != N) {
+      right_o = BVHObjectBinning(
+          BVHRange(rgeom_bounds, rcent_bounds, start() + num_left, N - num_left), prims);
+      left_o = BVHObjectBinning(BVHRange(lgeom_bounds, lcent_bounds, start(), num_left), prims);
+      return;
+    }
+  }
+
   int64_t l = 0, r = N - 1;
 
   while (l <= r) {
@@ -17,12 +17,13 @@ CCL_NAMESPACE_BEGIN
 
 class BVHBuild;
 
-/* Single threaded object binner. Finds the split with the best SAH heuristic
+/* Object binner. Finds the split with the best SAH heuristic
  * by testing for each dimension multiple partitionings for regular spaced
  * partition locations. A partitioning for a partition location is computed,
  * by putting primitives whose centroid is on the left and right of the split
  * location to different sets. The SAH is evaluated by computing the number of
- * blocks occupied by the primitives in the partitions. */
+ * blocks occupied by the primitives in the partitions. Large ranges are binned and
+ * split using multiple threads. */
 
 class BVHObjectBinning : public BVHRange {
  public:
@@ -59,6 +60,34 @@ class BVHObjectBinning : public BVHRange {
   enum { MAX_BINS = 32 };
   enum { LOG_BLOCK_SIZE = 2 };
 
+  /* Ranges with at least this many primitives are binned and partitioned from multiple threads,
+   * which matters for the top levels of the tree where no parallel subtrees exist yet. */
+  enum { PARALLEL_MIN_SIZE = 65536 };
+  enum { PARALLEL_GRAIN_SIZE = 16384 };
+
+  /* Accumulate primitives in [begin, end) into the given bins. */
+  void bin_primitives(const BVHReference *prims,
+                      size_t begin,
+                      size_t end,
+                      BoundBox (*bin_bounds)[4],
+                      int4 *bin_count) const;
+
+  /* In place partition of the range into left and right sides of the best split, returns the
+   * number of primitives on the left side. The resulting order only depends on the input order.
+   * Bounds are only filled in when both sides are non-empty. */
+  size_t split_parallel(BVHReference *prims,
+                        BoundBox &lgeom_bounds,
+                        BoundBox &lcent_bounds,
+                        BoundBox &rgeom_bounds,
+                        BoundBox &rcent_bounds) const;
+
+  /* Whether primitive belongs to the left side of the best split. */
+  __forceinline bool is_left(const BVHReference &prim) const
+  {
+    const BoundBox unaligned_bounds = get_prim_bounds(prim);
+    return get_bin(unaligned_bounds.center2())[dim] < pos;
+  }
+
   /* computes the bin numbers for each dimension for a box. */
   __forceinline int4 get_bin(const BoundBox &box) const
   {
@@ -26,6 +26,7 @@
 #include "util/queue.h"
 #include "util/simd.h"
 #include "util/stack_allocator.h"
+#include "util/tbb.h"
 #include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
@@ -56,7 +57,8 @@ BVHBuild::~BVHBuild() {}
 
 /* Adding References */
 
-void BVHBuild::add_reference_triangles(BoundBox &root,
+void BVHBuild::add_reference_triangles(BVHReferenceSlice &refs,
+                                       BoundBox &root,
                                        BoundBox &center,
                                        Mesh *mesh,
                                        int object_index)
@@ -74,7 +76,7 @@ void BVHBuild::add_reference_triangles(BoundBox &root,
       BoundBox bounds = BoundBox::empty;
       t.bounds_grow(verts, bounds);
       if (bounds.valid() && t.valid(verts)) {
-        references.push_back(BVHReference(bounds, j, object_index, primitive_type));
+        refs.push_back(BVHReference(bounds, j, object_index, primitive_type));
         root.grow(bounds);
         center.grow(bounds.center2());
       }
@@ -94,7 +96,7 @@ void BVHBuild::add_reference_triangles(BoundBox &root,
         t.bounds_grow(vert_steps + step * num_verts, bounds);
       }
       if (bounds.valid()) {
-        references.push_back(BVHReference(bounds, j, object_index, primitive_type));
+        refs.push_back(BVHReference(bounds, j, object_index, primitive_type));
         root.grow(bounds);
         center.grow(bounds.center2());
       }
@@ -132,7 +134,7 @@ void BVHBuild::add_reference_triangles(BoundBox &root,
         bounds.grow(curr_bounds);
         if (bounds.valid()) {
           const float prev_time = (float)(bvh_step - 1) * num_bvh_steps_inv_1;
-          references.push_back(
+          refs.push_back(
               BVHReference(bounds, j, object_index, primitive_type, prev_time, curr_time));
           root.grow(bounds);
           center.grow(bounds.center2());
@@ -146,7 +148,8 @@ void BVHBuild::add_reference_triangles(BoundBox &root,
   }
 }
 
-void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair, int object_index)
+void BVHBuild::add_reference_curves(
+    BVHReferenceSlice &refs, BoundBox &root, BoundBox &center, Hair *hair, int object_index)
 {
   const Attribute *curve_attr_mP = NULL;
   if (hair->has_motion_blur()) {
@@ -166,7 +169,7 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
         curve.bounds_grow(k, &hair->get_curve_keys()[0], curve_radius, bounds);
         if (bounds.valid()) {
           int packed_type = PRIMITIVE_PACK_SEGMENT(primitive_type, k);
-          references.push_back(BVHReference(bounds, j, object_index, packed_type));
+          refs.push_back(BVHReference(bounds, j, object_index, packed_type));
           root.grow(bounds);
           center.grow(bounds.center2());
         }
@@ -187,7 +190,7 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
         }
         if (bounds.valid()) {
           int packed_type = PRIMITIVE_PACK_SEGMENT(primitive_type, k);
-          references.push_back(BVHReference(bounds, j, object_index, packed_type));
+          refs.push_back(BVHReference(bounds, j, object_index, packed_type));
           root.grow(bounds);
           center.grow(bounds.center2());
         }
@@ -243,7 +246,7 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
           if (bounds.valid()) {
             const float prev_time = (float)(bvh_step - 1) * num_bvh_steps_inv_1;
             int packed_type = PRIMITIVE_PACK_SEGMENT(primitive_type, k);
-            references.push_back(
+            refs.push_back(
                 BVHReference(bounds, j, object_index, packed_type, prev_time, curr_time));
             root.grow(bounds);
             center.grow(bounds.center2());
@@ -258,7 +261,8 @@ void BVHBuild::add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair
   }
 }
 
-void BVHBuild::add_reference_points(BoundBox &root,
+void BVHBuild::add_reference_points(BVHReferenceSlice &refs,
+                                    BoundBox &root,
                                     BoundBox &center,
                                     PointCloud *pointcloud,
                                     int i)
@@ -281,7 +285,7 @@ void BVHBuild::add_reference_points(BoundBox &root,
       BoundBox bounds = BoundBox::empty;
       point.bounds_grow(points_data, radius_data, bounds);
       if (bounds.valid()) {
-        references.push_back(BVHReference(bounds, j, i, PRIMITIVE_POINT));
+        refs.push_back(BVHReference(bounds, j, i, PRIMITIVE_POINT));
         root.grow(bounds);
         center.grow(bounds.center2());
       }
@@ -301,7 +305,7 @@ void BVHBuild::add_reference_points(BoundBox &root,
         point.bounds_grow(motion_data[step * num_points + j], bounds);
       }
       if (bounds.valid()) {
-        references.push_back(BVHReference(bounds, j, i, PRIMITIVE_MOTION_POINT));
+        refs.push_back(BVHReference(bounds, j, i, PRIMITIVE_MOTION_POINT));
         root.grow(bounds);
         center.grow(bounds.center2());
       }
@@ -339,7 +343,7 @@ void BVHBuild::add_reference_points(BoundBox &root,
         bounds.grow(curr_bounds);
         if (bounds.valid()) {
           const float prev_time = (float)(bvh_step - 1) * num_bvh_steps_inv_1;
-          references.push_back(
+          refs.push_back(
               BVHReference(bounds, j, i, PRIMITIVE_MOTION_POINT, prev_time, curr_time));
           root.grow(bounds);
           center.grow(bounds.center2());
@@ -353,28 +357,30 @@ void BVHBuild::add_reference_points(BoundBox &root,
   }
 }
 
-void BVHBuild::add_reference_geometry(BoundBox &root,
+void BVHBuild::add_reference_geometry(BVHReferenceSlice &refs,
+                                      BoundBox &root,
                                       BoundBox &center,
                                       Geometry *geom,
                                       int object_index)
 {
   if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
     Mesh *mesh = static_cast<Mesh *>(geom);
-    add_reference_triangles(root, center, mesh, object_index);
+    add_reference_triangles(refs, root, center, mesh, object_index);
   }
   else if (geom->geometry_type == Geometry::HAIR) {
     Hair *hair = static_cast<Hair *>(geom);
-    add_reference_curves(root, center, hair, object_index);
+    add_reference_curves(refs, root, center, hair, object_index);
   }
   else if (geom->geometry_type == Geometry::POINTCLOUD) {
     PointCloud *pointcloud = static_cast<PointCloud *>(geom);
-    add_reference_points(root, center, pointcloud, object_index);
+    add_reference_points(refs, root, center, pointcloud, object_index);
   }
 }
 
-void BVHBuild::add_reference_object(BoundBox &root, BoundBox &center, Object *ob, int i)
+void BVHBuild::add_reference_object(
+    BVHReferenceSlice &refs, BoundBox &root, BoundBox &center, Object *ob, int i)
 {
-  references.push_back(BVHReference(ob->bounds, -1, i, 0));
+  refs.push_back(BVHReference(ob->bounds, -1, i, 0));
   root.grow(ob->bounds);
   center.grow(ob->bounds.center2());
 }
@@ -390,75 +396,134 @@ static size_t count_curve_segments(Hair *hair)
   return num;
 }
 
-static size_t count_primitives(Geometry *geom)
+/* Number of references added per primitive. Motion blurred primitives are split into a reference
+ * per time step, unless the steps are disabled in the parameters. */
+static size_t count_primitive_time_steps(Geometry *geom,
+                                         const int num_motion_steps,
+                                         const bool use_spatial_split)
+{
+  if (!geom->has_motion_blur() || num_motion_steps == 0 || use_spatial_split) {
+    return 1;
+  }
+  return size_t(num_motion_steps) * 2;
+}
+
+static size_t count_primitives(Geometry *geom, const BVHParams &params)
 {
   if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
     Mesh *mesh = static_cast<Mesh *>(geom);
-    return mesh->num_triangles();
+    return mesh->num_triangles() * count_primitive_time_steps(geom,
+                                                              params.num_motion_triangle_steps,
+                                                              params.use_spatial_split);
   }
   else if (geom->geometry_type == Geometry::HAIR) {
     Hair *hair = static_cast<Hair *>(geom);
-    return count_curve_segments(hair);
+    return count_curve_segments(hair) * count_primitive_time_steps(
+                                            geom,
+                                            params.num_motion_curve_steps,
+                                            params.use_spatial_split);
   }
   else if (geom->geometry_type == Geometry::POINTCLOUD) {
     PointCloud *pointcloud = static_cast<PointCloud *>(geom);
-    return pointcloud->num_points();
+    return pointcloud->num_points() * count_primitive_time_steps(geom,
+                                                                 params.num_motion_point_steps,
+                                                                 params.use_spatial_split);
   }
 
   return 0;
 }
 
+size_t BVHBuild::count_references(Object *ob) const
+{
+  if (params.top_level) {
+    if (!ob->is_traceable()) {
+      return 0;
+    }
+    if (ob->get_geometry()->is_instanced()) {
+      return 1;
+    }
+  }
+  return count_primitives(ob->get_geometry(), params);
+}
+
 void BVHBuild::add_references(BVHRange &root)
 {
-  /* reserve space for references */
-  size_t num_alloc_references = 0;
+  /* Group objects into chunks of roughly REFERENCES_PER_TASK primitives. Every chunk writes its
+   * references to its own slice of the references array, starting at the sum of the counts of
+   * the previous chunks. The chunks only depend on the scene, so the result is the same as for a
+   * serial build. */
+  struct ReferencesChunk {
+    size_t object_begin = 0;
+    size_t object_end = 0;
+    size_t offset = 0;
+    BVHReferenceSlice slice;
+    BoundBox bounds = BoundBox::empty;
+    BoundBox center = BoundBox::empty;
+  };
 
-  foreach (Object *ob, objects) {
-    if (params.top_level) {
-      if (!ob->is_traceable()) {
-        continue;
-      }
-      if (!ob->get_geometry()->is_instanced()) {
-        num_alloc_references += count_primitives(ob->get_geometry());
-      }
-      else {
-        num_alloc_references++;
-      }
-    }
-    else {
-      num_alloc_references += count_primitives(ob->get_geometry());
+  vector<ReferencesChunk> chunks;
+  size_t num_alloc_references = 0;
+  for (size_t i = 0; i < objects.size(); i++) {
+    if (chunks.empty() || chunks.back().slice.capacity >= REFERENCES_PER_TASK) {
+      chunks.emplace_back();
+      chunks.back().object_begin = i;
+      chunks.back().offset = num_alloc_references;
     }
+    const size_t num_object_references = count_references(objects[i]);
+    chunks.back().object_end = i + 1;
+    chunks.back().slice.capacity += num_object_references;
+    num_alloc_references += num_object_references;
   }
 
-  references.reserve(num_alloc_references);
+  references.resize(num_alloc_references);
 
   /* add references from objects */
-  BoundBox bounds = BoundBox::empty, center = BoundBox::empty;
-  int i = 0;
+  parallel_for(size_t(0), chunks.size(), [&](size_t chunk_index) {
+    ReferencesChunk &chunk = chunks[chunk_index];
+    chunk.slice.data = references.data() + chunk.offset;
 
-  foreach (Object *ob, objects) {
-    if (params.top_level) {
-      if (!ob->is_traceable()) {
-        ++i;
-        continue;
+    for (size_t i = chunk.object_begin; i < chunk.object_end; i++) {
+      if (progress.get_cancel()) {
+        return;
       }
-      if (!ob->get_geometry()->is_instanced()) {
-        add_reference_geometry(bounds, center, ob->get_geometry(), i);
+
+      Object *ob = objects[i];
+      if (params.top_level) {
+        if (!ob->is_traceable()) {
+          continue;
+        }
+        if (!ob->get_geometry()->is_instanced()) {
+          add_reference_geometry(chunk.slice, chunk.bounds, chunk.center, ob->get_geometry(), i);
+        }
+        else {
+          add_reference_object(chunk.slice, chunk.bounds, chunk.center, ob, i);
+        }
       }
       else {
-        add_reference_object(bounds, center, ob, i);
+        add_reference_geometry(chunk.slice, chunk.bounds, chunk.center, ob->get_geometry(), i);
       }
     }
-    else {
-      add_reference_geometry(bounds, center, ob->get_geometry(), i);
-    }
+  });
 
-    i++;
+  if (progress.get_cancel()) {
+    return;
+  }
 
-    if (progress.get_cancel()) {
-      return;
+  /* Primitives with invalid bounds are skipped, close the gaps they leave at the end of slices.
+   * References only move towards the start of the array, so this is done in place. */
+  size_t num_references = 0;
+  BoundBox bounds = BoundBox::empty, center = BoundBox::empty;
+  foreach (const ReferencesChunk &chunk, chunks) {
+    if (chunk.offset != num_references) {
+      std::copy(chunk.slice.data,
+                chunk.slice.data + chunk.slice.size,
+                references.data() + num_references);
     }
+    num_references += chunk.slice.size;
+    bounds.grow(chunk.bounds);
+    center.grow(chunk.center);
   }
+  references.resize(num_references);
 
   /* happens mostly on empty meshes */
   if (!bounds.valid()) {
@@ -32,6 +32,21 @@ class Object;
 class PointCloud;
 class Progress;
 
+/* Appends references to a slice of the preallocated references array. The capacity of the slice
+ * comes from #BVHBuild::count_references, which is an upper bound of the references added. */
+
+struct BVHReferenceSlice {
+  BVHReference *data = nullptr;
+  size_t size = 0;
+  size_t capacity = 0;
+
+  void push_back(const BVHReference &ref)
+  {
+    assert(size < capacity);
+    data[size++] = ref;
+  }
+};
+
 /* BVH Builder */
 
 class BVHBuild {
@@ -57,11 +72,20 @@ class BVHBuild {
   friend class BVHObjectBinning;
 
   /* Adding references. */
-  void add_reference_triangles(BoundBox &root, BoundBox &center, Mesh *mesh, int i);
-  void add_reference_curves(BoundBox &root, BoundBox &center, Hair *hair, int i);
-  void add_reference_points(BoundBox &root, BoundBox &center, PointCloud *pointcloud, int i);
-  void add_reference_geometry(BoundBox &root, BoundBox &center, Geometry *geom, int i);
-  void add_reference_object(BoundBox &root, BoundBox &center, Object *ob, int i);
+  void add_reference_triangles(
+      BVHReferenceSlice &refs, BoundBox &root, BoundBox &center, Mesh *mesh, int i);
+  void add_reference_curves(
+      BVHReferenceSlice &refs, BoundBox &root, BoundBox &center, Hair *hair, int i);
+  void add_reference_points(BVHReferenceSlice &refs,
+                            BoundBox &root,
+                            BoundBox &center,
+                            PointCloud *pointcloud,
+                            int i);
+  void add_reference_geometry(
+      BVHReferenceSlice &refs, BoundBox &root, BoundBox &center, Geometry *geom, int i);
+  void add_reference_object(
+      BVHReferenceSlice &refs, BoundBox &root, BoundBox &center, Object *ob, int i);
+  size_t count_references(Object *ob) const;
   void add_references(BVHRange &root);
 
   /* Building. */
@@ -78,6 +102,7 @@ class BVHBuild {
 
   /* Threads. */
   enum { THREAD_TASK_SIZE = 4096 };
+  enum { REFERENCES_PER_TASK = 65536 };
   void thread_build_node(InnerNode *node, int child, const BVHObjectBinning &range, int level);
   void thread_build_spatial_split_node(InnerNode *node,
                                        int child,
@@ -83,6 +83,8 @@ NODE_DEFINE(DenoiseParams)
   SOCKET_ENUM(prefilter, "Prefilter", *prefilter_enum, DENOISER_PREFILTER_FAST);
   SOCKET_ENUM(quality, "Quality", *quality_enum, DENOISER_QUALITY_HIGH);
 
+  SOCKET_INT(max_memory, "Max Memory", 0);
+
   return type;
 }
 
@@ -77,6 +77,10 @@ class DenoiseParams : public Node {
   DenoiserPrefilter prefilter = DENOISER_PREFILTER_FAST;
   DenoiserQuality quality = DENOISER_QUALITY_HIGH;
 
+  /* Approximate limit of the memory used by the denoiser, in megabytes. When the image does not
+   * fit into the limit it is denoised in overlapping tiles. Zero means the denoiser default. */
+  int max_memory = 0;
+
   static const NodeEnum *get_type_enum();
   static const NodeEnum *get_prefilter_enum();
   static const NodeEnum *get_quality_enum();
@@ -184,6 +184,7 @@ class OIDNDenoiseContext {
       oidn_filter.setData("weights", custom_weights.data(), custom_weights.size());
     }
     set_quality(oidn_filter);
+    set_max_memory(oidn_filter);
 
     if (denoise_params_.prefilter == DENOISER_PREFILTER_NONE ||
         denoise_params_.prefilter == DENOISER_PREFILTER_ACCURATE)
@@ -221,6 +222,7 @@ class OIDNDenoiseContext {
     set_pass(oidn_filter, oidn_pass);
     set_output_pass(oidn_filter, oidn_pass);
     set_quality(oidn_filter);
+    set_max_memory(oidn_filter);
     oidn_filter.commit();
     oidn_filter.execute();
 
@@ -442,6 +444,16 @@ class OIDNDenoiseContext {
 #  endif
   }
 
+  /* Limit memory used by the filter. When the image does not fit into the limit OpenImageDenoise
+   * splits it into overlapping tiles which are denoised one after another, so that the result
+   * matches denoising of the full frame while the peak memory usage is bounded. */
+  void set_max_memory(oidn::FilterRef &oidn_filter)
+  {
+    if (denoise_params_.max_memory > 0) {
+      oidn_filter.set("maxMemoryMB", denoise_params_.max_memory);
+    }
+  }
+
   /* Scale output pass to match adaptive sampling per-pixel scale, as well as bring alpha channel
    * back. */
   void postprocess_output(const OIDNPass &oidn_input_pass, const OIDNPass &oidn_output_pass)
@@ -158,6 +158,7 @@ NODE_DEFINE(Integrator)
               DENOISER_PREFILTER_ACCURATE);
   SOCKET_BOOLEAN(denoise_use_gpu, "Denoise on GPU", true);
   SOCKET_ENUM(denoiser_quality, "Denoiser Quality", denoiser_quality_enum, DENOISER_QUALITY_HIGH);
+  SOCKET_INT(denoise_max_memory, "Denoiser Max Memory", 0);
 
   return type;
 }
@@ -434,6 +435,7 @@ DenoiseParams Integrator::get_denoise_params() const
 
   denoise_params.prefilter = denoiser_prefilter;
   denoise_params.quality = denoiser_quality;
+  denoise_params.max_memory = denoise_max_memory;
 
   return denoise_params;
 }
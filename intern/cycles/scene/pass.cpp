@@ -180,9 +180,11 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bo
       break;
     case PASS_NORMAL:
       pass_info.num_components = 3;
+      pass_info.support_half_storage = true;
       break;
     case PASS_ROUGHNESS:
       pass_info.num_components = 1;
+      pass_info.support_half_storage = true;
       break;
     case PASS_UV:
       pass_info.num_components = 3;
@@ -207,12 +209,14 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bo
       break;
     case PASS_AO:
       pass_info.num_components = 3;
+      pass_info.support_half_storage = true;
       break;
 
     case PASS_DIFFUSE_COLOR:
     case PASS_GLOSSY_COLOR:
     case PASS_TRANSMISSION_COLOR:
       pass_info.num_components = 3;
+      pass_info.support_half_storage = true;
       break;
     case PASS_DIFFUSE:
       pass_info.num_components = 3;
@@ -282,9 +286,11 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bo
 
     case PASS_DENOISING_NORMAL:
       pass_info.num_components = 3;
+      pass_info.support_half_storage = true;
       break;
     case PASS_DENOISING_ALBEDO:
       pass_info.num_components = 3;
+      pass_info.support_half_storage = true;
       break;
     case PASS_DENOISING_DEPTH:
       pass_info.num_components = 1;
@@ -353,12 +359,15 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo, const bo
       break;
     case PASS_GUIDING_COLOR:
       pass_info.num_components = 3;
+      pass_info.support_half_storage = true;
       break;
     case PASS_GUIDING_PROBABILITY:
       pass_info.num_components = 1;
+      pass_info.support_half_storage = true;
       break;
     case PASS_GUIDING_AVG_ROUGHNESS:
       pass_info.num_components = 1;
+      pass_info.support_half_storage = true;
       break;
   }
 
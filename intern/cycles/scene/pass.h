@@ -44,6 +44,11 @@ struct PassInfo {
 
   /* Pass supports denoising. */
   bool support_denoise = false;
+
+  /* Per-sample contribution of the pass is bounded to a small range (colors, normals, roughness
+   * and alike), so that the accumulated value can be stored with half-float precision outside of
+   * the render buffers (in the on-disk tile storage) without visible loss of precision. */
+  bool support_half_storage = false;
 };
 
 class Pass : public Node {
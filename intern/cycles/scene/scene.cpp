@@ -460,6 +460,7 @@ void Scene::collect_statistics(RenderStats *stats)
 {
   geometry_manager->collect_statistics(this, stats);
   image_manager->collect_statistics(stats);
+  shader_manager->collect_statistics(stats);
 }
 
 void Scene::enable_update_stats()
@@ -28,6 +28,7 @@ class Device;
 class DeviceScene;
 class Mesh;
 class Progress;
+class RenderStats;
 class Scene;
 class ShaderGraph;
 struct float3;
@@ -193,6 +194,8 @@ class ShaderManager {
                                       Progress &progress) = 0;
   virtual void device_free(Device *device, DeviceScene *dscene, Scene *scene) = 0;
 
+  virtual void collect_statistics(RenderStats * /*stats*/) {}
+
   void device_update_common(Device *device, DeviceScene *dscene, Scene *scene, Progress &progress);
   void device_free_common(Device *device, DeviceScene *dscene, Scene *scene);
 
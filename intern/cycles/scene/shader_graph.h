@@ -208,6 +208,14 @@ class ShaderNode : public Node {
   {
     return false;
   }
+  /* Compilation of the node acquires resources outside of the generated SVM nodes (such as image
+   * slots or pass offsets), so the compiled nodes can not be re-used by a later update. */
+  virtual bool has_compile_side_effects()
+  {
+    return special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT ||
+           special_type == SHADER_SPECIAL_TYPE_OUTPUT_AOV ||
+           special_type == SHADER_SPECIAL_TYPE_OSL;
+  }
   vector<ShaderInput *> inputs;
   vector<ShaderOutput *> outputs;
 
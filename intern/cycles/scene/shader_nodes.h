@@ -170,6 +170,11 @@ class SkyTextureNode : public TextureNode {
 
   void simplify_settings(Scene *scene);
 
+  bool has_compile_side_effects()
+  {
+    return true;
+  }
+
   float get_sun_size()
   {
     /* Clamping for numerical precision. */
@@ -361,6 +366,11 @@ class PointDensityTextureNode : public ShaderNode {
     return true;
   }
 
+  bool has_compile_side_effects()
+  {
+    return true;
+  }
+
   /* Parameters. */
   NODE_SOCKET_API(ustring, filename)
   NODE_SOCKET_API(NodeTexVoxelSpace, space)
@@ -387,6 +397,11 @@ class IESLightNode : public TextureNode {
   ~IESLightNode();
   ShaderNode *clone(ShaderGraph *graph) const;
 
+  bool has_compile_side_effects()
+  {
+    return true;
+  }
+
   NODE_SOCKET_API(ustring, filename)
   NODE_SOCKET_API(ustring, ies)
 
@@ -222,6 +222,27 @@ string ImageStats::full_report(int indent_level)
   return result;
 }
 
+/* Shader cache statistics. */
+
+ShaderCacheStats::ShaderCacheStats()
+    : num_hits(0), num_misses(0), num_uncacheable(0), num_entries(0), memory_size(0)
+{
+}
+
+string ShaderCacheStats::full_report(int indent_level)
+{
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  string result = "";
+  result += string_printf("%sHits: %d\n", indent.c_str(), num_hits);
+  result += string_printf("%sMisses: %d\n", indent.c_str(), num_misses);
+  result += string_printf("%sUncacheable: %d\n", indent.c_str(), num_uncacheable);
+  result += string_printf("%sEntries: %d (%s)\n",
+                          indent.c_str(),
+                          num_entries,
+                          string_human_readable_size(memory_size).c_str());
+  return result;
+}
+
 /* Overall statistics. */
 
 RenderStats::RenderStats()
@@ -287,6 +308,7 @@ string RenderStats::full_report()
   string result = "";
   result += "Mesh statistics:\n" + mesh.full_report(1);
   result += "Image statistics:\n" + image.full_report(1);
+  result += "Shader cache statistics:\n" + shader_cache.full_report(1);
   if (has_profiling) {
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
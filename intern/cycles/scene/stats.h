@@ -161,6 +161,25 @@ class ImageStats {
   NamedSizeStats textures;
 };
 
+/* Statistics about the cache of compiled shaders. */
+class ShaderCacheStats {
+ public:
+  ShaderCacheStats();
+
+  /* Generate full human-readable report. */
+  string full_report(int indent_level = 0);
+
+  /* Number of shaders which used cached compiled nodes, which were compiled and stored in the
+   * cache, and which could not be cached. */
+  int num_hits;
+  int num_misses;
+  int num_uncacheable;
+
+  /* Number of entries and memory used by the cache. */
+  int num_entries;
+  size_t memory_size;
+};
+
 /* Render process statistics. */
 class RenderStats {
  public:
@@ -176,6 +195,7 @@ class RenderStats {
 
   MeshStats mesh;
   ImageStats image;
+  ShaderCacheStats shader_cache;
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
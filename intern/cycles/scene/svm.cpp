@@ -16,6 +16,7 @@
 
 #include "util/foreach.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/progress.h"
 #include "util/task.h"
 
@@ -29,6 +30,60 @@ SVMShaderManager::~SVMShaderManager() {}
 
 void SVMShaderManager::reset(Scene * /*scene*/) {}
 
+bool SVMShaderManager::compiled_shader_cache_key(Shader *shader,
+                                                 const bool background,
+                                                 string *r_key)
+{
+  ShaderGraph *graph = shader->graph;
+
+  /* Similar to the displacement hash, but covers all nodes of the graph. The node hash takes
+   * socket values into account, links are hashed separately. */
+  MD5Hash md5;
+  foreach (ShaderNode *node, graph->nodes) {
+    if (node->has_compile_side_effects()) {
+      return false;
+    }
+
+    node->hash(md5);
+
+    const int node_info[] = {node->id, node->bump, node->special_type};
+    md5.append((const uint8_t *)node_info, sizeof(node_info));
+
+    foreach (ShaderInput *input, node->inputs) {
+      const int link_id = (input->link) ? input->link->parent->id : -1;
+      md5.append((const uint8_t *)&link_id, sizeof(link_id));
+      md5.append((input->link) ? input->link->name().c_str() : "");
+    }
+  }
+
+  /* Settings of the shader and compiler which affect the generated nodes. Whether the graph is
+   * finalized is left out on purpose: compiling finalizes the graph, and the nodes added by
+   * finalization are part of the hash already. */
+  const int settings[] = {background,
+                          shader->reference_count() != 0,
+                          shader->get_displacement_method(),
+                          shader->get_emission_sampling_method()};
+  md5.append((const uint8_t *)settings, sizeof(settings));
+
+  *r_key = md5.get_hex();
+
+  return true;
+}
+
+void SVMShaderManager::compiled_shader_cache_prune()
+{
+  thread_scoped_lock lock(compiled_shader_cache_mutex_);
+
+  for (auto it = compiled_shader_cache_.begin(); it != compiled_shader_cache_.end();) {
+    if (it->second.last_used_update != update_index_) {
+      it = compiled_shader_cache_.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
 void SVMShaderManager::device_update_shader(Scene *scene,
                                             Shader *shader,
                                             Progress *progress,
@@ -39,14 +94,91 @@ void SVMShaderManager::device_update_shader(Scene *scene,
   }
   assert(shader->graph);
 
+  const bool background = (shader == scene->background->get_shader(scene));
+
+  string key;
+  const bool use_cache = compiled_shader_cache_key(shader, background, &key);
+
+  if (use_cache) {
+    thread_scoped_lock lock(compiled_shader_cache_mutex_);
+
+    auto it = compiled_shader_cache_.find(key);
+    if (it != compiled_shader_cache_.end()) {
+      CompiledShader &compiled = it->second;
+      compiled.last_used_update = update_index_;
+      ++num_cache_hits_;
+
+      std::atomic_int *svm_node_types_used = (std::atomic_int *)&scene->dscene.data.svm_usage;
+      for (const ShaderNodeType type : compiled.node_types_used) {
+        svm_node_types_used[type] = true;
+      }
+
+      *svm_nodes = compiled.svm_nodes;
+
+      shader->has_surface = compiled.has_surface;
+      shader->has_surface_transparent = compiled.has_surface_transparent;
+      shader->has_surface_raytrace = compiled.has_surface_raytrace;
+      shader->has_surface_bssrdf = compiled.has_surface_bssrdf;
+      shader->has_bump = compiled.has_bump;
+      shader->has_bssrdf_bump = compiled.has_bssrdf_bump;
+      shader->has_volume = compiled.has_volume;
+      shader->has_displacement = compiled.has_displacement;
+      shader->has_surface_spatial_varying = compiled.has_surface_spatial_varying;
+      shader->has_volume_spatial_varying = compiled.has_volume_spatial_varying;
+      shader->has_volume_attribute_dependency = compiled.has_volume_attribute_dependency;
+      shader->emission_estimate = compiled.emission_estimate;
+      shader->emission_sampling = compiled.emission_sampling;
+      shader->emission_is_constant = compiled.emission_is_constant;
+
+      VLOG_WORK << "Using cached SVM nodes for shader " << shader->name;
+
+      return;
+    }
+  }
+
   SVMCompiler::Summary summary;
   SVMCompiler compiler(scene);
-  compiler.background = (shader == scene->background->get_shader(scene));
+  compiler.background = background;
   compiler.compile(shader, *svm_nodes, 0, &summary);
 
   VLOG_WORK << "Compilation summary:\n"
             << "Shader name: " << shader->name << "\n"
             << summary.full_report();
+
+  thread_scoped_lock lock(compiled_shader_cache_mutex_);
+
+  if (!use_cache) {
+    ++num_cache_uncacheable_;
+    return;
+  }
+
+  ++num_cache_misses_;
+
+  CompiledShader &compiled = compiled_shader_cache_[key];
+  compiled.svm_nodes = *svm_nodes;
+  compiled.node_types_used = compiler.get_node_types_used();
+  compiled.has_surface = shader->has_surface;
+  compiled.has_surface_transparent = shader->has_surface_transparent;
+  compiled.has_surface_raytrace = shader->has_surface_raytrace;
+  compiled.has_surface_bssrdf = shader->has_surface_bssrdf;
+  compiled.has_bump = shader->has_bump;
+  compiled.has_bssrdf_bump = shader->has_bssrdf_bump;
+  compiled.has_volume = shader->has_volume;
+  compiled.has_displacement = shader->has_displacement;
+  compiled.has_surface_spatial_varying = shader->has_surface_spatial_varying;
+  compiled.has_volume_spatial_varying = shader->has_volume_spatial_varying;
+  compiled.has_volume_attribute_dependency = shader->has_volume_attribute_dependency;
+  compiled.emission_estimate = shader->emission_estimate;
+  compiled.emission_sampling = shader->emission_sampling;
+  compiled.emission_is_constant = shader->emission_is_constant;
+  compiled.last_used_update = update_index_;
+
+  /* Compiling finalized the graph, which may have changed its nodes. Store the result for the
+   * finalized graph as well, so compiling the same graph again finds it. */
+  string finalized_key;
+  if (compiled_shader_cache_key(shader, background, &finalized_key) && finalized_key != key) {
+    compiled_shader_cache_[finalized_key] = compiled;
+  }
 }
 
 void SVMShaderManager::device_update_specific(Device *device,
@@ -73,6 +205,8 @@ void SVMShaderManager::device_update_specific(Device *device,
   /* test if we need to update */
   device_free(device, dscene, scene);
 
+  ++update_index_;
+
   /* Build all shaders. */
   TaskPool task_pool;
   vector<array<int4>> shader_svm_nodes(num_shaders);
@@ -90,6 +224,8 @@ void SVMShaderManager::device_update_specific(Device *device,
     return;
   }
 
+  compiled_shader_cache_prune();
+
   /* The global node list contains a jump table (one node per shader)
    * followed by the nodes of all shaders. */
   int svm_nodes_size = num_shaders;
@@ -153,6 +289,21 @@ void SVMShaderManager::device_free(Device *device, DeviceScene *dscene, Scene *s
   dscene->svm_nodes.free();
 }
 
+void SVMShaderManager::collect_statistics(RenderStats *stats)
+{
+  thread_scoped_lock lock(compiled_shader_cache_mutex_);
+
+  ShaderCacheStats &cache_stats = stats->shader_cache;
+  cache_stats.num_hits = num_cache_hits_;
+  cache_stats.num_misses = num_cache_misses_;
+  cache_stats.num_uncacheable = num_cache_uncacheable_;
+  cache_stats.num_entries = compiled_shader_cache_.size();
+  cache_stats.memory_size = 0;
+  for (const auto &it : compiled_shader_cache_) {
+    cache_stats.memory_size += it.second.svm_nodes.size() * sizeof(int4);
+  }
+}
+
 /* Graph Compiler */
 
 SVMCompiler::SVMCompiler(Scene *scene) : scene(scene)
@@ -168,6 +319,18 @@ SVMCompiler::SVMCompiler(Scene *scene) : scene(scene)
 
   /* This struct has one entry for every node, in order of ShaderNodeType definition. */
   svm_node_types_used = (std::atomic_int *)&scene->dscene.data.svm_usage;
+  memset(local_node_types_used, 0, sizeof(local_node_types_used));
+}
+
+vector<ShaderNodeType> SVMCompiler::get_node_types_used() const
+{
+  vector<ShaderNodeType> node_types;
+  for (int i = 0; i < NODE_NUM; i++) {
+    if (local_node_types_used[i]) {
+      node_types.push_back(ShaderNodeType(i));
+    }
+  }
+  return node_types;
 }
 
 int SVMCompiler::stack_size(SocketType::Type type)
@@ -392,13 +555,13 @@ void SVMCompiler::add_node(int a, int b, int c, int d)
 
 void SVMCompiler::add_node(ShaderNodeType type, int a, int b, int c)
 {
-  svm_node_types_used[type] = true;
+  tag_node_type_used(type);
   current_svm_nodes.push_back_slow(make_int4(type, a, b, c));
 }
 
 void SVMCompiler::add_node(ShaderNodeType type, const float3 &f)
 {
-  svm_node_types_used[type] = true;
+  tag_node_type_used(type);
   current_svm_nodes.push_back_slow(
       make_int4(type, __float_as_int(f.x), __float_as_int(f.y), __float_as_int(f.z)));
 }
@@ -685,7 +848,7 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Add instruction to skip closure and its dependencies if mix
          * weight is zero.
          */
-        svm_node_types_used[NODE_JUMP_IF_ONE] = true;
+        tag_node_type_used(NODE_JUMP_IF_ONE);
         current_svm_nodes.push_back_slow(make_int4(NODE_JUMP_IF_ONE, 0, stack_assign(facin), 0));
         int node_jump_skip_index = current_svm_nodes.size() - 1;
 
@@ -701,7 +864,7 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Add instruction to skip closure and its dependencies if mix
          * weight is zero.
          */
-        svm_node_types_used[NODE_JUMP_IF_ZERO] = true;
+        tag_node_type_used(NODE_JUMP_IF_ZERO);
         current_svm_nodes.push_back_slow(make_int4(NODE_JUMP_IF_ZERO, 0, stack_assign(facin), 0));
         int node_jump_skip_index = current_svm_nodes.size() - 1;
 
@@ -869,7 +1032,7 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
 
 void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Summary *summary)
 {
-  svm_node_types_used[NODE_SHADER_JUMP] = true;
+  tag_node_type_used(NODE_SHADER_JUMP);
   svm_nodes.push_back_slow(make_int4(NODE_SHADER_JUMP, 0, 0, 0));
 
   /* copy graph for shader with bump mapping */
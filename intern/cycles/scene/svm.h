@@ -10,9 +10,11 @@
 #include "scene/shader_graph.h"
 
 #include "util/array.h"
+#include "util/map.h"
 #include "util/set.h"
 #include "util/string.h"
 #include "util/thread.h"
+#include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -40,11 +42,65 @@ class SVMShaderManager : public ShaderManager {
                               Progress &progress) override;
   void device_free(Device *device, DeviceScene *dscene, Scene *scene) override;
 
+  void collect_statistics(RenderStats *stats) override;
+
  protected:
   void device_update_shader(Scene *scene,
                             Shader *shader,
                             Progress *progress,
                             array<int4> *svm_nodes);
+
+  /* Cache of compiled SVM nodes.
+   *
+   * Shaders are compiled from scratch on every update, even when only a few of them have been
+   * modified, and when rendering animation with persistent data. The cache allows to skip graph
+   * finalization and SVM nodes generation for shaders whose graph and settings did not change.
+   *
+   * The key is a hash of the graph nodes, their links and the shader settings which affect the
+   * compilation. Graphs with nodes which acquire resources during compilation (images, IES
+   * slots, AOV pass offsets) are never cached, as the compiled nodes refer to those resources. */
+  struct CompiledShader {
+    /* Nodes of the shader, starting with the local jump node. */
+    array<int4> svm_nodes;
+
+    /* Node types used by the compiled nodes, for the kernel SVM usage table. */
+    vector<ShaderNodeType> node_types_used;
+
+    /* Shader state which is assigned by the compiler. */
+    bool has_surface;
+    bool has_surface_transparent;
+    bool has_surface_raytrace;
+    bool has_surface_bssrdf;
+    bool has_bump;
+    bool has_bssrdf_bump;
+    bool has_volume;
+    bool has_displacement;
+    bool has_surface_spatial_varying;
+    bool has_volume_spatial_varying;
+    bool has_volume_attribute_dependency;
+
+    float3 emission_estimate;
+    EmissionSampling emission_sampling;
+    bool emission_is_constant;
+
+    /* Index of the last update which used this entry. */
+    int last_used_update;
+  };
+
+  /* Compute key of the shader in the cache.
+   * Returns false if the shader can not be cached. */
+  static bool compiled_shader_cache_key(Shader *shader, bool background, string *r_key);
+
+  /* Remove entries which were not used by the current update. */
+  void compiled_shader_cache_prune();
+
+  thread_mutex compiled_shader_cache_mutex_;
+  unordered_map<string, CompiledShader> compiled_shader_cache_;
+  int update_index_ = 0;
+
+  int num_cache_hits_ = 0;
+  int num_cache_misses_ = 0;
+  int num_cache_uncacheable_ = 0;
 };
 
 /* Graph Compiler */
@@ -117,6 +173,9 @@ class SVMCompiler {
     return current_type;
   }
 
+  /* Node types used by the nodes compiled so far. */
+  vector<ShaderNodeType> get_node_types_used() const;
+
   Scene *scene;
   ShaderGraph *current_graph;
   bool background;
@@ -220,7 +279,14 @@ class SVMCompiler {
   /* compile */
   void compile_type(Shader *shader, ShaderGraph *graph, ShaderType type);
 
+  void tag_node_type_used(ShaderNodeType type)
+  {
+    svm_node_types_used[type] = true;
+    local_node_types_used[type] = true;
+  }
+
   std::atomic_int *svm_node_types_used;
+  bool local_node_types_used[NODE_NUM];
   array<int4> current_svm_nodes;
   ShaderType current_type;
   Shader *current_shader;
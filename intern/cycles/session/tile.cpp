@@ -71,6 +71,94 @@ static std::vector<std::string> exr_channel_names_for_passes(const BufferParams
   return channel_names;
 }
 
+/* Maximum number of samples for which accumulated values of passes which support half-float
+ * storage are guaranteed to stay within the half-float range (with a headroom for values which
+ * slightly exceed 1 per sample). */
+static const int MAX_HALF_STORAGE_SAMPLES = 16384;
+
+/* Check whether pixels of the given pass can be stored in the tile file using half-float. */
+static bool use_half_storage_for_pass(const BufferParams &buffer_params, const BufferPass &pass)
+{
+  if (pass.mode != PassMode::NOISY) {
+    return false;
+  }
+  if (buffer_params.samples <= 0 || buffer_params.samples > MAX_HALF_STORAGE_SAMPLES) {
+    return false;
+  }
+  return pass.get_info().support_half_storage;
+}
+
+/* Construct per-channel storage formats of the EXR file, in the same order as channels returned
+ * by `exr_channel_names_for_passes()`.
+ *
+ * Returns an empty vector when all channels are to be stored as float, which allows to keep the
+ * image specification in the simple single-format form. */
+static std::vector<TypeDesc> exr_channel_formats_for_passes(const BufferParams &buffer_params)
+{
+  std::vector<TypeDesc> channel_formats;
+  bool has_half_channels = false;
+
+  for (const BufferPass &pass : buffer_params.passes) {
+    if (pass.offset == PASS_UNUSED) {
+      continue;
+    }
+
+    const PassInfo pass_info = pass.get_info();
+    const bool use_half = use_half_storage_for_pass(buffer_params, pass);
+
+    for (int i = 0; i < pass_info.num_components; ++i) {
+      channel_formats.push_back(use_half ? TypeDesc::HALF : TypeDesc::FLOAT);
+    }
+
+    has_half_channels |= use_half;
+  }
+
+  if (!has_half_channels) {
+    channel_formats.clear();
+  }
+
+  return channel_formats;
+}
+
+/* Log memory used by the render buffer passes and by their storage in the tile file, per pass. */
+static void log_tile_storage_memory_usage(const BufferParams &buffer_params)
+{
+  if (!VLOG_INFO_IS_ON) {
+    return;
+  }
+
+  const size_t num_pixels = size_t(buffer_params.width) * buffer_params.height;
+
+  size_t buffer_size = 0;
+  size_t storage_size = 0;
+
+  for (const BufferPass &pass : buffer_params.passes) {
+    if (pass.offset == PASS_UNUSED) {
+      continue;
+    }
+
+    const PassInfo pass_info = pass.get_info();
+    const bool use_half = use_half_storage_for_pass(buffer_params, pass);
+
+    const size_t pass_buffer_size = num_pixels * pass_info.num_components * sizeof(float);
+    const size_t pass_storage_size = num_pixels * pass_info.num_components *
+                                     (use_half ? sizeof(half) : sizeof(float));
+
+    VLOG_DEBUG << "Pass " << pass.name << " (" << pass_type_as_string(pass.type) << ", "
+               << pass_mode_as_string(pass.mode) << "): "
+               << string_human_readable_size(pass_buffer_size) << " in render buffers, "
+               << string_human_readable_size(pass_storage_size) << " in tile file ("
+               << (use_half ? "half" : "float") << ").";
+
+    buffer_size += pass_buffer_size;
+    storage_size += pass_storage_size;
+  }
+
+  VLOG_INFO << "Full-frame render buffers use " << string_human_readable_size(buffer_size)
+            << ", tile file storage uses " << string_human_readable_size(storage_size)
+            << " before compression.";
+}
+
 inline string node_socket_attribute_name(const SocketType &socket, const string &attr_name_prefix)
 {
   return attr_name_prefix + string(socket.name);
@@ -287,6 +375,7 @@ static bool configure_image_spec_from_buffer(ImageSpec *image_spec,
       buffer_params.width, buffer_params.height, num_channels, TypeDesc::FLOAT);
 
   image_spec->channelnames = std::move(channel_names);
+  image_spec->channelformats = exr_channel_formats_for_passes(buffer_params);
 
   if (!buffer_params_to_image_spec_atttributes(image_spec, buffer_params)) {
     return false;
@@ -367,6 +456,8 @@ void TileManager::update(const BufferParams &params, const Scene *scene)
     node_to_image_spec_atttributes(
         &write_state_.image_spec, &denoise_params, ATTR_DENOISE_SOCKET_PREFIX);
 
+    log_tile_storage_memory_usage(buffer_params_);
+
     /* Not adaptive sampling overscan yet for baking, would need overscan also
      * for buffers read from the output driver. */
     if (adaptive_sampling.use && !scene->bake_manager->get_baking()) {
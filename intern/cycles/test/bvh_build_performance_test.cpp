@@ -0,0 +1,125 @@
+/* SPDX-FileCopyrightText: 2011-2024 Blender Foundation
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+/* Benchmark of the BVH2 builder, reports build time and SAH cost of the resulting tree.
+ * Not registered as a regular test, the binary is to be run manually. */
+
+#include "testing/testing.h"
+
+#include "bvh/build.h"
+#include "bvh/node.h"
+#include "bvh/params.h"
+
+#include "scene/mesh.h"
+#include "scene/object.h"
+
+#include "util/array.h"
+#include "util/hash.h"
+#include "util/progress.h"
+#include "util/task.h"
+#include "util/time.h"
+#include "util/unique_ptr.h"
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Run the longest tests! */
+// #define USE_BIG_TESTS
+
+namespace {
+
+/* Random triangles of roughly the given edge length inside the unit cube. Triangles are grouped
+ * in clusters, which is closer to real scenes than a uniform soup. */
+unique_ptr<Mesh> create_triangle_soup(const int num_triangles, const float edge_length)
+{
+  unique_ptr<Mesh> mesh = make_unique<Mesh>();
+  mesh->reserve_mesh(num_triangles * 3, num_triangles);
+
+  const int triangles_per_cluster = 1024;
+  float3 cluster_center = zero_float3();
+
+  for (int i = 0; i < num_triangles; i++) {
+    if (i % triangles_per_cluster == 0) {
+      const uint seed = hash_uint(i / triangles_per_cluster);
+      cluster_center = make_float3(hash_uint2_to_float(seed, 0),
+                                   hash_uint2_to_float(seed, 1),
+                                   hash_uint2_to_float(seed, 2));
+    }
+
+    const float3 p = cluster_center + make_float3(hash_uint2_to_float(i, 3) - 0.5f,
+                                                  hash_uint2_to_float(i, 4) - 0.5f,
+                                                  hash_uint2_to_float(i, 5) - 0.5f) *
+                                          0.05f;
+    for (int v = 0; v < 3; v++) {
+      mesh->add_vertex(p + make_float3(hash_uint2_to_float(i, 6 + v * 3),
+                                       hash_uint2_to_float(i, 7 + v * 3),
+                                       hash_uint2_to_float(i, 8 + v * 3)) *
+                               edge_length);
+    }
+    mesh->add_triangle(i * 3, i * 3 + 1, i * 3 + 2, 0, false);
+  }
+
+  mesh->compute_bounds();
+  return mesh;
+}
+
+void bvh_build_benchmark(const char *name, const int num_triangles, const bool use_spatial_split)
+{
+  unique_ptr<Mesh> mesh = create_triangle_soup(num_triangles, 0.002f);
+
+  Object object;
+  object.set_geometry(mesh.get());
+  vector<Object *> objects;
+  objects.push_back(&object);
+
+  BVHParams params;
+  params.use_spatial_split = use_spatial_split;
+
+  array<int> prim_type, prim_index, prim_object;
+  array<float2> prim_time;
+  Progress progress;
+
+  const double start_time = time_dt();
+  BVHBuild build(objects, prim_type, prim_index, prim_object, prim_time, params, progress);
+  BVHNode *root = build.run();
+  const double build_time = time_dt() - start_time;
+
+  ASSERT_NE(root, nullptr);
+
+  printf("%s (%d triangles, %s):\n", name, num_triangles, use_spatial_split ? "spatial" : "binned");
+  printf("  Build time: %.3f s\n", build_time);
+  printf("  SAH cost: %f\n", root->computeSubtreeSAHCost(params));
+  printf("  Nodes: %d, leaves: %d, depth: %d\n",
+         root->getSubtreeSize(BVH_STAT_NODE_COUNT),
+         root->getSubtreeSize(BVH_STAT_LEAF_COUNT),
+         root->getSubtreeSize(BVH_STAT_DEPTH));
+
+  root->deleteSubtree();
+}
+
+}  // namespace
+
+TEST(bvh_build_performance, binned)
+{
+  TaskScheduler::init(0);
+  bvh_build_benchmark("Triangle soup", 100000, false);
+  bvh_build_benchmark("Triangle soup", 1000000, false);
+#ifdef USE_BIG_TESTS
+  bvh_build_benchmark("Triangle soup", 10000000, false);
+#endif
+  TaskScheduler::exit();
+}
+
+TEST(bvh_build_performance, spatial_split)
+{
+  TaskScheduler::init(0);
+  bvh_build_benchmark("Triangle soup", 100000, true);
+  bvh_build_benchmark("Triangle soup", 1000000, true);
+#ifdef USE_BIG_TESTS
+  bvh_build_benchmark("Triangle soup", 10000000, true);
+#endif
+  TaskScheduler::exit();
+}
+
+CCL_NAMESPACE_END
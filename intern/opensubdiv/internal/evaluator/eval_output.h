@@ -258,6 +258,11 @@ class FaceVaryingVolatileEval {
     return src_desc.offset;
   }
 
+  BufferDescriptor getSrcDesc() const
+  {
+    return get_src_varying_desc();
+  }
+
   PATCH_TABLE *getPatchTable() const
   {
     return patch_table_;
@@ -596,11 +601,26 @@ class VolatileEvalOutput : public EvalOutputAPI::EvalOutput {
     return src_data_;
   }
 
+  SRC_VERTEX_BUFFER *getSrcVaryingBuffer() const
+  {
+    return src_varying_data_;
+  }
+
+  const BufferDescriptor &getSrcVaryingDesc() const
+  {
+    return src_varying_desc_;
+  }
+
   SRC_VERTEX_BUFFER *getSrcVertexDataBuffer() const
   {
     return src_vertex_data_;
   }
 
+  const BufferDescriptor &getSrcVertexDataDesc() const
+  {
+    return src_vertex_data_desc_;
+  }
+
   PATCH_TABLE *getPatchTable() const
   {
     return patch_table_;
@@ -616,6 +636,11 @@ class VolatileEvalOutput : public EvalOutputAPI::EvalOutput {
     return face_varying_evaluators_[face_varying_channel]->getFVarSrcBufferOffset();
   }
 
+  BufferDescriptor getFVarSrcDesc(const int face_varying_channel) const
+  {
+    return face_varying_evaluators_[face_varying_channel]->getSrcDesc();
+  }
+
   PATCH_TABLE *getFVarPatchTable(const int face_varying_channel) const
   {
     return face_varying_evaluators_[face_varying_channel]->getPatchTable();
@@ -12,10 +12,16 @@
 #include <opensubdiv/osd/cpuEvaluator.h>
 #include <opensubdiv/osd/cpuPatchTable.h>
 #include <opensubdiv/osd/cpuVertexBuffer.h>
+#ifdef OPENSUBDIV_HAS_TBB
+#  include <opensubdiv/osd/tbbEvaluator.h>
+#endif
 
 using OpenSubdiv::Far::StencilTable;
 using OpenSubdiv::Osd::CpuEvaluator;
 using OpenSubdiv::Osd::CpuVertexBuffer;
+#ifdef OPENSUBDIV_HAS_TBB
+using OpenSubdiv::Osd::TbbEvaluator;
+#endif
 
 namespace blender::opensubdiv {
 
@@ -47,6 +53,158 @@ class CpuEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
   }
 };
 
+#ifdef OPENSUBDIV_HAS_TBB
+
+// CPU evaluator which uses TBB to refine the stencils and to evaluate large batches of patch
+// coordinates in parallel. Evaluation of just a few coordinates (which is what the single point
+// queries do, often from many threads at once) goes through the serial CPU evaluator instead, to
+// avoid the overhead of scheduling parallel tasks for a handful of patches.
+class TbbEvalOutput : public VolatileEvalOutput<CpuVertexBuffer,
+                                                CpuVertexBuffer,
+                                                StencilTable,
+                                                CpuPatchTable,
+                                                TbbEvaluator> {
+ public:
+  typedef VolatileEvalOutput<CpuVertexBuffer,
+                             CpuVertexBuffer,
+                             StencilTable,
+                             CpuPatchTable,
+                             TbbEvaluator>
+      BaseEvalOutput;
+
+  // Batches smaller than this are evaluated on the calling thread.
+  static constexpr int MIN_PARALLEL_PATCH_COORDS = 256;
+
+  TbbEvalOutput(const StencilTable *vertex_stencils,
+                const StencilTable *varying_stencils,
+                const std::vector<const StencilTable *> &all_face_varying_stencils,
+                const int face_varying_width,
+                const PatchTable *patch_table)
+      : BaseEvalOutput(vertex_stencils,
+                       varying_stencils,
+                       all_face_varying_stencils,
+                       face_varying_width,
+                       patch_table)
+  {
+  }
+
+  void evalPatches(const PatchCoord *patch_coord, const int num_patch_coords, float *P) override
+  {
+    if (num_patch_coords >= MIN_PARALLEL_PATCH_COORDS) {
+      BaseEvalOutput::evalPatches(patch_coord, num_patch_coords, P);
+      return;
+    }
+    RawDataWrapperBuffer<float> P_data(P);
+    BufferDescriptor src_desc(0, 3, 3);
+    BufferDescriptor P_desc(0, 3, 3);
+    ConstPatchCoordWrapperBuffer patch_coord_buffer(patch_coord, num_patch_coords);
+    CpuEvaluator::EvalPatches(getSrcBuffer(),
+                              src_desc,
+                              &P_data,
+                              P_desc,
+                              patch_coord_buffer.GetNumVertices(),
+                              &patch_coord_buffer,
+                              getPatchTable());
+  }
+
+  void evalPatchesWithDerivatives(const PatchCoord *patch_coord,
+                                  const int num_patch_coords,
+                                  float *P,
+                                  float *dPdu,
+                                  float *dPdv) override
+  {
+    if (num_patch_coords >= MIN_PARALLEL_PATCH_COORDS) {
+      BaseEvalOutput::evalPatchesWithDerivatives(patch_coord, num_patch_coords, P, dPdu, dPdv);
+      return;
+    }
+    assert(dPdu);
+    assert(dPdv);
+    RawDataWrapperBuffer<float> P_data(P);
+    RawDataWrapperBuffer<float> dPdu_data(dPdu), dPdv_data(dPdv);
+    BufferDescriptor src_desc(0, 3, 3);
+    BufferDescriptor P_desc(0, 3, 3);
+    BufferDescriptor dpDu_desc(0, 3, 3), pPdv_desc(0, 3, 3);
+    ConstPatchCoordWrapperBuffer patch_coord_buffer(patch_coord, num_patch_coords);
+    CpuEvaluator::EvalPatches(getSrcBuffer(),
+                              src_desc,
+                              &P_data,
+                              P_desc,
+                              &dPdu_data,
+                              dpDu_desc,
+                              &dPdv_data,
+                              pPdv_desc,
+                              patch_coord_buffer.GetNumVertices(),
+                              &patch_coord_buffer,
+                              getPatchTable());
+  }
+
+  void evalPatchesVarying(const PatchCoord *patch_coord,
+                          const int num_patch_coords,
+                          float *varying) override
+  {
+    if (num_patch_coords >= MIN_PARALLEL_PATCH_COORDS) {
+      BaseEvalOutput::evalPatchesVarying(patch_coord, num_patch_coords, varying);
+      return;
+    }
+    RawDataWrapperBuffer<float> varying_data(varying);
+    BufferDescriptor varying_desc(3, 3, 6);
+    ConstPatchCoordWrapperBuffer patch_coord_buffer(patch_coord, num_patch_coords);
+    CpuEvaluator::EvalPatchesVarying(getSrcVaryingBuffer(),
+                                     getSrcVaryingDesc(),
+                                     &varying_data,
+                                     varying_desc,
+                                     patch_coord_buffer.GetNumVertices(),
+                                     &patch_coord_buffer,
+                                     getPatchTable());
+  }
+
+  void evalPatchesVertexData(const PatchCoord *patch_coord,
+                             const int num_patch_coords,
+                             float *data) override
+  {
+    if (num_patch_coords >= MIN_PARALLEL_PATCH_COORDS) {
+      BaseEvalOutput::evalPatchesVertexData(patch_coord, num_patch_coords, data);
+      return;
+    }
+    const BufferDescriptor &src_desc = getSrcVertexDataDesc();
+    RawDataWrapperBuffer<float> vertex_data(data);
+    BufferDescriptor vertex_desc(0, src_desc.length, src_desc.length);
+    ConstPatchCoordWrapperBuffer patch_coord_buffer(patch_coord, num_patch_coords);
+    CpuEvaluator::EvalPatches(getSrcVertexDataBuffer(),
+                              src_desc,
+                              &vertex_data,
+                              vertex_desc,
+                              patch_coord_buffer.GetNumVertices(),
+                              &patch_coord_buffer,
+                              getPatchTable());
+  }
+
+  void evalPatchesFaceVarying(const int face_varying_channel,
+                              const PatchCoord *patch_coord,
+                              const int num_patch_coords,
+                              float face_varying[2]) override
+  {
+    if (num_patch_coords >= MIN_PARALLEL_PATCH_COORDS) {
+      BaseEvalOutput::evalPatchesFaceVarying(
+          face_varying_channel, patch_coord, num_patch_coords, face_varying);
+      return;
+    }
+    RawDataWrapperBuffer<float> face_varying_data(face_varying);
+    BufferDescriptor face_varying_desc(0, 2, 2);
+    ConstPatchCoordWrapperBuffer patch_coord_buffer(patch_coord, num_patch_coords);
+    CpuEvaluator::EvalPatchesFaceVarying(getFVarSrcBuffer(face_varying_channel),
+                                         getFVarSrcDesc(face_varying_channel),
+                                         &face_varying_data,
+                                         face_varying_desc,
+                                         patch_coord_buffer.GetNumVertices(),
+                                         &patch_coord_buffer,
+                                         getFVarPatchTable(face_varying_channel),
+                                         face_varying_channel);
+  }
+};
+
+#endif  // OPENSUBDIV_HAS_TBB
+
 }  // namespace blender::opensubdiv
 
 #endif  // OPENSUBDIV_EVAL_OUTPUT_CPU_H_
@@ -281,6 +281,11 @@ void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator *evaluator)
   MEM_delete(evaluator);
 }
 
+void openSubdiv_prepareEvaluatorTables(OpenSubdiv_TopologyRefiner *topology_refiner)
+{
+  openSubdiv_prepareEvaluatorTablesInternal(topology_refiner);
+}
+
 OpenSubdiv_EvaluatorCache *openSubdiv_createEvaluatorCache(eOpenSubdivEvaluator evaluator_type)
 {
   OpenSubdiv_EvaluatorCache *evaluator_cache = MEM_new<OpenSubdiv_EvaluatorCache>(__func__);
@@ -8,6 +8,7 @@
 
 #include <cassert>
 #include <cstdio>
+#include <mutex>
 
 #ifdef _MSC_VER
 #  include <iso646.h>
@@ -407,27 +408,33 @@ bool EvalOutputAPI::hasVertexData() const
 
 }  // namespace blender::opensubdiv
 
-OpenSubdiv_EvaluatorImpl::OpenSubdiv_EvaluatorImpl()
-    : eval_output(NULL), patch_map(NULL), patch_table(NULL)
-{
-}
+namespace blender::opensubdiv {
 
-OpenSubdiv_EvaluatorImpl::~OpenSubdiv_EvaluatorImpl()
+EvaluatorTables::~EvaluatorTables()
 {
-  delete eval_output;
+  delete vertex_stencils;
+  delete varying_stencils;
+  for (const StencilTable *table : all_face_varying_stencils) {
+    delete table;
+  }
   delete patch_map;
   delete patch_table;
 }
 
-OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
-    OpenSubdiv_TopologyRefiner *topology_refiner,
-    eOpenSubdivEvaluator evaluator_type,
-    OpenSubdiv_EvaluatorCacheImpl *evaluator_cache_descr)
+// Refine the topology and create the tables needed by evaluators, or return the tables which were
+// created for the topology refiner already.
+static std::shared_ptr<const EvaluatorTables> ensureEvaluatorTables(
+    OpenSubdiv_TopologyRefiner *topology_refiner)
 {
-  TopologyRefiner *refiner = topology_refiner->impl->topology_refiner;
+  TopologyRefinerImpl *topology_refiner_impl = topology_refiner->impl;
+  std::lock_guard<std::mutex> lock(topology_refiner_impl->evaluator_tables_mutex);
+  if (topology_refiner_impl->evaluator_tables) {
+    return topology_refiner_impl->evaluator_tables;
+  }
+  TopologyRefiner *refiner = topology_refiner_impl->topology_refiner;
   if (refiner == NULL) {
     // Happens on bad topology.
-    return NULL;
+    return nullptr;
   }
   // TODO(sergey): Base this on actual topology.
   const bool has_varying_data = false;
@@ -526,6 +533,35 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
       all_face_varying_stencils[face_varying_channel] = table;
     }
   }
+  EvaluatorTables *tables = new EvaluatorTables();
+  tables->vertex_stencils = vertex_stencils;
+  tables->varying_stencils = varying_stencils;
+  tables->all_face_varying_stencils = std::move(all_face_varying_stencils);
+  tables->patch_table = patch_table;
+  tables->patch_map = new PatchMap(*patch_table);
+  topology_refiner_impl->evaluator_tables = std::shared_ptr<const EvaluatorTables>(tables);
+  return topology_refiner_impl->evaluator_tables;
+}
+
+}  // namespace blender::opensubdiv
+
+OpenSubdiv_EvaluatorImpl::OpenSubdiv_EvaluatorImpl() : eval_output(NULL) {}
+
+OpenSubdiv_EvaluatorImpl::~OpenSubdiv_EvaluatorImpl()
+{
+  delete eval_output;
+}
+
+OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
+    OpenSubdiv_TopologyRefiner *topology_refiner,
+    eOpenSubdivEvaluator evaluator_type,
+    OpenSubdiv_EvaluatorCacheImpl *evaluator_cache_descr)
+{
+  std::shared_ptr<const blender::opensubdiv::EvaluatorTables> tables =
+      blender::opensubdiv::ensureEvaluatorTables(topology_refiner);
+  if (!tables) {
+    return NULL;
+  }
   // Create OpenSubdiv's CPU side evaluator.
   blender::opensubdiv::EvalOutputAPI::EvalOutput *eval_output = nullptr;
 
@@ -537,32 +573,36 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
           evaluator_cache_descr->eval_cache);
     }
 
-    eval_output = new blender::opensubdiv::GpuEvalOutput(vertex_stencils,
-                                                         varying_stencils,
-                                                         all_face_varying_stencils,
+    eval_output = new blender::opensubdiv::GpuEvalOutput(tables->vertex_stencils,
+                                                         tables->varying_stencils,
+                                                         tables->all_face_varying_stencils,
                                                          2,
-                                                         patch_table,
+                                                         tables->patch_table,
                                                          evaluator_cache);
   }
   else {
-    eval_output = new blender::opensubdiv::CpuEvalOutput(
-        vertex_stencils, varying_stencils, all_face_varying_stencils, 2, patch_table);
+#ifdef OPENSUBDIV_HAS_TBB
+    eval_output = new blender::opensubdiv::TbbEvalOutput(tables->vertex_stencils,
+                                                         tables->varying_stencils,
+                                                         tables->all_face_varying_stencils,
+                                                         2,
+                                                         tables->patch_table);
+#else
+    eval_output = new blender::opensubdiv::CpuEvalOutput(tables->vertex_stencils,
+                                                         tables->varying_stencils,
+                                                         tables->all_face_varying_stencils,
+                                                         2,
+                                                         tables->patch_table);
+#endif
   }
 
-  blender::opensubdiv::PatchMap *patch_map = new blender::opensubdiv::PatchMap(*patch_table);
   // Wrap everything we need into an object which we control from our side.
   OpenSubdiv_EvaluatorImpl *evaluator_descr;
   evaluator_descr = new OpenSubdiv_EvaluatorImpl();
 
-  evaluator_descr->eval_output = new blender::opensubdiv::EvalOutputAPI(eval_output, patch_map);
-  evaluator_descr->patch_map = patch_map;
-  evaluator_descr->patch_table = patch_table;
-  // TODO(sergey): Look into whether we've got duplicated stencils arrays.
-  delete vertex_stencils;
-  delete varying_stencils;
-  for (const StencilTable *table : all_face_varying_stencils) {
-    delete table;
-  }
+  evaluator_descr->eval_output = new blender::opensubdiv::EvalOutputAPI(eval_output,
+                                                                        tables->patch_map);
+  evaluator_descr->tables = tables;
   return evaluator_descr;
 }
 
@@ -570,3 +610,8 @@ void openSubdiv_deleteEvaluatorInternal(OpenSubdiv_EvaluatorImpl *evaluator)
 {
   delete evaluator;
 }
+
+void openSubdiv_prepareEvaluatorTablesInternal(OpenSubdiv_TopologyRefiner *topology_refiner)
+{
+  blender::opensubdiv::ensureEvaluatorTables(topology_refiner);
+}
@@ -11,8 +11,12 @@
 #  include <iso646.h>
 #endif
 
+#include <memory>
+#include <vector>
+
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/stencilTable.h>
 
 #include "internal/base/memory.h"
 
@@ -28,6 +32,24 @@ namespace blender::opensubdiv {
 
 class PatchMap;
 
+// Stencil and patch tables which are needed to create evaluators for a refined topology.
+//
+// They only depend on the topology and the refiner settings, so they are created once per
+// topology refiner and are shared by all evaluators which are created from it. This avoids
+// refining the same topology again when an evaluator is re-created, or when the topology refiner
+// is shared between multiple users.
+struct EvaluatorTables {
+  ~EvaluatorTables();
+
+  const OpenSubdiv::Far::StencilTable *vertex_stencils = nullptr;
+  const OpenSubdiv::Far::StencilTable *varying_stencils = nullptr;
+  std::vector<const OpenSubdiv::Far::StencilTable *> all_face_varying_stencils;
+  const OpenSubdiv::Far::PatchTable *patch_table = nullptr;
+  PatchMap *patch_map = nullptr;
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("EvaluatorTables");
+};
+
 // Wrapper around implementation, which defines API which we are capable to
 // provide over the implementation.
 //
@@ -190,8 +212,9 @@ struct OpenSubdiv_EvaluatorImpl {
   ~OpenSubdiv_EvaluatorImpl();
 
   blender::opensubdiv::EvalOutputAPI *eval_output;
-  const blender::opensubdiv::PatchMap *patch_map;
-  const OpenSubdiv::Far::PatchTable *patch_table;
+  // Tables are shared with the topology refiner and other evaluators created from it, keep them
+  // alive for as long as the evaluator is, since the evaluator references the patch map.
+  std::shared_ptr<const blender::opensubdiv::EvaluatorTables> tables;
 
   MEM_CXX_CLASS_ALLOC_FUNCS("OpenSubdiv_EvaluatorImpl");
 };
@@ -203,4 +226,6 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
 
 void openSubdiv_deleteEvaluatorInternal(OpenSubdiv_EvaluatorImpl *evaluator);
 
+void openSubdiv_prepareEvaluatorTablesInternal(OpenSubdiv_TopologyRefiner *topology_refiner);
+
 #endif  // OPENSUBDIV_EVALUATOR_IMPL_H_
@@ -11,6 +11,9 @@
 #  include <iso646.h>
 #endif
 
+#include <memory>
+#include <mutex>
+
 #include <opensubdiv/far/topologyRefiner.h>
 
 #include "internal/base/memory.h"
@@ -21,6 +24,8 @@ struct OpenSubdiv_Converter;
 
 namespace blender::opensubdiv {
 
+struct EvaluatorTables;
+
 class TopologyRefinerImpl {
  public:
   // NOTE: Will return nullptr if topology refiner can not be created (for
@@ -57,6 +62,11 @@ class TopologyRefinerImpl {
   //    corner vertices.
   MeshTopology base_mesh_topology;
 
+  // Tables which are created by the first evaluator created from this refiner, and are shared
+  // with all evaluators created afterwards.
+  std::shared_ptr<const EvaluatorTables> evaluator_tables;
+  std::mutex evaluator_tables_mutex;
+
   MEM_CXX_CLASS_ALLOC_FUNCS("TopologyRefinerImpl");
 };
 
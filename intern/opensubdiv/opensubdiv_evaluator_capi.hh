@@ -231,6 +231,14 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
 
 void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator *evaluator);
 
+// Refine the topology and create the stencil and patch tables which evaluators need, unless this
+// was done already. The tables are stored in the topology refiner and are shared by all
+// evaluators created from it, so evaluators are created without refining the topology again.
+//
+// NOTE: Refinement modifies the topology refiner, so this needs to be called before a topology
+// refiner is shared between multiple threads.
+void openSubdiv_prepareEvaluatorTables(OpenSubdiv_TopologyRefiner *topology_refiner);
+
 OpenSubdiv_EvaluatorCache *openSubdiv_createEvaluatorCache(eOpenSubdivEvaluator evaluator_type);
 
 void openSubdiv_deleteEvaluatorCache(OpenSubdiv_EvaluatorCache *evaluator_cache);
@@ -18,6 +18,8 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
 
 void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator * /*evaluator*/) {}
 
+void openSubdiv_prepareEvaluatorTables(OpenSubdiv_TopologyRefiner * /*topology_refiner*/) {}
+
 OpenSubdiv_EvaluatorCache *openSubdiv_createEvaluatorCache(eOpenSubdivEvaluator /*evaluator_type*/)
 {
   return NULL;
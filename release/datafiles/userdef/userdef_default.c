@@ -139,6 +139,8 @@ const UserDef U_default = {
 
     .prefetchframes = 0,
     .pad_rot_angle = 15,
+    .compositor_cache_limit = 1024,
+    .compositor_streaming_limit = 256,
     .rvisize = 25,
     .rvibright = 8,
     .recent_files = 20,
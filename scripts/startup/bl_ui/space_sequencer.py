@@ -10,6 +10,7 @@ from bpy.types import (
 )
 from bpy.app.translations import (
     contexts as i18n_contexts,
+    pgettext_iface as iface_,
     pgettext_rpt as rpt_,
 )
 from bl_ui.properties_grease_pencil_common import (
@@ -2394,6 +2395,12 @@ class SEQUENCER_PT_cache_settings(SequencerButtonsPanel, Panel):
         col.prop(ed, "use_cache_preprocessed", text="Preprocessed")
         col.prop(ed, "use_cache_composite", text="Composite")
         col.prop(ed, "use_cache_final", text="Final")
+        col.prop(ed, "use_cache_display", text="Display")
+
+        if context.preferences.system.use_sequencer_disk_cache:
+            col = layout.column(heading="Disk Cache", align=True)
+            col.label(text=iface_("Read: {:.1f} MB/s").format(ed.disk_cache_read_speed), translate=False)
+            col.label(text=iface_("Write: {:.1f} MB/s").format(ed.disk_cache_write_speed), translate=False)
 
 
 class SEQUENCER_PT_cache_view_settings(SequencerButtonsPanel, Panel):
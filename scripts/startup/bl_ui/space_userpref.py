@@ -777,6 +777,12 @@ class USERPREF_PT_system_memory(SystemPanel, CenterAlignMixIn, Panel):
         col.prop(system, "vbo_time_out", text="VBO Time Out")
         col.prop(system, "vbo_collection_rate", text="Garbage Collection Rate")
 
+        layout.separator()
+
+        col = layout.column()
+        col.prop(system, "compositor_cache_limit", text="Compositor Cache Limit")
+        col.prop(system, "compositor_streaming_limit", text="Streaming Limit")
+
         if sys.platform != "darwin":
             layout.separator()
             col = layout.column()
@@ -2860,6 +2866,7 @@ class USERPREF_PT_experimental_prototypes(ExperimentalPanel, Panel):
                 ({"property": "use_sculpt_texture_paint"}, ("blender/blender/issues/96225", "#96225")),
                 ({"property": "enable_overlay_next"}, ("blender/blender/issues/102179", "#102179")),
                 ({"property": "use_animation_baklava"}, ("/blender/blender/issues/120406", "#120406")),
+                ({"property": "use_realtime_compositor_cpu"}, None),
             ),
         )
 
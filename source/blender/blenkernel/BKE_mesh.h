@@ -502,9 +502,16 @@ void BKE_mesh_eval_geometry(Depsgraph *depsgraph, Mesh *mesh);
 /* Draw Cache */
 void BKE_mesh_batch_cache_dirty_tag(Mesh *mesh, eMeshBatchDirtyMode mode);
 void BKE_mesh_batch_cache_free(void *batch_cache);
+/**
+ * Take the draw cache of an evaluated mesh that is about to be freed, so that the draw code can
+ * keep the parts that are still valid for the next evaluated mesh of the same object.
+ * \return The detached cache, or null when it can't be reused and stays on the mesh.
+ */
+void *BKE_mesh_batch_cache_detach(Mesh *mesh);
 
 extern void (*BKE_mesh_batch_cache_dirty_tag_cb)(Mesh *mesh, eMeshBatchDirtyMode mode);
 extern void (*BKE_mesh_batch_cache_free_cb)(void *batch_cache);
+extern void *(*BKE_mesh_batch_cache_detach_cb)(Mesh *mesh);
 
 /* `mesh_debug.cc` */
 
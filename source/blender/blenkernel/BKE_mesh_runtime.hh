@@ -45,6 +45,12 @@ void BKE_mesh_runtime_clear_cache(Mesh *mesh);
 
 namespace blender::bke {
 
+/**
+ * Replace the mesh's topology map caches with the caches shared by all meshes that use the same
+ * implicitly shared face offsets and corner vertices. Called before accessing the caches.
+ */
+void mesh_ensure_topology_maps_linked(const Mesh &mesh);
+
 void mesh_get_mapped_verts_coords(Mesh *mesh_eval, MutableSpan<float3> r_cos);
 
 Mesh *editbmesh_get_eval_cage(Depsgraph *depsgraph,
@@ -29,6 +29,7 @@ struct SubdivCCG;
 struct SubsurfRuntimeData;
 namespace blender::bke {
 struct EditMeshData;
+struct TopologyMaps;
 }
 namespace blender::bke::bake {
 struct BakeMaterialsList;
@@ -210,6 +211,15 @@ struct MeshRuntime {
   SharedCache<Array<int>> vert_to_corner_map_cache;
   /** Cache of face indices for each face corner. */
   SharedCache<Array<int>> corner_to_face_map_cache;
+  /**
+   * Whether the topology map caches above were replaced by the caches stored for the implicitly
+   * shared face offsets and corner vertices, so that meshes that share their topology arrays
+   * without being copies of each other (e.g. after modifiers or when reading baked geometry) only
+   * build the maps once.
+   */
+  CacheMutex topology_maps_link_mutex;
+  /** The linked topology maps, owned by all linked meshes. */
+  std::shared_ptr<TopologyMaps> topology_maps;
   /** Cache of data about edges not used by faces. See #Mesh::loose_edges(). */
   SharedCache<LooseEdgeCache> loose_edges_cache;
   /** Cache of data about vertices not used by edges. See #Mesh::loose_verts(). */
@@ -100,6 +100,13 @@ struct ObjectRuntime {
    */
   Mesh *editmesh_eval_cage = nullptr;
 
+  /**
+   * Draw cache of a previous evaluated mesh, detached before that mesh was freed by a new
+   * evaluation. The draw code reuses the buffers that don't depend on the changed data when the
+   * new evaluated mesh is drawn. Owned by the object.
+   */
+  void *mesh_batch_cache_prev = nullptr;
+
   /**
    * Original grease pencil bGPdata pointer, before object->data was changed to point
    * to gpd_eval.
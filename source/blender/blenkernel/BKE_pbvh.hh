@@ -28,6 +28,22 @@ enum class Type {
   BMesh,
 };
 
+/**
+ * The kinds of node data that changed since the node's draw buffers were last updated. Only the
+ * vertex buffers depending on changed data are extracted and uploaded again.
+ */
+enum class DrawDirty : uint8_t {
+  None = 0,
+  /** Positions and normals. */
+  Positions = 1 << 0,
+  Masks = 1 << 1,
+  FaceSets = 1 << 2,
+  /** Generic attributes, like color attributes. */
+  Attributes = 1 << 3,
+  All = Positions | Masks | FaceSets | Attributes,
+};
+ENUM_OPERATORS(DrawDirty, DrawDirty::Attributes);
+
 }  // namespace blender::bke::pbvh
 
 /* #PBVHNodeFlags is needed by `DRW_render.hh` and `draw_cache.cc`. */
@@ -137,6 +137,24 @@ class Node {
    * marking various updates that need to be applied. */
   PBVHNodeFlags flag_ = PBVHNodeFlags(0);
 
+  /**
+   * Data that changed since the draw buffers were updated, used together with
+   * #PBVH_UpdateDrawBuffers to avoid extracting unchanged vertex buffers.
+   */
+  DrawDirty draw_dirty_ = DrawDirty::All;
+
+  /**
+   * Vertices which positions changed since the draw buffers were updated, used when
+   * #draw_dirty_ contains #DrawDirty::Positions. Indices are in #node_unique_verts for meshes and
+   * in the elements of the node's grids for multires, in the order of #node_grid_indices.
+   */
+  IndexRange draw_dirty_verts_;
+  /** Whether positions changed without recording them in #draw_dirty_verts_. */
+  bool draw_dirty_verts_all_ = true;
+  /** Whether positions are about to change and aren't recorded yet, see
+   * #BKE_pbvh_node_mark_positions_pending. */
+  bool draw_dirty_verts_pending_ = false;
+
   /* Used for ray-casting: how close the bounding-box is to the ray point. */
   float tmin_ = 0.0f;
 
@@ -426,6 +444,18 @@ void BKE_pbvh_node_mark_update_visibility(blender::bke::pbvh::Node *node);
 void BKE_pbvh_node_mark_rebuild_draw(blender::bke::pbvh::Node *node);
 void BKE_pbvh_node_mark_redraw(blender::bke::pbvh::Node *node);
 void BKE_pbvh_node_mark_positions_update(blender::bke::pbvh::Node *node);
+/**
+ * Tag positions of the node as changed, like #BKE_pbvh_node_mark_positions_update, but only for
+ * the given vertices (see #blender::bke::pbvh::Node::draw_dirty_verts_). Only the draw data of
+ * these vertices and their neighbors is extracted again.
+ */
+void BKE_pbvh_node_mark_positions_update(blender::bke::pbvh::Node *node,
+                                         blender::IndexRange verts);
+/**
+ * Tag positions of the node as about to change, before a brush records the changed vertices with
+ * #BKE_pbvh_node_mark_positions_update. All vertices are considered changed if none are recorded.
+ */
+void BKE_pbvh_node_mark_positions_pending(blender::bke::pbvh::Node *node);
 void BKE_pbvh_node_mark_topology_update(blender::bke::pbvh::Node *node);
 void BKE_pbvh_node_fully_hidden_set(blender::bke::pbvh::Node *node, int fully_hidden);
 bool BKE_pbvh_node_fully_hidden_get(const blender::bke::pbvh::Node *node);
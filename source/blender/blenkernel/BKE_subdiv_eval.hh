@@ -8,11 +8,14 @@
 
 #pragma once
 
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_sys_types.h"
 
 struct Mesh;
 struct OpenSubdiv_EvaluatorCache;
 struct OpenSubdiv_EvaluatorSettings;
+struct OpenSubdiv_PatchCoord;
 
 namespace blender::bke::subdiv {
 
@@ -59,6 +62,24 @@ void eval_limit_point_and_derivatives(Subdiv *subdiv,
 void eval_limit_point_and_normal(
     Subdiv *subdiv, int ptex_face_index, float u, float v, float r_P[3], float r_N[3]);
 
+/* Batched queries.
+ *
+ * Evaluate many points at once, in parallel chunks of patch coordinates. This is considerably
+ * faster than calling the single point queries in a loop for large numbers of points, since the
+ * per-point overhead of the evaluator is amortized over the whole chunk. */
+
+/* Evaluate points at a limit surface. */
+void eval_limit_points(Subdiv *subdiv,
+                       Span<OpenSubdiv_PatchCoord> patch_coords,
+                       MutableSpan<float3> r_P);
+/* Evaluate points at a limit surface with derivatives. Degenerate derivatives are handled the same
+ * way as in #eval_limit_point_and_derivatives. */
+void eval_limit_points_and_derivatives(Subdiv *subdiv,
+                                       Span<OpenSubdiv_PatchCoord> patch_coords,
+                                       MutableSpan<float3> r_P,
+                                       MutableSpan<float3> r_dPdu,
+                                       MutableSpan<float3> r_dPdv);
+
 /* Evaluate smoothly interpolated vertex data (such as ORCO). */
 void eval_vertex_data(Subdiv *subdiv,
                       const int ptex_face_index,
@@ -8,10 +8,48 @@
 
 #pragma once
 
+#include "BLI_sys_types.h"
+
+class OpenSubdiv_TopologyRefiner;
+struct OpenSubdiv_Converter;
+
 namespace blender::bke::subdiv {
 
+struct Settings;
 struct Subdiv;
 
 int topology_num_fvar_layers_get(const Subdiv *subdiv);
 
+/* --------------------------------------------------------------------
+ * Topology refiner cache.
+ *
+ * Topology refiners, together with the stencil and patch tables evaluators are created from, only
+ * depend on the topology of the base mesh and on the subdivision settings. They are shared between
+ * all subdivision surfaces with identical topology and settings, such as duplicated characters of
+ * a crowd which only differ in their deformation, and are freed when their last user releases
+ * them.
+ */
+
+struct TopologyCacheStats {
+  /* Number of times an existing topology refiner was shared. */
+  int64_t hits;
+  /* Number of times a new topology refiner was created. */
+  int64_t misses;
+  /* Number of topology refiners in the cache. */
+  int64_t refiners_num;
+  /* Total number of users of the cached topology refiners. */
+  int64_t users_num;
+};
+
+/* Get a topology refiner for the given settings and topology, sharing an existing one if possible.
+ * The refiner is refined and has its evaluator tables prepared, so it can be used from multiple
+ * threads. Returns null for topology which OpenSubdiv can not handle.
+ *
+ * The result must be released with #topology_refiner_release. */
+OpenSubdiv_TopologyRefiner *topology_refiner_acquire(const Settings *settings,
+                                                     OpenSubdiv_Converter *converter);
+void topology_refiner_release(OpenSubdiv_TopologyRefiner *topology_refiner);
+
+TopologyCacheStats topology_cache_stats_get();
+
 }  // namespace blender::bke::subdiv
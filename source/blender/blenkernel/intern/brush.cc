@@ -19,6 +19,7 @@
 #include "BLI_math_base.hh"
 #include "BLI_math_rotation.h"
 #include "BLI_rand.h"
+#include "BLI_simd.hh"
 
 #include "BLT_translation.hh"
 
@@ -1488,6 +1489,50 @@ void BKE_brush_randomize_texture_coords(UnifiedPaintSettings *ups, bool mask)
   }
 }
 
+/**
+ * Multiply factors by a falloff of the normalized distance to the brush edge, and clear them for
+ * distances outside of the radius. With SSE2, four factors are processed at once with the same
+ * operations as the scalar fallback, which is used for the remaining elements.
+ */
+template<typename CurveFn, typename CurveSSE2Fn>
+static void calc_curve_factors(const blender::Span<float> distances,
+                               const float brush_radius,
+                               const blender::MutableSpan<float> factors,
+                               const CurveFn curve_fn,
+                               const CurveSSE2Fn curve_sse2_fn)
+{
+  const float radius_rcp = blender::math::rcp(brush_radius);
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 radius = _mm_set1_ps(brush_radius);
+  const __m128 radius_rcp_4 = _mm_set1_ps(radius_rcp);
+  const __m128 one = _mm_set1_ps(1.0f);
+  for (; i + 4 <= distances.size(); i += 4) {
+    const __m128 distance = _mm_loadu_ps(&distances[i]);
+    const __m128 inside = _mm_cmplt_ps(distance, radius);
+    const __m128 factor = _mm_sub_ps(one, _mm_mul_ps(distance, radius_rcp_4));
+    const __m128 result = _mm_mul_ps(_mm_loadu_ps(&factors[i]), curve_sse2_fn(factor));
+    _mm_storeu_ps(&factors[i], _mm_and_ps(inside, result));
+  }
+#else
+  UNUSED_VARS(curve_sse2_fn);
+#endif
+  for (; i < distances.size(); i++) {
+    const float distance = distances[i];
+    if (distance >= brush_radius) {
+      factors[i] = 0.0f;
+      continue;
+    }
+    factors[i] *= curve_fn(1.0f - distance * radius_rcp);
+  }
+}
+
+#if BLI_HAVE_SSE2
+#  define CURVE_SSE2_FN(expr) [](const __m128 factor) { return expr; }
+#else
+#  define CURVE_SSE2_FN(expr) [](const float /*factor*/) { return 0.0f; }
+#endif
+
 void BKE_brush_calc_curve_factors(const eBrushCurvePreset preset,
                                   const CurveMapping *cumap,
                                   const blender::Span<float> distances,
@@ -1496,9 +1541,9 @@ void BKE_brush_calc_curve_factors(const eBrushCurvePreset preset,
 {
   BLI_assert(factors.size() == distances.size());
 
-  const float radius_rcp = blender::math::rcp(brush_radius);
   switch (preset) {
     case BRUSH_CURVE_CUSTOM: {
+      const float radius_rcp = blender::math::rcp(brush_radius);
       for (const int i : distances.index_range()) {
         const float distance = distances[i];
         if (distance >= brush_radius) {
@@ -1510,107 +1555,98 @@ void BKE_brush_calc_curve_factors(const eBrushCurvePreset preset,
       break;
     }
     case BRUSH_CURVE_SHARP: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= factor * factor;
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) { return factor * factor; },
+          CURVE_SSE2_FN(_mm_mul_ps(factor, factor)));
       break;
     }
     case BRUSH_CURVE_SMOOTH: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= 3.0f * factor * factor - 2.0f * factor * factor * factor;
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) {
+            return 3.0f * factor * factor - 2.0f * factor * factor * factor;
+          },
+          CURVE_SSE2_FN(_mm_sub_ps(
+              _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(3.0f), factor), factor),
+              _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.0f), factor), factor), factor))));
       break;
     }
     case BRUSH_CURVE_SMOOTHER: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= pow3f(factor) * (factor * (factor * 6.0f - 15.0f) + 10.0f);
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) {
+            return pow3f(factor) * (factor * (factor * 6.0f - 15.0f) + 10.0f);
+          },
+          CURVE_SSE2_FN(_mm_mul_ps(
+              _mm_mul_ps(_mm_mul_ps(factor, factor), factor),
+              _mm_add_ps(_mm_mul_ps(factor,
+                                    _mm_sub_ps(_mm_mul_ps(factor, _mm_set1_ps(6.0f)),
+                                               _mm_set1_ps(15.0f))),
+                         _mm_set1_ps(10.0f)))));
       break;
     }
     case BRUSH_CURVE_ROOT: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= sqrtf(factor);
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) { return sqrtf(factor); },
+          CURVE_SSE2_FN(_mm_sqrt_ps(factor)));
       break;
     }
     case BRUSH_CURVE_LIN: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= factor;
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) { return factor; },
+          CURVE_SSE2_FN(factor));
       break;
     }
     case BRUSH_CURVE_CONSTANT: {
       break;
     }
     case BRUSH_CURVE_SPHERE: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= sqrtf(2 * factor - factor * factor);
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) { return sqrtf(2 * factor - factor * factor); },
+          CURVE_SSE2_FN(_mm_sqrt_ps(
+              _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.0f), factor), _mm_mul_ps(factor, factor)))));
       break;
     }
     case BRUSH_CURVE_POW4: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= factor * factor * factor * factor;
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) { return factor * factor * factor * factor; },
+          CURVE_SSE2_FN(
+              _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(factor, factor), factor), factor)));
       break;
     }
     case BRUSH_CURVE_INVSQUARE: {
-      for (const int i : distances.index_range()) {
-        const float distance = distances[i];
-        if (distance >= brush_radius) {
-          factors[i] = 0.0f;
-          continue;
-        }
-        const float factor = 1.0f - distance * radius_rcp;
-        factors[i] *= factor * (2.0f - factor);
-      }
+      calc_curve_factors(
+          distances,
+          brush_radius,
+          factors,
+          [](const float factor) { return factor * (2.0f - factor); },
+          CURVE_SSE2_FN(_mm_mul_ps(factor, _mm_sub_ps(_mm_set1_ps(2.0f), factor))));
       break;
     }
   }
 }
 
+#undef CURVE_SSE2_FN
+
 float BKE_brush_curve_strength(const eBrushCurvePreset preset,
                                const CurveMapping *cumap,
                                const float distance,
@@ -999,8 +999,9 @@ bool BKE_image_render_write_exr(ReportList *reports,
   BLI_file_ensure_parent_dir_exists(filepath);
 
   int compress = (imf ? imf->exr_codec : 0);
+  const bool multipart = multi_layer && imf && (imf->flag & R_IMF_FLAG_EXR_MULTIPART);
   bool success = IMB_exr_begin_write(
-      exrhandle, filepath, rr->rectx, rr->recty, compress, rr->stamp_data);
+      exrhandle, filepath, rr->rectx, rr->recty, compress, rr->stamp_data, multipart);
   if (success) {
     IMB_exr_write_channels(exrhandle);
   }
@@ -138,7 +138,8 @@ static void mesh_copy_data(Main *bmain,
 
   /* Share various derived caches between the source and destination mesh for improved performance
    * when the source is persistent and edits to the destination mesh don't affect the caches.
-   * Caches will be "un-shared" as necessary later on. */
+   * Caches will be "un-shared" as necessary later on. The topology maps aren't copied, since the
+   * copy shares the topology arrays and gets the maps from #mesh_ensure_topology_maps_linked. */
   mesh_dst->runtime->bounds_cache = mesh_src->runtime->bounds_cache;
   mesh_dst->runtime->vert_normals_cache = mesh_src->runtime->vert_normals_cache;
   mesh_dst->runtime->face_normals_cache = mesh_src->runtime->face_normals_cache;
@@ -148,10 +149,6 @@ static void mesh_copy_data(Main *bmain,
   mesh_dst->runtime->loose_edges_cache = mesh_src->runtime->loose_edges_cache;
   mesh_dst->runtime->corner_tris_cache = mesh_src->runtime->corner_tris_cache;
   mesh_dst->runtime->corner_tri_faces_cache = mesh_src->runtime->corner_tri_faces_cache;
-  mesh_dst->runtime->vert_to_face_offset_cache = mesh_src->runtime->vert_to_face_offset_cache;
-  mesh_dst->runtime->vert_to_face_map_cache = mesh_src->runtime->vert_to_face_map_cache;
-  mesh_dst->runtime->vert_to_corner_map_cache = mesh_src->runtime->vert_to_corner_map_cache;
-  mesh_dst->runtime->corner_to_face_map_cache = mesh_src->runtime->corner_to_face_map_cache;
   if (mesh_src->runtime->bake_materials) {
     mesh_dst->runtime->bake_materials = std::make_unique<blender::bke::bake::BakeMaterialsList>(
         *mesh_src->runtime->bake_materials);
@@ -150,7 +150,7 @@ void normals_calc_faces(const Span<float3> positions,
   BLI_assert(faces.size() == face_normals.size());
   threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
     for (const int i : range) {
-      face_normals[i] = normal_calc_ngon(positions, corner_verts.slice(faces[i]));
+      face_normals[i] = face_normal_calc(positions, corner_verts.slice(faces[i]));
     }
   });
 }
@@ -0,0 +1,126 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_offset_indices.hh"
+#include "BLI_rand.hh"
+#include "BLI_task.hh"
+
+#include "BKE_mesh.hh"
+
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::bke::mesh::tests {
+
+/* Newell's method for any face size, the reference for the fast paths of common face sizes. */
+static float3 newell_normal(const Span<float3> positions, const Span<int> face_verts)
+{
+  float3 normal(0.0f);
+  const float *v_prev = positions[face_verts.last()];
+  for (const int vert : face_verts) {
+    add_newell_cross_v3_v3v3(normal, v_prev, positions[vert]);
+    v_prev = positions[vert];
+  }
+  if (normalize_v3(normal) == 0.0f) {
+    normal.z = 1.0f;
+  }
+  return normal;
+}
+
+TEST(mesh_normals, FaceNormalsMatchNewell)
+{
+  const int faces_num = 1000;
+  RandomNumberGenerator rng(0);
+
+  Array<int> face_offsets(faces_num + 1);
+  for (const int i : IndexRange(faces_num)) {
+    /* Mostly triangles and quads, like most meshes, but also some n-gons. */
+    face_offsets[i] = 3 + i % 4;
+  }
+  const OffsetIndices faces = offset_indices::accumulate_counts_to_offsets(face_offsets);
+
+  Array<float3> positions(faces.total_size());
+  for (float3 &position : positions) {
+    position = float3(rng.get_float(), rng.get_float(), rng.get_float()) * 2.0f - 1.0f;
+  }
+  Array<int> corner_verts(faces.total_size());
+  for (const int i : corner_verts.index_range()) {
+    corner_verts[i] = (i * 7) % positions.size();
+  }
+  /* Degenerate triangle and quad. */
+  positions[corner_verts[faces[0][1]]] = positions[corner_verts[faces[0][0]]];
+  positions[corner_verts[faces[0][2]]] = positions[corner_verts[faces[0][0]]];
+  for (const int corner : faces[1]) {
+    positions[corner_verts[corner]] = float3(0.5f);
+  }
+
+  Array<float3> face_normals(faces_num);
+  normals_calc_faces(positions, faces, corner_verts, face_normals);
+
+  for (const int i : faces.index_range()) {
+    const float3 expected = newell_normal(positions, corner_verts.as_span().slice(faces[i]));
+    EXPECT_V3_NEAR(face_normals[i], expected, 1e-4f);
+  }
+  EXPECT_EQ(face_normals[0], float3(0.0f, 0.0f, 1.0f));
+  EXPECT_EQ(face_normals[1], float3(0.0f, 0.0f, 1.0f));
+}
+
+#if DO_PERF_TESTS
+
+TEST(mesh_normals, FaceNormals_Performance)
+{
+  /* A grid of about 25 million corners. */
+  const int size = 2500;
+  const int verts_x = size + 1;
+  Array<float3> positions(verts_x * verts_x);
+  for (const int y : IndexRange(verts_x)) {
+    for (const int x : IndexRange(verts_x)) {
+      positions[y * verts_x + x] = float3(x, y, math::sin(x * 0.1f) * math::cos(y * 0.1f));
+    }
+  }
+  Array<int> face_offsets(size * size + 1);
+  Array<int> corner_verts(size * size * 4);
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const int face = y * size + x;
+      face_offsets[face] = face * 4;
+      corner_verts[face * 4 + 0] = y * verts_x + x;
+      corner_verts[face * 4 + 1] = y * verts_x + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * verts_x + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * verts_x + x;
+    }
+  }
+  face_offsets.last() = corner_verts.size();
+  const OffsetIndices<int> faces(face_offsets);
+
+  Array<float3> expected(faces.size());
+  {
+    SCOPED_TIMER("newell");
+    threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+      for (const int i : range) {
+        expected[i] = newell_normal(positions, corner_verts.as_span().slice(faces[i]));
+      }
+    });
+  }
+  Array<float3> face_normals(faces.size());
+  {
+    SCOPED_TIMER("normals_calc_faces");
+    normals_calc_faces(positions, faces, corner_verts, face_normals);
+  }
+  for (const int i : faces.index_range()) {
+    EXPECT_V3_NEAR(face_normals[i], expected[i], 1e-5f);
+  }
+}
+
+#endif
+
+}  // namespace blender::bke::mesh::tests
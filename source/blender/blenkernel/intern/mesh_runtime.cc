@@ -6,10 +6,15 @@
  * \ingroup bke
  */
 
+#include <mutex>
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_array_utils.hh"
+#include "BLI_hash.hh"
+#include "BLI_map.hh"
 #include "BLI_math_geom.h"
+#include "BLI_struct_equality_utils.hh"
 #include "BLI_task.hh"
 
 #include "BKE_bake_data_block_id.hh"
@@ -27,6 +32,168 @@ using blender::float3;
 using blender::MutableSpan;
 using blender::Span;
 
+/* -------------------------------------------------------------------- */
+/** \name Shared Topology Maps
+ *
+ * The vertex to face/corner maps and the corner to face map only depend on the face offsets and
+ * the corner vertices. Copying a mesh shares the caches already, but meshes often share these
+ * arrays without being copies of each other, e.g. when a modifier builds a new mesh from the
+ * input's topology or when baked geometry is read for every frame. Storing the caches together
+ * with the implicitly shared arrays lets all of these meshes build the maps only once.
+ * \{ */
+
+namespace blender::bke {
+
+struct TopologyMapsKey {
+  const ImplicitSharingInfo *face_offsets;
+  const ImplicitSharingInfo *corner_verts;
+  int verts_num;
+
+  uint64_t hash() const
+  {
+    return get_default_hash(face_offsets, corner_verts, verts_num);
+  }
+
+  BLI_STRUCT_EQUALITY_OPERATORS_3(TopologyMapsKey, face_offsets, corner_verts, verts_num)
+};
+
+/**
+ * The caches shared by the linked meshes. They own it, so it is freed together with the last
+ * linked mesh or when the last one's topology changes. The weak users of the sharing info make
+ * sure the key's pointers aren't reused by other arrays while it exists.
+ */
+struct TopologyMaps {
+  TopologyMapsKey key;
+  SharedCache<Array<int>> vert_to_face_offset_cache;
+  SharedCache<Array<int>> vert_to_face_map_cache;
+  SharedCache<Array<int>> vert_to_corner_map_cache;
+  SharedCache<Array<int>> corner_to_face_map_cache;
+
+  TopologyMaps(const TopologyMapsKey &key) : key(key)
+  {
+    key.face_offsets->add_weak_user();
+    key.corner_verts->add_weak_user();
+  }
+
+  ~TopologyMaps();
+};
+
+/**
+ * Finds the maps of the linked meshes by their topology arrays. The maps aren't owned by the
+ * registry, entries are removed when the maps are freed.
+ */
+class TopologyMapsRegistry {
+  std::mutex mutex_;
+  Map<TopologyMapsKey, std::weak_ptr<TopologyMaps>> maps_;
+
+ public:
+  std::shared_ptr<TopologyMaps> lookup_or_add(const TopologyMapsKey &key)
+  {
+    std::lock_guard lock{mutex_};
+    std::weak_ptr<TopologyMaps> &weak_maps = maps_.lookup_or_add_default(key);
+    if (std::shared_ptr<TopologyMaps> maps = weak_maps.lock()) {
+      return maps;
+    }
+    std::shared_ptr<TopologyMaps> maps = std::make_shared<TopologyMaps>(key);
+    weak_maps = maps;
+    return maps;
+  }
+
+  /** Don't share the maps with meshes linked later, they may have been built from old data. */
+  void remove(const TopologyMaps &maps)
+  {
+    std::lock_guard lock{mutex_};
+    const std::weak_ptr<TopologyMaps> *weak_maps = maps_.lookup_ptr(maps.key);
+    if (weak_maps && weak_maps->lock().get() == &maps) {
+      maps_.remove(maps.key);
+    }
+  }
+
+  void remove_expired(const TopologyMapsKey &key)
+  {
+    std::lock_guard lock{mutex_};
+    const std::weak_ptr<TopologyMaps> *weak_maps = maps_.lookup_ptr(key);
+    if (weak_maps && weak_maps->expired()) {
+      maps_.remove(key);
+    }
+  }
+};
+
+static TopologyMapsRegistry &topology_maps_registry()
+{
+  static TopologyMapsRegistry registry;
+  return registry;
+}
+
+TopologyMaps::~TopologyMaps()
+{
+  /* The entry may have been replaced by the maps of new arrays at the same address already. */
+  topology_maps_registry().remove_expired(key);
+  key.face_offsets->remove_weak_user_and_delete_if_last();
+  key.corner_verts->remove_weak_user_and_delete_if_last();
+}
+
+static void link_cache(SharedCache<Array<int>> &mesh_cache, SharedCache<Array<int>> &shared_cache)
+{
+  if (mesh_cache.is_cached() && !shared_cache.is_cached()) {
+    shared_cache = mesh_cache;
+  }
+  else {
+    mesh_cache = shared_cache;
+  }
+}
+
+static const ImplicitSharingInfo *corner_verts_sharing_info(const Mesh &mesh)
+{
+  const int layer_index = CustomData_get_named_layer_index(
+      &mesh.corner_data, CD_PROP_INT32, ".corner_vert");
+  return layer_index == -1 ? nullptr : mesh.corner_data.layers[layer_index].sharing_info;
+}
+
+void mesh_ensure_topology_maps_linked(const Mesh &mesh)
+{
+  mesh.runtime->topology_maps_link_mutex.ensure([&]() {
+    MeshRuntime &runtime = *mesh.runtime;
+    const ImplicitSharingInfo *face_offsets = runtime.face_offsets_sharing_info;
+    const ImplicitSharingInfo *corner_verts = corner_verts_sharing_info(mesh);
+    if (!face_offsets || !corner_verts) {
+      return;
+    }
+    runtime.topology_maps = topology_maps_registry().lookup_or_add(
+        {face_offsets, corner_verts, mesh.verts_num});
+    TopologyMaps &maps = *runtime.topology_maps;
+    link_cache(runtime.vert_to_face_offset_cache, maps.vert_to_face_offset_cache);
+    link_cache(runtime.vert_to_face_map_cache, maps.vert_to_face_map_cache);
+    link_cache(runtime.vert_to_corner_map_cache, maps.vert_to_corner_map_cache);
+    link_cache(runtime.corner_to_face_map_cache, maps.corner_to_face_map_cache);
+  });
+}
+
+/**
+ * Unlink the mesh after its topology changed. When it is the only user of the arrays it linked,
+ * they may have been modified in place, possibly while the maps were built from them. Other
+ * meshes can't use the same arrays then, but removing the registry entry makes sure that meshes
+ * getting them later don't find the outdated maps.
+ */
+static void mesh_unlink_topology_maps(Mesh &mesh)
+{
+  MeshRuntime &runtime = *mesh.runtime;
+  if (const std::shared_ptr<TopologyMaps> maps = std::move(runtime.topology_maps)) {
+    const TopologyMapsKey &key = maps->key;
+    if (runtime.face_offsets_sharing_info == key.face_offsets &&
+        corner_verts_sharing_info(mesh) == key.corner_verts &&
+        (key.face_offsets->is_mutable() || key.corner_verts->is_mutable()))
+    {
+      topology_maps_registry().remove(*maps);
+    }
+  }
+  runtime.topology_maps_link_mutex.tag_dirty();
+}
+
+}  // namespace blender::bke
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Mesh Runtime Struct Utils
  * \{ */
@@ -113,6 +280,7 @@ static void try_tag_verts_no_face_none(const Mesh &mesh)
 blender::Span<int> Mesh::corner_to_face_map() const
 {
   using namespace blender;
+  bke::mesh_ensure_topology_maps_linked(*this);
   this->runtime->corner_to_face_map_cache.ensure([&](Array<int> &r_data) {
     const OffsetIndices faces = this->faces();
     r_data = bke::mesh::build_corner_to_face_map(faces);
@@ -123,6 +291,7 @@ blender::Span<int> Mesh::corner_to_face_map() const
 blender::OffsetIndices<int> Mesh::vert_to_face_map_offsets() const
 {
   using namespace blender;
+  bke::mesh_ensure_topology_maps_linked(*this);
   this->runtime->vert_to_face_offset_cache.ensure([&](Array<int> &r_data) {
     r_data = Array<int>(this->verts_num + 1, 0);
     offset_indices::build_reverse_offsets(this->corner_verts(), r_data);
@@ -319,6 +488,7 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
   mesh->runtime->vert_to_face_map_cache.tag_dirty();
   mesh->runtime->vert_to_corner_map_cache.tag_dirty();
   mesh->runtime->corner_to_face_map_cache.tag_dirty();
+  blender::bke::mesh_unlink_topology_maps(*mesh);
   mesh->runtime->vert_normals_cache.tag_dirty();
   mesh->runtime->face_normals_cache.tag_dirty();
   mesh->runtime->corner_normals_cache.tag_dirty();
@@ -342,6 +512,7 @@ void Mesh::tag_edges_split()
   this->runtime->vert_to_face_offset_cache.tag_dirty();
   this->runtime->vert_to_face_map_cache.tag_dirty();
   this->runtime->vert_to_corner_map_cache.tag_dirty();
+  blender::bke::mesh_unlink_topology_maps(*this);
   if (this->runtime->loose_edges_cache.is_cached() &&
       this->runtime->loose_edges_cache.data().count != 0)
   {
@@ -378,6 +549,7 @@ void Mesh::tag_face_winding_changed()
   this->runtime->face_normals_cache.tag_dirty();
   this->runtime->corner_normals_cache.tag_dirty();
   this->runtime->vert_to_corner_map_cache.tag_dirty();
+  blender::bke::mesh_unlink_topology_maps(*this);
   this->runtime->shrinkwrap_boundary_cache.tag_dirty();
 }
 
@@ -420,6 +592,7 @@ void Mesh::tag_topology_changed()
 
 void (*BKE_mesh_batch_cache_dirty_tag_cb)(Mesh *mesh, eMeshBatchDirtyMode mode) = nullptr;
 void (*BKE_mesh_batch_cache_free_cb)(void *batch_cache) = nullptr;
+void *(*BKE_mesh_batch_cache_detach_cb)(Mesh *mesh) = nullptr;
 
 void BKE_mesh_batch_cache_dirty_tag(Mesh *mesh, eMeshBatchDirtyMode mode)
 {
@@ -431,6 +604,13 @@ void BKE_mesh_batch_cache_free(void *batch_cache)
 {
   BKE_mesh_batch_cache_free_cb(batch_cache);
 }
+void *BKE_mesh_batch_cache_detach(Mesh *mesh)
+{
+  if (mesh->runtime->batch_cache) {
+    return BKE_mesh_batch_cache_detach_cb(mesh);
+  }
+  return nullptr;
+}
 
 /** \} */
 
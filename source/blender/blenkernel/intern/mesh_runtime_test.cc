@@ -0,0 +1,107 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "CLG_log.h"
+
+#include "BKE_customdata.hh"
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+namespace blender::bke::tests {
+
+class MeshRuntimeTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/* Two quads sharing the edge between vertices 1 and 4. */
+static Mesh *create_two_quads()
+{
+  Mesh *mesh = BKE_mesh_new_nomain(6, 0, 2, 8);
+  mesh->face_offsets_for_write().copy_from({0, 4, 8});
+  mesh->corner_verts_for_write().copy_from({0, 1, 4, 3, 1, 2, 5, 4});
+  return mesh;
+}
+
+/* A new mesh using the face offsets and corner vertices of the given mesh without copying it. */
+static Mesh *create_mesh_sharing_topology(const Mesh &src)
+{
+  Mesh *mesh = mesh_new_no_attributes(src.verts_num, 0, 0, src.corners_num);
+  mesh->faces_num = src.faces_num;
+  implicit_sharing::copy_shared_pointer(src.face_offset_indices,
+                                        src.runtime->face_offsets_sharing_info,
+                                        &mesh->face_offset_indices,
+                                        &mesh->runtime->face_offsets_sharing_info);
+  const int layer_index = CustomData_get_named_layer_index(
+      &src.corner_data, CD_PROP_INT32, ".corner_vert");
+  const CustomDataLayer &layer = src.corner_data.layers[layer_index];
+  CustomData_add_layer_named_with_data(&mesh->corner_data,
+                                       CD_PROP_INT32,
+                                       layer.data,
+                                       src.corners_num,
+                                       ".corner_vert",
+                                       layer.sharing_info);
+  return mesh;
+}
+
+TEST_F(MeshRuntimeTest, TopologyMapsSharedBetweenMeshes)
+{
+  Mesh *mesh_a = create_two_quads();
+  Mesh *mesh_b = create_mesh_sharing_topology(*mesh_a);
+  Mesh *mesh_c = create_two_quads();
+
+  EXPECT_EQ(mesh_a->vert_to_face_map()[1], Span<int>({0, 1}));
+  EXPECT_EQ(mesh_b->vert_to_face_map()[1], Span<int>({0, 1}));
+  EXPECT_EQ(mesh_a->vert_to_face_map().data.data(), mesh_b->vert_to_face_map().data.data());
+  EXPECT_EQ(mesh_a->corner_to_face_map().data(), mesh_b->corner_to_face_map().data());
+
+  /* Equal topology in other arrays doesn't share the maps. */
+  EXPECT_EQ(mesh_c->vert_to_face_map()[1], Span<int>({0, 1}));
+  EXPECT_NE(mesh_a->vert_to_face_map().data.data(), mesh_c->vert_to_face_map().data.data());
+
+  BKE_id_free(nullptr, mesh_a);
+  BKE_id_free(nullptr, mesh_b);
+  BKE_id_free(nullptr, mesh_c);
+}
+
+TEST_F(MeshRuntimeTest, TopologyMapsInvalidatedAfterTopologyChange)
+{
+  Mesh *mesh_a = create_two_quads();
+
+  /* Build the maps while the arrays are being modified in place. */
+  MutableSpan<int> corner_verts = mesh_a->corner_verts_for_write();
+  EXPECT_EQ(mesh_a->vert_to_face_map()[3], Span<int>({0}));
+  corner_verts[4] = 3;
+  mesh_a->tag_topology_changed();
+
+  /* Meshes using the modified arrays don't get the outdated maps. */
+  Mesh *mesh_b = create_mesh_sharing_topology(*mesh_a);
+  EXPECT_EQ(mesh_b->vert_to_face_map()[1], Span<int>({0}));
+  EXPECT_EQ(mesh_b->vert_to_face_map()[3], Span<int>({0, 1}));
+  EXPECT_EQ(mesh_a->vert_to_face_map()[3], Span<int>({0, 1}));
+  EXPECT_EQ(mesh_a->vert_to_face_map().data.data(), mesh_b->vert_to_face_map().data.data());
+
+  /* Modifying shared arrays copies them, the other mesh keeps its maps. */
+  mesh_b->corner_verts_for_write()[4] = 1;
+  mesh_b->tag_topology_changed();
+  EXPECT_EQ(mesh_b->vert_to_face_map()[3], Span<int>({0}));
+  EXPECT_EQ(mesh_a->vert_to_face_map()[3], Span<int>({0, 1}));
+  EXPECT_NE(mesh_a->vert_to_face_map().data.data(), mesh_b->vert_to_face_map().data.data());
+
+  BKE_id_free(nullptr, mesh_a);
+  BKE_id_free(nullptr, mesh_b);
+}
+
+}  // namespace blender::bke::tests
@@ -14,6 +14,7 @@
 
 #include "BLI_math_matrix.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.hh"
 
 #include "BKE_mesh.hh"
 #include "BKE_multires.hh"
@@ -70,60 +71,64 @@ void multires_reshape_apply_base_refit_base_mesh(MultiresReshapeContext *reshape
     copy_v3_v3(origco[i], base_positions[i]);
   }
 
-  for (int i = 0; i < base_mesh->verts_num; i++) {
-    float avg_no[3] = {0, 0, 0}, center[3] = {0, 0, 0}, push[3];
-
-    /* Don't adjust vertices not used by at least one face. */
-    if (!vert_to_face_map[i].size()) {
-      continue;
-    }
-
-    /* Find center. */
-    int tot = 0;
-    for (const int face : vert_to_face_map[i]) {
-      /* This double counts, not sure if that's bad or good. */
-      for (const int corner : reshape_context->base_faces[face]) {
-        const int vndx = reshape_context->base_corner_verts[corner];
-        if (vndx != i) {
-          add_v3_v3(center, origco[vndx]);
-          tot++;
+  /* Vertices are independent, only the original coordinates of their neighbors are read. */
+  blender::threading::parallel_for(
+      blender::IndexRange(base_mesh->verts_num), 256, [&](const blender::IndexRange range) {
+        for (const int i : range) {
+          float avg_no[3] = {0, 0, 0}, center[3] = {0, 0, 0}, push[3];
+
+          /* Don't adjust vertices not used by at least one face. */
+          if (!vert_to_face_map[i].size()) {
+            continue;
+          }
+
+          /* Find center. */
+          int tot = 0;
+          for (const int face : vert_to_face_map[i]) {
+            /* This double counts, not sure if that's bad or good. */
+            for (const int corner : reshape_context->base_faces[face]) {
+              const int vndx = reshape_context->base_corner_verts[corner];
+              if (vndx != i) {
+                add_v3_v3(center, origco[vndx]);
+                tot++;
+              }
+            }
+          }
+          mul_v3_fl(center, 1.0f / tot);
+
+          /* Find normal. */
+          for (int j = 0; j < vert_to_face_map[i].size(); j++) {
+            const blender::IndexRange face = reshape_context->base_faces[vert_to_face_map[i][j]];
+
+            /* Set up face, loops, and coords in order to call #bke::mesh::face_normal_calc(). */
+            blender::Array<int> face_verts(face.size());
+            blender::Array<blender::float3> fake_co(face.size());
+
+            for (int k = 0; k < face.size(); k++) {
+              const int vndx = reshape_context->base_corner_verts[face[k]];
+
+              face_verts[k] = k;
+
+              if (vndx == i) {
+                copy_v3_v3(fake_co[k], center);
+              }
+              else {
+                copy_v3_v3(fake_co[k], origco[vndx]);
+              }
+            }
+
+            const blender::float3 no = blender::bke::mesh::face_normal_calc(fake_co, face_verts);
+            add_v3_v3(avg_no, no);
+          }
+          normalize_v3(avg_no);
+
+          /* Push vertex away from the plane. */
+          const float dist = v3_dist_from_plane(base_positions[i], center, avg_no);
+          copy_v3_v3(push, avg_no);
+          mul_v3_fl(push, dist);
+          add_v3_v3(base_positions[i], push);
         }
-      }
-    }
-    mul_v3_fl(center, 1.0f / tot);
-
-    /* Find normal. */
-    for (int j = 0; j < vert_to_face_map[i].size(); j++) {
-      const blender::IndexRange face = reshape_context->base_faces[vert_to_face_map[i][j]];
-
-      /* Set up face, loops, and coords in order to call #bke::mesh::face_normal_calc(). */
-      blender::Array<int> face_verts(face.size());
-      blender::Array<blender::float3> fake_co(face.size());
-
-      for (int k = 0; k < face.size(); k++) {
-        const int vndx = reshape_context->base_corner_verts[face[k]];
-
-        face_verts[k] = k;
-
-        if (vndx == i) {
-          copy_v3_v3(fake_co[k], center);
-        }
-        else {
-          copy_v3_v3(fake_co[k], origco[vndx]);
-        }
-      }
-
-      const blender::float3 no = blender::bke::mesh::face_normal_calc(fake_co, face_verts);
-      add_v3_v3(avg_no, no);
-    }
-    normalize_v3(avg_no);
-
-    /* Push vertex away from the plane. */
-    const float dist = v3_dist_from_plane(base_positions[i], center, avg_no);
-    copy_v3_v3(push, avg_no);
-    mul_v3_fl(push, dist);
-    add_v3_v3(base_positions[i], push);
-  }
+      });
 
   MEM_freeN(origco);
 
@@ -149,6 +149,8 @@ struct MultiresReshapeSmoothContext {
    * used by Subdivide operation, but the idea is exactly the same as propagation in the sculpt
    * mode. */
   SurfaceGrid *base_surface_grids;
+  /* Points of all base surface grids, allocated at once. */
+  SurfacePoint *base_surface_points_storage;
 
   /* Defines how displacement is interpolated on the higher levels (for example, whether
    * displacement is smoothed in Catmull-Clark mode or interpolated linearly preserving sharp edges
@@ -254,13 +256,15 @@ static void base_surface_grids_allocate(MultiresReshapeSmoothContext *reshape_sm
 
   SurfaceGrid *surface_grid = static_cast<SurfaceGrid *>(
       MEM_malloc_arrayN(num_grids, sizeof(SurfaceGrid), __func__));
+  SurfacePoint *points_storage = static_cast<SurfacePoint *>(
+      MEM_calloc_arrayN(size_t(num_grids) * grid_area, sizeof(SurfacePoint), __func__));
 
   for (int grid_index = 0; grid_index < num_grids; ++grid_index) {
-    surface_grid[grid_index].points = static_cast<SurfacePoint *>(
-        MEM_calloc_arrayN(grid_area, sizeof(SurfacePoint), __func__));
+    surface_grid[grid_index].points = &points_storage[size_t(grid_area) * grid_index];
   }
 
   reshape_smooth_context->base_surface_grids = surface_grid;
+  reshape_smooth_context->base_surface_points_storage = points_storage;
 }
 
 static void base_surface_grids_free(MultiresReshapeSmoothContext *reshape_smooth_context)
@@ -269,12 +273,7 @@ static void base_surface_grids_free(MultiresReshapeSmoothContext *reshape_smooth
     return;
   }
 
-  const MultiresReshapeContext *reshape_context = reshape_smooth_context->reshape_context;
-
-  const int num_grids = reshape_context->num_grids;
-  for (int grid_index = 0; grid_index < num_grids; ++grid_index) {
-    MEM_freeN(reshape_smooth_context->base_surface_grids[grid_index].points);
-  }
+  MEM_freeN(reshape_smooth_context->base_surface_points_storage);
   MEM_freeN(reshape_smooth_context->base_surface_grids);
 }
 
@@ -528,6 +527,7 @@ static void context_init(MultiresReshapeSmoothContext *reshape_smooth_context,
   reshape_smooth_context->loose_base_edges = {};
   reshape_smooth_context->reshape_subdiv = nullptr;
   reshape_smooth_context->base_surface_grids = nullptr;
+  reshape_smooth_context->base_surface_points_storage = nullptr;
 
   reshape_smooth_context->smoothing_type = mode;
 }
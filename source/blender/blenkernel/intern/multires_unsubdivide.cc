@@ -18,6 +18,7 @@
 
 #include "BLI_gsqueue.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.hh"
 
 #include "BKE_customdata.hh"
 #include "BKE_mesh.hh"
@@ -1163,8 +1164,9 @@ void multires_unsubdivide_context_free(MultiresUnsubdivideContext *context)
 }
 
 /**
- * This function allocates new mdisps with the right size to fit the new extracted grids from the
- * base mesh and copies the data to them.
+ * This function creates new mdisps with the right size to fit the new extracted grids from the
+ * base mesh. The extracted grids have the same size, so they are moved to the mdisps instead of
+ * copied, which avoids keeping two copies of the grids of the new top level in memory.
  */
 static void multires_create_grids_in_unsubdivided_base_mesh(MultiresUnsubdivideContext *context,
                                                             Mesh *base_mesh)
@@ -1181,25 +1183,30 @@ static void multires_create_grids_in_unsubdivided_base_mesh(MultiresUnsubdivideC
 
   BLI_assert(base_mesh->corners_num == context->num_grids);
 
-  /* Allocate the MDISPS grids and copy the extracted data from context. */
-  for (int i = 0; i < totloop; i++) {
-    float(*disps)[3] = static_cast<float(*)[3]>(
-        MEM_calloc_arrayN(totdisp, sizeof(float[3]), __func__));
-
-    if (mdisps[i].disps) {
-      MEM_freeN(mdisps[i].disps);
-    }
+  /* Move the extracted grids from context to the MDISPS, allocate grids that weren't extracted. */
+  blender::threading::parallel_for(
+      blender::IndexRange(totloop), 1024, [&](const blender::IndexRange range) {
+        for (const int i : range) {
+          MultiresUnsubdivideGrid &grid = context->base_mesh_grids[i];
+          float(*disps)[3] = grid.grid_co;
+          if (disps) {
+            BLI_assert(grid.grid_size * grid.grid_size == totdisp);
+            grid.grid_co = nullptr;
+          }
+          else {
+            disps = static_cast<float(*)[3]>(
+                MEM_calloc_arrayN(totdisp, sizeof(float[3]), "multires disps"));
+          }
 
-    for (int j = 0; j < totdisp; j++) {
-      if (context->base_mesh_grids[i].grid_co) {
-        copy_v3_v3(disps[j], context->base_mesh_grids[i].grid_co[j]);
-      }
-    }
+          if (mdisps[i].disps) {
+            MEM_freeN(mdisps[i].disps);
+          }
 
-    mdisps[i].disps = disps;
-    mdisps[i].totdisp = totdisp;
-    mdisps[i].level = context->num_total_levels;
-  }
+          mdisps[i].disps = disps;
+          mdisps[i].totdisp = totdisp;
+          mdisps[i].level = context->num_total_levels;
+        }
+      });
 }
 
 int multiresModifier_rebuild_subdiv(Depsgraph *depsgraph,
@@ -290,6 +290,14 @@ static void ntree_free_data(ID *id)
     }
   }
 
+  /* Results cached by the compositor are freed along with the original tree. Localized and
+   * evaluated copies are freed after every execution and depsgraph update, so they are skipped. */
+  if (ntree->type == NTREE_COMPOSIT &&
+      (ntree->id.tag & (LIB_TAG_LOCALIZED | LIB_TAG_COPIED_ON_EVAL)) == 0)
+  {
+    ntreeCompositClearCaches();
+  }
+
   /* XXX not nice, but needed to free localized node groups properly */
   free_localized_node_groups(ntree);
 
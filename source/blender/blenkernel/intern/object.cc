@@ -1651,6 +1651,10 @@ void BKE_object_free_derived_caches(Object *ob)
     BKE_id_free(nullptr, mesh_deform_eval);
     ob->runtime->mesh_deform_eval = nullptr;
   }
+  if (ob->runtime->mesh_batch_cache_prev != nullptr) {
+    BKE_mesh_batch_cache_free(ob->runtime->mesh_batch_cache_prev);
+    ob->runtime->mesh_batch_cache_prev = nullptr;
+  }
 
   /* Restore initial pointer for copy-on-evaluation data-blocks, object->data
    * might be pointing to an evaluated data-block data was just freed above. */
@@ -4881,6 +4885,7 @@ void BKE_object_runtime_reset_on_copy(Object *object, const int /*flag*/)
   runtime->data_eval = nullptr;
   runtime->gpd_eval = nullptr;
   runtime->mesh_deform_eval = nullptr;
+  runtime->mesh_batch_cache_prev = nullptr;
   runtime->curve_cache = nullptr;
   runtime->object_as_temp_mesh = nullptr;
   runtime->pose_backup = nullptr;
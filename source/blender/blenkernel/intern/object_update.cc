@@ -45,9 +45,36 @@
 
 namespace deg = blender::deg;
 
+/**
+ * Detach the draw cache of the evaluated mesh before it is freed. Often only the positions change
+ * between evaluations (e.g. during armature animation playback), in which case the draw code can
+ * keep most of the buffers.
+ */
+static void *object_eval_detach_mesh_batch_cache(Object *ob_eval)
+{
+  if (ob_eval->type != OB_MESH || !ob_eval->runtime->is_data_eval_owned) {
+    return nullptr;
+  }
+  ID *data_eval = ob_eval->runtime->data_eval;
+  if (data_eval == nullptr || GS(data_eval->name) != ID_ME) {
+    return nullptr;
+  }
+  Mesh *mesh_eval = reinterpret_cast<Mesh *>(data_eval);
+  if (mesh_eval->runtime->edit_mesh) {
+    return nullptr;
+  }
+  return BKE_mesh_batch_cache_detach(mesh_eval);
+}
+
 void BKE_object_eval_reset(Object *ob_eval)
 {
+  void *mesh_batch_cache_prev = object_eval_detach_mesh_batch_cache(ob_eval);
+  if (mesh_batch_cache_prev == nullptr) {
+    /* The evaluated mesh wasn't drawn since the cache was detached, keep the older one. */
+    mesh_batch_cache_prev = std::exchange(ob_eval->runtime->mesh_batch_cache_prev, nullptr);
+  }
   BKE_object_free_derived_caches(ob_eval);
+  ob_eval->runtime->mesh_batch_cache_prev = mesh_batch_cache_prev;
 }
 
 void BKE_object_eval_local_transform(Depsgraph *depsgraph, Object *ob)
@@ -101,22 +101,23 @@ static int partition_prim_indices(MutableSpan<int> prim_indices,
                                   const Span<Bounds<float3>> prim_bounds,
                                   const Span<int> prim_to_face_map)
 {
+  /* Only use the scratch elements of the partitioned range, so that other ranges can be
+   * partitioned in parallel. */
   for (int i = lo; i < hi; i++) {
-    prim_scratch[i - lo] = prim_indices[i];
+    prim_scratch[i] = prim_indices[i];
   }
 
   int lo2 = lo, hi2 = hi - 1;
-  int i1 = lo, i2 = 0;
+  int i = lo;
 
-  while (i1 < hi) {
-    const int face_i = prim_to_face_map[prim_scratch[i2]];
-    const Bounds<float3> &bounds = prim_bounds[prim_scratch[i2]];
+  while (i < hi) {
+    const int face_i = prim_to_face_map[prim_scratch[i]];
+    const Bounds<float3> &bounds = prim_bounds[prim_scratch[i]];
     const bool side = math::midpoint(bounds.min[axis], bounds.max[axis]) >= mid;
 
-    while (i1 < hi && prim_to_face_map[prim_scratch[i2]] == face_i) {
-      prim_indices[side ? hi2-- : lo2++] = prim_scratch[i2];
-      i1++;
-      i2++;
+    while (i < hi && prim_to_face_map[prim_scratch[i]] == face_i) {
+      prim_indices[side ? hi2-- : lo2++] = prim_scratch[i];
+      i++;
     }
   }
 
@@ -154,81 +155,102 @@ static int partition_indices_material_faces(MutableSpan<int> indices,
   }
 }
 
-/* Add a vertex to the map, with a positive value for unique vertices and
- * a negative value for additional vertices */
-static int map_insert_vert(Map<int, int> &map,
-                           MutableSpan<bool> vert_bitmap,
-                           int *face_verts,
-                           int *uniq_verts,
-                           int vertex)
+/** Lower the integer to the given value if it is larger, from multiple threads. */
+static void atomic_min_int32(int32_t *value, const int32_t other)
 {
-  return map.lookup_or_add_cb(vertex, [&]() {
-    int value;
-    if (!vert_bitmap[vertex]) {
-      vert_bitmap[vertex] = true;
-      value = *uniq_verts;
-      (*uniq_verts)++;
-    }
-    else {
-      value = ~(*face_verts);
-      (*face_verts)++;
+  int32_t current = atomic_load_int32(value);
+  while (other < current) {
+    const int32_t previous = atomic_cas_int32(value, current, other);
+    if (previous == current) {
+      break;
     }
-    return value;
-  });
+    current = previous;
+  }
 }
 
-/* Find vertices used by the faces in this node and update the draw buffers */
-static void build_mesh_leaf_node(const Span<int> corner_verts,
-                                 const Span<int3> corner_tris,
-                                 MutableSpan<bool> vert_bitmap,
-                                 Node &node)
+/**
+ * Find vertices used by the faces in the leaf nodes. Leaves are processed in parallel, so every
+ * vertex is owned by ("unique" to) the leaf with the lowest index that uses it, which doesn't
+ * depend on the order in which the leaves are processed.
+ */
+static void build_mesh_leaf_nodes(const int verts_num,
+                                  const Span<int> corner_verts,
+                                  const Span<int3> corner_tris,
+                                  MutableSpan<Node> nodes)
 {
-  node.unique_verts_num_ = 0;
-  int shared_verts = 0;
-  const Span<int> prim_indices = node.prim_indices_;
-
-  /* reserve size is rough guess */
-  Map<int, int> map;
-  map.reserve(prim_indices.size());
+  Array<int> vert_owners(verts_num, INT_MAX);
 
-  node.face_vert_indices_.reinitialize(prim_indices.size());
-
-  for (const int i : prim_indices.index_range()) {
-    const int3 &tri = corner_tris[prim_indices[i]];
-    for (int j = 0; j < 3; j++) {
-      node.face_vert_indices_[i][j] = map_insert_vert(
-          map, vert_bitmap, &shared_verts, &node.unique_verts_num_, corner_verts[tri[j]]);
-    }
-  }
-
-  node.vert_indices_.reinitialize(node.unique_verts_num_ + shared_verts);
+  /* Gather the vertices of every leaf in the order they are used by its triangles. */
+  threading::parallel_for(nodes.index_range(), 8, [&](const IndexRange range) {
+    VectorSet<int> verts;
+    for (const int i : range) {
+      Node &node = nodes[i];
+      if (!(node.flag_ & PBVH_Leaf)) {
+        continue;
+      }
+      const Span<int> prim_indices = node.prim_indices_;
+
+      verts.clear();
+      /* Reserve size is rough guess. */
+      verts.reserve(prim_indices.size());
+      node.face_vert_indices_.reinitialize(prim_indices.size());
+      for (const int j : prim_indices.index_range()) {
+        const int3 &tri = corner_tris[prim_indices[j]];
+        for (int k = 0; k < 3; k++) {
+          node.face_vert_indices_[j][k] = verts.index_of_or_add(corner_verts[tri[k]]);
+        }
+      }
 
-  /* Build the vertex list, unique verts first */
-  for (const MapItem<int, int> item : map.items()) {
-    int value = item.value;
-    if (value < 0) {
-      value = -value + node.unique_verts_num_ - 1;
+      node.vert_indices_ = verts.as_span();
+      for (const int vert : verts) {
+        atomic_min_int32(&vert_owners[vert], i);
+      }
     }
+  });
 
-    node.vert_indices_[value] = item.key;
-  }
+  /* Move the vertices owned by each leaf to the front, and remap the triangle corners. */
+  threading::parallel_for(nodes.index_range(), 8, [&](const IndexRange range) {
+    Vector<int> new_indices;
+    Vector<int> shared_verts;
+    for (const int i : range) {
+      Node &node = nodes[i];
+      if (!(node.flag_ & PBVH_Leaf)) {
+        continue;
+      }
+      MutableSpan<int> verts = node.vert_indices_;
+
+      /* Unique vertices get a positive new index, shared vertices a negative one. */
+      new_indices.resize(verts.size());
+      shared_verts.clear();
+      int unique_verts_num = 0;
+      for (const int j : verts.index_range()) {
+        const int vert = verts[j];
+        if (vert_owners[vert] == i) {
+          new_indices[j] = unique_verts_num;
+          verts[unique_verts_num] = vert;
+          unique_verts_num++;
+        }
+        else {
+          new_indices[j] = ~int(shared_verts.size());
+          shared_verts.append(vert);
+        }
+      }
+      verts.drop_front(unique_verts_num).copy_from(shared_verts);
+      node.unique_verts_num_ = unique_verts_num;
 
-  for (const int i : prim_indices.index_range()) {
-    for (int j = 0; j < 3; j++) {
-      if (node.face_vert_indices_[i][j] < 0) {
-        node.face_vert_indices_[i][j] = -node.face_vert_indices_[i][j] + node.unique_verts_num_ -
-                                        1;
+      for (int3 &face_verts : node.face_vert_indices_) {
+        for (int k = 0; k < 3; k++) {
+          const int index = new_indices[face_verts[k]];
+          face_verts[k] = index >= 0 ? index : ~index + unique_verts_num;
+        }
       }
     }
-  }
-
-  BKE_pbvh_node_mark_positions_update(&node);
-  BKE_pbvh_node_mark_rebuild_draw(&node);
+  });
 }
 
 /* Return zero if all primitives in the node can be drawn with the
  * same material (including flat/smooth shading), non-zero otherwise */
-static bool leaf_needs_material_split(Tree &pbvh,
+static bool leaf_needs_material_split(const Span<int> prim_indices,
                                       const Span<int> prim_to_face_map,
                                       const Span<int> material_indices,
                                       const Span<bool> sharp_faces,
@@ -239,9 +261,9 @@ static bool leaf_needs_material_split(Tree &pbvh,
     return false;
   }
 
-  const int first = prim_to_face_map[pbvh.prim_indices_[offset]];
+  const int first = prim_to_face_map[prim_indices[offset]];
   for (int i = offset + count - 1; i > offset; i--) {
-    int prim = pbvh.prim_indices_[i];
+    int prim = prim_indices[i];
     if (!face_materials_match(material_indices, sharp_faces, first, prim_to_face_map[prim])) {
       return true;
     }
@@ -250,108 +272,159 @@ static bool leaf_needs_material_split(Tree &pbvh,
   return false;
 }
 
-static void build_nodes_recursive_mesh(Tree &pbvh,
-                                       const Span<int> corner_verts,
-                                       const Span<int3> corner_tris,
-                                       const Span<int> tri_faces,
-                                       const Span<int> material_indices,
-                                       const Span<bool> sharp_faces,
-                                       const int leaf_limit,
-                                       MutableSpan<bool> vert_bitmap,
-                                       const int node_index,
-                                       const Bounds<float3> *cb,
-                                       const Span<Bounds<float3>> prim_bounds,
-                                       const int prim_offset,
-                                       const int prims_num,
-                                       MutableSpan<int> prim_scratch,
-                                       const int depth)
+/**
+ * A range of #Tree::prim_indices_ in the tree, which is built before the nodes themselves so that
+ * independent subtrees can be partitioned in parallel.
+ */
+struct BuildNode {
+  int prim_offset = 0;
+  int prims_num = 0;
+  /** Null for leaf nodes. */
+  std::unique_ptr<BuildNode> children[2];
+};
+
+static void build_nodes_recursive(MutableSpan<int> prim_indices,
+                                  const Span<int> prim_to_face_map,
+                                  const Span<int> material_indices,
+                                  const Span<bool> sharp_faces,
+                                  const int leaf_limit,
+                                  const Bounds<float3> *cb,
+                                  const Span<Bounds<float3>> prim_bounds,
+                                  MutableSpan<int> prim_scratch,
+                                  const int depth,
+                                  BuildNode &node)
 {
+  const int prim_offset = node.prim_offset;
+  const int prims_num = node.prims_num;
   int end;
 
   /* Decide whether this is a leaf or not */
   const bool below_leaf_limit = prims_num <= leaf_limit || depth >= STACK_FIXED_DEPTH - 1;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(
-            pbvh, tri_faces, material_indices, sharp_faces, prim_offset, prims_num))
+            prim_indices, prim_to_face_map, material_indices, sharp_faces, prim_offset, prims_num))
     {
-      Node &node = pbvh.nodes_[node_index];
-      node.flag_ |= PBVH_Leaf;
-      node.prim_indices_ = pbvh.prim_indices_.as_span().slice(prim_offset, prims_num);
-      build_mesh_leaf_node(corner_verts, corner_tris, vert_bitmap, node);
-
       return;
     }
   }
 
-  /* Add two child nodes */
-  pbvh.nodes_[node_index].children_offset_ = pbvh.nodes_.size();
-  pbvh.nodes_.resize(pbvh.nodes_.size() + 2);
-
   Bounds<float3> cb_backing;
   if (!below_leaf_limit) {
     /* Find axis with widest range of primitive centroids */
     if (!cb) {
-      cb_backing = negative_bounds();
-      for (int i = prim_offset + prims_num - 1; i >= prim_offset; i--) {
-        const int prim = pbvh.prim_indices_[i];
-        const float3 center = math::midpoint(prim_bounds[prim].min, prim_bounds[prim].max);
-        math::min_max(center, cb_backing.min, cb_backing.max);
-      }
+      cb_backing = threading::parallel_reduce(
+          IndexRange(prim_offset, prims_num),
+          1024,
+          negative_bounds(),
+          [&](const IndexRange range, const Bounds<float3> &init) {
+            Bounds<float3> current = init;
+            for (const int i : range) {
+              const int prim = prim_indices[i];
+              const float3 center = math::midpoint(prim_bounds[prim].min, prim_bounds[prim].max);
+              math::min_max(center, current.min, current.max);
+            }
+            return current;
+          },
+          [](const Bounds<float3> &a, const Bounds<float3> &b) { return bounds::merge(a, b); });
       cb = &cb_backing;
     }
     const int axis = math::dominant_axis(cb->max - cb->min);
 
     /* Partition primitives along that axis */
-    end = partition_prim_indices(pbvh.prim_indices_,
+    end = partition_prim_indices(prim_indices,
                                  prim_scratch,
                                  prim_offset,
                                  prim_offset + prims_num,
                                  axis,
                                  math::midpoint(cb->min[axis], cb->max[axis]),
                                  prim_bounds,
-                                 tri_faces);
+                                 prim_to_face_map);
   }
   else {
     /* Partition primitives by material */
-    end = partition_indices_material_faces(pbvh.prim_indices_,
-                                           tri_faces,
+    end = partition_indices_material_faces(prim_indices,
+                                           prim_to_face_map,
                                            material_indices,
                                            sharp_faces,
                                            prim_offset,
                                            prim_offset + prims_num - 1);
   }
 
-  /* Build children */
-  build_nodes_recursive_mesh(pbvh,
-                             corner_verts,
-                             corner_tris,
-                             tri_faces,
-                             material_indices,
-                             sharp_faces,
-                             leaf_limit,
-                             vert_bitmap,
-                             pbvh.nodes_[node_index].children_offset_,
-                             nullptr,
-                             prim_bounds,
-                             prim_offset,
-                             end - prim_offset,
-                             prim_scratch,
-                             depth + 1);
-  build_nodes_recursive_mesh(pbvh,
-                             corner_verts,
-                             corner_tris,
-                             tri_faces,
-                             material_indices,
-                             sharp_faces,
-                             leaf_limit,
-                             vert_bitmap,
-                             pbvh.nodes_[node_index].children_offset_ + 1,
-                             nullptr,
-                             prim_bounds,
-                             end,
-                             prim_offset + prims_num - end,
-                             prim_scratch,
-                             depth + 1);
+  /* Add two child nodes */
+  node.children[0] = std::make_unique<BuildNode>();
+  node.children[0]->prim_offset = prim_offset;
+  node.children[0]->prims_num = end - prim_offset;
+  node.children[1] = std::make_unique<BuildNode>();
+  node.children[1]->prim_offset = end;
+  node.children[1]->prims_num = prim_offset + prims_num - end;
+
+  /* Build children. The children use separate ranges of the primitive and scratch arrays, so
+   * larger subtrees can be built in parallel. */
+  const auto build_child = [&](BuildNode &child) {
+    build_nodes_recursive(prim_indices,
+                          prim_to_face_map,
+                          material_indices,
+                          sharp_faces,
+                          leaf_limit,
+                          nullptr,
+                          prim_bounds,
+                          prim_scratch,
+                          depth + 1,
+                          child);
+  };
+  threading::parallel_invoke(
+      prims_num > leaf_limit * 8,
+      [&]() { build_child(*node.children[0]); },
+      [&]() { build_child(*node.children[1]); });
+}
+
+/** Create the nodes in the same order as when they were created during the recursion. */
+static void build_nodes_flatten(Tree &pbvh, const BuildNode &build_node, const int node_index)
+{
+  if (!build_node.children[0]) {
+    Node &node = pbvh.nodes_[node_index];
+    node.flag_ |= PBVH_Leaf;
+    node.prim_indices_ = pbvh.prim_indices_.as_span().slice(build_node.prim_offset,
+                                                            build_node.prims_num);
+    BKE_pbvh_node_mark_positions_update(&node);
+    BKE_pbvh_node_mark_rebuild_draw(&node);
+    return;
+  }
+
+  const int children_offset = pbvh.nodes_.size();
+  pbvh.nodes_[node_index].children_offset_ = children_offset;
+  pbvh.nodes_.resize(children_offset + 2);
+  build_nodes_flatten(pbvh, *build_node.children[0], children_offset);
+  build_nodes_flatten(pbvh, *build_node.children[1], children_offset + 1);
+}
+
+/**
+ * Partition #Tree::prim_indices_ spatially and by material, and create the nodes of the tree.
+ * \param cb: The bounds of all primitive centroids.
+ */
+static void build_nodes(Tree &pbvh,
+                        const Span<int> prim_to_face_map,
+                        const Span<int> material_indices,
+                        const Span<bool> sharp_faces,
+                        const int leaf_limit,
+                        const Bounds<float3> &cb,
+                        const Span<Bounds<float3>> prim_bounds)
+{
+  BuildNode root;
+  root.prims_num = pbvh.prim_indices_.size();
+  build_nodes_recursive(pbvh.prim_indices_,
+                        prim_to_face_map,
+                        material_indices,
+                        sharp_faces,
+                        leaf_limit,
+                        &cb,
+                        prim_bounds,
+                        Array<int>(pbvh.prim_indices_.size()),
+                        0,
+                        root);
+
+  pbvh.nodes_.resize(1);
+  build_nodes_flatten(pbvh, root, 0);
 }
 
 void update_mesh_pointers(Tree &pbvh, Mesh *mesh)
@@ -379,8 +452,6 @@ std::unique_ptr<Tree> build_mesh(Mesh *mesh)
   update_mesh_pointers(*pbvh, mesh);
   const Span<int> tri_faces = mesh->corner_tri_faces();
 
-  Array<bool> vert_bitmap(mesh->verts_num, false);
-
   const int leaf_limit = LEAF_LIMIT;
 
   /* For each face, store the AABB and the AABB centroid */
@@ -413,22 +484,8 @@ std::unique_ptr<Tree> build_mesh(Mesh *mesh)
     pbvh->prim_indices_.reinitialize(corner_tris.size());
     array_utils::fill_index_range<int>(pbvh->prim_indices_);
 
-    pbvh->nodes_.resize(1);
-    build_nodes_recursive_mesh(*pbvh,
-                               corner_verts,
-                               corner_tris,
-                               tri_faces,
-                               material_index,
-                               sharp_face,
-                               leaf_limit,
-                               vert_bitmap,
-                               0,
-                               &cb,
-                               prim_bounds,
-                               0,
-                               corner_tris.size(),
-                               Array<int>(pbvh->prim_indices_.size()),
-                               0);
+    build_nodes(*pbvh, tri_faces, material_index, sharp_face, leaf_limit, cb, prim_bounds);
+    build_mesh_leaf_nodes(mesh->verts_num, corner_verts, corner_tris, pbvh->nodes_);
 
     update_bounds(*pbvh);
     store_bounds_orig(*pbvh);
@@ -449,100 +506,6 @@ std::unique_ptr<Tree> build_mesh(Mesh *mesh)
   return pbvh;
 }
 
-static void build_nodes_recursive_grids(Tree &pbvh,
-                                        const Span<int> material_indices,
-                                        const Span<bool> sharp_faces,
-                                        const int leaf_limit,
-                                        const int node_index,
-                                        const Bounds<float3> *cb,
-                                        const Span<Bounds<float3>> prim_bounds,
-                                        const int prim_offset,
-                                        const int prims_num,
-                                        MutableSpan<int> prim_scratch,
-                                        const int depth)
-{
-  const Span<int> prim_to_face_map = pbvh.subdiv_ccg_->grid_to_face_map;
-  int end;
-
-  /* Decide whether this is a leaf or not */
-  const bool below_leaf_limit = prims_num <= leaf_limit || depth >= STACK_FIXED_DEPTH - 1;
-  if (below_leaf_limit) {
-    if (!leaf_needs_material_split(
-            pbvh, prim_to_face_map, material_indices, sharp_faces, prim_offset, prims_num))
-    {
-      Node &node = pbvh.nodes_[node_index];
-      node.flag_ |= PBVH_Leaf;
-
-      node.prim_indices_ = pbvh.prim_indices_.as_span().slice(prim_offset, prims_num);
-      BKE_pbvh_node_mark_positions_update(&node);
-      BKE_pbvh_node_mark_rebuild_draw(&node);
-      return;
-    }
-  }
-
-  /* Add two child nodes */
-  pbvh.nodes_[node_index].children_offset_ = pbvh.nodes_.size();
-  pbvh.nodes_.resize(pbvh.nodes_.size() + 2);
-
-  Bounds<float3> cb_backing;
-  if (!below_leaf_limit) {
-    /* Find axis with widest range of primitive centroids */
-    if (!cb) {
-      cb_backing = negative_bounds();
-      for (int i = prim_offset + prims_num - 1; i >= prim_offset; i--) {
-        const int prim = pbvh.prim_indices_[i];
-        const float3 center = math::midpoint(prim_bounds[prim].min, prim_bounds[prim].max);
-        math::min_max(center, cb_backing.min, cb_backing.max);
-      }
-      cb = &cb_backing;
-    }
-    const int axis = math::dominant_axis(cb->max - cb->min);
-
-    /* Partition primitives along that axis */
-    end = partition_prim_indices(pbvh.prim_indices_,
-                                 prim_scratch,
-                                 prim_offset,
-                                 prim_offset + prims_num,
-                                 axis,
-                                 math::midpoint(cb->min[axis], cb->max[axis]),
-                                 prim_bounds,
-                                 prim_to_face_map);
-  }
-  else {
-    /* Partition primitives by material */
-    end = partition_indices_material_faces(pbvh.prim_indices_,
-                                           prim_to_face_map,
-                                           material_indices,
-                                           sharp_faces,
-                                           prim_offset,
-                                           prim_offset + prims_num - 1);
-  }
-
-  /* Build children */
-  build_nodes_recursive_grids(pbvh,
-                              material_indices,
-                              sharp_faces,
-                              leaf_limit,
-                              pbvh.nodes_[node_index].children_offset_,
-                              nullptr,
-                              prim_bounds,
-                              prim_offset,
-                              end - prim_offset,
-                              prim_scratch,
-                              depth + 1);
-  build_nodes_recursive_grids(pbvh,
-                              material_indices,
-                              sharp_faces,
-                              leaf_limit,
-                              pbvh.nodes_[node_index].children_offset_ + 1,
-                              nullptr,
-                              prim_bounds,
-                              end,
-                              prim_offset + prims_num - end,
-                              prim_scratch,
-                              depth + 1);
-}
-
 std::unique_ptr<Tree> build_grids(Mesh *mesh, SubdivCCG *subdiv_ccg)
 {
   std::unique_ptr<Tree> pbvh = std::make_unique<Tree>(Type::Grids);
@@ -598,18 +561,13 @@ std::unique_ptr<Tree> build_grids(Mesh *mesh, SubdivCCG *subdiv_ccg)
     pbvh->prim_indices_.reinitialize(grids.size());
     array_utils::fill_index_range<int>(pbvh->prim_indices_);
 
-    pbvh->nodes_.resize(1);
-    build_nodes_recursive_grids(*pbvh,
-                                material_index,
-                                sharp_face,
-                                leaf_limit,
-                                0,
-                                &cb,
-                                prim_bounds,
-                                0,
-                                grids.size(),
-                                Array<int>(pbvh->prim_indices_.size()),
-                                0);
+    build_nodes(*pbvh,
+                subdiv_ccg->grid_to_face_map,
+                material_index,
+                sharp_face,
+                leaf_limit,
+                cb,
+                prim_bounds);
 
     update_bounds(*pbvh);
     store_bounds_orig(*pbvh);
@@ -1525,21 +1483,26 @@ void BKE_pbvh_node_mark_update(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_UpdateNormals | PBVH_UpdateBB | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw |
                  PBVH_RebuildPixels;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::All;
+  node->draw_dirty_verts_all_ = true;
 }
 
 void BKE_pbvh_node_mark_update_mask(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_UpdateMask | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::Masks;
 }
 
 void BKE_pbvh_node_mark_update_color(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_UpdateColor | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::Attributes;
 }
 
 void BKE_pbvh_node_mark_update_face_sets(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::FaceSets;
 }
 
 void BKE_pbvh_mark_rebuild_pixels(blender::bke::pbvh::Tree &pbvh)
@@ -1555,21 +1518,55 @@ void BKE_pbvh_node_mark_update_visibility(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_UpdateVisibility | PBVH_RebuildDrawBuffers | PBVH_UpdateDrawBuffers |
                  PBVH_UpdateRedraw;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::All;
+  node->draw_dirty_verts_all_ = true;
 }
 
 void BKE_pbvh_node_mark_rebuild_draw(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_RebuildDrawBuffers | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::All;
+  node->draw_dirty_verts_all_ = true;
 }
 
 void BKE_pbvh_node_mark_redraw(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::All;
+  node->draw_dirty_verts_all_ = true;
 }
 
 void BKE_pbvh_node_mark_positions_update(blender::bke::pbvh::Node *node)
 {
   node->flag_ |= PBVH_UpdateNormals | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw | PBVH_UpdateBB;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::Positions;
+  node->draw_dirty_verts_all_ = true;
+}
+
+void BKE_pbvh_node_mark_positions_update(blender::bke::pbvh::Node *node,
+                                         const blender::IndexRange verts)
+{
+  node->flag_ |= PBVH_UpdateNormals | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw | PBVH_UpdateBB;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::Positions;
+  node->draw_dirty_verts_pending_ = false;
+  if (verts.is_empty()) {
+    return;
+  }
+  if (node->draw_dirty_verts_.is_empty()) {
+    node->draw_dirty_verts_ = verts;
+  }
+  else {
+    node->draw_dirty_verts_ = blender::IndexRange::from_begin_end(
+        std::min(node->draw_dirty_verts_.first(), verts.first()),
+        std::max(node->draw_dirty_verts_.one_after_last(), verts.one_after_last()));
+  }
+}
+
+void BKE_pbvh_node_mark_positions_pending(blender::bke::pbvh::Node *node)
+{
+  node->flag_ |= PBVH_UpdateNormals | PBVH_UpdateDrawBuffers | PBVH_UpdateRedraw | PBVH_UpdateBB;
+  node->draw_dirty_ |= blender::bke::pbvh::DrawDirty::Positions;
+  node->draw_dirty_verts_pending_ = true;
 }
 
 void BKE_pbvh_node_fully_hidden_set(blender::bke::pbvh::Node *node, int fully_hidden)
@@ -2471,6 +2468,10 @@ static blender::draw::pbvh::PBVH_GPU_Args pbvh_draw_args_init(const Mesh &mesh,
 
       args.prim_indices = node.prim_indices_;
       args.tri_faces = mesh.corner_tri_faces();
+
+      args.node_verts = node.vert_indices_;
+      args.node_unique_verts_num = node.unique_verts_num_;
+      args.node_tri_verts = node.face_vert_indices_;
       break;
     case blender::bke::pbvh::Type::Grids:
       args.vert_data = &pbvh.mesh_->vert_data;
@@ -2515,7 +2516,12 @@ static void node_update_draw_buffers(const Mesh &mesh, Tree &pbvh, Node &node)
 
     if (node.draw_batches_) {
       const blender::draw::pbvh::PBVH_GPU_Args args = pbvh_draw_args_init(mesh, pbvh, node);
-      blender::draw::pbvh::node_update(node.draw_batches_, args);
+      /* Changes of positions that weren't recorded may affect any vertex. */
+      const std::optional<blender::IndexRange> dirty_verts =
+          node.draw_dirty_verts_all_ || node.draw_dirty_verts_pending_ ?
+              std::nullopt :
+              std::make_optional(node.draw_dirty_verts_);
+      blender::draw::pbvh::node_update(node.draw_batches_, args, node.draw_dirty_, dirty_verts);
     }
   }
 }
@@ -2568,6 +2574,10 @@ static void pbvh_update_draw_buffers(const Mesh &mesh,
     }
 
     node->flag_ &= ~(PBVH_RebuildDrawBuffers | PBVH_UpdateDrawBuffers);
+    node->draw_dirty_ = DrawDirty::None;
+    node->draw_dirty_verts_ = {};
+    node->draw_dirty_verts_all_ = false;
+    node->draw_dirty_verts_pending_ = false;
   }
 }
 
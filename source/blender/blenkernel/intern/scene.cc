@@ -1297,6 +1297,9 @@ static void scene_blend_read_data(BlendDataReader *reader, ID *id)
     ed->prefetch_job = nullptr;
     ed->runtime.sequence_lookup = nullptr;
     ed->runtime.media_presence = nullptr;
+    ed->runtime.playback_frames_displayed = 0;
+    ed->runtime.playback_frames_dropped = 0;
+    ed->runtime.playback_is_active = false;
 
     /* recursive link sequences, lb will be correctly initialized */
     link_recurs_seq(reader, &ed->seqbase);
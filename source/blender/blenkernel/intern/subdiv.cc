@@ -14,6 +14,7 @@
 #include "BLI_utildefines.h"
 
 #include "BKE_subdiv_modifier.hh"
+#include "BKE_subdiv_topology.hh"
 
 #include "MEM_guardedalloc.h"
 
@@ -100,13 +101,9 @@ Subdiv *new_from_converter(const Settings *settings, OpenSubdiv_Converter *conve
   SubdivStats stats;
   stats_init(&stats);
   stats_begin(&stats, SUBDIV_STATS_TOPOLOGY_REFINER_CREATION_TIME);
-  OpenSubdiv_TopologyRefinerSettings topology_refiner_settings;
-  topology_refiner_settings.level = settings->level;
-  topology_refiner_settings.is_adaptive = settings->is_adaptive;
   OpenSubdiv_TopologyRefiner *osd_topology_refiner = nullptr;
   if (converter->getNumVertices(converter) != 0) {
-    osd_topology_refiner = openSubdiv_createTopologyRefinerFromConverter(
-        converter, &topology_refiner_settings);
+    osd_topology_refiner = topology_refiner_acquire(settings, converter);
   }
   else {
     /* TODO(sergey): Check whether original geometry had any vertices.
@@ -189,9 +186,7 @@ void free(Subdiv *subdiv)
     }
     openSubdiv_deleteEvaluator(subdiv->evaluator);
   }
-  if (subdiv->topology_refiner != nullptr) {
-    openSubdiv_deleteTopologyRefiner(subdiv->topology_refiner);
-  }
+  topology_refiner_release(subdiv->topology_refiner);
   displacement_detach(subdiv);
   if (subdiv->cache_.face_ptex_offset != nullptr) {
     MEM_freeN(subdiv->cache_.face_ptex_offset);
@@ -24,6 +24,7 @@
 #include "BKE_subdiv.hh"
 #include "BKE_subdiv_eval.hh"
 
+#include "opensubdiv_capi_type.hh"
 #include "opensubdiv_topology_refiner_capi.hh"
 
 using blender::Array;
@@ -152,28 +153,21 @@ static void subdiv_ccg_alloc_elements(SubdivCCG &subdiv_ccg, Subdiv &subdiv)
 /** \name Grids evaluation
  * \{ */
 
-static void subdiv_ccg_eval_grid_element_limit(Subdiv &subdiv,
-                                               SubdivCCG &subdiv_ccg,
-                                               const int ptex_face_index,
-                                               const float u,
-                                               const float v,
-                                               uchar *element)
-{
-  if (subdiv.displacement_evaluator != nullptr) {
-    eval_final_point(&subdiv, ptex_face_index, u, v, (float *)element);
-  }
-  else if (subdiv_ccg.has_normal) {
-    eval_limit_point_and_normal(&subdiv,
-                                ptex_face_index,
-                                u,
-                                v,
-                                (float *)element,
-                                (float *)(element + subdiv_ccg.normal_offset));
-  }
-  else {
-    eval_limit_point(&subdiv, ptex_face_index, u, v, (float *)element);
+/**
+ * Patch coordinates of all elements of a grid and the limit surface evaluated at them, so that
+ * a grid is evaluated with a single batched query instead of one query per element.
+ */
+struct GridEvalData {
+  Array<OpenSubdiv_PatchCoord> patch_coords;
+  Array<float3> P;
+  Array<float3> dPdu;
+  Array<float3> dPdv;
+
+  GridEvalData(const int grid_area)
+      : patch_coords(grid_area), P(grid_area), dPdu(grid_area), dPdv(grid_area)
+  {
   }
-}
+};
 
 static void subdiv_ccg_eval_grid_element_mask(SubdivCCG &subdiv_ccg,
                                               SubdivCCGMaskEvaluator *mask_evaluator,
@@ -194,44 +188,75 @@ static void subdiv_ccg_eval_grid_element_mask(SubdivCCG &subdiv_ccg,
   }
 }
 
-static void subdiv_ccg_eval_grid_element(Subdiv &subdiv,
-                                         SubdivCCG &subdiv_ccg,
-                                         SubdivCCGMaskEvaluator *mask_evaluator,
-                                         const int ptex_face_index,
-                                         const float u,
-                                         const float v,
-                                         uchar *element)
+/** Evaluate all elements of a grid at the patch coordinates stored in \a data. */
+static void subdiv_ccg_eval_grid(Subdiv &subdiv,
+                                 SubdivCCG &subdiv_ccg,
+                                 SubdivCCGMaskEvaluator *mask_evaluator,
+                                 GridEvalData &data,
+                                 uchar *grid)
 {
-  subdiv_ccg_eval_grid_element_limit(subdiv, subdiv_ccg, ptex_face_index, u, v, element);
-  subdiv_ccg_eval_grid_element_mask(subdiv_ccg, mask_evaluator, ptex_face_index, u, v, element);
+  const int element_size = element_size_bytes_get(subdiv_ccg);
+  const Span<OpenSubdiv_PatchCoord> patch_coords = data.patch_coords;
+  const bool use_displacement = subdiv.displacement_evaluator != nullptr;
+  if (use_displacement || subdiv_ccg.has_normal) {
+    eval_limit_points_and_derivatives(&subdiv, patch_coords, data.P, data.dPdu, data.dPdv);
+  }
+  else {
+    eval_limit_points(&subdiv, patch_coords, data.P);
+  }
+  for (const int i : patch_coords.index_range()) {
+    const OpenSubdiv_PatchCoord &patch_coord = patch_coords[i];
+    uchar *element = &grid[size_t(i) * element_size];
+    float *co = (float *)element;
+    if (use_displacement) {
+      /* Normals are calculated from the displaced positions once all grids are evaluated. */
+      float D[3];
+      eval_displacement(&subdiv,
+                        patch_coord.ptex_face,
+                        patch_coord.u,
+                        patch_coord.v,
+                        data.dPdu[i],
+                        data.dPdv[i],
+                        D);
+      add_v3_v3v3(co, data.P[i], D);
+    }
+    else {
+      copy_v3_v3(co, data.P[i]);
+      if (subdiv_ccg.has_normal) {
+        float *normal = (float *)(element + subdiv_ccg.normal_offset);
+        cross_v3_v3v3(normal, data.dPdu[i], data.dPdv[i]);
+        normalize_v3(normal);
+      }
+    }
+    subdiv_ccg_eval_grid_element_mask(
+        subdiv_ccg, mask_evaluator, patch_coord.ptex_face, patch_coord.u, patch_coord.v, element);
+  }
 }
 
 static void subdiv_ccg_eval_regular_grid(Subdiv &subdiv,
                                          SubdivCCG &subdiv_ccg,
                                          const Span<int> face_ptex_offset,
                                          SubdivCCGMaskEvaluator *mask_evaluator,
+                                         GridEvalData &data,
                                          const int face_index)
 {
   const int ptex_face_index = face_ptex_offset[face_index];
   const int grid_size = subdiv_ccg.grid_size;
   const float grid_size_1_inv = 1.0f / (grid_size - 1);
-  const int element_size = element_size_bytes_get(subdiv_ccg);
   const IndexRange face = subdiv_ccg.faces[face_index];
   for (int corner = 0; corner < face.size(); corner++) {
     const int grid_index = face.start() + corner;
-    uchar *grid = (uchar *)subdiv_ccg.grids[grid_index];
     for (int y = 0; y < grid_size; y++) {
       const float grid_v = y * grid_size_1_inv;
       for (int x = 0; x < grid_size; x++) {
         const float grid_u = x * grid_size_1_inv;
-        float u, v;
-        rotate_grid_to_quad(corner, grid_u, grid_v, &u, &v);
-        const size_t grid_element_index = size_t(y) * grid_size + x;
-        const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(
-            subdiv, subdiv_ccg, mask_evaluator, ptex_face_index, u, v, &grid[grid_element_offset]);
+        OpenSubdiv_PatchCoord &patch_coord = data.patch_coords[y * grid_size + x];
+        patch_coord.ptex_face = ptex_face_index;
+        rotate_grid_to_quad(corner, grid_u, grid_v, &patch_coord.u, &patch_coord.v);
       }
     }
+    subdiv_ccg_eval_grid(
+        subdiv, subdiv_ccg, mask_evaluator, data, (uchar *)subdiv_ccg.grids[grid_index]);
   }
 }
 
@@ -239,26 +264,24 @@ static void subdiv_ccg_eval_special_grid(Subdiv &subdiv,
                                          SubdivCCG &subdiv_ccg,
                                          const Span<int> face_ptex_offset,
                                          SubdivCCGMaskEvaluator *mask_evaluator,
+                                         GridEvalData &data,
                                          const int face_index)
 {
   const int grid_size = subdiv_ccg.grid_size;
   const float grid_size_1_inv = 1.0f / (grid_size - 1);
-  const int element_size = element_size_bytes_get(subdiv_ccg);
   const IndexRange face = subdiv_ccg.faces[face_index];
   for (int corner = 0; corner < face.size(); corner++) {
     const int grid_index = face.start() + corner;
     const int ptex_face_index = face_ptex_offset[face_index] + corner;
-    uchar *grid = (uchar *)subdiv_ccg.grids[grid_index];
     for (int y = 0; y < grid_size; y++) {
       const float u = 1.0f - (y * grid_size_1_inv);
       for (int x = 0; x < grid_size; x++) {
         const float v = 1.0f - (x * grid_size_1_inv);
-        const size_t grid_element_index = size_t(y) * grid_size + x;
-        const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(
-            subdiv, subdiv_ccg, mask_evaluator, ptex_face_index, u, v, &grid[grid_element_offset]);
+        data.patch_coords[y * grid_size + x] = {ptex_face_index, u, v};
       }
     }
+    subdiv_ccg_eval_grid(
+        subdiv, subdiv_ccg, mask_evaluator, data, (uchar *)subdiv_ccg.grids[grid_index]);
   }
 }
 
@@ -271,14 +294,15 @@ static bool subdiv_ccg_evaluate_grids(SubdivCCG &subdiv_ccg,
   const int num_faces = topology_refiner->getNumFaces();
   const Span<int> face_ptex_offset(face_ptex_offset_get(&subdiv), subdiv_ccg.faces.size());
   threading::parallel_for(IndexRange(num_faces), 1024, [&](const IndexRange range) {
+    GridEvalData data(subdiv_ccg.grid_size * subdiv_ccg.grid_size);
     for (const int face_index : range) {
       if (subdiv_ccg.faces[face_index].size() == 4) {
         subdiv_ccg_eval_regular_grid(
-            subdiv, subdiv_ccg, face_ptex_offset, mask_evaluator, face_index);
+            subdiv, subdiv_ccg, face_ptex_offset, mask_evaluator, data, face_index);
       }
       else {
         subdiv_ccg_eval_special_grid(
-            subdiv, subdiv_ccg, face_ptex_offset, mask_evaluator, face_index);
+            subdiv, subdiv_ccg, face_ptex_offset, mask_evaluator, data, face_index);
       }
     }
   });
@@ -10,6 +10,7 @@
 
 #include "BLI_math_vector.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "BKE_customdata.hh"
@@ -279,6 +280,11 @@ void eval_init_displacement(Subdiv *subdiv)
  * Single point queries.
  */
 
+static bool derivatives_are_degenerate(const float dPdu[3], const float dPdv[3])
+{
+  return (is_zero_v3(dPdu) || is_zero_v3(dPdv)) || equals_v3v3(dPdu, dPdv);
+}
+
 void eval_limit_point(
     Subdiv *subdiv, const int ptex_face_index, const float u, const float v, float r_P[3])
 {
@@ -307,7 +313,7 @@ void eval_limit_point_and_derivatives(Subdiv *subdiv,
    * that giving totally unusable derivatives. */
 
   if (r_dPdu != nullptr && r_dPdv != nullptr) {
-    if ((is_zero_v3(r_dPdu) || is_zero_v3(r_dPdv)) || equals_v3v3(r_dPdu, r_dPdv)) {
+    if (derivatives_are_degenerate(r_dPdu, r_dPdv)) {
       subdiv->evaluator->evaluateLimit(subdiv->evaluator,
                                        ptex_face_index,
                                        u * 0.999f + 0.0005f,
@@ -379,4 +385,64 @@ void eval_final_point(
   }
 }
 
+/* --------------------------------------------------------------------
+ * Batched queries.
+ */
+
+/* Number of patch coordinates which are passed to the evaluator at once. Big enough for the
+ * evaluator overhead to be negligible, small enough to balance the work between threads. */
+static constexpr int64_t EVAL_PATCH_COORDS_CHUNK_SIZE = 1024;
+
+void eval_limit_points(Subdiv *subdiv,
+                       const Span<OpenSubdiv_PatchCoord> patch_coords,
+                       MutableSpan<float3> r_P)
+{
+  BLI_assert(r_P.size() == patch_coords.size());
+  OpenSubdiv_Evaluator *evaluator = subdiv->evaluator;
+  threading::parallel_for(
+      patch_coords.index_range(), EVAL_PATCH_COORDS_CHUNK_SIZE, [&](const IndexRange range) {
+        evaluator->evaluatePatchesLimit(evaluator,
+                                        &patch_coords[range.start()],
+                                        range.size(),
+                                        &r_P[range.start()].x,
+                                        nullptr,
+                                        nullptr);
+      });
+}
+
+void eval_limit_points_and_derivatives(Subdiv *subdiv,
+                                       const Span<OpenSubdiv_PatchCoord> patch_coords,
+                                       MutableSpan<float3> r_P,
+                                       MutableSpan<float3> r_dPdu,
+                                       MutableSpan<float3> r_dPdv)
+{
+  BLI_assert(r_P.size() == patch_coords.size());
+  BLI_assert(r_dPdu.size() == patch_coords.size());
+  BLI_assert(r_dPdv.size() == patch_coords.size());
+  OpenSubdiv_Evaluator *evaluator = subdiv->evaluator;
+  threading::parallel_for(
+      patch_coords.index_range(), EVAL_PATCH_COORDS_CHUNK_SIZE, [&](const IndexRange range) {
+        evaluator->evaluatePatchesLimit(evaluator,
+                                        &patch_coords[range.start()],
+                                        range.size(),
+                                        &r_P[range.start()].x,
+                                        &r_dPdu[range.start()].x,
+                                        &r_dPdv[range.start()].x);
+        /* See #eval_limit_point_and_derivatives for why degenerate derivatives are re-evaluated
+         * slightly inside of the face. */
+        for (const int64_t i : range) {
+          if (derivatives_are_degenerate(r_dPdu[i], r_dPdv[i])) {
+            const OpenSubdiv_PatchCoord &patch_coord = patch_coords[i];
+            evaluator->evaluateLimit(evaluator,
+                                     patch_coord.ptex_face,
+                                     patch_coord.u * 0.999f + 0.0005f,
+                                     patch_coord.v * 0.999f + 0.0005f,
+                                     r_P[i],
+                                     r_dPdu[i],
+                                     r_dPdv[i]);
+          }
+        }
+      });
+}
+
 }  // namespace blender::bke::subdiv
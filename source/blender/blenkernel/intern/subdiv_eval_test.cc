@@ -0,0 +1,194 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_utildefines.h"
+
+#include "BKE_idtype.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+#include "BKE_subdiv.hh"
+#include "BKE_subdiv_eval.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "CLG_log.h"
+
+#include "opensubdiv_capi_type.hh"
+
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::bke::subdiv::tests {
+
+class SubdivEvalTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    CLG_exit();
+  }
+};
+
+/* A grid of quads in the XY plane with a bit of a bump in Z, so that the limit surface and its
+ * derivatives are not trivial. */
+static Mesh *create_grid_mesh(const int faces_x, const int faces_y)
+{
+  const int verts_x = faces_x + 1;
+  const int verts_y = faces_y + 1;
+  Mesh *mesh = BKE_mesh_new_nomain(verts_x * verts_y, 0, faces_x * faces_y, faces_x * faces_y * 4);
+
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_y)) {
+    for (const int x : IndexRange(verts_x)) {
+      const float z = ((x + y) % 3 == 0) ? 0.25f : 0.0f;
+      positions[y * verts_x + x] = float3(x, y, z);
+    }
+  }
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  for (const int y : IndexRange(faces_y)) {
+    for (const int x : IndexRange(faces_x)) {
+      const int face = y * faces_x + x;
+      face_offsets[face] = face * 4;
+      corner_verts[face * 4 + 0] = y * verts_x + x;
+      corner_verts[face * 4 + 1] = y * verts_x + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * verts_x + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * verts_x + x;
+    }
+  }
+  face_offsets.last() = corner_verts.size();
+
+  mesh_calc_edges(*mesh, false, false);
+  return mesh;
+}
+
+static Subdiv *create_subdiv(const Mesh *mesh)
+{
+  Settings settings{};
+  settings.is_simple = false;
+  settings.is_adaptive = true;
+  settings.level = 3;
+  settings.use_creases = false;
+  settings.vtx_boundary_interpolation = SUBDIV_VTX_BOUNDARY_EDGE_ONLY;
+  settings.fvar_linear_interpolation = SUBDIV_FVAR_LINEAR_INTERPOLATION_ALL;
+  Subdiv *subdiv = new_from_mesh(&settings, mesh);
+  if (subdiv == nullptr) {
+    return nullptr;
+  }
+  if (!eval_begin_from_mesh(subdiv, mesh, nullptr, SUBDIV_EVALUATOR_TYPE_CPU, nullptr)) {
+    free(subdiv);
+    return nullptr;
+  }
+  return subdiv;
+}
+
+/* A few points on every ptex face, including its corners and edges. */
+static Array<OpenSubdiv_PatchCoord> create_patch_coords(const int ptex_faces_num)
+{
+  const float2 uvs[] = {
+      {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}, {0.5f, 0.5f}, {0.25f, 0.75f}};
+  Array<OpenSubdiv_PatchCoord> patch_coords(ptex_faces_num * ARRAY_SIZE(uvs));
+  for (const int ptex_face : IndexRange(ptex_faces_num)) {
+    for (const int i : IndexRange(ARRAY_SIZE(uvs))) {
+      OpenSubdiv_PatchCoord &patch_coord = patch_coords[ptex_face * ARRAY_SIZE(uvs) + i];
+      patch_coord.ptex_face = ptex_face;
+      patch_coord.u = uvs[i].x;
+      patch_coord.v = uvs[i].y;
+    }
+  }
+  return patch_coords;
+}
+
+TEST_F(SubdivEvalTest, limit_points_match_single_point_queries)
+{
+  Mesh *mesh = create_grid_mesh(24, 17);
+  Subdiv *subdiv = create_subdiv(mesh);
+  if (subdiv == nullptr) {
+    BKE_id_free(nullptr, mesh);
+    GTEST_SKIP() << "Blender was built without OpenSubdiv";
+  }
+
+  const Array<OpenSubdiv_PatchCoord> patch_coords = create_patch_coords(mesh->faces_num);
+  Array<float3> P(patch_coords.size());
+  Array<float3> dPdu(patch_coords.size());
+  Array<float3> dPdv(patch_coords.size());
+  eval_limit_points_and_derivatives(subdiv, patch_coords, P, dPdu, dPdv);
+
+  Array<float3> P_only(patch_coords.size());
+  eval_limit_points(subdiv, patch_coords, P_only);
+
+  for (const int64_t i : patch_coords.index_range()) {
+    const OpenSubdiv_PatchCoord &patch_coord = patch_coords[i];
+    float3 expected_P, expected_dPdu, expected_dPdv;
+    eval_limit_point_and_derivatives(subdiv,
+                                     patch_coord.ptex_face,
+                                     patch_coord.u,
+                                     patch_coord.v,
+                                     expected_P,
+                                     expected_dPdu,
+                                     expected_dPdv);
+    EXPECT_V3_NEAR(P[i], expected_P, 1e-5f);
+    EXPECT_V3_NEAR(dPdu[i], expected_dPdu, 1e-5f);
+    EXPECT_V3_NEAR(dPdv[i], expected_dPdv, 1e-5f);
+
+    float3 expected_P_only;
+    eval_limit_point(subdiv, patch_coord.ptex_face, patch_coord.u, patch_coord.v, expected_P_only);
+    EXPECT_V3_NEAR(P_only[i], expected_P_only, 1e-5f);
+  }
+
+  free(subdiv);
+  BKE_id_free(nullptr, mesh);
+}
+
+#if DO_PERF_TESTS
+
+TEST_F(SubdivEvalTest, limit_points_performance)
+{
+  /* About a million faces, similar to a dense character mesh. */
+  Mesh *mesh = create_grid_mesh(1000, 1000);
+
+  Subdiv *subdiv;
+  {
+    SCOPED_TIMER("create and refine evaluator");
+    subdiv = create_subdiv(mesh);
+  }
+  ASSERT_NE(subdiv, nullptr);
+
+  const Array<OpenSubdiv_PatchCoord> patch_coords = create_patch_coords(mesh->faces_num);
+  Array<float3> P(patch_coords.size());
+  Array<float3> dPdu(patch_coords.size());
+  Array<float3> dPdv(patch_coords.size());
+  {
+    SCOPED_TIMER("single point queries");
+    for (const int64_t i : patch_coords.index_range()) {
+      const OpenSubdiv_PatchCoord &patch_coord = patch_coords[i];
+      eval_limit_point_and_derivatives(
+          subdiv, patch_coord.ptex_face, patch_coord.u, patch_coord.v, P[i], dPdu[i], dPdv[i]);
+    }
+  }
+  {
+    SCOPED_TIMER("batched queries");
+    eval_limit_points_and_derivatives(subdiv, patch_coords, P, dPdu, dPdv);
+  }
+
+  free(subdiv);
+  BKE_id_free(nullptr, mesh);
+}
+
+#endif
+
+}  // namespace blender::bke::subdiv::tests
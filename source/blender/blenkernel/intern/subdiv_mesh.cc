@@ -12,6 +12,8 @@
 #include "DNA_mesh_types.h"
 
 #include "BLI_array.hh"
+#include "BLI_array_utils.hh"
+#include "BLI_index_mask.hh"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
@@ -29,6 +31,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.hh"
+
 namespace blender::bke::subdiv {
 
 /* -------------------------------------------------------------------- */
@@ -79,6 +83,14 @@ struct SubdivMeshContext {
   int *accumulated_counters;
   bool have_displacement;
 
+  /**
+   * Patch coordinate of every subdivided vertex whose limit surface position is still to be
+   * evaluated. The positions are evaluated in batches once the traversal is done, and the
+   * displacement already stored in the position is added to them. Vertices which are not on the
+   * limit surface (loose geometry, displaced inner vertices) have a ptex face index of -1.
+   */
+  Array<OpenSubdiv_PatchCoord> vert_patch_coords;
+
   /* Write optimal display edge tags into a boolean array rather than the final bit vector
    * to avoid race conditions when setting bits. */
   Array<bool> subdiv_display_edges;
@@ -585,6 +597,8 @@ static bool subdiv_mesh_topology_info(const ForeachContext *foreach_context,
 
   subdiv_mesh_ctx_cache_custom_data_layers(subdiv_context);
   subdiv_mesh_prepare_accumulator(subdiv_context, num_vertices);
+  subdiv_context->vert_patch_coords = Array<OpenSubdiv_PatchCoord>(num_vertices,
+                                                                   {-1, 0.0f, 0.0f});
   subdiv_mesh.runtime->subsurf_face_dot_tags.clear();
   subdiv_mesh.runtime->subsurf_face_dot_tags.resize(num_vertices);
   if (subdiv_context->settings->use_optimal_display) {
@@ -630,6 +644,22 @@ static void subdiv_vertex_data_interpolate(const SubdivMeshContext *ctx,
   }
 }
 
+/**
+ * Defer evaluation of the limit surface position of the vertex to
+ * #subdiv_mesh_eval_limit_positions, which adds it to the current position.
+ */
+static void subdiv_mesh_vertex_defer_limit_position(const SubdivMeshContext *ctx,
+                                                    const int ptex_face_index,
+                                                    const float u,
+                                                    const float v,
+                                                    const int subdiv_vertex_index)
+{
+  /* The context is only const because of the callback signatures, every subdivided vertex is
+   * visited by a single thread. */
+  const_cast<SubdivMeshContext *>(ctx)->vert_patch_coords[subdiv_vertex_index] = {
+      ptex_face_index, u, v};
+}
+
 static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext *ctx,
                                                         const int ptex_face_index,
                                                         const float u,
@@ -646,11 +676,10 @@ static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext
     copy_v3_v3(D, subdiv_position);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Copy custom data and evaluate position. */
+  /* Copy custom data and store displacement, the limit position is added to it later. */
   subdiv_vertex_data_copy(ctx, coarse_vertex_index, subdiv_vertex_index);
-  eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_position);
-  /* Apply displacement. */
-  subdiv_position += D;
+  copy_v3_v3(subdiv_position, D);
+  subdiv_mesh_vertex_defer_limit_position(ctx, ptex_face_index, u, v, subdiv_vertex_index);
   /* Evaluate undeformed texture coordinate. */
   subdiv_vertex_orco_evaluate(ctx, ptex_face_index, u, v, subdiv_vertex_index);
   /* Remove face-dot flag. This can happen if there is more than one subsurf modifier. */
@@ -674,11 +703,10 @@ static void evaluate_vertex_and_apply_displacement_interpolate(
     copy_v3_v3(D, subdiv_position);
     mul_v3_fl(D, inv_num_accumulated);
   }
-  /* Interpolate custom data and evaluate position. */
+  /* Interpolate custom data and store displacement, the limit position is added to it later. */
   subdiv_vertex_data_interpolate(ctx, subdiv_vertex_index, vertex_interpolation, u, v);
-  eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_position);
-  /* Apply displacement. */
-  add_v3_v3(subdiv_position, D);
+  copy_v3_v3(subdiv_position, D);
+  subdiv_mesh_vertex_defer_limit_position(ctx, ptex_face_index, u, v, subdiv_vertex_index);
   /* Evaluate undeformed texture coordinate. */
   subdiv_vertex_orco_evaluate(ctx, ptex_face_index, u, v, subdiv_vertex_index);
 }
@@ -832,7 +860,13 @@ static void subdiv_mesh_vertex_inner(const ForeachContext *foreach_context,
   float3 &subdiv_position = ctx->subdiv_positions[subdiv_vertex_index];
   subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_face_index, coarse_corner);
   subdiv_vertex_data_interpolate(ctx, subdiv_vertex_index, &tls->vertex_interpolation, u, v);
-  eval_final_point(subdiv, ptex_face_index, u, v, subdiv_position);
+  if (ctx->have_displacement) {
+    eval_final_point(subdiv, ptex_face_index, u, v, subdiv_position);
+  }
+  else {
+    subdiv_position = float3(0.0f);
+    subdiv_mesh_vertex_defer_limit_position(ctx, ptex_face_index, u, v, subdiv_vertex_index);
+  }
   subdiv_mesh_tag_center_vertex(coarse_face, subdiv_vertex_index, u, v, subdiv_mesh);
   subdiv_vertex_orco_evaluate(ctx, ptex_face_index, u, v, subdiv_vertex_index);
 }
@@ -1124,6 +1158,31 @@ static void subdiv_mesh_vertex_of_loose_edge(const ForeachContext *foreach_conte
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Limit positions evaluation
+ * \{ */
+
+static void subdiv_mesh_eval_limit_positions(SubdivMeshContext *ctx)
+{
+  const Span<OpenSubdiv_PatchCoord> vert_patch_coords = ctx->vert_patch_coords;
+  IndexMaskMemory memory;
+  const IndexMask verts = IndexMask::from_predicate(
+      vert_patch_coords.index_range(), GrainSize(4096), memory, [&](const int vert) {
+        return vert_patch_coords[vert].ptex_face != -1;
+      });
+  Array<OpenSubdiv_PatchCoord> patch_coords(verts.size());
+  array_utils::gather(vert_patch_coords, verts, patch_coords.as_mutable_span());
+  ctx->vert_patch_coords = {};
+  Array<float3> limit_positions(verts.size());
+  eval_limit_points(ctx->subdiv, patch_coords, limit_positions);
+  MutableSpan<float3> positions = ctx->subdiv_positions;
+  verts.foreach_index(GrainSize(4096), [&](const int vert, const int pos) {
+    positions[vert] += limit_positions[pos];
+  });
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Initialization
  * \{ */
@@ -1201,6 +1260,7 @@ Mesh *subdiv_to_mesh(Subdiv *subdiv, const ToMeshSettings *settings, const Mesh
   foreach_context.user_data_tls_size = sizeof(SubdivMeshTLS);
   foreach_context.user_data_tls = &tls;
   foreach_subdiv_geometry(subdiv, &foreach_context, settings, coarse_mesh);
+  subdiv_mesh_eval_limit_positions(&subdiv_context);
   stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   Mesh *result = subdiv_context.subdiv_mesh;
 
@@ -6,12 +6,21 @@
  * \ingroup bke
  */
 
+#include <mutex>
+
+#include "BLI_hash_mm2a.hh"
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
 #include "BLI_utildefines.h"
 
 #include "BKE_subdiv_topology.hh"
 
 #include "BKE_subdiv.hh"
 
+#include "MEM_guardedalloc.h"
+
+#include "opensubdiv_converter_capi.hh"
+#include "opensubdiv_evaluator_capi.hh"
 #include "opensubdiv_topology_refiner_capi.hh"
 
 namespace blender::bke::subdiv {
@@ -27,4 +36,221 @@ int topology_num_fvar_layers_get(const Subdiv *subdiv)
 #endif
 }
 
+/* --------------------------------------------------------------------
+ * Topology refiner cache.
+ */
+
+struct TopologyCacheEntry {
+  Settings settings;
+  OpenSubdiv_TopologyRefiner *topology_refiner = nullptr;
+  /* Number of subdivision surfaces using the topology refiner, including threads which are
+   * waiting for it to be created. */
+  int users = 0;
+  /* Locked while the topology refiner is being created. */
+  std::mutex creation_mutex;
+};
+
+struct TopologyCache {
+  std::mutex mutex;
+  /* Entries with the same hash have the same settings and likely the same topology, which still
+   * needs to be checked by comparing the topology refiner with the converter. */
+  Map<uint32_t, Vector<TopologyCacheEntry *>> entries_by_hash;
+  Map<const OpenSubdiv_TopologyRefiner *, uint32_t> hash_by_refiner;
+  int64_t hits = 0;
+  int64_t misses = 0;
+};
+
+static TopologyCache &get_topology_cache()
+{
+  static TopologyCache cache;
+  return cache;
+}
+
+/* Hash of the settings, face vertices and creases, which is much cheaper to compute than a
+ * topology refiner. */
+static uint32_t topology_hash(const Settings *settings, const OpenSubdiv_Converter *converter)
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  BLI_hash_mm2a_add_int(&mm2, settings->is_simple);
+  BLI_hash_mm2a_add_int(&mm2, settings->is_adaptive);
+  BLI_hash_mm2a_add_int(&mm2, settings->level);
+  BLI_hash_mm2a_add_int(&mm2, settings->use_creases);
+  BLI_hash_mm2a_add_int(&mm2, settings->vtx_boundary_interpolation);
+  BLI_hash_mm2a_add_int(&mm2, settings->fvar_linear_interpolation);
+
+  const int num_vertices = converter->getNumVertices(converter);
+  const int num_faces = converter->getNumFaces(converter);
+  BLI_hash_mm2a_add_int(&mm2, num_vertices);
+  BLI_hash_mm2a_add_int(&mm2, num_faces);
+  Vector<int, 16> face_vertices;
+  for (const int face_index : IndexRange(num_faces)) {
+    face_vertices.resize(converter->getNumFaceVertices(converter, face_index));
+    converter->getFaceVertices(converter, face_index, face_vertices.data());
+    BLI_hash_mm2a_add_int(&mm2, face_vertices.size());
+    BLI_hash_mm2a_add(&mm2,
+                      reinterpret_cast<const uchar *>(face_vertices.data()),
+                      face_vertices.as_span().size_in_bytes());
+  }
+
+  if (converter->getEdgeSharpness != nullptr) {
+    const int num_edges = converter->getNumEdges(converter);
+    BLI_hash_mm2a_add_int(&mm2, num_edges);
+    for (const int edge_index : IndexRange(num_edges)) {
+      const float sharpness = converter->getEdgeSharpness(converter, edge_index);
+      BLI_hash_mm2a_add(&mm2, reinterpret_cast<const uchar *>(&sharpness), sizeof(sharpness));
+    }
+  }
+  if (converter->getVertexSharpness != nullptr) {
+    for (const int vertex_index : IndexRange(num_vertices)) {
+      const float sharpness = converter->getVertexSharpness(converter, vertex_index);
+      BLI_hash_mm2a_add(&mm2, reinterpret_cast<const uchar *>(&sharpness), sizeof(sharpness));
+    }
+  }
+  return BLI_hash_mm2a_end(&mm2);
+}
+
+/* Remove a user from the entry, and free it together with its topology refiner when it was the
+ * last one. Must be called with the cache mutex locked. */
+static void topology_cache_entry_remove_user(TopologyCache &cache,
+                                             const uint32_t hash,
+                                             TopologyCacheEntry *entry)
+{
+  BLI_assert(entry->users > 0);
+  entry->users--;
+  if (entry->users > 0) {
+    return;
+  }
+  Vector<TopologyCacheEntry *> &entries = cache.entries_by_hash.lookup(hash);
+  entries.remove_first_occurrence_and_reorder(entry);
+  if (entries.is_empty()) {
+    cache.entries_by_hash.remove(hash);
+  }
+  if (entry->topology_refiner != nullptr) {
+    cache.hash_by_refiner.remove(entry->topology_refiner);
+    openSubdiv_deleteTopologyRefiner(entry->topology_refiner);
+  }
+  MEM_delete(entry);
+}
+
+OpenSubdiv_TopologyRefiner *topology_refiner_acquire(const Settings *settings,
+                                                     OpenSubdiv_Converter *converter)
+{
+  TopologyCache &cache = get_topology_cache();
+  const uint32_t hash = topology_hash(settings, converter);
+
+  /* Take a user of all candidates while the cache is locked, so they are not freed while their
+   * topology is compared with the converter. */
+  Vector<TopologyCacheEntry *> candidates;
+  TopologyCacheEntry *new_entry = nullptr;
+  {
+    std::lock_guard lock(cache.mutex);
+    Vector<TopologyCacheEntry *> &entries = cache.entries_by_hash.lookup_or_add_default(hash);
+    for (TopologyCacheEntry *entry : entries) {
+      if (settings_equal(&entry->settings, settings)) {
+        entry->users++;
+        candidates.append(entry);
+      }
+    }
+    if (candidates.is_empty()) {
+      /* Create the entry right away, so that other threads requesting the same topology wait for
+       * it to be created instead of creating their own. */
+      new_entry = MEM_new<TopologyCacheEntry>(__func__);
+      new_entry->settings = *settings;
+      new_entry->users = 1;
+      new_entry->creation_mutex.lock();
+      entries.append(new_entry);
+      cache.misses++;
+    }
+  }
+
+  TopologyCacheEntry *found_entry = nullptr;
+  for (TopologyCacheEntry *entry : candidates) {
+    if (found_entry == nullptr) {
+      /* Wait for the topology refiner to be created by another thread. */
+      std::lock_guard creation_lock(entry->creation_mutex);
+      if (entry->topology_refiner != nullptr &&
+          openSubdiv_topologyRefinerCompareWithConverter(entry->topology_refiner, converter))
+      {
+        found_entry = entry;
+        continue;
+      }
+    }
+    std::lock_guard lock(cache.mutex);
+    topology_cache_entry_remove_user(cache, hash, entry);
+  }
+  if (found_entry != nullptr) {
+    std::lock_guard lock(cache.mutex);
+    cache.hits++;
+    return found_entry->topology_refiner;
+  }
+
+  if (new_entry == nullptr) {
+    /* Hash collision or a topology which failed to be created, create a new entry next to the
+     * existing ones. */
+    std::lock_guard lock(cache.mutex);
+    new_entry = MEM_new<TopologyCacheEntry>(__func__);
+    new_entry->settings = *settings;
+    new_entry->users = 1;
+    new_entry->creation_mutex.lock();
+    cache.entries_by_hash.lookup_or_add_default(hash).append(new_entry);
+    cache.misses++;
+  }
+
+  OpenSubdiv_TopologyRefinerSettings topology_refiner_settings;
+  topology_refiner_settings.level = settings->level;
+  topology_refiner_settings.is_adaptive = settings->is_adaptive;
+  OpenSubdiv_TopologyRefiner *topology_refiner = openSubdiv_createTopologyRefinerFromConverter(
+      converter, &topology_refiner_settings);
+  if (topology_refiner != nullptr) {
+    /* Refine before the topology refiner is shared, refining modifies it. */
+    openSubdiv_prepareEvaluatorTables(topology_refiner);
+  }
+
+  std::lock_guard lock(cache.mutex);
+  new_entry->topology_refiner = topology_refiner;
+  new_entry->creation_mutex.unlock();
+  if (topology_refiner == nullptr) {
+    topology_cache_entry_remove_user(cache, hash, new_entry);
+    return nullptr;
+  }
+  cache.hash_by_refiner.add_new(topology_refiner, hash);
+  return topology_refiner;
+}
+
+void topology_refiner_release(OpenSubdiv_TopologyRefiner *topology_refiner)
+{
+  if (topology_refiner == nullptr) {
+    return;
+  }
+  TopologyCache &cache = get_topology_cache();
+  std::lock_guard lock(cache.mutex);
+  const uint32_t hash = cache.hash_by_refiner.lookup(topology_refiner);
+  for (TopologyCacheEntry *entry : cache.entries_by_hash.lookup(hash)) {
+    if (entry->topology_refiner == topology_refiner) {
+      topology_cache_entry_remove_user(cache, hash, entry);
+      return;
+    }
+  }
+  BLI_assert_unreachable();
+}
+
+TopologyCacheStats topology_cache_stats_get()
+{
+  TopologyCache &cache = get_topology_cache();
+  std::lock_guard lock(cache.mutex);
+  TopologyCacheStats stats{};
+  stats.hits = cache.hits;
+  stats.misses = cache.misses;
+  for (const Span<TopologyCacheEntry *> entries : cache.entries_by_hash.values()) {
+    for (const TopologyCacheEntry *entry : entries) {
+      if (entry->topology_refiner != nullptr) {
+        stats.refiners_num++;
+        stats.users_num += entry->users;
+      }
+    }
+  }
+  return stats;
+}
+
 }  // namespace blender::bke::subdiv
@@ -9,6 +9,7 @@
 #include "BLI_mmap.h"
 #include "BLI_fileops.h"
 #include "BLI_listbase.h"
+#include "BLI_threads.h"
 #include "MEM_guardedalloc.h"
 
 #include <string.h>
@@ -58,6 +59,10 @@ static struct error_handler_data {
   void (*next_handler)(int, siginfo_t *, void *);
 } error_handler = {0};
 
+/* Protects the handler setup and the list of mapped files, files may be mapped from multiple
+ * threads at once. */
+static ThreadMutex error_handler_mutex = BLI_MUTEX_INITIALIZER;
+
 static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 {
   /* We only handle SIGBUS here for now. */
@@ -96,6 +101,7 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 /* Ensures that the error handler is set up and ready. */
 static bool sigbus_handler_setup(void)
 {
+  BLI_mutex_lock(&error_handler_mutex);
   if (!error_handler.configured) {
     struct sigaction newact = {0}, oldact = {0};
 
@@ -103,6 +109,7 @@ static bool sigbus_handler_setup(void)
     newact.sa_flags = SA_SIGINFO;
 
     if (sigaction(SIGBUS, &newact, &oldact)) {
+      BLI_mutex_unlock(&error_handler_mutex);
       return false;
     }
 
@@ -111,6 +118,7 @@ static bool sigbus_handler_setup(void)
     error_handler.next_handler = oldact.sa_sigaction;
     error_handler.configured = 1;
   }
+  BLI_mutex_unlock(&error_handler_mutex);
 
   return true;
 }
@@ -118,14 +126,18 @@ static bool sigbus_handler_setup(void)
 /* Adds a file to the list that the error handler checks. */
 static void sigbus_handler_add(BLI_mmap_file *file)
 {
+  BLI_mutex_lock(&error_handler_mutex);
   BLI_addtail(&error_handler.open_mmaps, BLI_genericNodeN(file));
+  BLI_mutex_unlock(&error_handler_mutex);
 }
 
 /* Removes a file from the list that the error handler checks. */
 static void sigbus_handler_remove(BLI_mmap_file *file)
 {
+  BLI_mutex_lock(&error_handler_mutex);
   LinkData *link = BLI_findptr(&error_handler.open_mmaps, file, offsetof(LinkData, data));
   BLI_freelinkN(&error_handler.open_mmaps, link);
+  BLI_mutex_unlock(&error_handler_mutex);
 }
 #endif
 
@@ -1047,6 +1047,14 @@ void blo_do_versions_userdef(UserDef *userdef)
     }
   }
 
+  if (!USER_VERSION_ATLEAST(403, 17)) {
+    userdef->compositor_cache_limit = 1024;
+  }
+
+  if (!USER_VERSION_ATLEAST(403, 18)) {
+    userdef->compositor_streaming_limit = 256;
+  }
+
   /**
    * Always bump subversion in BKE_blender_version.h when adding versioning
    * code here, and wrap it inside a USER_VERSION_ATLEAST check.
@@ -33,6 +33,8 @@
 
 #include "BLI_strict_flags.h" /* Keep last. */
 
+using blender::Span;
+
 struct BMLogEntry {
   BMLogEntry *next, *prev;
 
@@ -464,7 +466,7 @@ static void bm_log_id_ghash_release(BMLog *log, GHash *id_ghash)
 
 /***************************** Public API *****************************/
 
-BMLog *BM_log_create(BMesh *bm)
+static BMLog *bm_log_alloc(BMesh *bm)
 {
   BMLog *log = static_cast<BMLog *>(MEM_callocN(sizeof(*log), __func__));
   const uint reserve_num = uint(bm->totvert + bm->totface);
@@ -473,12 +475,45 @@ BMLog *BM_log_create(BMesh *bm)
   log->id_to_elem = BLI_ghash_new_ex(logkey_hash, logkey_cmp, __func__, reserve_num);
   log->elem_to_id = BLI_ghash_ptr_new_ex(__func__, reserve_num);
 
+  return log;
+}
+
+BMLog *BM_log_create(BMesh *bm)
+{
+  BMLog *log = bm_log_alloc(bm);
+
   /* Assign IDs to all existing vertices and faces */
   bm_log_assign_ids(bm, log);
 
   return log;
 }
 
+BMLog *BM_log_create(BMesh *bm, const Span<int> vert_indices, const Span<int> face_indices)
+{
+  BLI_assert(vert_indices.size() == bm->totvert);
+  BLI_assert(face_indices.size() == bm->totface);
+  BMLog *log = bm_log_alloc(bm);
+
+  BMIter iter;
+  BMVert *v;
+  BMFace *f;
+  int i;
+
+  BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+    const uint id = uint(vert_indices[i]);
+    range_tree_uint_take(log->unused_ids, id);
+    bm_log_vert_id_set(log, v, id);
+  }
+
+  BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
+    const uint id = uint(bm->totvert + face_indices[i]);
+    range_tree_uint_take(log->unused_ids, id);
+    bm_log_face_id_set(log, f, id);
+  }
+
+  return log;
+}
+
 void BM_log_cleanup_entry(BMLogEntry *entry)
 {
   BMLog *log = entry->log;
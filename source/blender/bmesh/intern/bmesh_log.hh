@@ -8,6 +8,8 @@
  * \ingroup bmesh
  */
 
+#include "BLI_span.hh"
+
 struct BMFace;
 struct BMVert;
 struct BMesh;
@@ -19,6 +21,13 @@ struct BMLogEntry;
  * Allocate, initialize, and assign a new BMLog.
  */
 BMLog *BM_log_create(BMesh *bm);
+/**
+ * Like #BM_log_create, but order the IDs of vertices and faces by the given indices instead of by
+ * the current order of the elements. That is the order #BM_log_mesh_elems_reorder gives them.
+ *
+ * \param vert_indices, face_indices: A unique index for every vertex and face.
+ */
+BMLog *BM_log_create(BMesh *bm, blender::Span<int> vert_indices, blender::Span<int> face_indices);
 
 /**
  * Allocate and initialize a new #BMLog using existing #BMLogEntries
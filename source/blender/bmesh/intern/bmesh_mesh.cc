@@ -25,6 +25,7 @@
 using blender::Array;
 using blender::float3;
 using blender::MutableSpan;
+using blender::Span;
 
 const BMAllocTemplate bm_mesh_allocsize_default = {512, 1024, 2048, 512};
 const BMAllocTemplate bm_mesh_chunksize_default = {512, 1024, 2048, 512};
@@ -1039,15 +1040,29 @@ void BM_mesh_remap(BMesh *bm, const uint *vert_idx, const uint *edge_idx, const
   }
 }
 
-void BM_mesh_rebuild(BMesh *bm,
-                     const BMeshCreateParams *params,
-                     BLI_mempool *vpool_dst,
-                     BLI_mempool *epool_dst,
-                     BLI_mempool *lpool_dst,
-                     BLI_mempool *fpool_dst)
+/**
+ * \param vert_order, edge_order, face_order: Optional old index of the element at every new
+ * index. When empty, the elements keep their order.
+ */
+static void bm_mesh_rebuild_ex(BMesh *bm,
+                               const BMeshCreateParams *params,
+                               BLI_mempool *vpool_dst,
+                               BLI_mempool *epool_dst,
+                               BLI_mempool *lpool_dst,
+                               BLI_mempool *fpool_dst,
+                               const Span<int> vert_order,
+                               const Span<int> edge_order,
+                               const Span<int> face_order)
 {
   const char remap = (vpool_dst ? BM_VERT : 0) | (epool_dst ? BM_EDGE : 0) |
                      (lpool_dst ? BM_LOOP : 0) | (fpool_dst ? BM_FACE : 0);
+  const char reorder = (vert_order.is_empty() ? 0 : BM_VERT) |
+                       (edge_order.is_empty() ? 0 : BM_EDGE) |
+                       (face_order.is_empty() ? 0 : BM_FACE);
+  BLI_assert((reorder & remap) == reorder);
+  BLI_assert(!(reorder & BM_FACE) || (remap & BM_LOOP));
+  /* Old elements are looked up by their index. */
+  BM_mesh_elem_table_ensure(bm, reorder);
 
   BMVert **vtable_dst = (remap & BM_VERT) ? static_cast<BMVert **>(MEM_mallocN(
                                                 sizeof(BMVert *) * bm->totvert, __func__)) :
@@ -1065,10 +1080,7 @@ void BM_mesh_rebuild(BMesh *bm,
   const bool use_toolflags = params->use_toolflags;
 
   if (remap & BM_VERT) {
-    BMIter iter;
-    int index;
-    BMVert *v_src;
-    BM_ITER_MESH_INDEX (v_src, &iter, bm, BM_VERTS_OF_MESH, index) {
+    const auto copy_vert = [&](BMVert *v_src, const int index) {
       BMVert *v_dst = static_cast<BMVert *>(BLI_mempool_alloc(vpool_dst));
       memcpy(v_dst, v_src, sizeof(BMVert));
       if (use_toolflags) {
@@ -1080,14 +1092,25 @@ void BM_mesh_rebuild(BMesh *bm,
 
       vtable_dst[index] = v_dst;
       BM_elem_index_set(v_src, index); /* set_ok */
+      BM_elem_index_set(v_dst, index); /* set_ok */
+    };
+    if (vert_order.is_empty()) {
+      BMIter iter;
+      int index;
+      BMVert *v_src;
+      BM_ITER_MESH_INDEX (v_src, &iter, bm, BM_VERTS_OF_MESH, index) {
+        copy_vert(v_src, index);
+      }
+    }
+    else {
+      for (const int index : vert_order.index_range()) {
+        copy_vert(bm->vtable[vert_order[index]], index);
+      }
     }
   }
 
   if (remap & BM_EDGE) {
-    BMIter iter;
-    int index;
-    BMEdge *e_src;
-    BM_ITER_MESH_INDEX (e_src, &iter, bm, BM_EDGES_OF_MESH, index) {
+    const auto copy_edge = [&](BMEdge *e_src, const int index) {
       BMEdge *e_dst = static_cast<BMEdge *>(BLI_mempool_alloc(epool_dst));
       memcpy(e_dst, e_src, sizeof(BMEdge));
       if (use_toolflags) {
@@ -1099,15 +1122,26 @@ void BM_mesh_rebuild(BMesh *bm,
 
       etable_dst[index] = e_dst;
       BM_elem_index_set(e_src, index); /* set_ok */
+      BM_elem_index_set(e_dst, index); /* set_ok */
+    };
+    if (edge_order.is_empty()) {
+      BMIter iter;
+      int index;
+      BMEdge *e_src;
+      BM_ITER_MESH_INDEX (e_src, &iter, bm, BM_EDGES_OF_MESH, index) {
+        copy_edge(e_src, index);
+      }
+    }
+    else {
+      for (const int index : edge_order.index_range()) {
+        copy_edge(bm->etable[edge_order[index]], index);
+      }
     }
   }
 
   if (remap & (BM_LOOP | BM_FACE)) {
-    BMIter iter;
-    int index, index_loop = 0;
-    BMFace *f_src;
-    BM_ITER_MESH_INDEX (f_src, &iter, bm, BM_FACES_OF_MESH, index) {
-
+    int index_loop = 0;
+    const auto copy_face = [&](BMFace *f_src, const int index) {
       if (remap & BM_FACE) {
         BMFace *f_dst = static_cast<BMFace *>(BLI_mempool_alloc(fpool_dst));
         memcpy(f_dst, f_src, sizeof(BMFace));
@@ -1120,6 +1154,7 @@ void BM_mesh_rebuild(BMesh *bm,
 
         ftable_dst[index] = f_dst;
         BM_elem_index_set(f_src, index); /* set_ok */
+        BM_elem_index_set(f_dst, index); /* set_ok */
       }
 
       /* handle loops */
@@ -1130,9 +1165,24 @@ void BM_mesh_rebuild(BMesh *bm,
           BMLoop *l_dst = static_cast<BMLoop *>(BLI_mempool_alloc(lpool_dst));
           memcpy(l_dst, l_iter_src, sizeof(BMLoop));
           ltable_dst[index_loop] = l_dst;
-          BM_elem_index_set(l_iter_src, index_loop++); /* set_ok */
+          BM_elem_index_set(l_iter_src, index_loop); /* set_ok */
+          BM_elem_index_set(l_dst, index_loop); /* set_ok */
+          index_loop++;
         } while ((l_iter_src = l_iter_src->next) != l_first_src);
       }
+    };
+    if (face_order.is_empty()) {
+      BMIter iter;
+      int index;
+      BMFace *f_src;
+      BM_ITER_MESH_INDEX (f_src, &iter, bm, BM_FACES_OF_MESH, index) {
+        copy_face(f_src, index);
+      }
+    }
+    else {
+      for (const int index : face_order.index_range()) {
+        copy_face(bm->ftable[face_order[index]], index);
+      }
     }
   }
 
@@ -1295,6 +1345,44 @@ void BM_mesh_rebuild(BMesh *bm,
     BLI_mempool_destroy(bm->fpool);
     bm->fpool = fpool_dst;
   }
+
+  /* Indices of all rebuilt elements were set above. */
+  bm->elem_index_dirty &= ~remap;
+}
+
+void BM_mesh_rebuild(BMesh *bm,
+                     const BMeshCreateParams *params,
+                     BLI_mempool *vpool_dst,
+                     BLI_mempool *epool_dst,
+                     BLI_mempool *lpool_dst,
+                     BLI_mempool *fpool_dst)
+{
+  bm_mesh_rebuild_ex(bm, params, vpool_dst, epool_dst, lpool_dst, fpool_dst, {}, {}, {});
+}
+
+void BM_mesh_rebuild_in_order(BMesh *bm,
+                              const Span<int> vert_order,
+                              const Span<int> edge_order,
+                              const Span<int> face_order)
+{
+  BLI_assert(!bm->use_toolflags);
+  BLI_assert(vert_order.is_empty() || vert_order.size() == bm->totvert);
+  BLI_assert(edge_order.is_empty() || edge_order.size() == bm->totedge);
+  BLI_assert(face_order.is_empty() || face_order.size() == bm->totface);
+
+  const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_BM(bm);
+
+  BLI_mempool *vpool_dst = nullptr;
+  BLI_mempool *epool_dst = nullptr;
+  BLI_mempool *lpool_dst = nullptr;
+  BLI_mempool *fpool_dst = nullptr;
+  /* Fixing up pointers between elements relies on all element types being rebuilt. */
+  bm_mempool_init_ex(&allocsize, false, &vpool_dst, &epool_dst, &lpool_dst, &fpool_dst);
+
+  BMeshCreateParams params = {};
+  params.use_toolflags = false;
+  bm_mesh_rebuild_ex(
+      bm, &params, vpool_dst, epool_dst, lpool_dst, fpool_dst, vert_order, edge_order, face_order);
 }
 
 void BM_mesh_toolflags_set(BMesh *bm, bool use_toolflags)
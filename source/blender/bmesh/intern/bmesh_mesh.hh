@@ -171,6 +171,22 @@ void BM_mesh_rebuild(BMesh *bm,
                      BLI_mempool *lpool,
                      BLI_mempool *fpool);
 
+/**
+ * Move elements into new memory pools in the given order, so that both their iteration order and
+ * their layout in memory follow it. Unlike #BM_mesh_remap, this doesn't need pointer maps.
+ *
+ * \param vert_order, edge_order, face_order: The old index of the element at every new index.
+ * Elements of types with an empty order keep their order, but are still moved into the new pools.
+ * Loops are stored in the order of their faces.
+ *
+ * \note Meshes with tool flags are not supported.
+ * \warning Pointers to all moved elements are invalidated.
+ */
+void BM_mesh_rebuild_in_order(BMesh *bm,
+                              blender::Span<int> vert_order,
+                              blender::Span<int> edge_order,
+                              blender::Span<int> face_order);
+
 struct BMAllocTemplate {
   int totvert, totedge, totloop, totface;
 };
@@ -42,3 +42,63 @@ TEST(bmesh_core, BMVertCreate)
   EXPECT_EQ(BM_mesh_elem_count(bm, BM_VERT), 3);
   BM_mesh_free(bm);
 }
+
+TEST(bmesh_core, BMMeshRebuildInOrder)
+{
+  BMeshCreateParams bmesh_create_params{};
+  bmesh_create_params.use_toolflags = false;
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bmesh_create_params);
+
+  /* Two quads next to each other. */
+  const float co[6][3] = {{0, 0, 0}, {1, 0, 0}, {2, 0, 0}, {0, 1, 0}, {1, 1, 0}, {2, 1, 0}};
+  BMVert *verts[6];
+  for (int i = 0; i < 6; i++) {
+    verts[i] = BM_vert_create(bm, co[i], nullptr, BM_CREATE_NOP);
+  }
+  BMVert *quad_a[4] = {verts[0], verts[1], verts[4], verts[3]};
+  BMVert *quad_b[4] = {verts[1], verts[2], verts[5], verts[4]};
+  BM_face_create_verts(bm, quad_a, 4, nullptr, BM_CREATE_NOP, true);
+  BMFace *face_b = BM_face_create_verts(bm, quad_b, 4, nullptr, BM_CREATE_NOP, true);
+  face_b->mat_nr = 1;
+
+  const int vert_order[6] = {5, 2, 4, 1, 3, 0};
+  const int face_order[2] = {1, 0};
+  BM_mesh_rebuild_in_order(bm,
+                           blender::Span<int>(vert_order, 6),
+                           blender::Span<int>(),
+                           blender::Span<int>(face_order, 2));
+
+  EXPECT_TRUE(BM_mesh_validate(bm));
+  EXPECT_EQ(bm->totvert, 6);
+  EXPECT_EQ(bm->totedge, 7);
+  EXPECT_EQ(bm->totface, 2);
+
+  BMIter iter;
+  BMVert *v;
+  int i;
+  BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+    EXPECT_EQ(BM_elem_index_get(v), i);
+    EXPECT_TRUE(equals_v3v3(v->co, co[vert_order[i]]));
+  }
+
+  /* The second quad comes first now, and still uses the vertices on its side. */
+  BMFace *f;
+  BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
+    EXPECT_EQ(BM_elem_index_get(f), i);
+    EXPECT_EQ(f->len, 4);
+    EXPECT_EQ(f->mat_nr, i == 0 ? 1 : 0);
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      EXPECT_EQ(l_iter->f, f);
+      if (i == 0) {
+        EXPECT_GE(l_iter->v->co[0], 1.0f);
+      }
+      else {
+        EXPECT_LE(l_iter->v->co[0], 1.0f);
+      }
+    } while ((l_iter = l_iter->next) != l_first);
+  }
+
+  BM_mesh_free(bm);
+}
@@ -113,5 +113,8 @@ void COM_deinitialize();
 /**
  * \brief Clear all compositor caches. (Compositor system will still remain available).
  * To deinitialize the compositor use the COM_deinitialize method.
+ *
+ * Called when loading a file and when a compositing node tree is freed, so cached results do
+ * not stay in memory after the node tree they were computed for is gone.
  */
-// void COM_clear_caches(); // NOT YET WRITTEN
+void COM_clear_caches();
@@ -0,0 +1,186 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <complex>
+
+#if defined(WITH_FFTW3)
+#  include <fftw3.h>
+#endif
+
+#include "BLI_fftw.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rect.h"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+#include "BLI_utildefines.h"
+
+#include "COM_FFTConvolutionAlgorithm.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor {
+
+bool is_fft_convolution_supported()
+{
+#if defined(WITH_FFTW3)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void fft_convolve(const MemoryBuffer &input,
+                  MemoryBuffer &output,
+                  const rcti &area,
+                  const Span<float4> kernel,
+                  const int radius)
+{
+#if defined(WITH_FFTW3)
+  fftw::initialize_float();
+
+  const int kernel_size = radius * 2 + 1;
+  BLI_assert(kernel.size() == int64_t(kernel_size) * kernel_size);
+
+  /* The area is padded by the kernel radius on all sides, such that the circular convolution
+   * never wraps around for pixels inside the area. The padding is filled with the clamped input,
+   * which is exactly what a direct convolution reading clamped pixels sees. */
+  const int2 area_size = int2(BLI_rcti_size_x(&area), BLI_rcti_size_y(&area));
+  const int2 padded_lower_bound = int2(area.xmin, area.ymin) - radius;
+  const int2 needed_spatial_size = area_size + radius * 2;
+  const int2 spatial_size = fftw::optimal_size_for_real_transform(needed_spatial_size);
+
+  /* See Section 4.3.4 Real-data DFT Array Format in the FFTW manual, only half of the first
+   * dimension is stored since the other half is redundant. */
+  const int2 frequency_size = int2(spatial_size.x / 2 + 1, spatial_size.y);
+
+  const int channels_count = 4;
+  const int64_t spatial_pixels_per_channel = int64_t(spatial_size.x) * spatial_size.y;
+  const int64_t frequency_pixels_per_channel = int64_t(frequency_size.x) * frequency_size.y;
+  const int64_t spatial_pixels_count = spatial_pixels_per_channel * channels_count;
+  const int64_t frequency_pixels_count = frequency_pixels_per_channel * channels_count;
+
+  float *image_spatial_domain = fftwf_alloc_real(spatial_pixels_count);
+  std::complex<float> *image_frequency_domain = reinterpret_cast<std::complex<float> *>(
+      fftwf_alloc_complex(frequency_pixels_count));
+  float *kernel_spatial_domain = fftwf_alloc_real(spatial_pixels_count);
+  std::complex<float> *kernel_frequency_domain = reinterpret_cast<std::complex<float> *>(
+      fftwf_alloc_complex(frequency_pixels_count));
+
+  /* The same plans are used for the image and the kernel as well as all channels, since they all
+   * have the same dimensions. */
+  fftwf_plan forward_plan = fftwf_plan_dft_r2c_2d(
+      spatial_size.y,
+      spatial_size.x,
+      image_spatial_domain,
+      reinterpret_cast<fftwf_complex *>(image_frequency_domain),
+      FFTW_ESTIMATE);
+  fftwf_plan backward_plan = fftwf_plan_dft_c2r_2d(
+      spatial_size.y,
+      spatial_size.x,
+      reinterpret_cast<fftwf_complex *>(image_frequency_domain),
+      image_spatial_domain,
+      FFTW_ESTIMATE);
+
+  /* Store the padded image and the kernel in planar format for better cache locality, that is,
+   * RRRR...GGGG...BBBB...AAAA. The kernel is flipped and wrapped around such that its center is at
+   * the zero point, since the kernel weights the pixels at positive offsets while a convolution
+   * weights the pixels at negative offsets. */
+  const int input_channels_count = input.get_num_channels();
+  threading::parallel_for(IndexRange(spatial_size.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(spatial_size.x)) {
+        const int64_t base_index = x + y * spatial_size.x;
+        const bool is_inside_padded_area = x < needed_spatial_size.x &&
+                                           y < needed_spatial_size.y;
+        const float *color = input.get_elem_clamped(padded_lower_bound.x + x,
+                                                    padded_lower_bound.y + y);
+
+        /* The offset represented by this element, where the last elements wrap around to the
+         * negative offsets. */
+        const int64_t offset_x = x >= spatial_size.x - radius ? x - spatial_size.x : x;
+        const int64_t offset_y = y >= spatial_size.y - radius ? y - spatial_size.y : y;
+        const int64_t kernel_x = radius - offset_x;
+        const int64_t kernel_y = radius - offset_y;
+        const bool is_inside_kernel = kernel_x >= 0 && kernel_y >= 0;
+
+        for (const int64_t channel : IndexRange(channels_count)) {
+          const int64_t index = base_index + spatial_pixels_per_channel * channel;
+          image_spatial_domain[index] = is_inside_padded_area &&
+                                                channel < input_channels_count ?
+                                            color[channel] :
+                                            0.0f;
+          kernel_spatial_domain[index] = is_inside_kernel ?
+                                             kernel[kernel_x + kernel_y * kernel_size][channel] :
+                                             0.0f;
+        }
+      }
+    }
+  });
+
+  threading::parallel_for(IndexRange(channels_count), 1, [&](const IndexRange sub_range) {
+    for (const int64_t channel : sub_range) {
+      fftwf_execute_dft_r2c(forward_plan,
+                            image_spatial_domain + spatial_pixels_per_channel * channel,
+                            reinterpret_cast<fftwf_complex *>(image_frequency_domain) +
+                                frequency_pixels_per_channel * channel);
+      fftwf_execute_dft_r2c(forward_plan,
+                            kernel_spatial_domain + spatial_pixels_per_channel * channel,
+                            reinterpret_cast<fftwf_complex *>(kernel_frequency_domain) +
+                                frequency_pixels_per_channel * channel);
+    }
+  });
+
+  /* Multiply the kernel and the image in the frequency domain to perform the convolution. The FFT
+   * is not normalized, so the result is scaled by the product of the width and height, which is
+   * divided out here. See Section 4.8.6 Multi-dimensional Transforms of the FFTW manual. */
+  const float normalization_scale = float(spatial_size.x) * spatial_size.y;
+  threading::parallel_for(IndexRange(frequency_size.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t channel : IndexRange(channels_count)) {
+      for (const int64_t y : sub_y_range) {
+        for (const int64_t x : IndexRange(frequency_size.x)) {
+          const int64_t index = x + y * frequency_size.x + frequency_pixels_per_channel * channel;
+          image_frequency_domain[index] *= kernel_frequency_domain[index] / normalization_scale;
+        }
+      }
+    }
+  });
+
+  threading::parallel_for(IndexRange(channels_count), 1, [&](const IndexRange sub_range) {
+    for (const int64_t channel : sub_range) {
+      fftwf_execute_dft_c2r(backward_plan,
+                            reinterpret_cast<fftwf_complex *>(image_frequency_domain) +
+                                frequency_pixels_per_channel * channel,
+                            image_spatial_domain + spatial_pixels_per_channel * channel);
+    }
+  });
+
+  /* Copy the area to the output, skipping the padding. */
+  const int output_channels_count = math::min(output.get_num_channels(), channels_count);
+  threading::parallel_for(IndexRange(area_size.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(area_size.x)) {
+        float *output_color = output.get_elem(area.xmin + x, area.ymin + y);
+        const int64_t base_index = (x + radius) + (y + radius) * spatial_size.x;
+        for (const int64_t channel : IndexRange(output_channels_count)) {
+          output_color[channel] =
+              image_spatial_domain[base_index + spatial_pixels_per_channel * channel];
+        }
+      }
+    }
+  });
+
+  fftwf_destroy_plan(forward_plan);
+  fftwf_destroy_plan(backward_plan);
+  fftwf_free(image_spatial_domain);
+  fftwf_free(image_frequency_domain);
+  fftwf_free(kernel_spatial_domain);
+  fftwf_free(kernel_frequency_domain);
+#else
+  UNUSED_VARS(input, output, area, kernel, radius);
+  BLI_assert_unreachable();
+#endif
+}
+
+}  // namespace blender::compositor
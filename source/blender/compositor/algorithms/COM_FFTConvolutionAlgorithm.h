@@ -0,0 +1,33 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
+
+#include "DNA_vec_types.h"
+
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor {
+
+/* Returns true if the compositor was built with FFTW, which is needed for fft_convolve. */
+bool is_fft_convolution_supported();
+
+/* Convolve the given area of the input with the given kernel in the frequency domain, writing the
+ * result to the same area of the output. The cost per pixel only grows logarithmically with the
+ * kernel size, which is why this is used for large fixed kernels.
+ *
+ * The kernel is square with a size of (2 * radius + 1), where the element at index (x + y * size)
+ * stores the per-channel weight of the input pixel at an offset of (x - radius, y - radius) from
+ * the output pixel. The kernel is used as is, so it should be normalized by the caller. Pixels
+ * outside of the input are clamped to its border, just like MemoryBuffer::get_elem_clamped. */
+void fft_convolve(const MemoryBuffer &input,
+                  MemoryBuffer &output,
+                  const rcti &area,
+                  Span<float4> kernel,
+                  int radius);
+
+}  // namespace blender::compositor
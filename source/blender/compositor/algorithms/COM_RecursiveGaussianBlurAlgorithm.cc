@@ -0,0 +1,231 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+
+#include "BLI_array.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rect.h"
+#include "BLI_span.hh"
+#include "BLI_task.hh"
+
+#include "COM_deriche_gaussian_coefficients.hh"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_RecursiveGaussianBlurAlgorithm.h"
+
+namespace blender::compositor {
+
+using realtime_compositor::DericheGaussianCoefficients;
+
+/* Filter the given line using the causal and non causal filters of Equations (28) and (29) in
+ * Deriche's paper, and write the sum of both filters to the output. Values beyond the ends of the
+ * line are assumed to be zero, so the previous inputs and outputs of both filters start as zero.
+ * Filtering happens in double precision, since the feedback makes the filter sensitive to
+ * rounding errors for large sigma values. */
+static void deriche_filter_line(const DericheGaussianCoefficients &coefficients,
+                                Span<float4> input,
+                                MutableSpan<float4> output)
+{
+  const double4 &feedback = coefficients.feedback_coefficients();
+  const double4 &causal_feedforward = coefficients.causal_feedforward_coefficients();
+  const double4 &non_causal_feedforward = coefficients.non_causal_feedforward_coefficients();
+
+  /* The current and last three inputs and the last four outputs, the most recent first. */
+  double4 inputs[4] = {double4(0.0), double4(0.0), double4(0.0), double4(0.0)};
+  double4 outputs[4] = {double4(0.0), double4(0.0), double4(0.0), double4(0.0)};
+
+  for (const int64_t i : input.index_range()) {
+    inputs[3] = inputs[2];
+    inputs[2] = inputs[1];
+    inputs[1] = inputs[0];
+    inputs[0] = double4(input[i]);
+
+    double4 value = double4(0.0);
+    for (const int j : IndexRange(4)) {
+      value += causal_feedforward[j] * inputs[j] - feedback[j] * outputs[j];
+    }
+
+    outputs[3] = outputs[2];
+    outputs[2] = outputs[1];
+    outputs[1] = outputs[0];
+    outputs[0] = value;
+    output[i] = float4(value);
+  }
+
+  /* The non causal filter ignores the current input, so the inputs are shifted after computing the
+   * output, and are thus the last four inputs. */
+  for (double4 &value : inputs) {
+    value = double4(0.0);
+  }
+  for (double4 &value : outputs) {
+    value = double4(0.0);
+  }
+
+  for (int64_t i = input.size() - 1; i >= 0; i--) {
+    double4 value = double4(0.0);
+    for (const int j : IndexRange(4)) {
+      value += non_causal_feedforward[j] * inputs[j] - feedback[j] * outputs[j];
+    }
+
+    inputs[3] = inputs[2];
+    inputs[2] = inputs[1];
+    inputs[1] = inputs[0];
+    inputs[0] = double4(input[i]);
+
+    outputs[3] = outputs[2];
+    outputs[2] = outputs[1];
+    outputs[1] = outputs[0];
+    outputs[0] = value;
+    output[i] += float4(value);
+  }
+}
+
+/* Compute the sum of the filter weights that fall inside the range of valid values for every
+ * element of a line of the given size, by filtering a line that is one inside the range and zero
+ * outside of it. */
+static Array<float> compute_normalization_weights(const DericheGaussianCoefficients &coefficients,
+                                                  const int size,
+                                                  const IndexRange valid_range)
+{
+  Array<float4> mask(size, float4(0.0f));
+  mask.as_mutable_span().slice(valid_range).fill(float4(1.0f));
+
+  Array<float4> filtered_mask(size);
+  deriche_filter_line(coefficients, mask, filtered_mask);
+
+  Array<float> weights(size);
+  for (const int64_t i : IndexRange(size)) {
+    weights[i] = filtered_mask[i].x;
+  }
+  return weights;
+}
+
+static float4 load_pixel(const MemoryBuffer &buffer, const int x, const int y)
+{
+  float4 pixel = float4(0.0f);
+  const float *elem = buffer.get_elem(x, y);
+  for (const int channel : IndexRange(buffer.get_num_channels())) {
+    pixel[channel] = elem[channel];
+  }
+  return pixel;
+}
+
+static void store_pixel(MemoryBuffer &buffer, const int x, const int y, const float4 &pixel)
+{
+  float *elem = buffer.get_elem(x, y);
+  for (const int channel : IndexRange(buffer.get_num_channels())) {
+    elem[channel] = pixel[channel];
+  }
+}
+
+void deriche_gaussian_blur(const MemoryBuffer &input,
+                           MemoryBuffer &output,
+                           const rcti &area,
+                           const float2 sigma)
+{
+  const rcti &input_rect = input.get_rect();
+
+  /* Lines are filtered over the union of the input and the output area, such that the filter sees
+   * all of the input and the result covers all of the output. Ranges below are relative to the
+   * lower left corner of that union. */
+  const int2 lower_bound = int2(std::min(input_rect.xmin, area.xmin),
+                                std::min(input_rect.ymin, area.ymin));
+  const int2 upper_bound = int2(std::max(input_rect.xmax, area.xmax),
+                                std::max(input_rect.ymax, area.ymax));
+  const int2 size = upper_bound - lower_bound;
+  const IndexRange input_x_range = IndexRange(input_rect.xmin - lower_bound.x,
+                                              BLI_rcti_size_x(&input_rect));
+  const IndexRange input_y_range = IndexRange(input_rect.ymin - lower_bound.y,
+                                              BLI_rcti_size_y(&input_rect));
+  const int2 output_offset = int2(area.xmin, area.ymin) - lower_bound;
+
+  /* The horizontally blurred rows of the input, only for the columns of the output. */
+  const int output_width = BLI_rcti_size_x(&area);
+  Array<float4> horizontal_pass(int64_t(output_width) * input_y_range.size());
+
+  if (sigma.x > 0.0f) {
+    const DericheGaussianCoefficients coefficients(sigma.x);
+    const Array<float> weights = compute_normalization_weights(
+        coefficients, size.x, input_x_range);
+
+    threading::parallel_for(input_y_range, 1, [&](const IndexRange sub_y_range) {
+      Array<float4> line(size.x, float4(0.0f));
+      Array<float4> filtered_line(size.x);
+      for (const int64_t y : sub_y_range) {
+        for (const int64_t x : input_x_range) {
+          line[x] = load_pixel(input, lower_bound.x + x, lower_bound.y + y);
+        }
+        deriche_filter_line(coefficients, line, filtered_line);
+
+        float4 *row = &horizontal_pass[(y - input_y_range.start()) * output_width];
+        for (const int64_t x : IndexRange(output_width)) {
+          const int64_t index = output_offset.x + x;
+          row[x] = math::safe_divide(filtered_line[index], float4(weights[index]));
+        }
+      }
+    });
+  }
+  else {
+    threading::parallel_for(input_y_range, 1, [&](const IndexRange sub_y_range) {
+      for (const int64_t y : sub_y_range) {
+        float4 *row = &horizontal_pass[(y - input_y_range.start()) * output_width];
+        for (const int64_t x : IndexRange(output_width)) {
+          const int64_t index = output_offset.x + x;
+          row[x] = input_x_range.contains(index) ?
+                       load_pixel(input, lower_bound.x + index, lower_bound.y + y) :
+                       float4(0.0f);
+        }
+      }
+    });
+  }
+
+  const auto horizontal_pass_pixel = [&](const int64_t x, const int64_t y) -> const float4 & {
+    return horizontal_pass[(y - input_y_range.start()) * output_width + x];
+  };
+
+  const int output_height = BLI_rcti_size_y(&area);
+  if (sigma.y > 0.0f) {
+    const DericheGaussianCoefficients coefficients(sigma.y);
+    const Array<float> weights = compute_normalization_weights(
+        coefficients, size.y, input_y_range);
+
+    threading::parallel_for(IndexRange(output_width), 1, [&](const IndexRange sub_x_range) {
+      Array<float4> line(size.y, float4(0.0f));
+      Array<float4> filtered_line(size.y);
+      for (const int64_t x : sub_x_range) {
+        for (const int64_t y : input_y_range) {
+          line[y] = horizontal_pass_pixel(x, y);
+        }
+        deriche_filter_line(coefficients, line, filtered_line);
+
+        for (const int64_t y : IndexRange(output_height)) {
+          const int64_t index = output_offset.y + y;
+          store_pixel(output,
+                      area.xmin + x,
+                      area.ymin + y,
+                      math::safe_divide(filtered_line[index], float4(weights[index])));
+        }
+      }
+    });
+  }
+  else {
+    threading::parallel_for(IndexRange(output_height), 1, [&](const IndexRange sub_y_range) {
+      for (const int64_t y : sub_y_range) {
+        const int64_t index = output_offset.y + y;
+        for (const int64_t x : IndexRange(output_width)) {
+          store_pixel(output,
+                      area.xmin + x,
+                      area.ymin + y,
+                      input_y_range.contains(index) ? horizontal_pass_pixel(x, index) :
+                                                      float4(0.0f));
+        }
+      }
+    });
+  }
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,29 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_math_vector_types.hh"
+
+#include "DNA_vec_types.h"
+
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor {
+
+/* Blur the input using a fourth order IIR filter approximating a Gaussian filter of the given
+ * sigma, designed using Deriche's method, see COM_deriche_gaussian_coefficients.hh. The cost per
+ * pixel is independent of sigma, which is why this is used for large blur radii, where sigma
+ * should be at least 3 for good accuracy.
+ *
+ * Only the given area of the output is written. Pixels outside of the input buffer do not
+ * contribute to the result and the weights of the pixels inside it are normalized, just like a
+ * direct convolution skipping pixels outside of the input does. A zero sigma along an axis skips
+ * the blur along that axis. */
+void deriche_gaussian_blur(const MemoryBuffer &input,
+                           MemoryBuffer &output,
+                           const rcti &area,
+                           float2 sigma);
+
+}  // namespace blender::compositor
@@ -25,7 +25,9 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
                                  bool rendering,
                                  const char *view_name,
                                  realtime_compositor::RenderContext *render_context,
-                                 realtime_compositor::Profiler *profiler)
+                                 realtime_compositor::Profiler *profiler,
+                                 OperationResultCache *result_cache,
+                                 const int64_t streaming_memory_limit)
 {
   num_work_threads_ = WorkScheduler::get_num_cpu_threads();
   context_.set_render_context(render_context);
@@ -46,7 +48,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
     builder.convert_to_operations(this);
   }
 
-  execution_model_ = new FullFrameExecutionModel(context_, active_buffers_, operations_);
+  execution_model_ = new FullFrameExecutionModel(
+      context_, active_buffers_, result_cache, streaming_memory_limit, operations_);
 }
 
 ExecutionSystem::~ExecutionSystem()
@@ -86,6 +86,7 @@ namespace blender::compositor {
 /* Forward declarations. */
 class ExecutionModel;
 class NodeOperation;
+class OperationResultCache;
 
 /**
  * \brief the ExecutionSystem contains the whole compositor tree.
@@ -128,6 +129,9 @@ class ExecutionSystem {
    *
    * \param editingtree: [bNodeTree *]
    * \param rendering: [true false]
+   * \param result_cache: Operation results kept across executions, can be nullptr.
+   * \param streaming_memory_limit: Memory in bytes used by the intermediate results of chains of
+   * pixel operations before they are rendered in bands.
    */
   ExecutionSystem(RenderData *rd,
                   Scene *scene,
@@ -135,7 +139,9 @@ class ExecutionSystem {
                   bool rendering,
                   const char *view_name,
                   realtime_compositor::RenderContext *render_context,
-                  realtime_compositor::Profiler *profiler);
+                  realtime_compositor::Profiler *profiler,
+                  OperationResultCache *result_cache,
+                  int64_t streaming_memory_limit);
 
   /**
    * Destructor
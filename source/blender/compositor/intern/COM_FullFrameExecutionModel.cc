@@ -4,11 +4,17 @@
 
 #include "COM_FullFrameExecutionModel.h"
 
+#include <algorithm>
+#include <typeindex>
+#include <typeinfo>
+
 #include "BLI_string.h"
 
 #include "BLT_translation.hh"
 
+#include "COM_ConstantOperation.h"
 #include "COM_Debug.h"
+#include "COM_OperationResultCache.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
 
@@ -22,12 +28,27 @@
 
 namespace blender::compositor {
 
+/**
+ * Operations results are only cached when re-rendering them and their uncached inputs takes at
+ * least this long, in seconds. Avoids filling the cache with results of cheap operations.
+ */
+static constexpr double CACHE_MIN_RENDER_TIME = 0.05;
+
+/**
+ * Minimum number of rows of a band, so that there is enough work to split between threads.
+ */
+static constexpr int STREAMING_MIN_BAND_ROWS = 64;
+
 FullFrameExecutionModel::FullFrameExecutionModel(CompositorContext &context,
                                                  SharedOperationBuffers &shared_buffers,
+                                                 OperationResultCache *result_cache,
+                                                 const int64_t streaming_memory_limit,
                                                  Span<NodeOperation *> operations)
     : ExecutionModel(context, operations),
       active_buffers_(shared_buffers),
-      num_operations_finished_(0)
+      num_operations_finished_(0),
+      result_cache_(result_cache),
+      streaming_memory_limit_(streaming_memory_limit)
 {
   priorities_.append(eCompositorPriority::High);
   priorities_.append(eCompositorPriority::Medium);
@@ -42,8 +63,123 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   DebugInfo::graphviz(&exec_system, "compositor_prior_rendering");
 
+  WorkScheduler::start();
+  determine_cache_hits();
   determine_areas_to_render_and_reads();
+  determine_streamed_operations();
   render_operations();
+  WorkScheduler::stop();
+}
+
+void FullFrameExecutionModel::determine_cache_hits()
+{
+  /* Borders only render part of the operations, which results can't be reused. */
+  if (result_cache_ == nullptr || border_.use_render_border || border_.use_viewer_border) {
+    return;
+  }
+
+  result_cache_->begin_execution();
+
+  const bool is_rendering = context_.is_rendering();
+  const bNodeTree *node_tree = context_.get_bnodetree();
+  for (NodeOperation *op : operations_) {
+    op->set_bnodetree(node_tree);
+  }
+  for (NodeOperation *op : operations_) {
+    if (op->is_output_operation(is_rendering)) {
+      determine_cache_key(op);
+    }
+  }
+}
+
+std::shared_ptr<const OperationResultKey> FullFrameExecutionModel::determine_cache_key(
+    NodeOperation *op)
+{
+  if (const std::shared_ptr<const OperationResultKey> *key = cache_keys_.lookup_ptr(op)) {
+    return *key;
+  }
+
+  /* Keys of inputs are needed first, which also renders source operations. */
+  const int num_inputs = op->get_number_of_input_sockets();
+  Vector<std::shared_ptr<const OperationResultKey>> input_keys(num_inputs);
+  for (int i = 0; i < num_inputs; i++) {
+    input_keys[i] = determine_cache_key(op->get_input_operation(i));
+  }
+
+  std::shared_ptr<const OperationResultKey> key;
+  const bool has_size = op->get_width() > 0 && op->get_height() > 0;
+  if (op->get_number_of_output_sockets() > 0 && has_size) {
+    const rcti &canvas = op->get_canvas();
+    const DataType data_type = op->get_output_socket()->get_data_type();
+    const std::type_index operation_type = typeid(*op);
+    const auto make_key = [&](const Span<uint8_t> settings) {
+      return std::make_shared<const OperationResultKey>(
+          operation_type, data_type, canvas, Vector<uint8_t>(settings), input_keys);
+    };
+
+    if (op->get_flags().is_constant_operation) {
+      const float *elem = static_cast<ConstantOperation *>(op)->get_constant_elem();
+      const int num_channels = COM_data_type_num_channels(data_type);
+      key = make_key(Span<uint8_t>(reinterpret_cast<const uint8_t *>(elem),
+                                   num_channels * sizeof(float)));
+    }
+    else if (num_inputs == 0) {
+      /* Source operations read data which may change without any node setting changing, like
+       * render results or images. Identify them by their content instead. */
+      active_buffers_.register_area(op, canvas);
+      render_operation(op);
+      const MemoryBuffer *buf = active_buffers_.get_rendered_buffer(op);
+      const std::array<uint64_t, 2> content_hash = OperationResultCache::hash_buffer_content(
+          *buf);
+      key = make_key(Span<uint8_t>(reinterpret_cast<const uint8_t *>(content_hash.data()),
+                                   sizeof(content_hash)));
+    }
+    else if (op->get_node_instance_key() == bke::NODE_INSTANCE_KEY_NONE ||
+             op->get_node_settings())
+    {
+      /* Operations not created by a node are conversions only depending on their inputs and
+       * canvas. */
+      const bool has_input_keys = std::all_of(
+          input_keys.begin(),
+          input_keys.end(),
+          [](const std::shared_ptr<const OperationResultKey> &input_key) {
+            return input_key != nullptr;
+          });
+      if (has_input_keys) {
+        key = make_key(op->get_node_settings() ? op->get_node_settings()->as_span() :
+                                                 Span<uint8_t>());
+      }
+    }
+  }
+
+  cache_keys_.add(op, key);
+
+  if (key && num_inputs > 0 && !op->get_flags().is_constant_operation) {
+    if (std::shared_ptr<MemoryBuffer> buffer = result_cache_->lookup(*key)) {
+      cache_hits_.add(op, std::move(buffer));
+    }
+  }
+  return key;
+}
+
+bool FullFrameExecutionModel::should_cache_result(NodeOperation *op, const double render_time)
+{
+  double uncached_render_time = render_time;
+  const int num_inputs = op->get_number_of_input_sockets();
+  for (int i = 0; i < num_inputs; i++) {
+    uncached_render_time += uncached_render_times_.lookup_default(op->get_input_operation(i),
+                                                                  0.0);
+  }
+
+  const std::shared_ptr<const OperationResultKey> key = cache_keys_.lookup_default(op, nullptr);
+  const bNodeTree *node_tree = context_.get_bnodetree();
+  const bool should_cache = key && num_inputs > 0 && !op->get_flags().is_constant_operation &&
+                            uncached_render_time >= CACHE_MIN_RENDER_TIME &&
+                            active_buffers_.is_area_registered(op, op->get_canvas()) &&
+                            !node_tree->runtime->test_break(node_tree->runtime->tbh);
+
+  uncached_render_times_.add(op, should_cache ? 0.0 : uncached_render_time);
+  return should_cache;
 }
 
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
@@ -64,6 +200,36 @@ void FullFrameExecutionModel::determine_areas_to_render_and_reads()
   }
 }
 
+void FullFrameExecutionModel::determine_streamed_operations()
+{
+  for (NodeOperation *op : operations_) {
+    if (can_stream_operation(op)) {
+      streamed_operations_.add(op);
+    }
+  }
+}
+
+bool FullFrameExecutionModel::can_stream_operation(NodeOperation *op)
+{
+  const NodeOperationFlags flags = op->get_flags();
+  const bool has_size = op->get_width() > 0 && op->get_height() > 0;
+  if (!flags.is_pixel_operation || flags.is_constant_operation || !has_size ||
+      op->get_number_of_output_sockets() == 0 || cache_hits_.contains(op))
+  {
+    return false;
+  }
+
+  /* The reader renders the same areas as the operation, as pixel operations read the same area
+   * they render. */
+  const Vector<NodeOperation *> *readers = readers_.lookup_ptr(op);
+  if (readers == nullptr || readers->size() != 1) {
+    return false;
+  }
+  NodeOperation *reader = readers->first();
+  return reader->get_flags().is_pixel_operation && !cache_hits_.contains(reader) &&
+         BLI_rcti_compare(&reader->get_canvas(), &op->get_canvas());
+}
+
 Vector<MemoryBuffer *> FullFrameExecutionModel::get_input_buffers(NodeOperation *op,
                                                                   const int output_x,
                                                                   const int output_y)
@@ -72,6 +238,10 @@ Vector<MemoryBuffer *> FullFrameExecutionModel::get_input_buffers(NodeOperation
   Vector<MemoryBuffer *> inputs_buffers(num_inputs);
   for (int i = 0; i < num_inputs; i++) {
     NodeOperation *input = op->get_input_operation(i);
+    if (streamed_operations_.contains(input)) {
+      inputs_buffers[i] = nullptr;
+      continue;
+    }
     const int offset_x = (input->get_canvas().xmin - op->get_canvas().xmin) + output_x;
     const int offset_y = (input->get_canvas().ymin - op->get_canvas().ymin) + output_y;
     MemoryBuffer *buf = active_buffers_.get_rendered_buffer(input);
@@ -103,6 +273,26 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
   constexpr int output_x = 0;
   constexpr int output_y = 0;
 
+  if (const std::shared_ptr<MemoryBuffer> *cached_buf = cache_hits_.lookup_ptr(op)) {
+    MemoryBuffer &buf = **cached_buf;
+    active_buffers_.set_rendered_buffer(
+        op,
+        std::make_unique<MemoryBuffer>(
+            buf.get_buffer(), buf.get_num_channels(), buf.get_rect(), buf.is_a_single_elem()));
+    /* Inputs of cached operations have no reads registered. */
+    num_operations_finished_++;
+    update_progress_bar();
+    return;
+  }
+
+  const int num_inputs = op->get_number_of_input_sockets();
+  for (int i = 0; i < num_inputs; i++) {
+    if (streamed_operations_.contains(op->get_input_operation(i))) {
+      render_streamed_operations(op);
+      return;
+    }
+  }
+
   const timeit::TimePoint before_time = timeit::Clock::now();
 
   const bool has_outputs = op->get_number_of_output_sockets() > 0;
@@ -119,26 +309,165 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
       delete buf;
     }
   }
+  const timeit::TimePoint after_time = timeit::Clock::now();
+
   /* Even if operation has no resolution set the empty buffer. It will be clipped with a
    * TranslateOperation from convert resolutions if linked to an operation with resolution. */
-  active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
+  set_operation_buffer(
+      op, op_buf, std::chrono::duration<double>(after_time - before_time).count());
 
   operation_finished(op);
 
   /* The operation may not come from any node. For example, it may have been added to convert data
    * type. Do not accumulate time from its execution. */
-  const timeit::TimePoint after_time = timeit::Clock::now();
   const bNodeInstanceKey node_instance_key = op->get_node_instance_key();
   if (context_.get_profiler() && node_instance_key != bke::NODE_INSTANCE_KEY_NONE) {
     context_.get_profiler()->set_node_evaluation_time(node_instance_key, after_time - before_time);
   }
 }
 
+void FullFrameExecutionModel::get_streamed_inputs(NodeOperation *op,
+                                                  Vector<NodeOperation *> &r_streamed_ops)
+{
+  const int num_inputs = op->get_number_of_input_sockets();
+  for (int i = 0; i < num_inputs; i++) {
+    NodeOperation *input = op->get_input_operation(i);
+    if (streamed_operations_.contains(input)) {
+      get_streamed_inputs(input, r_streamed_ops);
+      r_streamed_ops.append(input);
+    }
+  }
+}
+
+void FullFrameExecutionModel::render_streamed_operations(NodeOperation *output_op)
+{
+  /* Output has no offset for easier image algorithms implementation on operations. */
+  constexpr int output_x = 0;
+  constexpr int output_y = 0;
+
+  /* All operations of the chain have the same canvas, so they share the same coordinates. */
+  Vector<NodeOperation *> chain;
+  get_streamed_inputs(output_op, chain);
+  chain.append(output_op);
+  const Span<NodeOperation *> streamed_ops = chain.as_span().drop_back(1);
+
+  const timeit::TimePoint before_time = timeit::Clock::now();
+  Map<NodeOperation *, timeit::Nanoseconds> render_times;
+
+  MemoryBuffer *op_buf = create_operation_buffer(output_op, output_x, output_y);
+  Map<NodeOperation *, Vector<MemoryBuffer *>> input_bufs;
+  for (NodeOperation *op : chain) {
+    input_bufs.add(op, get_input_buffers(op, output_x, output_y));
+    render_times.add(op, timeit::Nanoseconds(0));
+    op->init_execution();
+  }
+
+  const int op_offset_x = output_x - output_op->get_canvas().xmin;
+  const int op_offset_y = output_y - output_op->get_canvas().ymin;
+  for (const rcti &area : active_buffers_.get_areas_to_render(output_op, op_offset_x, op_offset_y))
+  {
+    if (BLI_rcti_is_empty(&area)) {
+      continue;
+    }
+
+    int64_t row_size = 0;
+    for (NodeOperation *op : streamed_ops) {
+      const DataType data_type = op->get_output_socket()->get_data_type();
+      row_size += int64_t(BLI_rcti_size_x(&area)) * COM_data_type_bytes_len(data_type);
+    }
+    const int band_height = int(std::min(int64_t(BLI_rcti_size_y(&area)),
+                                         std::max(int64_t(STREAMING_MIN_BAND_ROWS),
+                                                  streaming_memory_limit_ / row_size)));
+
+    for (int band_ymin = area.ymin; band_ymin < area.ymax; band_ymin += band_height) {
+      rcti band;
+      BLI_rcti_init(
+          &band, area.xmin, area.xmax, band_ymin, std::min(band_ymin + band_height, area.ymax));
+
+      /* Intermediate results are freed once the band is rendered. */
+      Map<NodeOperation *, std::unique_ptr<MemoryBuffer>> band_bufs;
+      for (NodeOperation *op : chain) {
+        MemoryBuffer *band_buf = op_buf;
+        if (op != output_op) {
+          const DataType data_type = op->get_output_socket()->get_data_type();
+          band_bufs.add_new(op, std::make_unique<MemoryBuffer>(data_type, band));
+          band_buf = band_bufs.lookup(op).get();
+        }
+
+        Vector<MemoryBuffer *> &inputs = input_bufs.lookup(op);
+        for (const int i : inputs.index_range()) {
+          NodeOperation *input = op->get_input_operation(i);
+          if (streamed_operations_.contains(input)) {
+            inputs[i] = band_bufs.lookup(input).get();
+          }
+        }
+
+        const timeit::TimePoint band_before_time = timeit::Clock::now();
+        op->update_memory_buffer(band_buf, band, inputs);
+        render_times.lookup(op) += timeit::Clock::now() - band_before_time;
+      }
+    }
+  }
+
+  for (NodeOperation *op : chain) {
+    op->deinit_execution();
+    const Vector<MemoryBuffer *> &inputs = input_bufs.lookup(op);
+    for (const int i : inputs.index_range()) {
+      if (!streamed_operations_.contains(op->get_input_operation(i))) {
+        delete inputs[i];
+      }
+    }
+  }
+  DebugInfo::operation_rendered(output_op, op_buf);
+  const timeit::TimePoint after_time = timeit::Clock::now();
+
+  /* Streamed operations can't be cached, their render time counts as uncached time of the
+   * output operation. */
+  for (NodeOperation *op : streamed_ops) {
+    double uncached_render_time = 0.0;
+    const int num_inputs = op->get_number_of_input_sockets();
+    for (int i = 0; i < num_inputs; i++) {
+      uncached_render_time += uncached_render_times_.lookup_default(op->get_input_operation(i),
+                                                                    0.0);
+    }
+    uncached_render_times_.add(op, uncached_render_time);
+  }
+  set_operation_buffer(
+      output_op, op_buf, std::chrono::duration<double>(after_time - before_time).count());
+
+  for (NodeOperation *op : chain) {
+    operation_finished(op);
+
+    const bNodeInstanceKey node_instance_key = op->get_node_instance_key();
+    if (context_.get_profiler() && node_instance_key != bke::NODE_INSTANCE_KEY_NONE) {
+      context_.get_profiler()->set_node_evaluation_time(node_instance_key,
+                                                        render_times.lookup(op));
+    }
+  }
+}
+
+void FullFrameExecutionModel::set_operation_buffer(NodeOperation *op,
+                                                   MemoryBuffer *op_buf,
+                                                   const double render_time)
+{
+  if (result_cache_ && op_buf && should_cache_result(op, render_time)) {
+    /* Share the buffer with the cache, the active buffer is only a view on it. */
+    std::shared_ptr<MemoryBuffer> cached_buf(op_buf);
+    result_cache_->add(*cache_keys_.lookup(op), cached_buf);
+    added_cache_buffers_.append(cached_buf);
+    op_buf = new MemoryBuffer(op_buf->get_buffer(),
+                              op_buf->get_num_channels(),
+                              op_buf->get_rect(),
+                              op_buf->is_a_single_elem());
+  }
+
+  active_buffers_.set_rendered_buffer(op, std::unique_ptr<MemoryBuffer>(op_buf));
+}
+
 void FullFrameExecutionModel::render_operations()
 {
   const bool is_rendering = context_.is_rendering();
 
-  WorkScheduler::start();
   for (eCompositorPriority priority : priorities_) {
     for (NodeOperation *op : operations_) {
       const bool has_size = op->get_width() > 0 && op->get_height() > 0;
@@ -153,14 +482,10 @@ void FullFrameExecutionModel::render_operations()
       }
     }
   }
-  WorkScheduler::stop();
 }
 
-/**
- * Returns all dependencies from inputs to outputs. A dependency may be repeated when
- * several operations depend on it.
- */
-static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
+Vector<NodeOperation *> FullFrameExecutionModel::get_operation_dependencies(
+    NodeOperation *operation)
 {
   /* Get dependencies from outputs to inputs. */
   Vector<NodeOperation *> dependencies;
@@ -170,6 +495,9 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
     Vector<NodeOperation *> outputs(next_outputs);
     next_outputs.clear();
     for (NodeOperation *output : outputs) {
+      if (cache_hits_.contains(output)) {
+        continue;
+      }
       for (int i = 0; i < output->get_number_of_input_sockets(); i++) {
         next_outputs.append(output->get_input_operation(i));
       }
@@ -188,7 +516,8 @@ void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_o
   BLI_assert(output_op->is_output_operation(context_.is_rendering()));
   Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
   for (NodeOperation *op : dependencies) {
-    if (!active_buffers_.is_operation_rendered(op)) {
+    /* Streamed operations are rendered together with their reader. */
+    if (!active_buffers_.is_operation_rendered(op) && !streamed_operations_.contains(op)) {
       render_operation(op);
     }
   }
@@ -212,6 +541,9 @@ void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op
     }
 
     active_buffers_.register_area(operation, render_area);
+    if (cache_hits_.contains(operation)) {
+      continue;
+    }
 
     const int num_inputs = operation->get_number_of_input_sockets();
     for (int i = 0; i < num_inputs; i++) {
@@ -235,6 +567,9 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   stack.append(output_op);
   while (stack.size() > 0) {
     NodeOperation *operation = stack.pop_last();
+    if (cache_hits_.contains(operation)) {
+      continue;
+    }
     const int num_inputs = operation->get_number_of_input_sockets();
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
@@ -242,6 +577,7 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
         stack.append(input_op);
       }
       active_buffers_.register_read(input_op);
+      readers_.lookup_or_add_default(input_op).append(operation);
     }
   }
 }
@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+
+#include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_vector.hh"
 
 #include "COM_Enums.h"
@@ -20,6 +25,8 @@ class CompositorContext;
 class ExecutionSystem;
 class MemoryBuffer;
 class NodeOperation;
+class OperationResultCache;
+class OperationResultKey;
 class SharedOperationBuffers;
 
 /**
@@ -43,27 +50,112 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   Vector<eCompositorPriority> priorities_;
 
+  /**
+   * Operation results kept across executions, nullptr when caching is disabled.
+   */
+  OperationResultCache *result_cache_;
+
+  /**
+   * Keys identifying results of operations in #result_cache_. Operations which results can't be
+   * identified have a null key.
+   */
+  Map<NodeOperation *, std::shared_ptr<const OperationResultKey>> cache_keys_;
+
+  /**
+   * Operations which results are taken from #result_cache_. Their inputs are not rendered unless
+   * other operations need them.
+   */
+  Map<NodeOperation *, std::shared_ptr<MemoryBuffer>> cache_hits_;
+
+  /**
+   * Time spent rendering each operation and its inputs that are not cached, in seconds.
+   */
+  Map<NodeOperation *, double> uncached_render_times_;
+
+  /**
+   * Buffers added to #result_cache_ in this execution. Kept alive in case they are evicted while
+   * still being read.
+   */
+  Vector<std::shared_ptr<MemoryBuffer>> added_cache_buffers_;
+
+  /**
+   * Operations reading each operation result.
+   */
+  Map<NodeOperation *, Vector<NodeOperation *>> readers_;
+
+  /**
+   * Pixel operations which result is only read by another pixel operation of the same canvas.
+   * They have no full buffer, they are rendered in bands together with their reader.
+   */
+  Set<NodeOperation *> streamed_operations_;
+
+  /**
+   * Maximum memory in bytes used by the intermediate results of a chain of streamed operations.
+   * Chains needing more memory to render their whole area at once are rendered in several bands.
+   */
+  int64_t streaming_memory_limit_;
+
  public:
+  /** Default of #streaming_memory_limit_, see #UserDef::compositor_streaming_limit. */
+  static constexpr int64_t DEFAULT_STREAMING_MEMORY_LIMIT = int64_t(256) * 1024 * 1024;
+
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
+                          OperationResultCache *result_cache,
+                          int64_t streaming_memory_limit,
                           Span<NodeOperation *> operations);
 
   void execute(ExecutionSystem &exec_system) override;
 
  private:
+  /**
+   * Determines keys of operations results and which of them can be taken from the cache. Source
+   * operations are rendered here as their keys are a hash of their content.
+   */
+  void determine_cache_hits();
+  std::shared_ptr<const OperationResultKey> determine_cache_key(NodeOperation *op);
+  /**
+   * Whether operation result should be stored in the cache after rendering.
+   */
+  bool should_cache_result(NodeOperation *op, double render_time);
   void determine_areas_to_render_and_reads();
+  /**
+   * Determines operations that can be rendered in bands together with their reader, see
+   * #NodeOperationFlags::is_pixel_operation.
+   */
+  void determine_streamed_operations();
+  bool can_stream_operation(NodeOperation *op);
   /**
    * Render output operations in order of priority.
    */
   void render_operations();
   void render_output_dependencies(NodeOperation *output_op);
   /**
-   * Returns input buffers with an offset relative to given output coordinates.
+   * Returns all dependencies from inputs to outputs. A dependency may be repeated when
+   * several operations depend on it. Inputs of cached operations are not included.
+   */
+  Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation);
+  /**
+   * Returns input buffers with an offset relative to given output coordinates. Inputs which are
+   * streamed operations have no buffer and are nullptr.
    * Returned memory buffers must be deleted.
    */
   Vector<MemoryBuffer *> get_input_buffers(NodeOperation *op, int output_x, int output_y);
   MemoryBuffer *create_operation_buffer(NodeOperation *op, int output_x, int output_y);
   void render_operation(NodeOperation *op);
+  /**
+   * Renders given operation and its streamed inputs band by band, limiting the memory used by
+   * the intermediate results to #streaming_memory_limit_.
+   */
+  void render_streamed_operations(NodeOperation *output_op);
+  /**
+   * Gets streamed inputs of given operation recursively, from inputs to outputs.
+   */
+  void get_streamed_inputs(NodeOperation *op, Vector<NodeOperation *> &r_streamed_ops);
+  /**
+   * Sets rendered buffer of given operation, storing it in the cache if worth it.
+   */
+  void set_operation_buffer(NodeOperation *op, MemoryBuffer *op_buf, double render_time);
 
   void operation_finished(NodeOperation *operation);
 
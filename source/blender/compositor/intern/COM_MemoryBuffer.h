@@ -368,6 +368,10 @@ class MemoryBuffer {
   {
     return buffer_;
   }
+  const float *get_buffer() const
+  {
+    return buffer_;
+  }
 
   /**
    * Converts a single elem buffer to a full size buffer (allocates memory for all
@@ -206,6 +206,14 @@ struct NodeOperationFlags {
    */
   bool can_be_constant : 1;
 
+  /**
+   * Whether each output pixel only depends on the input pixels at the same coordinates and the
+   * operation renders any area the same way regardless of the other areas rendered. Chains of
+   * such operations are rendered in bands without allocating full buffers for intermediate
+   * results.
+   */
+  bool is_pixel_operation : 1;
+
   NodeOperationFlags()
   {
     use_render_border = false;
@@ -217,6 +225,7 @@ struct NodeOperationFlags {
     use_datatype_conversion = true;
     is_constant_operation = false;
     can_be_constant = false;
+    is_pixel_operation = false;
   }
 };
 
@@ -274,6 +283,8 @@ class NodeOperation {
   size_t params_hash_;
   bool is_hash_output_params_implemented_;
 
+  std::optional<Vector<uint8_t>> node_settings_;
+
   /**
    * \brief the index of the input socket that will be used to determine the canvas
    */
@@ -328,6 +339,20 @@ class NodeOperation {
     return node_instance_key_;
   }
 
+  /**
+   * Settings of the node this operation was created from, identifying the operation result across
+   * executions together with its inputs. Not set for nodes which results depend on more than
+   * their settings and inputs.
+   */
+  void set_node_settings(std::optional<Vector<uint8_t>> settings)
+  {
+    node_settings_ = std::move(settings);
+  }
+  const std::optional<Vector<uint8_t>> &get_node_settings() const
+  {
+    return node_settings_;
+  }
+
   /** Get constant value when operation is constant, otherwise return default_value. */
   float get_constant_value_default(float default_value);
   /** Get constant elem when operation is constant, otherwise return default_elem. */
@@ -10,6 +10,7 @@
 
 #include "COM_Converter.h"
 #include "COM_Debug.h"
+#include "COM_OperationResultCache.h"
 
 #include "COM_PreviewOperation.h"
 #include "COM_SetColorOperation.h"
@@ -25,7 +26,11 @@ namespace blender::compositor {
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context,
                                            bNodeTree *b_nodetree,
                                            ExecutionSystem *system)
-    : context_(context), exec_system_(system), current_node_(nullptr), active_viewer_(nullptr)
+    : context_(context),
+      exec_system_(system),
+      current_node_(nullptr),
+      current_node_operations_num_(0),
+      active_viewer_(nullptr)
 {
   graph_.from_bNodeTree(*context, b_nodetree);
 }
@@ -37,6 +42,7 @@ void NodeOperationBuilder::convert_to_operations(ExecutionSystem *system)
 
   for (Node *node : graph_.nodes()) {
     current_node_ = node;
+    current_node_operations_num_ = 0;
 
     DebugInfo::node_to_operations(node);
     node->convert_to_operations(converter, *context_);
@@ -110,6 +116,8 @@ void NodeOperationBuilder::add_operation(NodeOperation *operation)
   if (current_node_) {
     operation->set_name(current_node_->get_bnode()->name);
     operation->set_node_instance_key(current_node_->get_instance_key());
+    operation->set_node_settings(OperationResultCache::node_settings(
+        *current_node_->get_bnode(), current_node_operations_num_++));
   }
   operation->set_execution_system(exec_system_);
 }
@@ -60,6 +60,8 @@ class NodeOperationBuilder {
   Map<NodeOutput *, NodeOperationOutput *> output_map_;
 
   Node *current_node_;
+  /** Number of operations added for the current node. */
+  int current_node_operations_num_;
 
   /**
    * Operation that will be writing to the viewer image
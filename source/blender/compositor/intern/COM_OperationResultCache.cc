@@ -0,0 +1,293 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstring>
+#include <limits>
+
+#include <xxhash.h>
+
+#include "BLI_array.hh"
+#include "BLI_ghash.h"
+#include "BLI_hash.hh"
+#include "BLI_listbase.h"
+#include "BLI_rect.h"
+#include "BLI_set.hh"
+#include "BLI_task.hh"
+
+#include "BKE_node.hh"
+
+#include "DNA_node_types.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_OperationResultCache.h"
+
+namespace blender::compositor {
+
+/**
+ * Nodes which results only depend on their settings and inputs. Nodes reading scene, movie clip
+ * or mask data, or depending on the view or frame, are not listed.
+ */
+static bool is_node_result_cacheable(const bNode &node)
+{
+  switch (node.type) {
+    case CMP_NODE_MIX_RGB:
+    case CMP_NODE_VALTORGB:
+    case CMP_NODE_RGBTOBW:
+    case CMP_NODE_NORMAL:
+    case CMP_NODE_CURVE_VEC:
+    case CMP_NODE_CURVE_RGB:
+    case CMP_NODE_ALPHAOVER:
+    case CMP_NODE_BLUR:
+    case CMP_NODE_FILTER:
+    case CMP_NODE_MAP_VALUE:
+    case CMP_NODE_VECBLUR:
+    case CMP_NODE_SETALPHA:
+    case CMP_NODE_HUE_SAT:
+    case CMP_NODE_TRANSLATE:
+    case CMP_NODE_ZCOMBINE:
+    case CMP_NODE_DILATEERODE:
+    case CMP_NODE_ROTATE:
+    case CMP_NODE_DIFF_MATTE:
+    case CMP_NODE_COLOR_SPILL:
+    case CMP_NODE_CHROMA_MATTE:
+    case CMP_NODE_CHANNEL_MATTE:
+    case CMP_NODE_FLIP:
+    case CMP_NODE_MAP_UV:
+    case CMP_NODE_ID_MASK:
+    case CMP_NODE_DISPLACE:
+    case CMP_NODE_MATH:
+    case CMP_NODE_LUMA_MATTE:
+    case CMP_NODE_BRIGHTCONTRAST:
+    case CMP_NODE_GAMMA:
+    case CMP_NODE_INVERT:
+    case CMP_NODE_NORMALIZE:
+    case CMP_NODE_CROP:
+    case CMP_NODE_DBLUR:
+    case CMP_NODE_BILATERALBLUR:
+    case CMP_NODE_PREMULKEY:
+    case CMP_NODE_DIST_MATTE:
+    case CMP_NODE_COLOR_MATTE:
+    case CMP_NODE_COLORBALANCE:
+    case CMP_NODE_HUECORRECT:
+    case CMP_NODE_TRANSFORM:
+    case CMP_NODE_DOUBLEEDGEMASK:
+    case CMP_NODE_KEYING:
+    case CMP_NODE_INPAINT:
+    case CMP_NODE_DESPECKLE:
+    case CMP_NODE_ANTIALIASING:
+    case CMP_NODE_KUWAHARA:
+    case CMP_NODE_GLARE:
+    case CMP_NODE_TONEMAP:
+    case CMP_NODE_LENSDIST:
+    case CMP_NODE_SUNBEAMS:
+    case CMP_NODE_COLORCORRECTION:
+    case CMP_NODE_MASK_BOX:
+    case CMP_NODE_MASK_ELLIPSE:
+    case CMP_NODE_BOKEHIMAGE:
+    case CMP_NODE_BOKEHBLUR:
+    case CMP_NODE_SWITCH:
+    case CMP_NODE_PIXELATE:
+    case CMP_NODE_MAP_RANGE:
+    case CMP_NODE_CORNERPIN:
+    case CMP_NODE_DENOISE:
+    case CMP_NODE_EXPOSURE:
+    case CMP_NODE_POSTERIZE:
+    case CMP_NODE_SEPARATE_XYZ:
+    case CMP_NODE_COMBINE_XYZ:
+    case CMP_NODE_COMBINE_COLOR:
+    case CMP_NODE_SEPARATE_COLOR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+OperationResultKey::OperationResultKey(const std::type_index operation_type,
+                                       const DataType data_type,
+                                       const rcti &canvas,
+                                       Vector<uint8_t> settings,
+                                       Vector<std::shared_ptr<const OperationResultKey>> inputs)
+    : operation_type_(operation_type),
+      data_type_(data_type),
+      canvas_(canvas),
+      settings_(std::move(settings)),
+      inputs_(std::move(inputs))
+{
+  hash_ = get_default_hash(operation_type_.hash_code(), data_type_);
+  hash_ = BLI_ghashutil_combine_hash(
+      hash_, get_default_hash(canvas_.xmin, canvas_.xmax, canvas_.ymin, canvas_.ymax));
+  hash_ = BLI_ghashutil_combine_hash(hash_, XXH3_64bits(settings_.data(), settings_.size()));
+  for (const std::shared_ptr<const OperationResultKey> &input : inputs_) {
+    hash_ = BLI_ghashutil_combine_hash(hash_, input->hash_);
+  }
+}
+
+bool operator==(const OperationResultKey &a, const OperationResultKey &b)
+{
+  Set<OperationResultKey::KeyPair> equal_keys;
+  return OperationResultKey::equal(a, b, equal_keys);
+}
+
+bool OperationResultKey::equal(const OperationResultKey &a,
+                               const OperationResultKey &b,
+                               Set<KeyPair> &equal_keys)
+{
+  if (&a == &b || equal_keys.contains({&a, &b})) {
+    return true;
+  }
+  if (a.hash_ != b.hash_ || a.operation_type_ != b.operation_type_ ||
+      a.data_type_ != b.data_type_ || !BLI_rcti_compare(&a.canvas_, &b.canvas_) ||
+      a.settings_.as_span() != b.settings_.as_span() || a.inputs_.size() != b.inputs_.size())
+  {
+    return false;
+  }
+  for (const int i : a.inputs_.index_range()) {
+    if (!equal(*a.inputs_[i], *b.inputs_[i], equal_keys)) {
+      return false;
+    }
+  }
+  equal_keys.add({&a, &b});
+  return true;
+}
+
+static void append_bytes(Vector<uint8_t> &settings, const void *data, const size_t size)
+{
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  settings.extend(Span<uint8_t>(bytes, size));
+}
+
+template<typename T> static void append_value(Vector<uint8_t> &settings, const T &value)
+{
+  append_bytes(settings, &value, sizeof(T));
+}
+
+static void append_guarded_memory(Vector<uint8_t> &settings, const void *data)
+{
+  append_bytes(settings, data, MEM_allocN_len(data));
+}
+
+OperationResultCache::OperationResultCache() : memory_limit_(DEFAULT_MEMORY_LIMIT) {}
+
+std::optional<Vector<uint8_t>> OperationResultCache::node_settings(const bNode &node,
+                                                                   const int operation_index)
+{
+  if (!is_node_result_cacheable(node)) {
+    return std::nullopt;
+  }
+
+  Vector<uint8_t> settings;
+  append_bytes(settings, node.idname, strlen(node.idname) + 1);
+  append_value(settings, operation_index);
+  append_value(settings, node.custom1);
+  append_value(settings, node.custom2);
+  append_value(settings, node.custom3);
+  append_value(settings, node.custom4);
+  /* Storage and socket values are plain DNA structs. Pointers they contain may change without
+   * the result changing, which only leads to a cache miss. */
+  if (node.storage) {
+    append_guarded_memory(settings, node.storage);
+  }
+  LISTBASE_FOREACH (const bNodeSocket *, socket, &node.inputs) {
+    if (socket->default_value) {
+      append_guarded_memory(settings, socket->default_value);
+    }
+  }
+  return settings;
+}
+
+std::array<uint64_t, 2> OperationResultCache::hash_buffer_content(const MemoryBuffer &buffer)
+{
+  const int64_t num_floats = buffer.is_a_single_elem() ?
+                                 buffer.get_num_channels() :
+                                 int64_t(buffer.get_width()) * buffer.get_height() *
+                                     buffer.get_num_channels();
+  const unsigned char *data = reinterpret_cast<const unsigned char *>(buffer.get_buffer());
+  const int64_t num_bytes = num_floats * sizeof(float);
+
+  /* Hash fixed size chunks in parallel, so the result does not depend on scheduling. The chunk
+   * hashes are then hashed together with the buffer dimensions. */
+  constexpr int64_t chunk_size = 1024 * 1024;
+  const int64_t num_chunks = (num_bytes + chunk_size - 1) / chunk_size;
+  Array<XXH128_hash_t> hashes(num_chunks + 1);
+  threading::parallel_for(IndexRange(num_chunks), 1, [&](const IndexRange range) {
+    for (const int64_t chunk : range) {
+      const int64_t offset = chunk * chunk_size;
+      const int64_t size = std::min(chunk_size, num_bytes - offset);
+      hashes[chunk] = XXH3_128bits(data + offset, size);
+    }
+  });
+  const int dimensions[4] = {buffer.get_width(),
+                             buffer.get_height(),
+                             buffer.get_num_channels(),
+                             buffer.is_a_single_elem()};
+  hashes.last() = XXH3_128bits(dimensions, sizeof(dimensions));
+
+  const XXH128_hash_t hash = XXH3_128bits(hashes.data(), hashes.as_span().size_in_bytes());
+  return {hash.low64, hash.high64};
+}
+
+void OperationResultCache::begin_execution()
+{
+  execution_index_++;
+}
+
+std::shared_ptr<MemoryBuffer> OperationResultCache::lookup(const OperationResultKey &key)
+{
+  Entry *entry = entries_.lookup_ptr(key);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  entry->last_used = execution_index_;
+  return entry->buffer;
+}
+
+void OperationResultCache::add(const OperationResultKey &key,
+                               std::shared_ptr<MemoryBuffer> buffer)
+{
+  const int64_t memory_size = (buffer->is_a_single_elem() ?
+                                   int64_t(1) :
+                                   int64_t(buffer->get_width()) * buffer->get_height()) *
+                              buffer->get_num_channels() * sizeof(float);
+  if (memory_size > memory_limit_ || entries_.contains(key)) {
+    return;
+  }
+
+  evict(memory_limit_ - memory_size);
+
+  entries_.add_new(key, {std::move(buffer), memory_size, execution_index_});
+  memory_used_ += memory_size;
+}
+
+void OperationResultCache::evict(const int64_t memory_limit)
+{
+  while (memory_used_ > memory_limit && !entries_.is_empty()) {
+    const OperationResultKey *oldest_key = nullptr;
+    int64_t oldest_last_used = std::numeric_limits<int64_t>::max();
+    for (const auto item : entries_.items()) {
+      if (item.value.last_used < oldest_last_used) {
+        oldest_key = &item.key;
+        oldest_last_used = item.value.last_used;
+      }
+    }
+    /* Copy the key, since popping the entry destructs the stored one. */
+    const OperationResultKey key = *oldest_key;
+    memory_used_ -= entries_.pop(key).memory_size;
+  }
+}
+
+void OperationResultCache::set_memory_limit(const int64_t memory_limit)
+{
+  memory_limit_ = memory_limit;
+  evict(memory_limit_);
+}
+
+void OperationResultCache::clear()
+{
+  entries_.clear();
+  memory_used_ = 0;
+}
+
+}  // namespace blender::compositor
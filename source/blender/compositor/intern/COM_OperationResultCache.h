@@ -0,0 +1,149 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <typeindex>
+
+#include "BLI_map.hh"
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_vec_types.h"
+
+#include "COM_defines.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+struct bNode;
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Identifies the result of an operation across executions, see #OperationResultCache.
+ *
+ * The key holds everything the result depends on: the operation type, canvas, settings and the
+ * keys of its inputs. Keys are compared in full, so two different results are never confused
+ * even if their hashes collide.
+ */
+class OperationResultKey {
+ private:
+  std::type_index operation_type_;
+  DataType data_type_;
+  rcti canvas_;
+  /**
+   * Settings of the node the operation was created from, the value of a constant operation or
+   * the content hash of a source operation.
+   */
+  Vector<uint8_t> settings_;
+  Vector<std::shared_ptr<const OperationResultKey>> inputs_;
+  uint64_t hash_;
+
+ public:
+  OperationResultKey(std::type_index operation_type,
+                     DataType data_type,
+                     const rcti &canvas,
+                     Vector<uint8_t> settings,
+                     Vector<std::shared_ptr<const OperationResultKey>> inputs);
+
+  uint64_t hash() const
+  {
+    return hash_;
+  }
+
+  friend bool operator==(const OperationResultKey &a, const OperationResultKey &b);
+  friend bool operator!=(const OperationResultKey &a, const OperationResultKey &b)
+  {
+    return !(a == b);
+  }
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:OperationResultKey")
+#endif
+
+ private:
+  using KeyPair = std::pair<const OperationResultKey *, const OperationResultKey *>;
+
+  /**
+   * Keys of inputs shared by several operations are only compared once, so comparing keys of
+   * node trees with many shared inputs does not take exponential time.
+   */
+  static bool equal(const OperationResultKey &a,
+                    const OperationResultKey &b,
+                    Set<KeyPair> &equal_keys);
+};
+
+/**
+ * Keeps rendered operation buffers alive across executions, so that editing a node only
+ * re-renders operations downstream of it.
+ *
+ * Buffers are identified by an #OperationResultKey, so any change upstream of an operation
+ * results in a different key. Source operations are identified by a hash of their rendered
+ * content.
+ */
+class OperationResultCache {
+ private:
+  struct Entry {
+    std::shared_ptr<MemoryBuffer> buffer;
+    int64_t memory_size;
+    int64_t last_used;
+  };
+  Map<OperationResultKey, Entry> entries_;
+
+  int64_t memory_limit_;
+  int64_t memory_used_ = 0;
+
+  /** Incremented on every execution, used for least recently used eviction. */
+  int64_t execution_index_ = 0;
+
+ public:
+  /** Default memory limit in bytes, see #UserDef::compositor_cache_limit. */
+  static constexpr int64_t DEFAULT_MEMORY_LIMIT = int64_t(1024) * 1024 * 1024;
+
+  OperationResultCache();
+
+  /**
+   * Settings of given node that affect the results of the operations created from it, combined
+   * with the index of the operation within the node. Returns `std::nullopt` for nodes which
+   * results depend on data other than their settings and inputs, like scene or tracking data.
+   */
+  static std::optional<Vector<uint8_t>> node_settings(const bNode &node, int operation_index);
+
+  /**
+   * 128-bit hash of the buffer content, used to identify results of source operations. Unlike
+   * hashes used for hash tables, collisions are not expected in practice.
+   */
+  static std::array<uint64_t, 2> hash_buffer_content(const MemoryBuffer &buffer);
+
+  /** Mark the start of a new execution. */
+  void begin_execution();
+
+  /** Get cached buffer for given key, nullptr if not cached. */
+  std::shared_ptr<MemoryBuffer> lookup(const OperationResultKey &key);
+
+  /**
+   * Store buffer for given key, evicting least recently used buffers to stay within the memory
+   * limit. Buffers bigger than the limit are not stored.
+   */
+  void add(const OperationResultKey &key, std::shared_ptr<MemoryBuffer> buffer);
+
+  void set_memory_limit(int64_t memory_limit);
+  void clear();
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:OperationResultCache")
+#endif
+
+ private:
+  void evict(int64_t memory_limit);
+};
+
+}  // namespace blender::compositor
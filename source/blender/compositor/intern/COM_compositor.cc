@@ -10,7 +10,10 @@
 #include "BKE_node_runtime.hh"
 #include "BKE_scene.hh"
 
+#include "DNA_userdef_types.h"
+
 #include "COM_ExecutionSystem.h"
+#include "COM_OperationResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.hh"
 
@@ -19,6 +22,9 @@
 static struct {
   bool is_initialized = false;
   ThreadMutex mutex;
+  /* Operation results kept between executions while editing, so only operations downstream of
+   * edited nodes are re-rendered. */
+  blender::compositor::OperationResultCache *result_cache = nullptr;
 } g_compositor;
 
 /* Make sure node tree has previews.
@@ -77,12 +83,18 @@ void COM_execute(Render *render,
   compositor_init_node_previews(render_data, node_tree);
   compositor_reset_node_tree_status(node_tree);
 
-  if (scene->r.compositor_device == SCE_COMPOSITOR_DEVICE_GPU) {
-    /* GPU compositor. */
-    RE_compositor_execute(
+  bool is_executed = false;
+  if (scene->r.compositor_device == SCE_COMPOSITOR_DEVICE_GPU ||
+      (USER_EXPERIMENTAL_TEST(&U, use_realtime_compositor_cpu) && render != nullptr))
+  {
+    /* GPU compositor, or the realtime compositor evaluated on the CPU, see
+     * Context::use_gpu(). The latter is not executed if the node tree has nodes that are not
+     * supported on the CPU, in which case, the CPU compositor is used below. */
+    is_executed = RE_compositor_execute(
         *render, *scene, *render_data, *node_tree, view_name, render_context, profiler);
   }
-  else {
+
+  if (!is_executed) {
     /* CPU compositor. */
 
     /* Initialize workscheduler. */
@@ -90,8 +102,29 @@ void COM_execute(Render *render,
 
     /* Execute. */
     const bool is_rendering = render_context != nullptr;
-    blender::compositor::ExecutionSystem system(
-        render_data, scene, node_tree, is_rendering, view_name, render_context, profiler);
+    const int64_t cache_limit = int64_t(U.compositor_cache_limit) * 1024 * 1024;
+    if (cache_limit == 0) {
+      delete g_compositor.result_cache;
+      g_compositor.result_cache = nullptr;
+    }
+    const int64_t streaming_memory_limit = int64_t(U.compositor_streaming_limit) * 1024 * 1024;
+    blender::compositor::OperationResultCache *result_cache = nullptr;
+    if (!is_rendering && cache_limit > 0) {
+      if (g_compositor.result_cache == nullptr) {
+        g_compositor.result_cache = new blender::compositor::OperationResultCache();
+      }
+      g_compositor.result_cache->set_memory_limit(cache_limit);
+      result_cache = g_compositor.result_cache;
+    }
+    blender::compositor::ExecutionSystem system(render_data,
+                                                scene,
+                                                node_tree,
+                                                is_rendering,
+                                                view_name,
+                                                render_context,
+                                                profiler,
+                                                result_cache,
+                                                streaming_memory_limit);
     system.execute();
   }
 
@@ -103,8 +136,20 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    delete g_compositor.result_cache;
+    g_compositor.result_cache = nullptr;
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
   }
 }
+
+void COM_clear_caches()
+{
+  if (g_compositor.is_initialized) {
+    BLI_mutex_lock(&g_compositor.mutex);
+    delete g_compositor.result_cache;
+    g_compositor.result_cache = nullptr;
+    BLI_mutex_unlock(&g_compositor.mutex);
+  }
+}
@@ -2,11 +2,14 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_array.hh"
+#include "BLI_index_range.hh"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector.hh"
 
 #include "COM_BokehBlurOperation.h"
 #include "COM_ConstantOperation.h"
+#include "COM_FFTConvolutionAlgorithm.h"
 
 namespace blender::compositor {
 
@@ -15,6 +18,11 @@ constexpr int BOKEH_INPUT_INDEX = 1;
 constexpr int BOUNDING_BOX_INPUT_INDEX = 2;
 constexpr int SIZE_INPUT_INDEX = 3;
 
+/* The radius from which the convolution is done in the frequency domain. The cost of the direct
+ * convolution grows with the square of the radius while the cost of the FFT convolution grows only
+ * logarithmically, so the latter is much faster for all but small radii. */
+constexpr int FFT_CONVOLUTION_MIN_RADIUS = 16;
+
 BokehBlurOperation::BokehBlurOperation()
 {
   this->add_input_socket(DataType::Color);
@@ -96,16 +104,69 @@ void BokehBlurOperation::get_area_of_interest(const int input_idx,
   }
 }
 
+int BokehBlurOperation::get_radius() const
+{
+  const float max_dim = std::max(this->get_width(), this->get_height());
+  return size_ * max_dim / 100.0f;
+}
+
+static bool use_fft_convolution(const int radius)
+{
+  return is_fft_convolution_supported() && radius >= FFT_CONVOLUTION_MIN_RADIUS;
+}
+
+/* Get the weight of the input pixel at the given offset from the output pixel for a kernel of the
+ * given radius, which is read from the bokeh input by mapping the kernel to it. */
+static float4 get_bokeh_weight(const MemoryBuffer *bokeh_input,
+                               const int2 offset,
+                               const int radius)
+{
+  const int2 bokeh_size = int2(bokeh_input->get_width(), bokeh_input->get_height());
+  const float2 normalized_texel = (float2(offset) + radius + 0.5f) / (radius * 2.0f + 1.0f);
+  const float2 weight_texel = (1.0f - normalized_texel) * float2(bokeh_size - 1);
+  return bokeh_input->get_elem(int(weight_texel.x), int(weight_texel.y));
+}
+
+void BokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                      const rcti &area,
+                                                      Span<MemoryBuffer *> inputs)
+{
+  const int radius = get_radius();
+  if (!use_fft_convolution(radius)) {
+    return;
+  }
+
+  /* Compute the kernel and normalize it, since the whole kernel is used for every pixel. */
+  const MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
+  const int kernel_size = radius * 2 + 1;
+  Array<float4> kernel(int64_t(kernel_size) * kernel_size);
+  float4 weights_sum = float4(0.0f);
+  for (const int y : IndexRange(kernel_size)) {
+    for (const int x : IndexRange(kernel_size)) {
+      const float4 weight = get_bokeh_weight(bokeh_input, int2(x, y) - radius, radius);
+      kernel[x + y * kernel_size] = weight;
+      weights_sum += weight;
+    }
+  }
+  for (float4 &weight : kernel) {
+    weight = math::safe_divide(weight, weights_sum);
+  }
+
+  /* The bounding box is handled in update_memory_buffer_partial, which copies the input where it
+   * is zero. */
+  fft_convolve(*inputs[IMAGE_INPUT_INDEX], *output, area, kernel, radius);
+}
+
 void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                       const rcti &area,
                                                       Span<MemoryBuffer *> inputs)
 {
-  const float max_dim = std::max(this->get_width(), this->get_height());
-  const int radius = size_ * max_dim / 100.0f;
+  const int radius = get_radius();
+  /* The blurred pixels were already computed in update_memory_buffer_started. */
+  const bool is_blur_computed = use_fft_convolution(radius);
 
   const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
   const MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
-  const int2 bokeh_size = int2(bokeh_input->get_width(), bokeh_input->get_height());
   MemoryBuffer *bounding_input = inputs[BOUNDING_BOX_INPUT_INDEX];
   BuffersIterator<float> it = output->iterate_with({bounding_input}, area);
   for (; !it.is_end(); ++it) {
@@ -117,13 +178,15 @@ void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
       continue;
     }
 
+    if (is_blur_computed) {
+      continue;
+    }
+
     float4 accumulated_color = float4(0.0f);
     float4 accumulated_weight = float4(0.0f);
     for (int yi = -radius; yi <= radius; ++yi) {
       for (int xi = -radius; xi <= radius; ++xi) {
-        const float2 normalized_texel = (float2(xi, yi) + radius + 0.5f) / (radius * 2.0f + 1.0f);
-        const float2 weight_texel = (1.0f - normalized_texel) * float2(bokeh_size - 1);
-        const float4 weight = bokeh_input->get_elem(int(weight_texel.x), int(weight_texel.y));
+        const float4 weight = get_bokeh_weight(bokeh_input, int2(xi, yi), radius);
         const float4 color = float4(image_input->get_elem_clamped(x + xi, y + yi)) * weight;
         accumulated_color += color;
         accumulated_weight += weight;
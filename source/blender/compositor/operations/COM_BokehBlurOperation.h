@@ -11,6 +11,7 @@ namespace blender::compositor {
 class BokehBlurOperation : public MultiThreadedOperation {
  private:
   void update_size();
+  int get_radius() const;
   float size_;
   bool sizeavailable_;
 
@@ -35,6 +36,9 @@ class BokehBlurOperation : public MultiThreadedOperation {
   void determine_canvas(const rcti &preferred_area, rcti &r_area) override;
 
   void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
@@ -8,11 +8,17 @@
 #include "BLI_math_vector.hh"
 
 #include "COM_GaussianBokehBlurOperation.h"
+#include "COM_RecursiveGaussianBlurAlgorithm.h"
 
 #include "RE_pipeline.h"
 
 namespace blender::compositor {
 
+/* The radius from which the Gaussian filter is approximated using a recursive filter instead of a
+ * direct convolution. The recursive filter is only accurate for sigma values of 3 or more, which
+ * corresponds to a radius of 9 pixels since the radius spans three standard deviations. */
+constexpr float RECURSIVE_GAUSSIAN_MIN_RADIUS = 9.0f;
+
 GaussianBokehBlurOperation::GaussianBokehBlurOperation() : BlurBaseOperation(DataType::Color)
 {
   gausstab_ = nullptr;
@@ -112,10 +118,43 @@ void GaussianBokehBlurOperation::get_area_of_interest(const int input_idx,
   r_input_area.ymin = output_area.ymin - rady_;
 }
 
+bool GaussianBokehBlurOperation::use_recursive_gaussian() const
+{
+  /* Only the Gaussian filter is separable and can be approximated recursively. */
+  if (data_.filtertype != R_FILTER_GAUSS) {
+    return false;
+  }
+
+  /* Each axis is either not blurred at all or blurred with a large enough radius. */
+  const auto is_radius_supported = [](const float radius) {
+    return radius == 0.0f || radius >= RECURSIVE_GAUSSIAN_MIN_RADIUS;
+  };
+  return is_radius_supported(radxf_) && is_radius_supported(radyf_) &&
+         math::max(radxf_, radyf_) > 0.0f;
+}
+
+void GaussianBokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                              const rcti &area,
+                                                              Span<MemoryBuffer *> inputs)
+{
+  if (!use_recursive_gaussian()) {
+    return;
+  }
+
+  /* The filter spans three standard deviations, see RE_filter_value. */
+  const float2 sigma = float2(radxf_, radyf_) / 3.0f;
+  deriche_gaussian_blur(*inputs[IMAGE_INPUT_INDEX], *output, area, sigma);
+}
+
 void GaussianBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                               const rcti &area,
                                                               Span<MemoryBuffer *> inputs)
 {
+  /* Already computed in update_memory_buffer_started. */
+  if (use_recursive_gaussian()) {
+    return;
+  }
+
   const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
   BuffersIterator<float> it = output->iterate_with({}, area);
   const rcti &input_rect = input->get_rect();
@@ -18,6 +18,7 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
   float radxf_;
   float radyf_;
   void update_gauss();
+  bool use_recursive_gaussian() const;
 
  public:
   GaussianBokehBlurOperation();
@@ -26,6 +27,9 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
   void deinit_execution() override;
 
   void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
@@ -18,6 +18,7 @@ MathBaseOperation::MathBaseOperation()
   this->add_output_socket(DataType::Value);
   use_clamp_ = false;
   flags_.can_be_constant = true;
+  flags_.is_pixel_operation = true;
 }
 
 void MathBaseOperation::determine_canvas(const rcti &preferred_area, rcti &r_area)
@@ -93,6 +93,24 @@ class Context {
                                         int view_layer,
                                         const char *pass_name) = 0;
 
+  /* Same as get_output_texture but for contexts that do not use the GPU, see use_gpu(). Returns a
+   * buffer of RGBA float pixels of the render size, or nullptr if the context does not support
+   * the composite output on the CPU, which is the default. */
+  virtual float *get_output_buffer();
+
+  /* Same as get_viewer_output_texture but for contexts that do not use the GPU, see use_gpu().
+   * Returns a buffer of RGBA float pixels, which is of the size of the given domain if the context
+   * uses the composite output and of the render size otherwise. Returns nullptr by default. */
+  virtual float *get_viewer_output_buffer(Domain domain, bool is_data);
+
+  /* Same as get_input_texture but for contexts that do not use the GPU, see use_gpu(). Returns a
+   * buffer of float pixels of the render size with the number of channels per pixel written to
+   * r_channels_count, or nullptr if the pass is not available, which is the default. */
+  virtual const float *get_input_buffer(const Scene *scene,
+                                        int view_layer,
+                                        const char *pass_name,
+                                        int *r_channels_count);
+
   /* Get the name of the view currently being rendered. */
   virtual StringRef get_view_name() const = 0;
 
@@ -135,6 +153,12 @@ class Context {
    * executing as soon as possible. */
   virtual bool is_canceled() const;
 
+  /* True if the compositor should evaluate on the GPU, false otherwise. If false, results are
+   * allocated in CPU memory and operations are executed using multithreaded CPU kernels.
+   * Operations that are not supported on the CPU produce invalid results, see
+   * Operation::is_cpu_supported. Defaults to true. */
+  virtual bool use_gpu() const;
+
   /* Resets the context's internal structures like texture pool and cache manager. This should be
    * called before every evaluation. */
   void reset();
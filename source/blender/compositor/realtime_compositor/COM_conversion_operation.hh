@@ -25,9 +25,12 @@ class ConversionOperation : public SimpleOperation {
   using SimpleOperation::SimpleOperation;
 
   /* If the input result is a single value, execute_single is called. Otherwise, the shader
-   * provided by get_conversion_shader is dispatched. */
+   * provided by get_conversion_shader is dispatched, or convert_pixel is called for every pixel if
+   * the context does not use the GPU. */
   void execute() override;
 
+  bool is_cpu_supported() const override;
+
   /* Determine if a conversion operation is needed for the input with the given result and
    * descriptor. If it is not needed, return a null pointer. If it is needed, return an instance of
    * the appropriate conversion operation. */
@@ -42,6 +45,10 @@ class ConversionOperation : public SimpleOperation {
   /* Get the shader the will be used for conversion. */
   virtual GPUShader *get_conversion_shader() const = 0;
 
+  /* Convert the given input pixel to the output type, used when the context does not use the
+   * GPU. Pixels of all types are passed as 4D vectors, see Result::load_pixel. */
+  virtual float4 convert_pixel(const float4 &value) const = 0;
+
   /** \} */
 
 };  // namespace blender::realtime_compositorclassConversionOperation:publicSimpleOperation
@@ -60,6 +67,8 @@ class ConvertFloatToVectorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &value) const override;
 };
 
 /** \} */
@@ -78,6 +87,8 @@ class ConvertFloatToColorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &value) const override;
 };
 
 /** \} */
@@ -96,6 +107,8 @@ class ConvertColorToFloatOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &value) const override;
 };
 
 /** \} */
@@ -114,6 +127,8 @@ class ConvertColorToVectorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &value) const override;
 };
 
 /** \} */
@@ -132,6 +147,8 @@ class ConvertVectorToFloatOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &value) const override;
 };
 
 /** \} */
@@ -150,6 +167,8 @@ class ConvertVectorToColorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &value) const override;
 };
 
 /** \} */
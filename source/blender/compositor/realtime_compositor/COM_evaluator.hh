@@ -16,6 +16,7 @@
 #include "COM_context.hh"
 #include "COM_node_operation.hh"
 #include "COM_operation.hh"
+#include "COM_scheduler.hh"
 #include "COM_shader_operation.hh"
 
 namespace blender::realtime_compositor {
@@ -117,6 +118,9 @@ class Evaluator {
   /* True if the node tree is already compiled into an operations stream that can be evaluated
    * directly. False if the node tree is not compiled yet and needs to be compiled. */
   bool is_compiled_ = false;
+  /* False if the last compilation found nodes that can't be evaluated on the CPU while the context
+   * does not use the GPU, in which case, nothing was evaluated. See validate_cpu_support. */
+  bool is_cpu_supported_ = true;
 
  public:
   /* Construct an evaluator from a context. */
@@ -133,6 +137,11 @@ class Evaluator {
    * contents do not necessitate a reset. */
   void reset();
 
+  /* Returns false if the node tree was not evaluated because it has nodes that are not supported
+   * on the CPU while the context does not use the GPU, see Context::use_gpu(). The caller is then
+   * expected to evaluate the node tree by other means, like the CPU compositor. */
+  bool is_cpu_supported() const;
+
  private:
   /* Check if the compositor node tree is valid by checking if it has:
    * - Cyclic links.
@@ -142,6 +151,12 @@ class Evaluator {
    * error message is set by calling the context's set_info_message method. */
   bool validate_node_tree();
 
+  /* Check if all nodes in the given schedule can be evaluated on the CPU, see
+   * Operation::is_cpu_supported. Operations are instantiated for the nodes only to query their
+   * support and are not evaluated. If a node is not supported, false is returned and an
+   * appropriate error message is set by calling the context's set_info_message method. */
+  bool validate_cpu_support(const Schedule &schedule);
+
   /* Compile the node tree into an operations stream and evaluate it. */
   void compile_and_evaluate();
 
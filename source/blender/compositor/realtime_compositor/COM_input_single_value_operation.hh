@@ -35,6 +35,8 @@ class InputSingleValueOperation : public Operation {
   /* Allocate a single value result and set its value to the default value of the input socket. */
   void execute() override;
 
+  bool is_cpu_supported() const override;
+
   /* Get a reference to the output result of the operation, this essentially calls the super
    * get_result with the output identifier of the operation. */
   Result &get_result();
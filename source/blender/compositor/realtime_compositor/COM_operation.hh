@@ -92,7 +92,8 @@ class Operation {
   /* Evaluate the operation by:
    * 1. Evaluating the input processors.
    * 2. Resetting the results of the operation.
-   * 3. Calling the execute method of the operation.
+   * 3. Calling the execute method of the operation, or allocating invalid results if the
+   *    operation is not supported on the CPU and the context does not use the GPU.
    * 4. Releasing the results mapped to the inputs. */
   virtual void evaluate();
 
@@ -104,6 +105,12 @@ class Operation {
    * establish links between different operations. */
   void map_input_to_result(StringRef identifier, Result *result);
 
+  /* Returns true if the operation can be executed when the context does not use the GPU, see
+   * Context::use_gpu. Operations that are not supported allocate invalid results instead of
+   * executing. This defaults to false and should be overridden by operations that implement a CPU
+   * code path in their execute method. */
+  virtual bool is_cpu_supported() const;
+
  protected:
   /* Compute the operation domain of this operation. By default, this implements a default logic
    * that infers the operation domain from the inputs, which may be overridden for a different
@@ -31,6 +31,8 @@ class RealizeOnDomainOperation : public SimpleOperation {
 
   void execute() override;
 
+  bool is_cpu_supported() const override;
+
   /* Determine if a realize on domain operation is needed for the input with the given result and
    * descriptor in an operation with the given operation domain. If it is not needed, return a null
    * pointer. If it is needed, return an instance of the operation. */
@@ -24,10 +24,16 @@ class ReduceToSingleValueOperation : public SimpleOperation {
    * single value output result. */
   void execute() override;
 
+  bool is_cpu_supported() const override;
+
   /* Determine if a reduce to single value operation is needed for the input with the
    * given result. If it is not needed, return a null pointer. If it is needed, return an instance
    * of the operation. */
   static SimpleOperation *construct_if_needed(Context &context, const Result &input_result);
+
+ private:
+  /* Same as execute but for results stored on the CPU, where the pixel can be read directly. */
+  void execute_cpu();
 };
 
 }  // namespace blender::realtime_compositor
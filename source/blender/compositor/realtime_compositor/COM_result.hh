@@ -77,7 +77,12 @@ enum class ResultPrecision : uint8_t {
  *
  * A result can wrap an external texture that is not allocated nor managed by the result. This is
  * set up by a call to the wrap_external method. In that case, when the reference count eventually
- * reach zero, the texture will not be freed. */
+ * reach zero, the texture will not be freed.
+ *
+ * If the context does not use the GPU, see Context::use_gpu(), the data of the result is stored in
+ * a CPU buffer of floats instead of a GPU texture, with as many channels per pixel as returned by
+ * the channels_count method. Such results can be accessed using the load_pixel and store_pixel
+ * methods. Single values are then stored in a buffer of a single pixel. */
 class Result {
  private:
   /* The context that the result was created within, this should be initialized during
@@ -94,6 +99,10 @@ class Result {
    * value, the value of which will be identical to that of the value member. See class description
    * for more information. */
   GPUTexture *texture_ = nullptr;
+  /* A CPU buffer storing the result data if the context does not use the GPU, otherwise, this is
+   * nullptr. This will be a single pixel buffer if the result is a single value, the value of
+   * which will be identical to that of the value member. */
+  float *float_texture_ = nullptr;
   /* The number of operations that currently needs this result. At the time when the result is
    * computed, this member will have a value that matches initial_reference_count_. Once each
    * operation that needs the result no longer needs it, the release method is called and the
@@ -227,6 +236,10 @@ class Result {
    * to have a lifetime that covers the evaluation of the compositor. */
   void wrap_external(GPUTexture *texture);
 
+  /* Same as wrap_external but wraps a CPU buffer of the given size instead, for contexts that do
+   * not use the GPU. The buffer should have as many channels as returned by channels_count. */
+  void wrap_external(float *texture, int2 size);
+
   /* Sets the transformation of the domain of the result to the given transformation. */
   void set_transformation(const float3x3 &transformation);
 
@@ -318,12 +331,35 @@ class Result {
   /* Returns the allocated GPU texture of the result. */
   GPUTexture *texture() const;
 
+  /* Returns the allocated CPU buffer of the result, nullptr if the result is stored on the
+   * GPU. */
+  float *float_texture() const;
+
+  /* Returns the number of channels of each pixel in the CPU buffer of the result. */
+  int64_t channels_count() const;
+
+  /* Loads the pixel at the given texel coordinates from the CPU buffer of the result. Channels
+   * that the type of the result does not have are zero. If the result is a single value, its value
+   * is returned regardless of the texel. */
+  float4 load_pixel(const int2 &texel) const;
+
+  /* Stores the given pixel at the given texel coordinates in the CPU buffer of the result, only
+   * the channels that the type of the result has are stored. */
+  void store_pixel(const int2 &texel, const float4 &pixel);
+
   /* Returns the reference count of the result. If this result have a master result, then the
    * reference count of the master result is returned instead. */
   int reference_count() const;
 
   /* Returns a reference to the domain of the result. See the Domain class. */
   const Domain &domain() const;
+
+ private:
+  /* Allocates the CPU buffer of the result with the given size. */
+  void allocate_float_texture(int2 size);
+
+  /* Returns a pointer to the first channel of the pixel at the given texel in the CPU buffer. */
+  float *get_float_pixel(const int2 &texel) const;
 };
 
 }  // namespace blender::realtime_compositor
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_vector.hh"
 
@@ -27,7 +29,10 @@ using namespace nodes::derived_node_tree_types;
  * more information. Derived classes should implement the compile method to add the node and link
  * it to the GPU material given to the method. The compiler is expected to initialize the input
  * links of the node before invoking the compile method. See the discussion in
- * COM_shader_operation.hh for more information. */
+ * COM_shader_operation.hh for more information.
+ *
+ * When the context does not use the GPU, the node is instead evaluated pixel by pixel by calling
+ * the evaluate_pixel method, which derived classes implement along with is_cpu_supported. */
 class ShaderNode {
  private:
   /* The node that this operation represents. */
@@ -52,6 +57,16 @@ class ShaderNode {
    * appropriate resources. */
   virtual void compile(GPUMaterial *material) = 0;
 
+  /* Returns true if the node implements the evaluate_pixel method. Defaults to false. */
+  virtual bool is_cpu_supported() const;
+
+  /* Evaluate the node for a single pixel on the CPU. The inputs are given in the order of the
+   * input sockets of the node and are already converted to the types of the sockets, where floats
+   * are stored in the first component, vectors in the first three components, and colors in all
+   * four components. The outputs should be written in the order of the output sockets in the same
+   * representation. */
+  virtual void evaluate_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const;
+
   /* Returns a contiguous array containing the GPU node stacks of each input. */
   GPUNodeStack *get_inputs_array();
 
@@ -5,11 +5,18 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <utility>
 
+#include "BLI_index_range.hh"
 #include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 
+#include "DNA_node_types.h"
+
 #include "GPU_material.hh"
 #include "GPU_shader.hh"
 
@@ -20,6 +27,7 @@
 #include "COM_context.hh"
 #include "COM_operation.hh"
 #include "COM_scheduler.hh"
+#include "COM_shader_node.hh"
 
 namespace blender::realtime_compositor {
 
@@ -91,7 +99,12 @@ using ShaderCompileUnit = VectorSet<DNode>;
  *
  * The GPU material code generator source is used to construct a compute shader that is then
  * dispatched during operation evaluation after binding the inputs, outputs, and any necessary
- * resources. */
+ * resources.
+ *
+ * If the context does not use the GPU, no GPU material is created. Instead, the nodes are
+ * evaluated in schedule order for every pixel by calling ShaderNode::evaluate_pixel, storing the
+ * values of all sockets in a small per-thread array of values, so the whole compile unit is still
+ * computed in a single multithreaded pass without intermediate images. */
 class ShaderOperation : public Operation {
  private:
   /* A reference to the node execution schedule that is being compiled. */
@@ -118,6 +131,32 @@ class ShaderOperation : public Operation {
    * shader operation. */
   VectorSet<DOutputSocket> preview_outputs_;
 
+  /* An input of a node evaluated on the CPU, identifying the value that provides the input and
+   * the socket types of the provider and the input, to perform implicit conversion. */
+  struct CPUNodeInput {
+    int value_index;
+    eNodeSocketDatatype from_type;
+    eNodeSocketDatatype to_type;
+  };
+  /* A node evaluated on the CPU. The values of its outputs are stored contiguously starting from
+   * the first output value index. */
+  struct CPUNode {
+    const ShaderNode *shader_node;
+    Vector<CPUNodeInput> inputs;
+    IndexRange output_values;
+  };
+  /* The nodes of the compile unit in evaluation order, only used when evaluating on the CPU. */
+  Vector<CPUNode> cpu_nodes_;
+  /* The values of unlinked inputs, which are the same for all pixels. */
+  Vector<std::pair<int, float4>> cpu_constant_values_;
+  /* The identifiers of the inputs of the operation along with the index of their values. */
+  Vector<std::pair<std::string, int>> cpu_input_values_;
+  /* The index of the value of every output socket in the compile unit as well as the output
+   * sockets of nodes outside of the compile unit that are inputs of the operation. */
+  Map<DOutputSocket, int> cpu_output_value_indices_;
+  /* The number of values needed to evaluate a single pixel. */
+  int cpu_values_count_ = 0;
+
  public:
   /* Construct and compile a GPU material from the given shader compile unit and execution schedule
    * by calling GPU_material_from_callbacks with the appropriate callbacks. */
@@ -127,9 +166,12 @@ class ShaderOperation : public Operation {
   ~ShaderOperation();
 
   /* Allocate the output results, bind the shader and all its needed resources, then dispatch the
-   * shader. */
+   * shader. If the context does not use the GPU, evaluate the nodes on the CPU instead. */
   void execute() override;
 
+  /* Returns true if all nodes of the compile unit support CPU evaluation. */
+  bool is_cpu_supported() const override;
+
   /* Compute a node preview for all nodes in the shader operations if the node requires a preview.
    *
    * Previews are computed from results that are populated for outputs that are used to compute
@@ -214,6 +256,13 @@ class ShaderOperation : public Operation {
                                 DOutputSocket output_socket,
                                 GPUMaterial *material);
 
+  /* Given the input socket of a node that is part of the shader operation which is linked to the
+   * given output socket of a node that is not part of the shader operation, declare a new input
+   * descriptor for it and map its identifier to the output socket. The identifier of the new input
+   * is returned. */
+  std::string declare_operation_input_descriptor(DInputSocket input_socket,
+                                                 DOutputSocket output_socket);
+
   /* Given the input socket of a node that is part of the shader operation which is linked to the
    * given output socket of a node that is not part of the shader operation, declare a new input to
    * the operation that is represented in the GPU material by a newly created GPU attribute. It is
@@ -225,9 +274,18 @@ class ShaderOperation : public Operation {
                                DOutputSocket output_socket,
                                GPUMaterial *material);
 
+  /* The counterpart of construct_material when the context does not use the GPU. Instantiates the
+   * shader nodes and gathers the values and links needed to evaluate them on the CPU, declaring
+   * the inputs and populating the results of the operation like construct_material does. */
+  void construct_cpu();
+
+  /* Evaluate the nodes of the compile unit for every pixel of the given domain on the CPU. The
+   * results are expected to be already allocated. */
+  void execute_cpu(const Domain &domain);
+
   /* Populate the output results of the shader operation for output sockets of the given node that
    * are linked to nodes outside of the shader operation or are used to compute a preview for the
-   * node. */
+   * node. The material is null when evaluating on the CPU. */
   void populate_results_for_node(DNode node, GPUMaterial *material);
 
   /* Given the output socket of a node that is part of the shader operation which is linked to an
@@ -235,7 +293,8 @@ class ShaderOperation : public Operation {
    * operation and link it to an output storer passing in the index of the output. In the
    * generate_code_for_outputs method, an image will be added in the shader for each of the
    * declared outputs. Additionally, code will be emitted to define the storer functions that store
-   * the value in the appropriate image identified by the given index. */
+   * the value in the appropriate image identified by the given index. Only the result is populated
+   * when evaluating on the CPU. */
   void populate_operation_result(DOutputSocket output_socket, GPUMaterial *material);
 
   /* A static callback method of interface GPUCodegenCallbackFn that is passed to
@@ -5,7 +5,9 @@
 #pragma once
 
 #include "BLI_function_ref.hh"
+#include "BLI_index_range.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_task.hh"
 
 #include "NOD_derived_node_tree.hh"
 
@@ -70,6 +72,23 @@ void compute_dispatch_threads_at_least(GPUShader *shader,
                                        int2 threads_range,
                                        int2 local_size = int2(16));
 
+/**
+ * Call the given function for each texel in the given range in parallel, the CPU equivalent of
+ * compute_dispatch_threads_at_least. Rows are distributed between threads, so the function should
+ * be cheap enough for a row to be a reasonable amount of work. The function is called with the
+ * integer coordinates of the texel.
+ */
+template<typename Function> inline void parallel_for(const int2 range, const Function &function)
+{
+  threading::parallel_for(IndexRange(range.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(range.x)) {
+        function(int2(x, y));
+      }
+    }
+  });
+}
+
 /* Returns true if a node preview needs to be computed for the give node. */
 bool is_node_preview_needed(const DNode &node);
 
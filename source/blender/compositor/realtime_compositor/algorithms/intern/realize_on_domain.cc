@@ -5,6 +5,8 @@
 #include <limits>
 
 #include "BLI_math_angle_types.hh"
+#include "BLI_math_base.h"
+#include "BLI_math_interp.hh"
 #include "BLI_math_matrix.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
@@ -61,6 +63,71 @@ static const char *get_realization_shader(Result &input,
   return nullptr;
 }
 
+/* Sample the input at the given coordinates in pixel space, where wrapped axes repeat the input
+ * and other axes are zero outside of the input, matching the sampler setup of the GPU path. */
+static float4 sample_input_cpu(const Result &input,
+                               float2 coordinates,
+                               const RealizationOptions &realization_options)
+{
+  const int2 size = input.domain().size;
+  if (realization_options.wrap_x) {
+    coordinates.x = floored_fmod(coordinates.x, float(size.x));
+  }
+  if (realization_options.wrap_y) {
+    coordinates.y = floored_fmod(coordinates.y, float(size.y));
+  }
+
+  const bool use_border = !realization_options.wrap_x && !realization_options.wrap_y;
+  const bool is_outside = (!realization_options.wrap_x &&
+                           (coordinates.x < 0.0f || coordinates.x >= size.x)) ||
+                          (!realization_options.wrap_y &&
+                           (coordinates.y < 0.0f || coordinates.y >= size.y));
+
+  float4 value(0.0f);
+  switch (realization_options.interpolation) {
+    case Interpolation::Nearest:
+      if (!is_outside) {
+        value = input.load_pixel(math::min(int2(math::floor(coordinates)), size - int2(1)));
+      }
+      break;
+    case Interpolation::Bilinear:
+      /* Samples at the border of the input blend with zeros, like the GPU sampler does. */
+      if (use_border) {
+        math::interpolate_bilinear_border_fl(input.float_texture(),
+                                             value,
+                                             size.x,
+                                             size.y,
+                                             input.channels_count(),
+                                             coordinates.x - 0.5f,
+                                             coordinates.y - 0.5f);
+      }
+      else if (!is_outside) {
+        math::interpolate_bilinear_wrap_fl(input.float_texture(),
+                                           value,
+                                           size.x,
+                                           size.y,
+                                           input.channels_count(),
+                                           coordinates.x - 0.5f,
+                                           coordinates.y - 0.5f,
+                                           realization_options.wrap_x,
+                                           realization_options.wrap_y);
+      }
+      break;
+    case Interpolation::Bicubic:
+      if (!is_outside) {
+        math::interpolate_cubic_bspline_fl(input.float_texture(),
+                                           value,
+                                           size.x,
+                                           size.y,
+                                           input.channels_count(),
+                                           coordinates.x - 0.5f,
+                                           coordinates.y - 0.5f);
+      }
+      break;
+  }
+  return value;
+}
+
 void realize_on_domain(Context &context,
                        Result &input,
                        Result &output,
@@ -75,9 +142,6 @@ void realize_on_domain(Context &context,
     return;
   }
 
-  GPUShader *shader = context.get_shader(get_realization_shader(input, realization_options));
-  GPU_shader_bind(shader);
-
   /* Translation from lower-left corner to center of input space. */
   float2 input_translate(-float2(input_domain.size) / 2.0f);
 
@@ -97,6 +161,19 @@ void realize_on_domain(Context &context,
   /* Concatenate to get full transform from output space to input space */
   const float3x3 inverse_transformation = math::invert(in_transformation) * out_transformation;
 
+  if (!context.use_gpu()) {
+    output.allocate_texture(domain);
+    parallel_for(domain.size, [&](const int2 texel) {
+      /* Add 0.5 to evaluate the input at the center of the pixel. */
+      const float3 coordinates = inverse_transformation * float3(float2(texel) + 0.5f, 1.0f);
+      output.store_pixel(texel, sample_input_cpu(input, coordinates.xy(), realization_options));
+    });
+    return;
+  }
+
+  GPUShader *shader = context.get_shader(get_realization_shader(input, realization_options));
+  GPU_shader_bind(shader);
+
   GPU_shader_uniform_mat3_as_mat4(shader, "inverse_transformation", inverse_transformation.ptr());
 
   /* The texture sampler should use bilinear interpolation for both the bilinear and bicubic
@@ -60,6 +60,9 @@ class DericheGaussianCoefficients : public CachedResource {
  public:
   DericheGaussianCoefficients(Context &context, float sigma);
 
+  /* Same as above but without a context, used by the CPU compositor. */
+  DericheGaussianCoefficients(float sigma);
+
   const double4 &feedback_coefficients() const;
   const double4 &causal_feedforward_coefficients() const;
   const double4 &non_causal_feedforward_coefficients() const;
@@ -236,9 +236,14 @@ static double compute_boundary_coefficient(const double4 &feedforward_coefficien
          (1.0 + math::reduce_add(feedback_coefficients));
 }
 
+DericheGaussianCoefficients::DericheGaussianCoefficients(Context & /*context*/, float sigma)
+    : DericheGaussianCoefficients(sigma)
+{
+}
+
 /* Computes the feedback, causal feedforward, and non causal feedforward coefficients given a
  * target Gaussian sigma value as used in Equations (28) and (29) in Deriche's paper. */
-DericheGaussianCoefficients::DericheGaussianCoefficients(Context & /*context*/, float sigma)
+DericheGaussianCoefficients::DericheGaussianCoefficients(float sigma)
 {
   /* The numerator coefficients are the causal feedforward coefficients and the denominator
    * coefficients are the feedback coefficients as can be seen in Equation (28). */
@@ -22,6 +22,24 @@ namespace blender::realtime_compositor {
 
 Context::Context(TexturePool &texture_pool) : texture_pool_(texture_pool) {}
 
+float *Context::get_output_buffer()
+{
+  return nullptr;
+}
+
+float *Context::get_viewer_output_buffer(Domain /* domain */, bool /* is_data */)
+{
+  return nullptr;
+}
+
+const float *Context::get_input_buffer(const Scene * /* scene */,
+                                       int /* view_layer */,
+                                       const char * /* pass_name */,
+                                       int * /* r_channels_count */)
+{
+  return nullptr;
+}
+
 void Context::populate_meta_data_for_pass(const Scene * /* scene*/,
                                           int /* view_layer_id */,
                                           const char * /* pass_name */,
@@ -49,6 +67,11 @@ bool Context::is_canceled() const
   return this->get_node_tree().runtime->test_break(get_node_tree().runtime->tbh);
 }
 
+bool Context::use_gpu() const
+{
+  return true;
+}
+
 void Context::reset()
 {
   texture_pool_.reset();
@@ -31,6 +31,13 @@ void ConversionOperation::execute()
 
   result.allocate_texture(input.domain());
 
+  if (!context().use_gpu()) {
+    parallel_for(input.domain().size, [&](const int2 texel) {
+      result.store_pixel(texel, convert_pixel(input.load_pixel(texel)));
+    });
+    return;
+  }
+
   GPUShader *shader = get_conversion_shader();
   GPU_shader_bind(shader);
 
@@ -44,6 +51,11 @@ void ConversionOperation::execute()
   GPU_shader_unbind();
 }
 
+bool ConversionOperation::is_cpu_supported() const
+{
+  return true;
+}
+
 SimpleOperation *ConversionOperation::construct_if_needed(Context &context,
                                                           const Result &input_result,
                                                           const InputDescriptor &input_descriptor)
@@ -106,6 +118,11 @@ GPUShader *ConvertFloatToVectorOperation::get_conversion_shader() const
   return context().get_shader("compositor_convert_float_to_vector");
 }
 
+float4 ConvertFloatToVectorOperation::convert_pixel(const float4 &value) const
+{
+  return float4(float3(value.x), 1.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -133,6 +150,11 @@ GPUShader *ConvertFloatToColorOperation::get_conversion_shader() const
   return context().get_shader("compositor_convert_float_to_color");
 }
 
+float4 ConvertFloatToColorOperation::convert_pixel(const float4 &value) const
+{
+  return float4(float3(value.x), 1.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -159,6 +181,11 @@ GPUShader *ConvertColorToFloatOperation::get_conversion_shader() const
   return context().get_shader("compositor_convert_color_to_float");
 }
 
+float4 ConvertColorToFloatOperation::convert_pixel(const float4 &value) const
+{
+  return float4((value.x + value.y + value.z) / 3.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -185,6 +212,11 @@ GPUShader *ConvertColorToVectorOperation::get_conversion_shader() const
   return context().get_shader("compositor_convert_color_to_vector");
 }
 
+float4 ConvertColorToVectorOperation::convert_pixel(const float4 &value) const
+{
+  return value;
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -211,6 +243,11 @@ GPUShader *ConvertVectorToFloatOperation::get_conversion_shader() const
   return context().get_shader("compositor_convert_vector_to_float");
 }
 
+float4 ConvertVectorToFloatOperation::convert_pixel(const float4 &value) const
+{
+  return float4((value.x + value.y + value.z) / 3.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -236,6 +273,11 @@ GPUShader *ConvertVectorToColorOperation::get_conversion_shader() const
   return context().get_shader("compositor_convert_vector_to_color");
 }
 
+float4 ConvertVectorToColorOperation::convert_pixel(const float4 &value) const
+{
+  return float4(value.xyz(), 1.0f);
+}
+
 /** \} */
 
 }  // namespace blender::realtime_compositor
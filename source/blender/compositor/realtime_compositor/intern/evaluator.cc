@@ -16,6 +16,7 @@
 #include "COM_operation.hh"
 #include "COM_result.hh"
 #include "COM_scheduler.hh"
+#include "COM_shader_node.hh"
 #include "COM_shader_operation.hh"
 #include "COM_utilities.hh"
 
@@ -55,6 +56,11 @@ void Evaluator::reset()
   is_compiled_ = false;
 }
 
+bool Evaluator::is_cpu_supported() const
+{
+  return is_cpu_supported_;
+}
+
 bool Evaluator::validate_node_tree()
 {
   if (derived_node_tree_->has_link_cycles()) {
@@ -70,8 +76,33 @@ bool Evaluator::validate_node_tree()
   return true;
 }
 
+bool Evaluator::validate_cpu_support(const Schedule &schedule)
+{
+  for (const DNode &node : schedule) {
+    bool is_supported;
+    if (is_shader_node(node)) {
+      std::unique_ptr<ShaderNode> shader_node(node->typeinfo->get_compositor_shader_node(node));
+      is_supported = shader_node->is_cpu_supported();
+    }
+    else {
+      std::unique_ptr<NodeOperation> operation(
+          node->typeinfo->get_compositor_operation(context_, node));
+      is_supported = operation->is_cpu_supported();
+    }
+
+    if (!is_supported) {
+      context_.set_info_message("Compositor node tree has nodes not supported on the CPU!");
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void Evaluator::compile_and_evaluate()
 {
+  is_cpu_supported_ = true;
+
   derived_node_tree_ = std::make_unique<DerivedNodeTree>(context_.get_node_tree());
 
   if (!validate_node_tree()) {
@@ -86,6 +117,12 @@ void Evaluator::compile_and_evaluate()
 
   const Schedule schedule = compute_schedule(context_, *derived_node_tree_);
 
+  if (!context_.use_gpu() && !validate_cpu_support(schedule)) {
+    is_cpu_supported_ = false;
+    reset();
+    return;
+  }
+
   CompileState compile_state(schedule);
 
   for (const DNode &node : schedule) {
@@ -166,7 +203,7 @@ void Evaluator::compile_and_evaluate_shader_compile_unit(CompileState &compile_s
   /* GPUs have hardware limitations on the number of output images shaders can have, so we might
    * have to split the compile unit into smaller units to workaround this limitation. In practice,
    * splitting will almost always never happen due to the scheduling strategy we use, so the base
-   * case remains fast. */
+   * case remains fast. Evaluation on the CPU has no such limitation. */
   int number_of_outputs = 0;
   for (int i : compile_unit.index_range()) {
     const DNode node = compile_unit[i];
@@ -174,7 +211,7 @@ void Evaluator::compile_and_evaluate_shader_compile_unit(CompileState &compile_s
 
     /* The GPU module currently only supports up to 8 output images in shaders, but once this
      * limitation is lifted, we can replace that with GPU_max_images(). */
-    if (number_of_outputs <= 8) {
+    if (number_of_outputs <= 8 || !context_.use_gpu()) {
       continue;
     }
 
@@ -53,6 +53,11 @@ void InputSingleValueOperation::execute()
   }
 }
 
+bool InputSingleValueOperation::is_cpu_supported() const
+{
+  return true;
+}
+
 Result &InputSingleValueOperation::get_result()
 {
   return Operation::get_result(output_identifier_);
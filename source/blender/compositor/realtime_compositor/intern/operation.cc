@@ -32,7 +32,15 @@ void Operation::evaluate()
 
   reset_results();
 
-  execute();
+  if (context().use_gpu() || is_cpu_supported()) {
+    execute();
+  }
+  else {
+    context().set_info_message("Compositor node tree has nodes not supported on the CPU!");
+    for (Result &result : results_.values()) {
+      result.allocate_invalid();
+    }
+  }
 
   compute_preview();
 
@@ -53,6 +61,11 @@ void Operation::map_input_to_result(StringRef identifier, Result *result)
   results_mapped_to_inputs_.add_new(identifier, result);
 }
 
+bool Operation::is_cpu_supported() const
+{
+  return false;
+}
+
 Domain Operation::compute_domain()
 {
   /* Default to an identity domain in case no domain input was found, most likely because all
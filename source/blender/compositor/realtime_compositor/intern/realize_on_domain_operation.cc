@@ -47,6 +47,11 @@ void RealizeOnDomainOperation::execute()
                     get_input().get_realization_options());
 }
 
+bool RealizeOnDomainOperation::is_cpu_supported() const
+{
+  return true;
+}
+
 Domain RealizeOnDomainOperation::compute_domain()
 {
   return domain_;
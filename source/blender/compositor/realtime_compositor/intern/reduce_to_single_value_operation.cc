@@ -27,6 +27,11 @@ ReduceToSingleValueOperation::ReduceToSingleValueOperation(Context &context, Res
 
 void ReduceToSingleValueOperation::execute()
 {
+  if (!context().use_gpu()) {
+    execute_cpu();
+    return;
+  }
+
   /* Make sure any prior writes to the texture are reflected before downloading it. */
   GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
 
@@ -54,6 +59,34 @@ void ReduceToSingleValueOperation::execute()
   MEM_freeN(pixel);
 }
 
+void ReduceToSingleValueOperation::execute_cpu()
+{
+  const float4 pixel = get_input().load_pixel(int2(0));
+
+  Result &result = get_result();
+  result.allocate_single_value();
+  switch (result.type()) {
+    case ResultType::Color:
+      result.set_color_value(pixel);
+      break;
+    case ResultType::Vector:
+      result.set_vector_value(pixel);
+      break;
+    case ResultType::Float:
+      result.set_float_value(pixel.x);
+      break;
+    default:
+      /* Other types are internal and needn't be handled by operations. */
+      BLI_assert_unreachable();
+      break;
+  }
+}
+
+bool ReduceToSingleValueOperation::is_cpu_supported() const
+{
+  return true;
+}
+
 SimpleOperation *ReduceToSingleValueOperation::construct_if_needed(Context &context,
                                                                    const Result &input_result)
 {
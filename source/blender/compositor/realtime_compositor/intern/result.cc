@@ -3,9 +3,12 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include "BLI_assert.h"
+#include "BLI_index_range.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
 
+#include "MEM_guardedalloc.h"
+
 #include "GPU_shader.hh"
 #include "GPU_state.hh"
 #include "GPU_texture.hh"
@@ -182,7 +185,12 @@ void Result::allocate_texture(Domain domain)
   }
 
   is_single_value_ = false;
-  texture_ = context_->texture_pool().acquire(domain.size, get_texture_format());
+  if (context_->use_gpu()) {
+    texture_ = context_->texture_pool().acquire(domain.size, get_texture_format());
+  }
+  else {
+    allocate_float_texture(domain.size);
+  }
   domain_ = domain;
 }
 
@@ -191,10 +199,22 @@ void Result::allocate_single_value()
   is_single_value_ = true;
   /* Single values are stored in 1x1 textures as well as the single value members. */
   const int2 texture_size{1, 1};
-  texture_ = context_->texture_pool().acquire(texture_size, get_texture_format());
+  if (context_->use_gpu()) {
+    texture_ = context_->texture_pool().acquire(texture_size, get_texture_format());
+  }
+  else {
+    allocate_float_texture(texture_size);
+  }
   domain_ = Domain::identity();
 }
 
+void Result::allocate_float_texture(const int2 size)
+{
+  const size_t pixels_count = size_t(size.x) * size_t(size.y);
+  float_texture_ = static_cast<float *>(
+      MEM_malloc_arrayN(pixels_count * channels_count(), sizeof(float), __func__));
+}
+
 void Result::allocate_invalid()
 {
   allocate_single_value();
@@ -268,6 +288,7 @@ void Result::steal_data(Result &source)
 
   is_single_value_ = source.is_single_value_;
   texture_ = source.texture_;
+  float_texture_ = source.float_texture_;
   context_ = source.context_;
   domain_ = source.domain_;
 
@@ -287,6 +308,7 @@ void Result::steal_data(Result &source)
   }
 
   source.texture_ = nullptr;
+  source.float_texture_ = nullptr;
   source.context_ = nullptr;
 }
 
@@ -302,6 +324,17 @@ void Result::wrap_external(GPUTexture *texture)
   domain_ = Domain(int2(GPU_texture_width(texture), GPU_texture_height(texture)));
 }
 
+void Result::wrap_external(float *texture, const int2 size)
+{
+  BLI_assert(!is_allocated());
+  BLI_assert(!master_);
+
+  float_texture_ = texture;
+  is_external_ = true;
+  is_single_value_ = false;
+  domain_ = Domain(size);
+}
+
 void Result::set_transformation(const float3x3 &transformation)
 {
   domain_.transformation = transformation;
@@ -359,19 +392,34 @@ float4 Result::get_color_value_default(const float4 &default_value) const
 void Result::set_float_value(float value)
 {
   float_value_ = value;
-  GPU_texture_update(texture_, GPU_DATA_FLOAT, &float_value_);
+  if (float_texture_) {
+    float_texture_[0] = value;
+  }
+  else {
+    GPU_texture_update(texture_, GPU_DATA_FLOAT, &float_value_);
+  }
 }
 
 void Result::set_vector_value(const float4 &value)
 {
   vector_value_ = value;
-  GPU_texture_update(texture_, GPU_DATA_FLOAT, vector_value_);
+  if (float_texture_) {
+    store_pixel(int2(0), value);
+  }
+  else {
+    GPU_texture_update(texture_, GPU_DATA_FLOAT, vector_value_);
+  }
 }
 
 void Result::set_color_value(const float4 &value)
 {
   color_value_ = value;
-  GPU_texture_update(texture_, GPU_DATA_FLOAT, color_value_);
+  if (float_texture_) {
+    store_pixel(int2(0), value);
+  }
+  else {
+    GPU_texture_update(texture_, GPU_DATA_FLOAT, color_value_);
+  }
 }
 
 void Result::set_initial_reference_count(int count)
@@ -411,9 +459,13 @@ void Result::release()
   reference_count_--;
   if (reference_count_ == 0) {
     if (!is_external_) {
-      context_->texture_pool().release(texture_);
+      if (texture_) {
+        context_->texture_pool().release(texture_);
+      }
+      MEM_SAFE_FREE(float_texture_);
     }
     texture_ = nullptr;
+    float_texture_ = nullptr;
   }
 }
 
@@ -451,7 +503,7 @@ bool Result::is_single_value() const
 
 bool Result::is_allocated() const
 {
-  return texture_ != nullptr;
+  return texture_ != nullptr || float_texture_ != nullptr;
 }
 
 GPUTexture *Result::texture() const
@@ -459,6 +511,58 @@ GPUTexture *Result::texture() const
   return texture_;
 }
 
+float *Result::float_texture() const
+{
+  return float_texture_;
+}
+
+int64_t Result::channels_count() const
+{
+  switch (type_) {
+    case ResultType::Float:
+      return 1;
+    case ResultType::Float2:
+    case ResultType::Int2:
+      return 2;
+    case ResultType::Float3:
+      return 3;
+    case ResultType::Vector:
+    case ResultType::Color:
+      return 4;
+  }
+
+  BLI_assert_unreachable();
+  return 4;
+}
+
+float *Result::get_float_pixel(const int2 &texel) const
+{
+  BLI_assert(float_texture_ != nullptr);
+  if (is_single_value_) {
+    return float_texture_;
+  }
+  BLI_assert(texel.x >= 0 && texel.x < domain_.size.x && texel.y >= 0 && texel.y < domain_.size.y);
+  return float_texture_ + (int64_t(texel.y) * domain_.size.x + texel.x) * channels_count();
+}
+
+float4 Result::load_pixel(const int2 &texel) const
+{
+  const float *pixel = get_float_pixel(texel);
+  float4 value(0.0f);
+  for (const int64_t i : IndexRange(channels_count())) {
+    value[i] = pixel[i];
+  }
+  return value;
+}
+
+void Result::store_pixel(const int2 &texel, const float4 &pixel)
+{
+  float *destination = get_float_pixel(texel);
+  for (const int64_t i : IndexRange(channels_count())) {
+    destination[i] = pixel[i];
+  }
+}
+
 int Result::reference_count() const
 {
   /* If there is a master result, return its reference count instead. */
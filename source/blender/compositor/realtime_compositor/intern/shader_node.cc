@@ -25,6 +25,16 @@ ShaderNode::ShaderNode(DNode node) : node_(node)
   populate_outputs();
 }
 
+bool ShaderNode::is_cpu_supported() const
+{
+  return false;
+}
+
+void ShaderNode::evaluate_pixel(Span<float4> /*inputs*/, MutableSpan<float4> /*outputs*/) const
+{
+  BLI_assert_unreachable();
+}
+
 GPUNodeStack *ShaderNode::get_inputs_array()
 {
   return inputs_.data();
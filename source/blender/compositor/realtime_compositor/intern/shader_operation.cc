@@ -2,13 +2,19 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 
+#include "BLI_array.hh"
 #include "BLI_assert.h"
+#include "BLI_index_range.hh"
 #include "BLI_listbase.h"
 #include "BLI_map.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "DNA_customdata_types.h"
@@ -41,8 +47,13 @@ using namespace nodes::derived_node_tree_types;
 ShaderOperation::ShaderOperation(Context &context,
                                  ShaderCompileUnit &compile_unit,
                                  const Schedule &schedule)
-    : Operation(context), schedule_(schedule), compile_unit_(compile_unit)
+    : Operation(context), schedule_(schedule), compile_unit_(compile_unit), material_(nullptr)
 {
+  if (!context.use_gpu()) {
+    construct_cpu();
+    return;
+  }
+
   material_ = GPU_material_from_callbacks(
       GPU_MAT_COMPOSITOR, &construct_material, &generate_code, this);
   GPU_material_status_set(material_, GPU_MAT_QUEUED);
@@ -51,7 +62,9 @@ ShaderOperation::ShaderOperation(Context &context,
 
 ShaderOperation::~ShaderOperation()
 {
-  GPU_material_free_single(material_);
+  if (material_) {
+    GPU_material_free_single(material_);
+  }
 }
 
 void ShaderOperation::execute()
@@ -62,6 +75,11 @@ void ShaderOperation::execute()
     result.allocate_texture(domain);
   }
 
+  if (!context().use_gpu()) {
+    execute_cpu(domain);
+    return;
+  }
+
   GPUShader *shader = GPU_material_get_shader(material_);
   GPU_shader_bind(shader);
 
@@ -77,6 +95,173 @@ void ShaderOperation::execute()
   GPU_shader_unbind();
 }
 
+bool ShaderOperation::is_cpu_supported() const
+{
+  for (const std::unique_ptr<ShaderNode> &shader_node : shader_nodes_.values()) {
+    if (!shader_node->is_cpu_supported()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Implicitly convert the given value between socket types, following the conversion functions of
+ * gpu_shader_compositor_type_conversion.glsl that are used when evaluating on the GPU. */
+static float4 convert_socket_value(const float4 &value,
+                                   const eNodeSocketDatatype from_type,
+                                   const eNodeSocketDatatype to_type)
+{
+  if (from_type == to_type) {
+    return value;
+  }
+
+  switch (to_type) {
+    case SOCK_FLOAT:
+      return float4((value.x + value.y + value.z) / 3.0f, 0.0f, 0.0f, 0.0f);
+    case SOCK_VECTOR:
+      if (from_type == SOCK_FLOAT) {
+        return float4(float3(value.x), 0.0f);
+      }
+      return float4(value.xyz(), 0.0f);
+    case SOCK_RGBA:
+      if (from_type == SOCK_FLOAT) {
+        return float4(float3(value.x), 1.0f);
+      }
+      return float4(value.xyz(), 1.0f);
+    default:
+      break;
+  }
+
+  BLI_assert_unreachable();
+  return value;
+}
+
+/* Get the value of the given GPU node stack in the representation expected by
+ * ShaderNode::evaluate_pixel, ignoring components that are not used by the socket type. */
+static float4 value_from_gpu_node_stack(const GPUNodeStack &stack)
+{
+  switch (stack.sockettype) {
+    case SOCK_FLOAT:
+      return float4(stack.vec[0], 0.0f, 0.0f, 0.0f);
+    case SOCK_VECTOR:
+      return float4(stack.vec[0], stack.vec[1], stack.vec[2], 0.0f);
+    default:
+      return float4(stack.vec);
+  }
+}
+
+void ShaderOperation::construct_cpu()
+{
+  for (DNode node : compile_unit_) {
+    ShaderNode *shader_node = node->typeinfo->get_compositor_shader_node(node);
+    shader_nodes_.add_new(node, std::unique_ptr<ShaderNode>(shader_node));
+
+    CPUNode cpu_node;
+    cpu_node.shader_node = shader_node;
+
+    const GPUNodeStack *input_stacks = shader_node->get_inputs_array();
+    for (const bNodeSocket *input : node->input_sockets()) {
+      const DInputSocket dinput{node.context(), input};
+      const eNodeSocketDatatype input_type = eNodeSocketDatatype(input->type);
+
+      /* Unlinked inputs have a constant value, which was already computed for the GPU node stack
+       * of the input. */
+      const DOutputSocket doutput = get_output_linked_to_input(dinput);
+      if (!doutput) {
+        const int value_index = cpu_values_count_++;
+        cpu_constant_values_.append(
+            {value_index, value_from_gpu_node_stack(input_stacks[input->index()])});
+        cpu_node.inputs.append({value_index, input_type, input_type});
+        continue;
+      }
+
+      /* Inputs linked to nodes outside of the compile unit are inputs of the operation, declared
+       * only once for each distinct output socket, like link_node_input_external does. Their
+       * values are loaded from the input results for every pixel. */
+      if (!compile_unit_.contains(doutput.node()) && !cpu_output_value_indices_.contains(doutput))
+      {
+        const int value_index = cpu_values_count_++;
+        const std::string identifier = declare_operation_input_descriptor(dinput, doutput);
+        cpu_input_values_.append({identifier, value_index});
+        cpu_output_value_indices_.add_new(doutput, value_index);
+      }
+
+      cpu_node.inputs.append({cpu_output_value_indices_.lookup(doutput),
+                              eNodeSocketDatatype(doutput->type),
+                              input_type});
+    }
+
+    const int outputs_count = node->output_sockets().size();
+    cpu_node.output_values = IndexRange(cpu_values_count_, outputs_count);
+    cpu_values_count_ += outputs_count;
+    for (const bNodeSocket *output : node->output_sockets()) {
+      const DOutputSocket doutput{node.context(), output};
+      cpu_output_value_indices_.add_new(doutput, cpu_node.output_values[output->index()]);
+    }
+
+    cpu_nodes_.append(std::move(cpu_node));
+
+    populate_results_for_node(node, nullptr);
+  }
+}
+
+void ShaderOperation::execute_cpu(const Domain &domain)
+{
+  /* Look up the input and output results once, as opposed to for every pixel. */
+  Vector<std::pair<const Result *, int>> inputs;
+  for (const std::pair<std::string, int> &input : cpu_input_values_) {
+    inputs.append({&get_input(input.first), input.second});
+  }
+
+  Vector<std::pair<Result *, int>> outputs;
+  for (const auto item : output_sockets_to_output_identifiers_map_.items()) {
+    outputs.append({&get_result(item.value), cpu_output_value_indices_.lookup(item.key)});
+  }
+
+  int max_inputs_count = 0;
+  for (const CPUNode &cpu_node : cpu_nodes_) {
+    max_inputs_count = std::max(max_inputs_count, int(cpu_node.inputs.size()));
+  }
+
+  threading::parallel_for(IndexRange(domain.size.y), 1, [&](const IndexRange sub_y_range) {
+    Array<float4> values(cpu_values_count_, float4(0.0f));
+    for (const std::pair<int, float4> &constant : cpu_constant_values_) {
+      values[constant.first] = constant.second;
+    }
+    Array<float4> node_inputs(max_inputs_count);
+
+    for (const int64_t y : sub_y_range) {
+      for (const int64_t x : IndexRange(domain.size.x)) {
+        const int2 texel = int2(x, y);
+
+        for (const std::pair<const Result *, int> &input : inputs) {
+          values[input.second] = input.first->load_pixel(texel);
+        }
+
+        for (const CPUNode &cpu_node : cpu_nodes_) {
+          for (const int i : cpu_node.inputs.index_range()) {
+            const CPUNodeInput &input = cpu_node.inputs[i];
+            node_inputs[i] = convert_socket_value(
+                values[input.value_index], input.from_type, input.to_type);
+          }
+          cpu_node.shader_node->evaluate_pixel(
+              node_inputs.as_span().take_front(cpu_node.inputs.size()),
+              values.as_mutable_span().slice(cpu_node.output_values));
+        }
+
+        /* Vectors are stored with a zero fourth component, like the GPU storer does. */
+        for (const std::pair<Result *, int> &output : outputs) {
+          const float4 &value = values[output.second];
+          output.first->store_pixel(texel,
+                                    output.first->type() == ResultType::Vector ?
+                                        float4(value.xyz(), 0.0f) :
+                                        value);
+        }
+      }
+    }
+  });
+}
+
 void ShaderOperation::compute_preview()
 {
   for (const DOutputSocket &output : preview_outputs_) {
@@ -240,11 +425,10 @@ static const char *get_set_function_name(ResultType type)
   return nullptr;
 }
 
-void ShaderOperation::declare_operation_input(DInputSocket input_socket,
-                                              DOutputSocket output_socket,
-                                              GPUMaterial *material)
+std::string ShaderOperation::declare_operation_input_descriptor(DInputSocket input_socket,
+                                                               DOutputSocket output_socket)
 {
-  const int input_index = output_to_material_attribute_map_.size();
+  const int input_index = inputs_to_linked_outputs_map_.size();
   std::string input_identifier = "input" + std::to_string(input_index);
 
   /* Declare the input descriptor for this input and prefer to declare its type to be the same as
@@ -253,21 +437,32 @@ void ShaderOperation::declare_operation_input(DInputSocket input_socket,
   input_descriptor.type = get_node_socket_result_type(output_socket.bsocket());
   declare_input_descriptor(input_identifier, input_descriptor);
 
+  /* Map the identifier of the operation input to the output socket it is linked to. */
+  inputs_to_linked_outputs_map_.add_new(input_identifier, output_socket);
+
+  return input_identifier;
+}
+
+void ShaderOperation::declare_operation_input(DInputSocket input_socket,
+                                              DOutputSocket output_socket,
+                                              GPUMaterial *material)
+{
+  const std::string input_identifier = declare_operation_input_descriptor(input_socket,
+                                                                          output_socket);
+  const ResultType input_type = get_input_descriptor(input_identifier).type;
+
   /* Add a new GPU attribute representing an input to the GPU material. Instead of using the
    * attribute directly, we link it to an appropriate set function and use its output link instead.
    * This is needed because the `gputype` member of the attribute is only initialized if it is
    * linked to a GPU node. */
   GPUNodeLink *attribute_link;
   GPU_link(material,
-           get_set_function_name(input_descriptor.type),
+           get_set_function_name(input_type),
            GPU_attribute(material, CD_AUTO_FROM_NAME, input_identifier.c_str()),
            &attribute_link);
 
   /* Map the output socket to the attribute that was created for it. */
   output_to_material_attribute_map_.add(output_socket, attribute_link);
-
-  /* Map the identifier of the operation input to the output socket it is linked to. */
-  inputs_to_linked_outputs_map_.add_new(input_identifier, output_socket);
 }
 
 void ShaderOperation::populate_results_for_node(DNode node, GPUMaterial *material)
@@ -326,6 +521,11 @@ void ShaderOperation::populate_operation_result(DOutputSocket output_socket, GPU
   /* Map the output socket to the identifier of the newly populated result. */
   output_sockets_to_output_identifiers_map_.add_new(output_socket, output_identifier);
 
+  /* When evaluating on the CPU, the output value is stored in the result directly. */
+  if (!material) {
+    return;
+  }
+
   ShaderNode &node = *shader_nodes_.lookup(output_socket.node());
   GPUNodeLink *output_link = node.get_output(output_socket->identifier).link;
 
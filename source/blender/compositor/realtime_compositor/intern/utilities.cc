@@ -6,6 +6,7 @@
 #include "BLI_function_ref.hh"
 #include "BLI_index_range.hh"
 #include "BLI_math_color.h"
+#include "BLI_math_interp.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_task.hh"
@@ -192,22 +193,12 @@ static int2 compute_preview_size(int2 size)
   }
 }
 
-void compute_preview_from_result(Context &context, const DNode &node, Result &input_result)
+/* Computes the preview pixels of the given result on the GPU and returns them as an RGBA buffer
+ * of the given preview size. The returned buffer should be freed by the caller. */
+static float *compute_preview_pixels_gpu(Context &context,
+                                         Result &input_result,
+                                         const int2 preview_size)
 {
-  /* Initialize node tree previews if not already initialized. */
-  bNodeTree *root_tree = const_cast<bNodeTree *>(
-      &node.context()->derived_tree().root_context().btree());
-  if (!root_tree->previews) {
-    root_tree->previews = bke::BKE_node_instance_hash_new("node previews");
-  }
-
-  const int2 preview_size = compute_preview_size(input_result.domain().size);
-  node->runtime->preview_xsize = preview_size.x;
-  node->runtime->preview_ysize = preview_size.y;
-
-  bNodePreview *preview = bke::node_preview_verify(
-      root_tree->previews, node.instance_key(), preview_size.x, preview_size.y, true);
-
   GPUShader *shader = context.get_shader("compositor_compute_preview");
   GPU_shader_bind(shader);
 
@@ -232,6 +223,65 @@ void compute_preview_from_result(Context &context, const DNode &node, Result &in
       GPU_texture_read(preview_result.texture(), GPU_DATA_FLOAT, 0));
   preview_result.release();
 
+  /* Restore original swizzle mask set above. */
+  if (input_result.type() == ResultType::Float) {
+    GPU_texture_swizzle_set(input_result.texture(), "rgba");
+  }
+
+  return preview_pixels;
+}
+
+/* Same as compute_preview_pixels_gpu but for results stored on the CPU. */
+static float *compute_preview_pixels_cpu(const Result &input_result, const int2 preview_size)
+{
+  float *preview_pixels = static_cast<float *>(MEM_malloc_arrayN(
+      size_t(preview_size.x) * size_t(preview_size.y) * 4, sizeof(float), __func__));
+
+  const int2 input_size = input_result.domain().size;
+  parallel_for(preview_size, [&](const int2 texel) {
+    /* Sample at the center of the preview pixel, with the same bilinear filtering as the GPU. */
+    const float2 coordinates = (float2(texel) + float2(0.5f)) / float2(preview_size) *
+                                   float2(input_size) -
+                               float2(0.5f);
+    float4 color(0.0f);
+    math::interpolate_bilinear_fl(input_result.float_texture(),
+                                  color,
+                                  input_size.x,
+                                  input_size.y,
+                                  input_result.channels_count(),
+                                  coordinates.x,
+                                  coordinates.y);
+    if (input_result.type() == ResultType::Float) {
+      color = float4(float3(color.x), 1.0f);
+    }
+
+    const int64_t index = (int64_t(texel.y) * preview_size.x + texel.x) * 4;
+    copy_v4_v4(preview_pixels + index, color);
+  });
+
+  return preview_pixels;
+}
+
+void compute_preview_from_result(Context &context, const DNode &node, Result &input_result)
+{
+  /* Initialize node tree previews if not already initialized. */
+  bNodeTree *root_tree = const_cast<bNodeTree *>(
+      &node.context()->derived_tree().root_context().btree());
+  if (!root_tree->previews) {
+    root_tree->previews = bke::BKE_node_instance_hash_new("node previews");
+  }
+
+  const int2 preview_size = compute_preview_size(input_result.domain().size);
+  node->runtime->preview_xsize = preview_size.x;
+  node->runtime->preview_ysize = preview_size.y;
+
+  bNodePreview *preview = bke::node_preview_verify(
+      root_tree->previews, node.instance_key(), preview_size.x, preview_size.y, true);
+
+  float *preview_pixels = context.use_gpu() ?
+                              compute_preview_pixels_gpu(context, input_result, preview_size) :
+                              compute_preview_pixels_cpu(input_result, preview_size);
+
   ColormanageProcessor *color_processor = IMB_colormanagement_display_processor_new(
       &context.get_scene().view_settings, &context.get_scene().display_settings);
 
@@ -245,11 +295,6 @@ void compute_preview_from_result(Context &context, const DNode &node, Result &in
     }
   });
 
-  /* Restore original swizzle mask set above. */
-  if (input_result.type() == ResultType::Float) {
-    GPU_texture_swizzle_set(input_result.texture(), "rgba");
-  }
-
   IMB_colormanagement_processor_free(color_processor);
   MEM_freeN(preview_pixels);
 }
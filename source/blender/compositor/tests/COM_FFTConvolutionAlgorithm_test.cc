@@ -0,0 +1,68 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
+
+#include "COM_FFTConvolutionAlgorithm.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor::tests {
+
+TEST(FFTConvolution, MatchesDirectConvolution)
+{
+  if (!is_fft_convolution_supported()) {
+    GTEST_SKIP() << "Compositor was built without FFTW";
+  }
+
+  RandomNumberGenerator rng(0);
+
+  const rcti input_rect = {0, 40, 0, 30};
+  MemoryBuffer input(DataType::Color, input_rect);
+  for (BuffersIterator<float> it = input.iterate_with({}); !it.is_end(); ++it) {
+    for (const int channel : IndexRange(4)) {
+      it.out[channel] = rng.get_float();
+    }
+  }
+
+  /* A random kernel normalized per channel, which is not symmetric to catch flipped kernels. */
+  const int radius = 16;
+  const int kernel_size = radius * 2 + 1;
+  Array<float4> kernel(kernel_size * kernel_size);
+  float4 sum = float4(0.0f);
+  for (float4 &weight : kernel) {
+    weight = float4(rng.get_float(), rng.get_float(), rng.get_float(), rng.get_float());
+    sum += weight;
+  }
+  for (float4 &weight : kernel) {
+    weight /= sum;
+  }
+
+  /* Also compute pixels outside of the input to test clamping. */
+  const rcti area = {-4, 44, 2, 34};
+  MemoryBuffer output(DataType::Color, area);
+  fft_convolve(input, output, area, kernel, radius);
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      float4 expected = float4(0.0f);
+      for (int yi = -radius; yi <= radius; yi++) {
+        for (int xi = -radius; xi <= radius; xi++) {
+          const float4 weight = kernel[(xi + radius) + (yi + radius) * kernel_size];
+          expected += float4(input.get_elem_clamped(x + xi, y + yi)) * weight;
+        }
+      }
+
+      const float *result = output.get_elem(x, y);
+      for (const int channel : IndexRange(4)) {
+        EXPECT_NEAR(result[channel], expected[channel], 1e-4f) << "at " << x << ", " << y;
+      }
+    }
+  }
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,278 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "BLI_array.hh"
+#include "BLI_rect.h"
+#include "BLI_vector.hh"
+
+#include "CLG_log.h"
+
+#include "GHOST_Path-api.hh"
+
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+#include "RNA_define.hh"
+
+#include "BKE_appdir.hh"
+#include "BKE_global.hh"
+#include "BKE_idtype.hh"
+#include "BKE_main.hh"
+#include "BKE_node.hh"
+#include "BKE_node_runtime.hh"
+#include "BKE_scene.hh"
+
+#include "IMB_imbuf.hh"
+
+#include "NOD_composite.hh"
+
+#include "COM_CompositorContext.h"
+#include "COM_ExecutionSystem.h"
+#include "COM_FullFrameExecutionModel.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+#include "COM_SharedOperationBuffers.h"
+#include "COM_WorkScheduler.h"
+
+namespace blender::compositor::tests {
+
+/* Odd sizes so that the last band is smaller than the others. */
+static constexpr int width = 37;
+static constexpr int height = 203;
+static constexpr rcti canvas = {0, width, 0, height};
+
+/* A source whose pixels all differ, rendered at once as it is not a pixel operation. */
+class GradientOperation : public NodeOperation {
+ public:
+  GradientOperation()
+  {
+    add_output_socket(DataType::Value);
+    set_canvas(canvas);
+  }
+
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> /*inputs*/) override
+  {
+    for (int y = area.ymin; y < area.ymax; y++) {
+      for (int x = area.xmin; x < area.xmax; x++) {
+        *output->get_elem(x, y) = x * 0.37f + y * 1.3f + ((x * 7 + y * 13) % 11);
+      }
+    }
+  }
+};
+
+/* A pixel operation recording the areas it renders, which are bands when streamed. */
+class ScaleOperation : public NodeOperation {
+ private:
+  float factor_;
+
+ public:
+  Vector<rcti> rendered_areas;
+
+  ScaleOperation(NodeOperation &input, const float factor) : factor_(factor)
+  {
+    add_input_socket(DataType::Value);
+    add_output_socket(DataType::Value);
+    set_canvas(canvas);
+    flags_.is_pixel_operation = true;
+    get_input_socket(0)->set_link(input.get_output_socket());
+  }
+
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override
+  {
+    rendered_areas.append(area);
+    for (int y = area.ymin; y < area.ymax; y++) {
+      for (int x = area.xmin; x < area.xmax; x++) {
+        *output->get_elem(x, y) = *inputs[0]->get_elem(x, y) * factor_ + 0.5f;
+      }
+    }
+  }
+};
+
+/* A 3x3 box filter, reading the neighbors of pixels on both sides of band edges. */
+class BoxFilterOperation : public NodeOperation {
+ public:
+  BoxFilterOperation(NodeOperation &input)
+  {
+    add_input_socket(DataType::Value);
+    add_output_socket(DataType::Value);
+    set_canvas(canvas);
+    get_input_socket(0)->set_link(input.get_output_socket());
+  }
+
+  void get_area_of_interest(const int /*input_idx*/,
+                            const rcti &output_area,
+                            rcti &r_input_area) override
+  {
+    r_input_area = output_area;
+    BLI_rcti_pad(&r_input_area, 1, 1);
+  }
+
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override
+  {
+    for (int y = area.ymin; y < area.ymax; y++) {
+      for (int x = area.xmin; x < area.xmax; x++) {
+        float sum = 0.0f;
+        for (int j = -1; j <= 1; j++) {
+          for (int i = -1; i <= 1; i++) {
+            sum += *inputs[0]->get_elem_clamped(x + i, y + j);
+          }
+        }
+        *output->get_elem(x, y) = sum / 9.0f;
+      }
+    }
+  }
+};
+
+/* An output operation copying its input into #result. */
+class ResultOperation : public NodeOperation {
+ public:
+  Array<float> result = Array<float>(width * height, 0.0f);
+
+  ResultOperation(NodeOperation &input)
+  {
+    add_input_socket(DataType::Value);
+    set_canvas(canvas);
+    get_input_socket(0)->set_link(input.get_output_socket());
+  }
+
+  bool is_output_operation(bool /*rendering*/) const override
+  {
+    return true;
+  }
+
+  void update_memory_buffer(MemoryBuffer * /*output*/,
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override
+  {
+    for (int y = area.ymin; y < area.ymax; y++) {
+      for (int x = area.xmin; x < area.xmax; x++) {
+        result[y * width + x] = *inputs[0]->get_elem(x, y);
+      }
+    }
+  }
+};
+
+class FullFrameExecutionModelTest : public testing::Test {
+ protected:
+  Main *bmain_ = nullptr;
+  Scene *scene_ = nullptr;
+  bNodeTree *node_tree_ = nullptr;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    BKE_appdir_init();
+    IMB_init();
+    RNA_init();
+    bke::BKE_node_system_init();
+    WorkScheduler::initialize(1);
+  }
+
+  static void TearDownTestSuite()
+  {
+    WorkScheduler::deinitialize();
+    bke::BKE_node_system_exit();
+    RNA_exit();
+    IMB_exit();
+    GHOST_DisposeSystemPaths();
+    BKE_appdir_exit();
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    bmain_ = BKE_main_new();
+    G.main = bmain_;
+    scene_ = BKE_scene_add(bmain_, "CompositorScene");
+    node_tree_ = bke::ntreeAddTreeEmbedded(
+        nullptr, &scene_->id, "Compositing Nodetree", ntreeType_Composite->idname);
+    scene_->nodetree = node_tree_;
+
+    node_tree_->runtime->progress = [](void * /*data*/, float /*progress*/) {};
+    node_tree_->runtime->stats_draw = [](void * /*data*/, const char * /*str*/) {};
+    node_tree_->runtime->test_break = [](void * /*data*/) { return false; };
+  }
+
+  void TearDown() override
+  {
+    BKE_main_free(bmain_);
+    G.main = nullptr;
+  }
+
+  /* Renders given operations, the intermediate results of chains of pixel operations using at
+   * most given memory. The node tree is empty, the execution system only drives the model. */
+  void execute(Span<NodeOperation *> operations, const int64_t streaming_memory_limit)
+  {
+    ExecutionSystem exec_system(
+        &scene_->r, scene_, node_tree_, false, "", nullptr, nullptr, nullptr, 0);
+
+    CompositorContext context;
+    context.set_scene(scene_);
+    context.set_bnodetree(node_tree_);
+    context.set_render_data(&scene_->r);
+    context.set_rendering(false);
+
+    SharedOperationBuffers shared_buffers;
+    FullFrameExecutionModel execution_model(
+        context, shared_buffers, nullptr, streaming_memory_limit, operations);
+    execution_model.execute(exec_system);
+  }
+};
+
+TEST_F(FullFrameExecutionModelTest, StreamedMatchesFullFrame)
+{
+  /* Renders Gradient -> Scale -> Scale -> Box Filter -> Scale -> Scale -> Result, where the first
+   * scale of each pair of scales is streamed into the second one. */
+  const auto render = [&](const int64_t streaming_memory_limit,
+                          Vector<rcti> &r_first_chain_areas,
+                          Vector<rcti> &r_second_chain_areas) {
+    GradientOperation gradient;
+    ScaleOperation scale_a(gradient, 0.5f);
+    ScaleOperation scale_b(scale_a, 3.0f);
+    BoxFilterOperation box_filter(scale_b);
+    ScaleOperation scale_c(box_filter, 2.0f);
+    ScaleOperation scale_d(scale_c, 0.25f);
+    ResultOperation result(scale_d);
+
+    execute({&gradient, &scale_a, &scale_b, &box_filter, &scale_c, &scale_d, &result},
+            streaming_memory_limit);
+
+    r_first_chain_areas = scale_a.rendered_areas;
+    r_second_chain_areas = scale_c.rendered_areas;
+    return result.result;
+  };
+
+  Vector<rcti> first_chain_areas;
+  Vector<rcti> second_chain_areas;
+  const Array<float> full_frame = render(
+      std::numeric_limits<int64_t>::max(), first_chain_areas, second_chain_areas);
+  EXPECT_EQ(first_chain_areas.size(), 1);
+  EXPECT_EQ(second_chain_areas.size(), 1);
+
+  /* The smallest limit renders bands of the minimum number of rows. */
+  const Array<float> streamed = render(1, first_chain_areas, second_chain_areas);
+  EXPECT_EQ(first_chain_areas.size(), 4);
+  EXPECT_EQ(second_chain_areas.size(), 4);
+  for (const rcti &band : first_chain_areas) {
+    EXPECT_EQ(BLI_rcti_size_x(&band), width);
+    EXPECT_LE(BLI_rcti_size_y(&band), 64);
+  }
+
+  EXPECT_TRUE(std::equal(
+      full_frame.begin(), full_frame.end(), streamed.begin(), streamed.end()));
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,141 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <typeindex>
+
+#include "COM_MemoryBuffer.h"
+#include "COM_OperationResultCache.h"
+
+namespace blender::compositor::tests {
+
+using KeyPtr = std::shared_ptr<const OperationResultKey>;
+
+/* Stand-ins for operation types. */
+struct SourceOperation {};
+struct FilterOperation {};
+
+static KeyPtr create_key(const std::type_index type,
+                         const int setting,
+                         Vector<KeyPtr> inputs = {},
+                         const rcti &canvas = {0, 4, 0, 1})
+{
+  Vector<uint8_t> settings(sizeof(setting));
+  memcpy(settings.data(), &setting, sizeof(setting));
+  return std::make_shared<const OperationResultKey>(
+      type, DataType::Value, canvas, std::move(settings), std::move(inputs));
+}
+
+static KeyPtr create_key(const int setting)
+{
+  return create_key(typeid(SourceOperation), setting);
+}
+
+static std::shared_ptr<MemoryBuffer> create_buffer(const int width, const float value)
+{
+  std::shared_ptr<MemoryBuffer> buffer = std::make_shared<MemoryBuffer>(
+      DataType::Value, width, 1);
+  buffer->fill(buffer->get_rect(), &value);
+  return buffer;
+}
+
+TEST(OperationResultCache, lookup)
+{
+  OperationResultCache cache;
+  cache.begin_execution();
+  std::shared_ptr<MemoryBuffer> buffer = create_buffer(4, 1.0f);
+  cache.add(*create_key(1), buffer);
+
+  EXPECT_EQ(cache.lookup(*create_key(1)), buffer);
+  EXPECT_EQ(cache.lookup(*create_key(2)), nullptr);
+
+  cache.clear();
+  EXPECT_EQ(cache.lookup(*create_key(1)), nullptr);
+}
+
+TEST(OperationResultCache, evict_least_recently_used)
+{
+  /* Room for two buffers of 4 floats. */
+  OperationResultCache cache;
+  cache.set_memory_limit(8 * sizeof(float));
+
+  cache.begin_execution();
+  cache.add(*create_key(1), create_buffer(4, 1.0f));
+  cache.begin_execution();
+  cache.add(*create_key(2), create_buffer(4, 2.0f));
+  cache.begin_execution();
+  EXPECT_NE(cache.lookup(*create_key(1)), nullptr);
+
+  cache.add(*create_key(3), create_buffer(4, 3.0f));
+  EXPECT_NE(cache.lookup(*create_key(1)), nullptr);
+  EXPECT_EQ(cache.lookup(*create_key(2)), nullptr);
+  EXPECT_NE(cache.lookup(*create_key(3)), nullptr);
+
+  /* Buffers bigger than the limit are not stored. */
+  cache.add(*create_key(4), create_buffer(16, 4.0f));
+  EXPECT_EQ(cache.lookup(*create_key(4)), nullptr);
+  EXPECT_NE(cache.lookup(*create_key(1)), nullptr);
+}
+
+TEST(OperationResultCache, hash_buffer_content)
+{
+  std::shared_ptr<MemoryBuffer> a = create_buffer(4, 1.0f);
+  std::shared_ptr<MemoryBuffer> b = create_buffer(4, 1.0f);
+  std::shared_ptr<MemoryBuffer> c = create_buffer(4, 2.0f);
+  std::shared_ptr<MemoryBuffer> d = create_buffer(5, 1.0f);
+
+  EXPECT_EQ(OperationResultCache::hash_buffer_content(*a),
+            OperationResultCache::hash_buffer_content(*b));
+  EXPECT_NE(OperationResultCache::hash_buffer_content(*a),
+            OperationResultCache::hash_buffer_content(*c));
+  EXPECT_NE(OperationResultCache::hash_buffer_content(*a),
+            OperationResultCache::hash_buffer_content(*d));
+}
+
+TEST(OperationResultCache, full_key_comparison)
+{
+  const KeyPtr source = create_key(typeid(SourceOperation), 1);
+  const KeyPtr filter = create_key(typeid(FilterOperation), 2, {source});
+
+  OperationResultCache cache;
+  cache.begin_execution();
+  std::shared_ptr<MemoryBuffer> buffer = create_buffer(4, 1.0f);
+  cache.add(*filter, buffer);
+
+  /* Keys built again in a later execution find the result. */
+  EXPECT_EQ(cache.lookup(*create_key(
+                typeid(FilterOperation), 2, {create_key(typeid(SourceOperation), 1)})),
+            buffer);
+
+  /* Any difference in the operation type, settings, canvas or inputs is a miss. */
+  EXPECT_EQ(cache.lookup(*create_key(typeid(SourceOperation), 2, {source})), nullptr);
+  EXPECT_EQ(cache.lookup(*create_key(typeid(FilterOperation), 3, {source})), nullptr);
+  EXPECT_EQ(cache.lookup(*create_key(typeid(FilterOperation), 2, {source}, {0, 4, 0, 2})),
+            nullptr);
+  EXPECT_EQ(cache.lookup(*create_key(
+                typeid(FilterOperation), 2, {create_key(typeid(SourceOperation), 5)})),
+            nullptr);
+  EXPECT_EQ(cache.lookup(*create_key(typeid(FilterOperation), 2, {source, source})), nullptr);
+}
+
+TEST(OperationResultCache, shared_input_keys)
+{
+  /* A chain of operations each reading the previous one twice compares equal in linear time. */
+  const auto create_chain = []() {
+    KeyPtr key = create_key(0);
+    for (const int i : IndexRange(64)) {
+      key = create_key(typeid(FilterOperation), i, {key, key});
+    }
+    return key;
+  };
+  const KeyPtr a = create_chain();
+  const KeyPtr b = create_chain();
+  EXPECT_EQ(a->hash(), b->hash());
+  EXPECT_EQ(*a, *b);
+  EXPECT_NE(*a, *create_key(typeid(FilterOperation), 63, {a, a}));
+}
+
+}  // namespace blender::compositor::tests
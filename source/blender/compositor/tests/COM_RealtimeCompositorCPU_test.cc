@@ -0,0 +1,440 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <memory>
+#include <string>
+
+#include "BLI_array.hh"
+#include "BLI_listbase.h"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_utildefines.h"
+#include "BLI_vector.hh"
+
+#include "CLG_log.h"
+
+#include "GHOST_Path-api.hh"
+
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+#include "RNA_define.hh"
+
+#include "BKE_appdir.hh"
+#include "BKE_context.hh"
+#include "BKE_global.hh"
+#include "BKE_idtype.hh"
+#include "BKE_main.hh"
+#include "BKE_node.hh"
+#include "BKE_node_tree_update.hh"
+#include "BKE_scene.hh"
+
+#include "IMB_imbuf.hh"
+
+#include "NOD_composite.hh"
+
+#include "RE_pipeline.h"
+
+#include "COM_context.hh"
+#include "COM_evaluator.hh"
+
+#include "COM_InvertOperation.h"
+#include "COM_MathBaseOperation.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor::tests {
+
+static constexpr int width = 13;
+static constexpr int height = 7;
+
+/* A texture pool that is never used, since results are allocated on the CPU. */
+class CPUTexturePool : public realtime_compositor::TexturePool {
+ public:
+  GPUTexture *allocate_texture(int2 /*size*/, eGPUTextureFormat /*format*/) override
+  {
+    BLI_assert_unreachable();
+    return nullptr;
+  }
+};
+
+/* A realtime compositor context that evaluates on the CPU, reading the combined pass from the
+ * given buffer and writing the composite and viewer outputs into buffers of the context. */
+class CPUContext : public realtime_compositor::Context {
+ private:
+  const Scene &scene_;
+  Span<float> combined_pass_;
+
+ public:
+  Array<float> output_buffer = Array<float>(width * height * 4, 0.0f);
+  Array<float> viewer_output_buffer;
+  mutable Vector<std::string> info_messages;
+  /* Set from Evaluator::is_cpu_supported after evaluation. */
+  bool is_cpu_supported = true;
+  bool is_output_buffer_requested = false;
+
+  CPUContext(realtime_compositor::TexturePool &texture_pool,
+             const Scene &scene,
+             const Span<float> combined_pass)
+      : realtime_compositor::Context(texture_pool), scene_(scene), combined_pass_(combined_pass)
+  {
+  }
+
+  const Scene &get_scene() const override
+  {
+    return scene_;
+  }
+
+  const bNodeTree &get_node_tree() const override
+  {
+    return *scene_.nodetree;
+  }
+
+  bool use_file_output() const override
+  {
+    return false;
+  }
+
+  bool should_compute_node_previews() const override
+  {
+    return false;
+  }
+
+  bool use_composite_output() const override
+  {
+    return true;
+  }
+
+  const RenderData &get_render_data() const override
+  {
+    return scene_.r;
+  }
+
+  int2 get_render_size() const override
+  {
+    return int2(width, height);
+  }
+
+  rcti get_compositing_region() const override
+  {
+    return rcti{0, width, 0, height};
+  }
+
+  GPUTexture *get_output_texture() override
+  {
+    return nullptr;
+  }
+
+  GPUTexture *get_viewer_output_texture(realtime_compositor::Domain /*domain*/,
+                                        bool /*is_data*/) override
+  {
+    return nullptr;
+  }
+
+  GPUTexture *get_input_texture(const Scene * /*scene*/,
+                                int /*view_layer*/,
+                                const char * /*pass_name*/) override
+  {
+    return nullptr;
+  }
+
+  float *get_output_buffer() override
+  {
+    is_output_buffer_requested = true;
+    return output_buffer.data();
+  }
+
+  float *get_viewer_output_buffer(realtime_compositor::Domain domain,
+                                  bool /*is_data*/) override
+  {
+    viewer_output_buffer.reinitialize(int64_t(domain.size.x) * domain.size.y * 4);
+    return viewer_output_buffer.data();
+  }
+
+  const float *get_input_buffer(const Scene * /*scene*/,
+                                int /*view_layer*/,
+                                const char *pass_name,
+                                int *r_channels_count) override
+  {
+    if (StringRef(pass_name) != RE_PASSNAME_COMBINED) {
+      return nullptr;
+    }
+    *r_channels_count = 4;
+    return combined_pass_.data();
+  }
+
+  StringRef get_view_name() const override
+  {
+    return "";
+  }
+
+  realtime_compositor::ResultPrecision get_precision() const override
+  {
+    return realtime_compositor::ResultPrecision::Full;
+  }
+
+  void set_info_message(StringRef message) const override
+  {
+    info_messages.append(message);
+  }
+
+  IDRecalcFlag query_id_recalc_flag(ID * /*id*/) const override
+  {
+    return IDRecalcFlag(0);
+  }
+
+  bool use_gpu() const override
+  {
+    return false;
+  }
+};
+
+class RealtimeCompositorCPUTest : public testing::Test {
+ protected:
+  Main *bmain_ = nullptr;
+  bContext *C_ = nullptr;
+  Scene *scene_ = nullptr;
+  bNodeTree *node_tree_ = nullptr;
+  Array<float> combined_pass_ = Array<float>(width * height * 4);
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    BKE_appdir_init();
+    IMB_init();
+    RNA_init();
+    bke::BKE_node_system_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    bke::BKE_node_system_exit();
+    RNA_exit();
+    IMB_exit();
+    GHOST_DisposeSystemPaths();
+    BKE_appdir_exit();
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    bmain_ = BKE_main_new();
+    G.main = bmain_;
+    scene_ = BKE_scene_add(bmain_, "CompositorScene");
+    C_ = CTX_create();
+    CTX_data_main_set(C_, bmain_);
+    CTX_data_scene_set(C_, scene_);
+    node_tree_ = bke::ntreeAddTreeEmbedded(
+        nullptr, &scene_->id, "Compositing Nodetree", ntreeType_Composite->idname);
+    scene_->nodetree = node_tree_;
+
+    for (const int i : IndexRange(width * height)) {
+      combined_pass_[i * 4 + 0] = (i % width) / float(width);
+      combined_pass_[i * 4 + 1] = (i / width) / float(height);
+      combined_pass_[i * 4 + 2] = 2.0f - i * 0.05f;
+      combined_pass_[i * 4 + 3] = (i % 5) / 4.0f;
+    }
+  }
+
+  void TearDown() override
+  {
+    CTX_free(C_);
+    BKE_main_free(bmain_);
+    G.main = nullptr;
+  }
+
+  bNode *add_node(const int type)
+  {
+    return bke::nodeAddStaticNode(C_, node_tree_, type);
+  }
+
+  void add_link(bNode *from_node, const char *from, bNode *to_node, const char *to)
+  {
+    bke::nodeAddLink(node_tree_,
+                     from_node,
+                     bke::nodeFindSocket(from_node, SOCK_OUT, from),
+                     to_node,
+                     bke::nodeFindSocket(to_node, SOCK_IN, to));
+  }
+
+  /* Evaluates the node tree on the CPU and returns the context holding the outputs. */
+  std::unique_ptr<CPUContext> evaluate()
+  {
+    BKE_ntree_update_main_tree(bmain_, node_tree_, nullptr);
+    LISTBASE_FOREACH (bNode *, node, &node_tree_->nodes) {
+      if (ELEM(node->type, CMP_NODE_COMPOSITE, CMP_NODE_VIEWER)) {
+        node->flag |= NODE_DO_OUTPUT;
+      }
+    }
+
+    std::unique_ptr<CPUContext> context = std::make_unique<CPUContext>(
+        texture_pool_, *scene_, combined_pass_);
+    realtime_compositor::Evaluator evaluator(*context);
+    evaluator.evaluate();
+    context->is_cpu_supported = evaluator.is_cpu_supported();
+    return context;
+  }
+
+  /* Computes the inverted combined pass using the operation of the CPU compositor. */
+  Array<float> compute_inverted_combined()
+  {
+    const rcti area = {0, width, 0, height};
+    MemoryBuffer factor(DataType::Value, area, true);
+    *factor.get_elem(0, 0) = 1.0f;
+    MemoryBuffer combined(combined_pass_.data(), 4, area);
+    MemoryBuffer output(DataType::Color, area);
+
+    InvertOperation operation;
+    operation.set_color(true);
+    operation.set_alpha(false);
+    operation.update_memory_buffer_partial(&output, area, {&factor, &combined});
+
+    return Array<float>(Span<float>(output.get_buffer(), width * height * 4));
+  }
+
+  /* Computes the alpha of the combined pass multiplied by the given factor using the operation of
+   * the CPU compositor. */
+  Array<float> compute_multiplied_alpha(const float multiplier)
+  {
+    const rcti area = {0, width, 0, height};
+    Array<float> alpha(width * height);
+    for (const int i : alpha.index_range()) {
+      alpha[i] = combined_pass_[i * 4 + 3];
+    }
+    MemoryBuffer alpha_buffer(alpha.data(), 1, area);
+    MemoryBuffer factor(DataType::Value, area, true);
+    *factor.get_elem(0, 0) = multiplier;
+    MemoryBuffer unused(DataType::Value, area, true);
+    MemoryBuffer output(DataType::Value, area);
+
+    /* The partial update of buffers is hidden by the functor of the multiply operation. */
+    MathMultiplyOperation operation;
+    MathBaseOperation &base_operation = operation;
+    base_operation.update_memory_buffer_partial(
+        &output, area, {&alpha_buffer, &factor, &unused});
+
+    return Array<float>(Span<float>(output.get_buffer(), width * height));
+  }
+
+ private:
+  CPUTexturePool texture_pool_;
+};
+
+TEST_F(RealtimeCompositorCPUTest, CompositeMatchesOperations)
+{
+  /* Render Layers -> Invert -> Composite Image, and
+   * Render Layers Alpha -> Math Multiply -> Composite Alpha. */
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+  bNode *invert = add_node(CMP_NODE_INVERT);
+  bNode *math = add_node(CMP_NODE_MATH);
+  bNode *composite = add_node(CMP_NODE_COMPOSITE);
+
+  math->custom1 = NODE_MATH_MULTIPLY;
+  bNodeSocket *multiplier = bke::nodeFindSocket(math, SOCK_IN, "Value_001");
+  static_cast<bNodeSocketValueFloat *>(multiplier->default_value)->value = 0.5f;
+
+  add_link(render_layers, "Image", invert, "Color");
+  add_link(invert, "Color", composite, "Image");
+  add_link(render_layers, "Alpha", math, "Value");
+  add_link(math, "Value", composite, "Alpha");
+
+  const std::unique_ptr<CPUContext> context = this->evaluate();
+  EXPECT_TRUE(context->is_cpu_supported);
+  EXPECT_TRUE(context->info_messages.is_empty());
+
+  const Array<float> inverted = compute_inverted_combined();
+  const Array<float> alpha = compute_multiplied_alpha(0.5f);
+  for (const int i : IndexRange(width * height)) {
+    for (const int channel : IndexRange(3)) {
+      EXPECT_NEAR(context->output_buffer[i * 4 + channel], inverted[i * 4 + channel], 1e-6f);
+    }
+    EXPECT_NEAR(context->output_buffer[i * 4 + 3], alpha[i], 1e-6f);
+  }
+}
+
+TEST_F(RealtimeCompositorCPUTest, ViewerMatchesOperations)
+{
+  /* Render Layers -> Invert -> Viewer, where the alpha of the image is kept. */
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+  bNode *invert = add_node(CMP_NODE_INVERT);
+  bNode *viewer = add_node(CMP_NODE_VIEWER);
+
+  add_link(render_layers, "Image", invert, "Color");
+  add_link(invert, "Color", viewer, "Image");
+
+  const std::unique_ptr<CPUContext> context = this->evaluate();
+  EXPECT_TRUE(context->is_cpu_supported);
+  EXPECT_TRUE(context->info_messages.is_empty());
+
+  const Array<float> inverted = compute_inverted_combined();
+  ASSERT_EQ(context->viewer_output_buffer.size(), inverted.size());
+  for (const int i : inverted.index_range()) {
+    EXPECT_NEAR(context->viewer_output_buffer[i], inverted[i], 1e-6f);
+  }
+}
+
+TEST_F(RealtimeCompositorCPUTest, SingleValueClearsComposite)
+{
+  /* An unlinked Composite node clears the whole output to its input values, made opaque since
+   * the alpha of the image is ignored. */
+  bNode *composite = add_node(CMP_NODE_COMPOSITE);
+  composite->custom2 |= CMP_NODE_OUTPUT_IGNORE_ALPHA;
+  bNodeSocket *image = bke::nodeFindSocket(composite, SOCK_IN, "Image");
+  copy_v4_fl4(static_cast<bNodeSocketValueRGBA *>(image->default_value)->value,
+              0.25f,
+              0.5f,
+              0.75f,
+              0.0f);
+
+  const std::unique_ptr<CPUContext> context = this->evaluate();
+  EXPECT_TRUE(context->is_cpu_supported);
+  EXPECT_TRUE(context->info_messages.is_empty());
+
+  for (const int i : IndexRange(width * height)) {
+    EXPECT_EQ(context->output_buffer[i * 4 + 0], 0.25f);
+    EXPECT_EQ(context->output_buffer[i * 4 + 1], 0.5f);
+    EXPECT_EQ(context->output_buffer[i * 4 + 2], 0.75f);
+    EXPECT_EQ(context->output_buffer[i * 4 + 3], 1.0f);
+  }
+}
+
+TEST_F(RealtimeCompositorCPUTest, UnsupportedNodeIsNotEvaluated)
+{
+  /* Render Layers -> Blur -> Composite, where the Blur node has no CPU implementation, so nothing
+   * is evaluated and the caller falls back to the CPU compositor. */
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+  bNode *blur = add_node(CMP_NODE_BLUR);
+  bNode *composite = add_node(CMP_NODE_COMPOSITE);
+
+  add_link(render_layers, "Image", blur, "Image");
+  add_link(blur, "Image", composite, "Image");
+
+  const std::unique_ptr<CPUContext> context = this->evaluate();
+  EXPECT_FALSE(context->is_cpu_supported);
+  EXPECT_FALSE(context->is_output_buffer_requested);
+  EXPECT_FALSE(context->info_messages.is_empty());
+}
+
+TEST_F(RealtimeCompositorCPUTest, UnusedUnsupportedNodeIsIgnored)
+{
+  /* An unsupported node that does not contribute to the outputs is not scheduled, so it does not
+   * prevent evaluation on the CPU. */
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+  bNode *blur = add_node(CMP_NODE_BLUR);
+  bNode *invert = add_node(CMP_NODE_INVERT);
+  bNode *composite = add_node(CMP_NODE_COMPOSITE);
+
+  add_link(render_layers, "Image", blur, "Image");
+  add_link(render_layers, "Image", invert, "Color");
+  add_link(invert, "Color", composite, "Image");
+
+  const std::unique_ptr<CPUContext> context = this->evaluate();
+  EXPECT_TRUE(context->is_cpu_supported);
+  EXPECT_TRUE(context->is_output_buffer_requested);
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,94 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_math_base.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_RecursiveGaussianBlurAlgorithm.h"
+
+namespace blender::compositor::tests {
+
+static void fill_random(MemoryBuffer &buffer, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  for (BuffersIterator<float> it = buffer.iterate_with({}); !it.is_end(); ++it) {
+    for (const int channel : IndexRange(buffer.get_num_channels())) {
+      it.out[channel] = rng.get_float();
+    }
+  }
+}
+
+/* Direct convolution with a Gaussian kernel truncated at three standard deviations, skipping and
+ * normalizing over pixels outside of the input, like the Gaussian Bokeh Blur operation. */
+static float4 direct_gaussian_blur_pixel(const MemoryBuffer &input,
+                                         const int x,
+                                         const int y,
+                                         const float2 sigma)
+{
+  const int2 radius = int2(math::ceil(sigma * 3.0f));
+  const rcti &rect = input.get_rect();
+  const int2 lower_bound = math::max(int2(x, y) - radius, int2(rect.xmin, rect.ymin));
+  const int2 upper_bound = math::min(int2(x, y) + radius + 1, int2(rect.xmax, rect.ymax));
+
+  float4 accumulated_color = float4(0.0f);
+  float accumulated_weight = 0.0f;
+  for (int yi = lower_bound.y; yi < upper_bound.y; yi++) {
+    for (int xi = lower_bound.x; xi < upper_bound.x; xi++) {
+      const float dx = sigma.x > 0.0f ? (xi - x) / sigma.x : 0.0f;
+      const float dy = sigma.y > 0.0f ? (yi - y) / sigma.y : 0.0f;
+      const float weight = math::exp(-0.5f * (dx * dx + dy * dy));
+      accumulated_color += float4(input.get_elem(xi, yi)) * weight;
+      accumulated_weight += weight;
+    }
+  }
+  return accumulated_color / accumulated_weight;
+}
+
+static void test_against_direct_blur(const rcti &area, const float2 sigma)
+{
+  const rcti input_rect = {0, 64, 0, 48};
+  MemoryBuffer input(DataType::Color, input_rect);
+  fill_random(input, 0);
+
+  MemoryBuffer output(DataType::Color, area);
+  deriche_gaussian_blur(input, output, area, sigma);
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      const float4 expected = direct_gaussian_blur_pixel(input, x, y, sigma);
+      const float *result = output.get_elem(x, y);
+      for (const int channel : IndexRange(4)) {
+        EXPECT_NEAR(result[channel], expected[channel], 1e-2f) << "at " << x << ", " << y;
+      }
+    }
+  }
+}
+
+TEST(RecursiveGaussianBlur, MatchesDirectBlur)
+{
+  test_against_direct_blur(rcti{0, 64, 0, 48}, float2(5.0f, 4.0f));
+}
+
+TEST(RecursiveGaussianBlur, MatchesDirectBlurLargeSigma)
+{
+  test_against_direct_blur(rcti{0, 64, 0, 48}, float2(20.0f, 12.0f));
+}
+
+TEST(RecursiveGaussianBlur, MatchesDirectBlurSingleAxis)
+{
+  test_against_direct_blur(rcti{0, 64, 0, 48}, float2(6.0f, 0.0f));
+  test_against_direct_blur(rcti{0, 64, 0, 48}, float2(0.0f, 6.0f));
+}
+
+TEST(RecursiveGaussianBlur, MatchesDirectBlurOutsideInput)
+{
+  test_against_direct_blur(rcti{-8, 56, 4, 56}, float2(5.0f, 5.0f));
+}
+
+}  // namespace blender::compositor::tests
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <optional>
+
 /* Needed for BKE_ccg.hh. */
 #include "BLI_assert.h"
 #include "BLI_math_vector_types.hh"
@@ -94,12 +96,31 @@ struct PBVH_GPU_Args {
   Span<int3> corner_tris;
   Span<int> tri_faces;
 
+  /* Mesh node topology, see #bke::pbvh::node_verts. */
+  Span<int> node_verts;
+  int node_unique_verts_num;
+  Span<int3> node_tri_verts;
+
   /* BMesh. */
   const Set<BMFace *, 0> *bm_faces;
   int cd_mask_layer;
 };
 
-void node_update(PBVHBatches *batches, const PBVH_GPU_Args &args);
+/**
+ * Whether the vertex buffer for the request depends on data tagged as changed.
+ */
+bool request_is_dirty(const AttributeRequest &request, bke::pbvh::DrawDirty dirty);
+
+/**
+ * Extract the node's vertex buffers again, only for the requests depending on changed data.
+ *
+ * \param dirty_verts: The vertices which positions changed, see
+ * #bke::pbvh::Node::draw_dirty_verts_. When not set, all positions may have changed.
+ */
+void node_update(PBVHBatches *batches,
+                 const PBVH_GPU_Args &args,
+                 bke::pbvh::DrawDirty dirty,
+                 std::optional<IndexRange> dirty_verts);
 void update_pre(PBVHBatches *batches, const PBVH_GPU_Args &args);
 
 void node_gpu_flush(PBVHBatches *batches);
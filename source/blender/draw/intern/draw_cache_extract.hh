@@ -8,8 +8,15 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+
+#include "BLI_implicit_sharing_ptr.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
+
+#include "DNA_customdata_types.h"
 
 #include "GPU_shader.hh"
 
@@ -230,6 +237,37 @@ struct MeshBufferCache {
                  &batch_cache.cage : \
                  ((mbc == &batch_cache.cage) ? &batch_cache.uv_cage : nullptr))
 
+/** A custom data layer of the mesh that a #MeshBatchCache was extracted from. */
+struct MeshSourceLayer {
+  eCustomDataType type;
+  std::string name;
+  int flag;
+  int active, active_rnd, active_clone, active_mask;
+  /**
+   * Holding a user of the array means that changing it requires a copy, so a different pointer
+   * is a reliable way to detect changes.
+   */
+  ImplicitSharingPtrAndData data;
+};
+
+/**
+ * Identity of the mesh data that a #MeshBatchCache was extracted from, stored when the cache is
+ * detached from an evaluated mesh to find out which buffers are still valid for the next one.
+ */
+struct MeshSourceState {
+  int verts_num;
+  int edges_num;
+  int faces_num;
+  int corners_num;
+  ImplicitSharingPtrAndData face_offsets;
+  Vector<MeshSourceLayer> vert_layers;
+  Vector<MeshSourceLayer> edge_layers;
+  Vector<MeshSourceLayer> face_layers;
+  Vector<MeshSourceLayer> corner_layers;
+  std::string active_color_attribute;
+  std::string default_color_attribute;
+};
+
 struct MeshBatchCache {
   MeshBufferCache final, cage, uv_cage;
 
@@ -275,6 +313,9 @@ struct MeshBatchCache {
   bool no_loose_wire;
 
   eV3DShadingColorType color_type;
+
+  /** Only set while the cache is detached from its mesh, see #DRW_mesh_batch_cache_detach. */
+  std::unique_ptr<MeshSourceState> source;
 };
 
 #define MBC_EDITUV \
@@ -43,6 +43,7 @@ void DRW_curve_batch_cache_free(Curve *cu);
 void DRW_mesh_batch_cache_dirty_tag(Mesh *mesh, eMeshBatchDirtyMode mode);
 void DRW_mesh_batch_cache_validate(Object &object, Mesh &mesh);
 void DRW_mesh_batch_cache_free(void *batch_cache);
+void *DRW_mesh_batch_cache_detach(Mesh *mesh);
 
 void DRW_lattice_batch_cache_dirty_tag(Lattice *lt, int mode);
 void DRW_lattice_batch_cache_validate(Lattice *lt);
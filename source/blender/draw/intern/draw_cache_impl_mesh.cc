@@ -8,6 +8,7 @@
  * \brief Mesh API for render engines
  */
 
+#include <algorithm>
 #include <optional>
 
 #include "MEM_guardedalloc.h"
@@ -41,6 +42,7 @@
 #include "BKE_modifier.hh"
 #include "BKE_object.hh"
 #include "BKE_object_deform.h"
+#include "BKE_object_types.hh"
 #include "BKE_paint.hh"
 #include "BKE_pbvh_api.hh"
 #include "BKE_subdiv_modifier.hh"
@@ -603,8 +605,236 @@ static void mesh_batch_cache_init(Object &object, Mesh &mesh)
   drw_mesh_weight_state_clear(&cache->weight_state);
 }
 
+/* Every depsgraph evaluation creates a new evaluated mesh, so its draw cache would have to be
+ * extracted from scratch even when only the positions changed, like during armature animation
+ * playback. Instead the cache of the previous evaluated mesh is detached before that mesh is freed
+ * and adopted when the new mesh is drawn. Mesh arrays that don't change are implicitly shared
+ * between evaluations, so comparing them with the arrays the cache was extracted from tells
+ * whether the buffers that don't depend on positions are still valid. */
+
+enum class MeshSourceChange {
+  /** Only the positions and the data derived from them changed. */
+  Positions,
+  /** Attributes or their settings changed, but not the topology. */
+  Attributes,
+  Topology,
+};
+
+static ImplicitSharingPtrAndData sharing_ptr_from_info(const ImplicitSharingInfo *sharing_info,
+                                                       const void *data)
+{
+  if (sharing_info) {
+    sharing_info->add_user();
+  }
+  return ImplicitSharingPtrAndData(ImplicitSharingPtr<ImplicitSharingInfo>(sharing_info), data);
+}
+
+static Vector<MeshSourceLayer> mesh_source_layers_get(const CustomData &custom_data)
+{
+  Vector<MeshSourceLayer> layers(custom_data.totlayer);
+  for (const int i : layers.index_range()) {
+    const CustomDataLayer &layer = custom_data.layers[i];
+    MeshSourceLayer &source = layers[i];
+    source.type = eCustomDataType(layer.type);
+    source.name = layer.name;
+    source.flag = layer.flag;
+    source.active = layer.active;
+    source.active_rnd = layer.active_rnd;
+    source.active_clone = layer.active_clone;
+    source.active_mask = layer.active_mask;
+    source.data = sharing_ptr_from_info(layer.sharing_info, layer.data);
+  }
+  return layers;
+}
+
+static MeshSourceState mesh_source_state_get(const Mesh &mesh)
+{
+  MeshSourceState state;
+  state.verts_num = mesh.verts_num;
+  state.edges_num = mesh.edges_num;
+  state.faces_num = mesh.faces_num;
+  state.corners_num = mesh.corners_num;
+  state.face_offsets = sharing_ptr_from_info(mesh.runtime->face_offsets_sharing_info,
+                                             mesh.face_offset_indices);
+  state.vert_layers = mesh_source_layers_get(mesh.vert_data);
+  state.edge_layers = mesh_source_layers_get(mesh.edge_data);
+  state.face_layers = mesh_source_layers_get(mesh.face_data);
+  state.corner_layers = mesh_source_layers_get(mesh.corner_data);
+  state.active_color_attribute = StringRef(mesh.active_color_attribute);
+  state.default_color_attribute = StringRef(mesh.default_color_attribute);
+  return state;
+}
+
+static bool mesh_source_data_equal(const ImplicitSharingPtrAndData &a,
+                                   const ImplicitSharingPtrAndData &b)
+{
+  /* Data without sharing info may have been changed in place. */
+  return a.has_value() && a.sharing_info == b.sharing_info && a.data == b.data;
+}
+
+static bool mesh_source_layer_is_topology(const MeshSourceLayer &layer)
+{
+  return ELEM(layer.name, ".edge_verts", ".corner_vert", ".corner_edge");
+}
+
+/** Layers that are expected to change with the positions and only used by rebuilt buffers. */
+static bool mesh_source_layer_is_deformed(const MeshSourceLayer &layer)
+{
+  return layer.type == CD_ORCO || (layer.type == CD_PROP_FLOAT3 && layer.name == "position");
+}
+
+static MeshSourceChange mesh_source_layers_compare(const Span<MeshSourceLayer> prev,
+                                                   const Span<MeshSourceLayer> next)
+{
+  if (prev.size() != next.size()) {
+    return MeshSourceChange::Attributes;
+  }
+  MeshSourceChange change = MeshSourceChange::Positions;
+  for (const int i : prev.index_range()) {
+    const MeshSourceLayer &a = prev[i];
+    const MeshSourceLayer &b = next[i];
+    if (a.type != b.type || a.name != b.name) {
+      return MeshSourceChange::Attributes;
+    }
+    if (mesh_source_layer_is_deformed(a)) {
+      continue;
+    }
+    if (!mesh_source_data_equal(a.data, b.data)) {
+      if (mesh_source_layer_is_topology(a)) {
+        return MeshSourceChange::Topology;
+      }
+      change = MeshSourceChange::Attributes;
+    }
+    if (a.flag != b.flag || a.active != b.active || a.active_rnd != b.active_rnd ||
+        a.active_clone != b.active_clone || a.active_mask != b.active_mask)
+    {
+      change = MeshSourceChange::Attributes;
+    }
+  }
+  return change;
+}
+
+static MeshSourceChange mesh_source_compare(const MeshSourceState &prev,
+                                            const MeshSourceState &next)
+{
+  if (prev.verts_num != next.verts_num || prev.edges_num != next.edges_num ||
+      prev.faces_num != next.faces_num || prev.corners_num != next.corners_num)
+  {
+    return MeshSourceChange::Topology;
+  }
+  if (prev.faces_num > 0 && !mesh_source_data_equal(prev.face_offsets, next.face_offsets)) {
+    return MeshSourceChange::Topology;
+  }
+  const MeshSourceChange change = std::max({
+      mesh_source_layers_compare(prev.vert_layers, next.vert_layers),
+      mesh_source_layers_compare(prev.edge_layers, next.edge_layers),
+      mesh_source_layers_compare(prev.face_layers, next.face_layers),
+      mesh_source_layers_compare(prev.corner_layers, next.corner_layers),
+  });
+  if (change == MeshSourceChange::Positions &&
+      (prev.active_color_attribute != next.active_color_attribute ||
+       prev.default_color_attribute != next.default_color_attribute))
+  {
+    return MeshSourceChange::Attributes;
+  }
+  return change;
+}
+
+/**
+ * Discard the buffers that depend on vertex positions. The triangulation of quads depends on the
+ * positions too, so the triangle index buffers are included.
+ */
+static void mesh_batch_cache_discard_deformed(MeshBatchCache &cache)
+{
+  FOREACH_MESH_BUFFER_CACHE (cache, mbc) {
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.pos);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.vnor);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.tan);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.orco);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.edge_fac);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.mesh_analysis);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.fdots_pos);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.fdots_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.edituv_stretch_area);
+    GPU_VERTBUF_DISCARD_SAFE(mbc->buff.vbo.edituv_stretch_angle);
+    GPU_INDEXBUF_DISCARD_SAFE(mbc->buff.ibo.tris);
+    GPU_INDEXBUF_DISCARD_SAFE(mbc->buff.ibo.lines_adjacency);
+    GPU_INDEXBUF_DISCARD_SAFE(mbc->buff.ibo.edituv_tris);
+  }
+  /* The material sub-ranges reference the triangle index buffer. */
+  for (gpu::IndexBuf *&ibo : cache.tris_per_mat) {
+    GPU_INDEXBUF_DISCARD_SAFE(ibo);
+  }
+  mesh_batch_cache_discard_batch(cache,
+                                 BATCH_MAP(vbo.pos,
+                                           vbo.nor,
+                                           vbo.vnor,
+                                           vbo.tan,
+                                           vbo.orco,
+                                           vbo.edge_fac,
+                                           vbo.mesh_analysis,
+                                           vbo.fdots_pos,
+                                           vbo.fdots_nor));
+  mesh_batch_cache_discard_batch(cache,
+                                 BATCH_MAP(vbo.edituv_stretch_area,
+                                           vbo.edituv_stretch_angle,
+                                           ibo.tris,
+                                           ibo.lines_adjacency,
+                                           ibo.edituv_tris));
+  cache.tot_area = 0.0f;
+  cache.tot_uv_area = 0.0f;
+  /* The discarded tangents and generated coordinates are requested again when needed. */
+  cache.cd_used.tan = 0;
+  cache.cd_used.tan_orco = 0;
+  cache.cd_used.orco = 0;
+}
+
+void *DRW_mesh_batch_cache_detach(Mesh *mesh)
+{
+  MeshBatchCache *cache = static_cast<MeshBatchCache *>(mesh->runtime->batch_cache);
+  if (cache->is_dirty || cache->is_editmode || cache->subdiv_cache ||
+      mesh->runtime->wrapper_type != ME_WRAPPER_TYPE_MDATA)
+  {
+    return nullptr;
+  }
+  cache->source = std::make_unique<MeshSourceState>(mesh_source_state_get(*mesh));
+  mesh->runtime->batch_cache = nullptr;
+  return cache;
+}
+
+/** Adopt the cache detached from the previous evaluated mesh of the object, when possible. */
+static void mesh_batch_cache_adopt_detached(Object &object, Mesh &mesh)
+{
+  void *batch_cache_prev = object.runtime->mesh_batch_cache_prev;
+  if (batch_cache_prev == nullptr || &mesh.id != object.runtime->data_eval) {
+    return;
+  }
+  object.runtime->mesh_batch_cache_prev = nullptr;
+
+  MeshBatchCache *cache = static_cast<MeshBatchCache *>(batch_cache_prev);
+  MeshSourceChange change = MeshSourceChange::Topology;
+  if (mesh.runtime->edit_mesh == nullptr && mesh.runtime->wrapper_type == ME_WRAPPER_TYPE_MDATA &&
+      !BKE_subsurf_modifier_has_gpu_subdiv(&mesh))
+  {
+    change = mesh_source_compare(*cache->source, mesh_source_state_get(mesh));
+  }
+  cache->source.reset();
+
+  DRW_stats_mesh_cache_reuse_add(change == MeshSourceChange::Positions);
+  if (change != MeshSourceChange::Positions) {
+    DRW_mesh_batch_cache_free(cache);
+    return;
+  }
+  mesh_batch_cache_discard_deformed(*cache);
+  mesh.runtime->batch_cache = cache;
+}
+
 void DRW_mesh_batch_cache_validate(Object &object, Mesh &mesh)
 {
+  if (mesh.runtime->batch_cache == nullptr) {
+    mesh_batch_cache_adopt_detached(object, mesh);
+  }
   if (!mesh_batch_cache_valid(object, mesh)) {
     if (mesh.runtime->batch_cache) {
       mesh_batch_cache_clear(*static_cast<MeshBatchCache *>(mesh.runtime->batch_cache));
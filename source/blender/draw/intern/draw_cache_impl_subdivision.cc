@@ -20,6 +20,7 @@
 #include "BKE_subdiv_foreach.hh"
 #include "BKE_subdiv_mesh.hh"
 #include "BKE_subdiv_modifier.hh"
+#include "BKE_subdiv_topology.hh"
 
 #include "BLI_linklist.h"
 #include "BLI_string.h"
@@ -848,10 +849,8 @@ static void draw_subdiv_invalidate_evaluator_for_orco(bke::subdiv::Subdiv *subdi
     openSubdiv_deleteEvaluator(subdiv->evaluator);
     subdiv->evaluator = nullptr;
 
-    if (subdiv->topology_refiner != nullptr) {
-      openSubdiv_deleteTopologyRefiner(subdiv->topology_refiner);
-      subdiv->topology_refiner = nullptr;
-    }
+    bke::subdiv::topology_refiner_release(subdiv->topology_refiner);
+    subdiv->topology_refiner = nullptr;
   }
 }
 
@@ -167,6 +167,9 @@ static void drw_task_graph_init()
 
 static void drw_task_graph_deinit()
 {
+#ifdef USE_PROFILE
+  PROFILE_START(stime);
+#endif
   BLI_task_graph_work_and_wait(DST.task_graph);
 
   BLI_gset_free(DST.delayed_extraction,
@@ -176,6 +179,12 @@ static void drw_task_graph_deinit()
 
   BLI_task_graph_free(DST.task_graph);
   DST.task_graph = nullptr;
+
+#ifdef USE_PROFILE
+  double extraction_time = 0.0;
+  PROFILE_END_ACCUM(extraction_time, stime);
+  DRW_stats_extraction_time_add(extraction_time);
+#endif
 }
 
 /** \} */
@@ -3099,6 +3108,7 @@ void DRW_engines_register()
 
     BKE_mesh_batch_cache_dirty_tag_cb = DRW_mesh_batch_cache_dirty_tag;
     BKE_mesh_batch_cache_free_cb = DRW_mesh_batch_cache_free;
+    BKE_mesh_batch_cache_detach_cb = DRW_mesh_batch_cache_detach;
 
     BKE_lattice_batch_cache_dirty_tag_cb = DRW_lattice_batch_cache_dirty_tag;
     BKE_lattice_batch_cache_free_cb = DRW_lattice_batch_cache_free;
@@ -50,6 +50,16 @@ static struct DRWTimerPool {
   bool is_querying;    /* Keep track of bad usage. */
 } DTP = {nullptr};
 
+static struct DRWExtractionStats {
+  /** Time spent waiting for the batch cache extraction, averaged like the engine timings. */
+  double time_average;
+  double time;
+  /** Evaluated meshes that reused the draw cache of the previous evaluation. */
+  int meshes_deform_only;
+  /** Evaluated meshes that had to rebuild the draw cache of the previous evaluation. */
+  int meshes_rebuilt;
+} DES = {0};
+
 void DRW_stats_free()
 {
   if (DTP.timers != nullptr) {
@@ -152,6 +162,25 @@ void DRW_stats_query_end()
   }
 }
 
+void DRW_stats_extraction_time_add(const double time_ms)
+{
+  if (G.debug_value > 20 && G.debug_value < 30) {
+    DES.time += time_ms;
+  }
+}
+
+void DRW_stats_mesh_cache_reuse_add(const bool deform_only)
+{
+  if (G.debug_value > 20 && G.debug_value < 30) {
+    if (deform_only) {
+      DES.meshes_deform_only++;
+    }
+    else {
+      DES.meshes_rebuilt++;
+    }
+  }
+}
+
 void DRW_stats_reset()
 {
   BLI_assert_msg((DTP.timer_increment - DTP.end_increment) <= 0,
@@ -283,8 +312,29 @@ void DRW_stats_draw(const rcti *rect)
   draw_stat_5row(rect, u++, v, col_label, sizeof(col_label));
   SNPRINTF(time_to_txt, "%.2fms", *cache_time);
   draw_stat_5row(rect, u++, v, time_to_txt, sizeof(time_to_txt));
+  v++;
+
+  /* Extraction rows, gathered during the cache population of this redraw. */
+  DES.time_average = DES.time_average * (1.0 - GPU_TIMER_FALLOFF) + DES.time * GPU_TIMER_FALLOFF;
+  u = 0;
+  STRNCPY(col_label, "Extraction");
+  draw_stat_5row(rect, u++, v, col_label, sizeof(col_label));
+  SNPRINTF(time_to_txt, "%.2fms", DES.time_average);
+  draw_stat_5row(rect, u++, v, time_to_txt, sizeof(time_to_txt));
+  v++;
+  u = 0;
+  STRNCPY(col_label, "Mesh Reuse");
+  draw_stat_5row(rect, u++, v, col_label, sizeof(col_label));
+  SNPRINTF(stat_string, "%d deformed", DES.meshes_deform_only);
+  draw_stat_5row(rect, u++, v, stat_string, sizeof(stat_string));
+  SNPRINTF(stat_string, "%d rebuilt", DES.meshes_rebuilt);
+  draw_stat_5row(rect, u++, v, stat_string, sizeof(stat_string));
   v += 2;
 
+  DES.time = 0.0;
+  DES.meshes_deform_only = 0;
+  DES.meshes_rebuilt = 0;
+
   /* ------------------------------------------ */
   /* ---------------- GPU stats --------------- */
   /* ------------------------------------------ */
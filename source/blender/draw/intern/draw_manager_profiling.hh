@@ -27,4 +27,15 @@ void DRW_stats_group_end();
 void DRW_stats_query_start(const char *name);
 void DRW_stats_query_end();
 
+/**
+ * CPU side statistics of the batch cache extraction. They are gathered while the cache is
+ * populated, before #DRW_stats_begin, and are reset once drawn.
+ */
+void DRW_stats_extraction_time_add(double time_ms);
+/**
+ * Count the draw caches of evaluated meshes that replaced a previous evaluation, and whether
+ * only the buffers depending on positions had to be rebuilt.
+ */
+void DRW_stats_mesh_cache_reuse_add(bool deform_only);
+
 void DRW_stats_draw(const rcti *rect);
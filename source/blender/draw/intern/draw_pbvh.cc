@@ -19,11 +19,14 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_bit_vector.hh"
 #include "BLI_bitmap.h"
 #include "BLI_function_ref.hh"
 #include "BLI_ghash.h"
 #include "BLI_index_range.hh"
+#include "BLI_set.hh"
 #include "BLI_map.hh"
+#include "BLI_math_base.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string.h"
@@ -342,6 +345,9 @@ struct PBVHBatches {
 
   int material_index = 0;
 
+  /** Vertices of a mesh node used by faces of other nodes, see #calc_boundary_verts_mesh. */
+  BitVector<> boundary_verts;
+
   /* Stuff for displaying coarse multires grids. */
   gpu::IndexBuf *tri_index_coarse = nullptr;
   gpu::IndexBuf *lines_index_coarse = nullptr;
@@ -350,7 +356,9 @@ struct PBVHBatches {
   PBVHBatches(const PBVH_GPU_Args &args);
   ~PBVHBatches();
 
-  void update(const PBVH_GPU_Args &args);
+  void update(const PBVH_GPU_Args &args,
+              bke::pbvh::DrawDirty dirty,
+              std::optional<IndexRange> dirty_verts);
   void update_pre(const PBVH_GPU_Args &args);
 
   int create_vbo(const AttributeRequest &request, const PBVH_GPU_Args &args);
@@ -573,6 +581,127 @@ static void fill_vbo_attribute_mesh(const Span<int> corner_verts,
   });
 }
 
+BitVector<> calc_boundary_verts_mesh(const GroupedSpan<int> vert_to_face_map,
+                                     const Span<int> tri_faces,
+                                     const Span<int> tris,
+                                     const Span<int> node_verts)
+{
+  Set<int> node_faces;
+  for (const int tri : tris) {
+    node_faces.add(tri_faces[tri]);
+  }
+  BitVector<> boundary_verts(node_verts.size(), false);
+  for (const int i : node_verts.index_range()) {
+    const Span<int> vert_faces = vert_to_face_map[node_verts[i]];
+    if (std::any_of(vert_faces.begin(), vert_faces.end(), [&](const int face) {
+          return !node_faces.contains(face);
+        }))
+    {
+      boundary_verts[i].set();
+    }
+  }
+  return boundary_verts;
+}
+
+DirtyTrisMesh calc_dirty_tris_mesh(const Span<int> tri_faces,
+                                   const Span<bool> hide_poly,
+                                   const Span<int> tris,
+                                   const Span<int3> node_tri_verts,
+                                   const int unique_verts_num,
+                                   const IndexRange dirty_verts,
+                                   const BoundedBitSpan boundary_verts)
+{
+  const auto vert_moved = [&](const int vert) {
+    return vert >= unique_verts_num || dirty_verts.contains(vert);
+  };
+  const auto tri_moved = [&](const int tri) {
+    const int3 &verts = node_tri_verts[tri];
+    return vert_moved(verts[0]) || vert_moved(verts[1]) || vert_moved(verts[2]);
+  };
+
+  /* Moving a vertex changes the normals of its faces and of all of their vertices. The triangles
+   * of a face are consecutive in the node. Faces of other nodes can change the normals of the
+   * boundary vertices. */
+  BitVector<> normal_verts(boundary_verts);
+  BitVector<> normal_tris(tris.size(), false);
+  for (int face_start = 0; face_start < tris.size();) {
+    const int face = tri_faces[tris[face_start]];
+    int face_end = face_start + 1;
+    while (face_end < tris.size() && tri_faces[tris[face_end]] == face) {
+      face_end++;
+    }
+    const IndexRange face_tris = IndexRange::from_begin_end(face_start, face_end);
+    if (std::any_of(face_tris.begin(), face_tris.end(), tri_moved)) {
+      for (const int tri : face_tris) {
+        normal_tris[tri].set();
+        for (const int i : IndexRange(3)) {
+          normal_verts[node_tri_verts[tri][i]].set();
+        }
+      }
+    }
+    face_start = face_end;
+  }
+
+  DirtyTrisMesh dirty_tris;
+  int vbo_tri = 0;
+  for (const int tri : tris.index_range()) {
+    if (!hide_poly.is_empty() && hide_poly[tri_faces[tris[tri]]]) {
+      continue;
+    }
+    const int3 &verts = node_tri_verts[tri];
+    if (normal_tris[tri] || normal_verts[verts[0]] || normal_verts[verts[1]] ||
+        normal_verts[verts[2]])
+    {
+      dirty_tris.normals.append({tri, vbo_tri});
+      if (tri_moved(tri)) {
+        dirty_tris.positions.append({tri, vbo_tri});
+      }
+    }
+    vbo_tri++;
+  }
+  return dirty_tris;
+}
+
+void fill_positions_mesh_partial(const Span<int> corner_verts,
+                                 const Span<int3> corner_tris,
+                                 const Span<float3> vert_positions,
+                                 const Span<int> tris,
+                                 const Span<DirtyTri> dirty_tris,
+                                 const MutableSpan<float3> data)
+{
+  for (const DirtyTri &dirty_tri : dirty_tris) {
+    const int3 &tri = corner_tris[tris[dirty_tri.tri]];
+    for (const int i : IndexRange(3)) {
+      data[dirty_tri.vbo_tri * 3 + i] = vert_positions[corner_verts[tri[i]]];
+    }
+  }
+}
+
+void fill_normals_mesh_partial(const Span<int> corner_verts,
+                               const Span<int3> corner_tris,
+                               const Span<int> tri_faces,
+                               const Span<bool> sharp_faces,
+                               const Span<float3> vert_normals,
+                               const Span<float3> face_normals,
+                               const Span<int> tris,
+                               const Span<DirtyTri> dirty_tris,
+                               const MutableSpan<short4> data)
+{
+  for (const DirtyTri &dirty_tri : dirty_tris) {
+    const int face = tri_faces[tris[dirty_tri.tri]];
+    const MutableSpan<short4> tri_data = data.slice(dirty_tri.vbo_tri * 3, 3);
+    if (!sharp_faces.is_empty() && sharp_faces[face]) {
+      tri_data.fill(normal_float_to_short(face_normals[face]));
+    }
+    else {
+      const int3 &tri = corner_tris[tris[dirty_tri.tri]];
+      for (const int i : IndexRange(3)) {
+        tri_data[i] = normal_float_to_short(vert_normals[corner_verts[tri[i]]]);
+      }
+    }
+  }
+}
+
 static void fill_vbo_position_grids(const CCGKey &key,
                                     const Span<CCGElem *> grids,
                                     const bool use_flat_layout,
@@ -609,6 +738,50 @@ static void fill_vbo_position_grids(const CCGKey &key,
   }
 }
 
+IndexRange calc_dirty_grids(const CCGKey &key, const IndexRange dirty_verts)
+{
+  if (dirty_verts.is_empty()) {
+    return {};
+  }
+  return IndexRange::from_begin_end(dirty_verts.first() / key.grid_area,
+                                    dirty_verts.last() / key.grid_area + 1);
+}
+
+void fill_positions_grids_partial(const CCGKey &key,
+                                  const Span<CCGElem *> grids,
+                                  const bool use_flat_layout,
+                                  const Span<int> grid_indices,
+                                  const IndexRange dirty_grids,
+                                  const MutableSpan<float3> data)
+{
+  const int grid_size_1 = key.grid_size - 1;
+  const int verts_per_grid = use_flat_layout ? square_i(grid_size_1) * 4 : key.grid_area;
+  /* The last quad or element along each side of the grid. */
+  const int last = use_flat_layout ? grid_size_1 - 1 : grid_size_1;
+  for (const int i : grid_indices.index_range()) {
+    CCGElem *grid = grids[grid_indices[i]];
+    const MutableSpan<float3> grid_data = data.slice(i * verts_per_grid, verts_per_grid);
+    const bool boundary_only = !dirty_grids.contains(i);
+    for (int y = 0; y <= last; y++) {
+      /* Skip the inside of rows that aren't on the boundary. */
+      const int x_step = boundary_only && y != 0 && y != last ? std::max(last, 1) : 1;
+      for (int x = 0; x <= last; x += x_step) {
+        if (use_flat_layout) {
+          float3 *quad_data = &grid_data[(y * grid_size_1 + x) * 4];
+          quad_data[0] = CCG_grid_elem_co(key, grid, x, y);
+          quad_data[1] = CCG_grid_elem_co(key, grid, x + 1, y);
+          quad_data[2] = CCG_grid_elem_co(key, grid, x + 1, y + 1);
+          quad_data[3] = CCG_grid_elem_co(key, grid, x, y + 1);
+        }
+        else {
+          grid_data[CCG_grid_xy_to_index(key.grid_size, x, y)] = CCG_grid_elem_co(
+              key, grid, x, y);
+        }
+      }
+    }
+  }
+}
+
 static void fill_vbo_normal_grids(const CCGKey &key,
                                   const Span<CCGElem *> grids,
                                   const Span<int> grid_to_face_map,
@@ -727,7 +900,14 @@ static void fill_vbo_face_set_grids(const CCGKey &key,
   }
 }
 
-static void fill_vbo_grids(PBVHVbo &vbo, const PBVH_GPU_Args &args, const bool use_flat_layout)
+/**
+ * \param dirty_grids: When set, only the positions of these grids changed, see
+ * #fill_positions_grids_partial.
+ */
+static void fill_vbo_grids(PBVHVbo &vbo,
+                           const PBVH_GPU_Args &args,
+                           const bool use_flat_layout,
+                           std::optional<IndexRange> dirty_grids)
 {
   const Span<int> grid_indices = args.grid_indices;
   const Span<CCGElem *> grids = args.grids;
@@ -742,12 +922,23 @@ static void fill_vbo_grids(PBVHVbo &vbo, const PBVH_GPU_Args &args, const bool u
   if (vbo.vert_buf->data<uchar>().data() == nullptr || existing_num != vert_count) {
     /* Allocate buffer if not allocated yet or size changed. */
     GPU_vertbuf_data_alloc(*vbo.vert_buf, vert_count);
+    dirty_grids.reset();
   }
 
   if (const CustomRequest *request_type = std::get_if<CustomRequest>(&vbo.request)) {
     switch (*request_type) {
       case CustomRequest::Position: {
-        fill_vbo_position_grids(key, grids, use_flat_layout, grid_indices, *vbo.vert_buf);
+        if (dirty_grids) {
+          fill_positions_grids_partial(key,
+                                       grids,
+                                       use_flat_layout,
+                                       grid_indices,
+                                       *dirty_grids,
+                                       vbo.vert_buf->data<float3>());
+        }
+        else {
+          fill_vbo_position_grids(key, grids, use_flat_layout, grid_indices, *vbo.vert_buf);
+        }
         break;
       }
       case CustomRequest::Normal: {
@@ -804,7 +995,13 @@ static void fill_vbo_grids(PBVHVbo &vbo, const PBVH_GPU_Args &args, const bool u
   }
 }
 
-static void fill_vbo_faces(PBVHVbo &vbo, const PBVH_GPU_Args &args)
+/**
+ * \param dirty_tris: When not null, only the positions of some vertices changed and only the
+ * position and normal data of these triangles is extracted again.
+ */
+static void fill_vbo_faces(PBVHVbo &vbo,
+                           const PBVH_GPU_Args &args,
+                           const DirtyTrisMesh *dirty_tris)
 {
   const int totvert = count_faces(args) * 3;
 
@@ -813,6 +1010,7 @@ static void fill_vbo_faces(PBVHVbo &vbo, const PBVH_GPU_Args &args)
   if (vbo.vert_buf->data<uchar>().data() == nullptr || existing_num != totvert) {
     /* Allocate buffer if not allocated yet or size changed. */
     GPU_vertbuf_data_alloc(*vbo.vert_buf, totvert);
+    dirty_tris = nullptr;
   }
 
   gpu::VertBuf &vert_buf = *vbo.vert_buf;
@@ -822,6 +1020,15 @@ static void fill_vbo_faces(PBVHVbo &vbo, const PBVH_GPU_Args &args)
   if (const CustomRequest *request_type = std::get_if<CustomRequest>(&vbo.request)) {
     switch (*request_type) {
       case CustomRequest::Position: {
+        if (dirty_tris) {
+          fill_positions_mesh_partial(args.corner_verts,
+                                      args.corner_tris,
+                                      args.vert_positions,
+                                      args.prim_indices,
+                                      dirty_tris->positions,
+                                      vert_buf.data<float3>());
+          break;
+        }
         extract_data_vert_mesh<float3>(args.corner_verts,
                                        args.corner_tris,
                                        args.tri_faces,
@@ -835,6 +1042,18 @@ static void fill_vbo_faces(PBVHVbo &vbo, const PBVH_GPU_Args &args)
         const bke::AttributeAccessor attributes = args.mesh->attributes();
         const VArraySpan sharp_faces = *attributes.lookup<bool>("sharp_face",
                                                                 bke::AttrDomain::Face);
+        if (dirty_tris) {
+          fill_normals_mesh_partial(args.corner_verts,
+                                    args.corner_tris,
+                                    args.tri_faces,
+                                    sharp_faces,
+                                    args.vert_normals,
+                                    args.face_normals,
+                                    args.prim_indices,
+                                    dirty_tris->normals,
+                                    vert_buf.data<short4>());
+          break;
+        }
         fill_vbo_normal_mesh(args.corner_verts,
                              args.corner_tris,
                              args.tri_faces,
@@ -1076,23 +1295,79 @@ static void fill_vbo_bmesh(PBVHVbo &vbo, const PBVH_GPU_Args &args)
   }
 }
 
-void PBVHBatches::update(const PBVH_GPU_Args &args)
+bool request_is_dirty(const AttributeRequest &request, const bke::pbvh::DrawDirty dirty)
+{
+  using bke::pbvh::DrawDirty;
+  if (const CustomRequest *request_type = std::get_if<CustomRequest>(&request)) {
+    switch (*request_type) {
+      case CustomRequest::Position:
+      case CustomRequest::Normal:
+        return bool(dirty & DrawDirty::Positions);
+      case CustomRequest::Mask:
+        return bool(dirty & DrawDirty::Masks);
+      case CustomRequest::FaceSet:
+        return bool(dirty & DrawDirty::FaceSets);
+    }
+    BLI_assert_unreachable();
+    return true;
+  }
+  return bool(dirty & DrawDirty::Attributes);
+}
+
+void PBVHBatches::update(const PBVH_GPU_Args &args,
+                         const bke::pbvh::DrawDirty dirty,
+                         const std::optional<IndexRange> dirty_verts)
 {
   if (!this->lines_index) {
     create_index(args);
   }
+
+  /* When only some vertices moved, find the data depending on them. */
+  std::optional<DirtyTrisMesh> dirty_tris;
+  std::optional<IndexRange> dirty_grids;
+  if (dirty_verts) {
+    switch (args.pbvh_type) {
+      case bke::pbvh::Type::Mesh:
+        if (this->boundary_verts.size() != args.node_verts.size()) {
+          this->boundary_verts = calc_boundary_verts_mesh(
+              args.mesh->vert_to_face_map(), args.tri_faces, args.prim_indices, args.node_verts);
+        }
+        dirty_tris = calc_dirty_tris_mesh(args.tri_faces,
+                                          args.hide_poly,
+                                          args.prim_indices,
+                                          args.node_tri_verts,
+                                          args.node_unique_verts_num,
+                                          *dirty_verts,
+                                          this->boundary_verts);
+        break;
+      case bke::pbvh::Type::Grids:
+        dirty_grids = calc_dirty_grids(args.ccg_key, *dirty_verts);
+        break;
+      case bke::pbvh::Type::BMesh:
+        break;
+    }
+  }
+
   for (PBVHVbo &vbo : this->vbos) {
+    /* Buffers that aren't extracted again keep their contents on the GPU and aren't uploaded
+     * when flushing. Dynamic topology changes the triangles of a node without tagging all of its
+     * data, so it always updates all buffers. */
+    if (args.pbvh_type != bke::pbvh::Type::BMesh && !request_is_dirty(vbo.request, dirty)) {
+      continue;
+    }
     switch (args.pbvh_type) {
       case bke::pbvh::Type::Mesh:
-        fill_vbo_faces(vbo, args);
+        fill_vbo_faces(vbo, args, dirty_tris ? &*dirty_tris : nullptr);
         break;
       case bke::pbvh::Type::Grids:
-        fill_vbo_grids(vbo, args, this->use_flat_layout);
+        fill_vbo_grids(vbo, args, this->use_flat_layout, dirty_grids);
         break;
       case bke::pbvh::Type::BMesh:
         fill_vbo_bmesh(vbo, args);
         break;
     }
+    /* Buffers keeping their data aren't reallocated, which would tag them. */
+    GPU_vertbuf_tag_dirty(vbo.vert_buf);
   }
 }
 
@@ -1143,14 +1418,27 @@ int PBVHBatches::create_vbo(const AttributeRequest &request, const PBVH_GPU_Args
     DRW_cdlayer_attr_aliases_add(&format, prefix, data_type, name.c_str(), is_render, is_active);
   }
 
+  /* Positions and normals are extracted partially when only some vertices moved, which requires
+   * keeping their data after uploading it. Multires normals are always extracted fully, because
+   * they are averaged across grids. */
+  GPUUsageType usage = GPU_USAGE_STATIC;
+  if (const CustomRequest *request_type = std::get_if<CustomRequest>(&request)) {
+    if ((*request_type == CustomRequest::Position &&
+         args.pbvh_type != bke::pbvh::Type::BMesh) ||
+        (*request_type == CustomRequest::Normal && args.pbvh_type == bke::pbvh::Type::Mesh))
+    {
+      usage = GPU_USAGE_DYNAMIC;
+    }
+  }
+
   vbos.append_as(request);
-  vbos.last().vert_buf = GPU_vertbuf_create_with_format_ex(format, GPU_USAGE_STATIC);
+  vbos.last().vert_buf = GPU_vertbuf_create_with_format_ex(format, usage);
   switch (args.pbvh_type) {
     case bke::pbvh::Type::Mesh:
-      fill_vbo_faces(vbos.last(), args);
+      fill_vbo_faces(vbos.last(), args, nullptr);
       break;
     case bke::pbvh::Type::Grids:
-      fill_vbo_grids(vbos.last(), args, use_flat_layout);
+      fill_vbo_grids(vbos.last(), args, use_flat_layout, std::nullopt);
       break;
     case bke::pbvh::Type::BMesh:
       fill_vbo_bmesh(vbos.last(), args);
@@ -1557,9 +1845,12 @@ static PBVHBatch &ensure_batch(PBVHBatches &batches,
   });
 }
 
-void node_update(PBVHBatches *batches, const PBVH_GPU_Args &args)
+void node_update(PBVHBatches *batches,
+                 const PBVH_GPU_Args &args,
+                 const bke::pbvh::DrawDirty dirty,
+                 const std::optional<IndexRange> dirty_verts)
 {
-  batches->update(args);
+  batches->update(args, dirty, dirty_verts);
 }
 
 void node_gpu_flush(PBVHBatches *batches)
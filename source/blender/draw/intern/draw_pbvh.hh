@@ -4,10 +4,106 @@
 
 #pragma once
 
+#include "BLI_bit_vector.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_offset_indices.hh"
+#include "BLI_span.hh"
+#include "BLI_vector.hh"
+
+struct CCGElem;
+struct CCGKey;
+
 namespace blender::draw::pbvh {
 
 struct PBVHBatches;
 
 int material_index_get(PBVHBatches *batches);
 
+/* -------------------------------------------------------------------- */
+/** \name Partial Extraction
+ *
+ * When only the positions of some vertices of a node changed, only the vertex buffer data
+ * depending on them is extracted again.
+ * \{ */
+
+struct DirtyTri {
+  /** Index in the node's triangles. */
+  int tri;
+  /** Index of the triangle in the vertex buffers, which skip hidden triangles. */
+  int vbo_tri;
+};
+
+struct DirtyTrisMesh {
+  /** Triangles using vertices which positions changed. */
+  Vector<DirtyTri> positions;
+  /** Triangles which normals changed, a superset of #positions. */
+  Vector<DirtyTri> normals;
+};
+
+/**
+ * Find the vertices of a mesh node used by faces of other nodes. Their normals can change when
+ * other nodes change.
+ *
+ * \param tris: The node's triangles.
+ * \param node_verts: The node's vertices, see #bke::pbvh::node_verts.
+ */
+BitVector<> calc_boundary_verts_mesh(GroupedSpan<int> vert_to_face_map,
+                                     Span<int> tri_faces,
+                                     Span<int> tris,
+                                     Span<int> node_verts);
+
+/**
+ * Find the triangles of a mesh node which position or normal data changed when the positions of
+ * \a dirty_verts changed. Shared vertices are owned by other nodes and are considered changed.
+ *
+ * \param node_tri_verts: The vertices of the node's triangles, as indices in its vertices.
+ * \param unique_verts_num: The number of vertices owned by the node, which come first.
+ * \param dirty_verts: The changed vertices owned by the node.
+ * \param boundary_verts: See #calc_boundary_verts_mesh.
+ */
+DirtyTrisMesh calc_dirty_tris_mesh(Span<int> tri_faces,
+                                   Span<bool> hide_poly,
+                                   Span<int> tris,
+                                   Span<int3> node_tri_verts,
+                                   int unique_verts_num,
+                                   IndexRange dirty_verts,
+                                   BoundedBitSpan boundary_verts);
+
+void fill_positions_mesh_partial(Span<int> corner_verts,
+                                 Span<int3> corner_tris,
+                                 Span<float3> vert_positions,
+                                 Span<int> tris,
+                                 Span<DirtyTri> dirty_tris,
+                                 MutableSpan<float3> data);
+
+void fill_normals_mesh_partial(Span<int> corner_verts,
+                               Span<int3> corner_tris,
+                               Span<int> tri_faces,
+                               Span<bool> sharp_faces,
+                               Span<float3> vert_normals,
+                               Span<float3> face_normals,
+                               Span<int> tris,
+                               Span<DirtyTri> dirty_tris,
+                               MutableSpan<short4> data);
+
+/**
+ * Find the grids of a multires node containing the changed grid elements, see
+ * #bke::pbvh::Node::draw_dirty_verts_.
+ */
+IndexRange calc_dirty_grids(const CCGKey &key, IndexRange dirty_verts);
+
+/**
+ * Extract the positions of \a dirty_grids (indices in \a grid_indices) again. Only the boundaries
+ * of other grids are extracted, as averaging duplicate elements can move them.
+ */
+void fill_positions_grids_partial(const CCGKey &key,
+                                  Span<CCGElem *> grids,
+                                  bool use_flat_layout,
+                                  Span<int> grid_indices,
+                                  IndexRange dirty_grids,
+                                  MutableSpan<float3> data);
+
+/** \} */
+
 }  // namespace blender::draw::pbvh
@@ -0,0 +1,309 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_bit_vector.hh"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_vector.hh"
+
+#include "BKE_attribute.hh"
+#include "BKE_ccg.hh"
+#include "BKE_mesh_mapping.hh"
+
+#include "DRW_pbvh.hh"
+
+#include "draw_pbvh.hh"
+
+namespace blender::draw::pbvh::tests {
+
+using bke::pbvh::DrawDirty;
+
+/* Doesn't need a GPU context, only the selection of buffers to extract again is tested. */
+TEST(draw_pbvh, RequestIsDirty)
+{
+  const AttributeRequest position = CustomRequest::Position;
+  const AttributeRequest normal = CustomRequest::Normal;
+  const AttributeRequest mask = CustomRequest::Mask;
+  const AttributeRequest face_set = CustomRequest::FaceSet;
+  const AttributeRequest color = GenericRequest("Color", CD_PROP_COLOR, bke::AttrDomain::Point);
+
+  EXPECT_TRUE(request_is_dirty(position, DrawDirty::Positions));
+  EXPECT_TRUE(request_is_dirty(normal, DrawDirty::Positions));
+  EXPECT_FALSE(request_is_dirty(mask, DrawDirty::Positions));
+  EXPECT_FALSE(request_is_dirty(face_set, DrawDirty::Positions));
+  EXPECT_FALSE(request_is_dirty(color, DrawDirty::Positions));
+
+  EXPECT_FALSE(request_is_dirty(position, DrawDirty::Masks));
+  EXPECT_FALSE(request_is_dirty(normal, DrawDirty::Masks));
+  EXPECT_TRUE(request_is_dirty(mask, DrawDirty::Masks));
+
+  EXPECT_TRUE(request_is_dirty(face_set, DrawDirty::FaceSets));
+  EXPECT_FALSE(request_is_dirty(mask, DrawDirty::FaceSets));
+
+  EXPECT_TRUE(request_is_dirty(color, DrawDirty::Attributes));
+  EXPECT_FALSE(request_is_dirty(position, DrawDirty::Attributes));
+
+  EXPECT_TRUE(request_is_dirty(mask, DrawDirty::Masks | DrawDirty::FaceSets));
+  EXPECT_TRUE(request_is_dirty(face_set, DrawDirty::Masks | DrawDirty::FaceSets));
+
+  for (const AttributeRequest &request : {position, normal, mask, face_set, color}) {
+    EXPECT_TRUE(request_is_dirty(request, DrawDirty::All));
+    EXPECT_FALSE(request_is_dirty(request, DrawDirty::None));
+  }
+}
+
+/**
+ * A strip of quads along X, the first 8 quads being in the tested node and the last two in
+ * another node, which owns the vertices shared by both nodes.
+ */
+struct QuadStrip {
+  static constexpr int faces_num = 10;
+  static constexpr int node_faces_num = 8;
+  static constexpr int verts_num = (faces_num + 1) * 2;
+  /* The first vertex of the top row. */
+  static constexpr int top = faces_num + 1;
+
+  Array<int> face_offsets = Array<int>(faces_num + 1);
+  Array<int> corner_verts = Array<int>(faces_num * 4);
+  Array<int3> corner_tris = Array<int3>(faces_num * 2);
+  Array<int> tri_faces = Array<int>(faces_num * 2);
+  Array<float3> positions = Array<float3>(verts_num);
+  Array<float3> vert_normals = Array<float3>(verts_num);
+  Array<float3> face_normals = Array<float3>(faces_num, float3(0.0f, 0.0f, 1.0f));
+
+  /* The tested node. */
+  Array<int> tris = Array<int>(node_faces_num * 2);
+  Vector<int> node_verts;
+  int unique_verts_num;
+  Array<int3> node_tri_verts = Array<int3>(node_faces_num * 2);
+
+  QuadStrip()
+  {
+    for (const int face : IndexRange(faces_num)) {
+      face_offsets[face] = face * 4;
+      corner_verts[face * 4 + 0] = face;
+      corner_verts[face * 4 + 1] = face + 1;
+      corner_verts[face * 4 + 2] = top + face + 1;
+      corner_verts[face * 4 + 3] = top + face;
+      corner_tris[face * 2] = int3(face * 4, face * 4 + 1, face * 4 + 2);
+      corner_tris[face * 2 + 1] = int3(face * 4, face * 4 + 2, face * 4 + 3);
+      tri_faces[face * 2] = face;
+      tri_faces[face * 2 + 1] = face;
+    }
+    face_offsets.last() = faces_num * 4;
+    for (const int i : IndexRange(top)) {
+      positions[i] = float3(i, 0.0f, 0.0f);
+      positions[top + i] = float3(i, 1.0f, 0.0f);
+    }
+    for (const int vert : IndexRange(verts_num)) {
+      vert_normals[vert] = math::normalize(float3(0.01f * vert, 0.0f, 1.0f));
+    }
+
+    for (const int i : tris.index_range()) {
+      tris[i] = i;
+    }
+    /* The last vertices of the node are owned by the other node. */
+    for (const int i : IndexRange(node_faces_num)) {
+      node_verts.append(i);
+    }
+    for (const int i : IndexRange(node_faces_num)) {
+      node_verts.append(top + i);
+    }
+    unique_verts_num = node_verts.size();
+    node_verts.append(node_faces_num);
+    node_verts.append(top + node_faces_num);
+    for (const int tri : tris) {
+      for (const int i : IndexRange(3)) {
+        node_tri_verts[tri][i] = node_verts.first_index_of(corner_verts[corner_tris[tri][i]]);
+      }
+    }
+  }
+};
+
+static Vector<int> dirty_tri_indices(const Span<DirtyTri> dirty_tris)
+{
+  Vector<int> indices;
+  for (const DirtyTri &dirty_tri : dirty_tris) {
+    indices.append(dirty_tri.tri);
+  }
+  return indices;
+}
+
+TEST(draw_pbvh, PartialExtractionMesh)
+{
+  QuadStrip strip;
+  Array<bool> hide_poly(QuadStrip::faces_num, false);
+  hide_poly[5] = true;
+  Array<bool> sharp_faces(QuadStrip::faces_num, false);
+  sharp_faces[0] = true;
+
+  Array<int> vert_to_face_offsets;
+  Array<int> vert_to_face_indices;
+  const GroupedSpan<int> vert_to_face_map = bke::mesh::build_vert_to_face_map(
+      strip.face_offsets.as_span(),
+      strip.corner_verts,
+      QuadStrip::verts_num,
+      vert_to_face_offsets,
+      vert_to_face_indices);
+
+  /* Only the vertices shared with the other node are used by its faces. */
+  const BitVector<> boundary_verts = calc_boundary_verts_mesh(
+      vert_to_face_map, strip.tri_faces, strip.tris, strip.node_verts);
+  for (const int i : strip.node_verts.index_range()) {
+    EXPECT_EQ(boundary_verts[i], i >= strip.unique_verts_num);
+  }
+
+  /* Move the second vertex of the bottom row. */
+  const IndexRange dirty_verts(1, 1);
+  const DirtyTrisMesh dirty_tris = calc_dirty_tris_mesh(strip.tri_faces,
+                                                        hide_poly,
+                                                        strip.tris,
+                                                        strip.node_tri_verts,
+                                                        strip.unique_verts_num,
+                                                        dirty_verts,
+                                                        boundary_verts);
+  /* The triangles using the moved vertex and the shared vertices. */
+  EXPECT_EQ(dirty_tri_indices(dirty_tris.positions).as_span(), Span<int>({0, 2, 3, 14, 15}));
+  /* The triangles of their faces and of the neighbors of the vertices of these faces, except the
+   * triangles of the hidden face. */
+  EXPECT_EQ(dirty_tri_indices(dirty_tris.normals).as_span(),
+            Span<int>({0, 1, 2, 3, 4, 5, 12, 13, 14, 15}));
+  /* Hidden triangles aren't in the vertex buffers. */
+  EXPECT_EQ(dirty_tris.normals.last().vbo_tri, 13);
+
+  strip.positions[1].z = 0.5f;
+  for (float3 &normal : strip.vert_normals) {
+    normal = math::normalize(normal + float3(0.0f, 0.1f, 0.0f));
+  }
+  strip.face_normals[0] = math::normalize(float3(0.0f, -0.5f, 1.0f));
+
+  const int visible_tris_num = strip.tris.size() - 2;
+  const float3 position_sentinel(-1.0f);
+  const short4 normal_sentinel(-1);
+  Array<float3> positions_data(visible_tris_num * 3, position_sentinel);
+  Array<short4> normals_data(visible_tris_num * 3, normal_sentinel);
+  fill_positions_mesh_partial(strip.corner_verts,
+                              strip.corner_tris,
+                              strip.positions,
+                              strip.tris,
+                              dirty_tris.positions,
+                              positions_data);
+  fill_normals_mesh_partial(strip.corner_verts,
+                            strip.corner_tris,
+                            strip.tri_faces,
+                            sharp_faces,
+                            strip.vert_normals,
+                            strip.face_normals,
+                            strip.tris,
+                            dirty_tris.normals,
+                            normals_data);
+
+  /* Changed triangles match a full extraction, others aren't written. */
+  const Vector<int> position_tris = dirty_tri_indices(dirty_tris.positions);
+  const Vector<int> normal_tris = dirty_tri_indices(dirty_tris.normals);
+  int vbo_vert = 0;
+  for (const int tri : strip.tris) {
+    const int face = strip.tri_faces[tri];
+    if (hide_poly[face]) {
+      continue;
+    }
+    for (const int i : IndexRange(3)) {
+      const int vert = strip.corner_verts[strip.corner_tris[tri][i]];
+      if (position_tris.contains(tri)) {
+        EXPECT_EQ(positions_data[vbo_vert], strip.positions[vert]);
+      }
+      else {
+        EXPECT_EQ(positions_data[vbo_vert], position_sentinel);
+      }
+      if (normal_tris.contains(tri)) {
+        short3 normal;
+        normal_float_to_short_v3(
+            normal, sharp_faces[face] ? strip.face_normals[face] : strip.vert_normals[vert]);
+        EXPECT_EQ(normals_data[vbo_vert], short4(normal.x, normal.y, normal.z, 0));
+      }
+      else {
+        EXPECT_EQ(normals_data[vbo_vert], normal_sentinel);
+      }
+      vbo_vert++;
+    }
+  }
+}
+
+TEST(draw_pbvh, PartialExtractionGrids)
+{
+  CCGKey key{};
+  key.grid_size = 4;
+  key.grid_area = key.grid_size * key.grid_size;
+  key.elem_size = sizeof(float3);
+  key.grid_bytes = key.grid_area * key.elem_size;
+
+  /* Two grids, in reverse order in the node. */
+  Array<float3> grid_positions(key.grid_area * 2);
+  for (const int i : grid_positions.index_range()) {
+    grid_positions[i] = float3(i, 0.0f, 0.0f);
+  }
+  const Array<CCGElem *> grids = {
+      reinterpret_cast<CCGElem *>(&grid_positions[0]),
+      reinterpret_cast<CCGElem *>(&grid_positions[key.grid_area]),
+  };
+  const Array<int> grid_indices = {1, 0};
+
+  /* An element inside the first grid of the node. */
+  const IndexRange dirty_grids = calc_dirty_grids(key, IndexRange(5, 1));
+  EXPECT_EQ(dirty_grids, IndexRange(0, 1));
+  EXPECT_TRUE(calc_dirty_grids(key, {}).is_empty());
+  EXPECT_EQ(calc_dirty_grids(key, IndexRange(key.grid_area - 1, 2)), IndexRange(0, 2));
+
+  const float3 sentinel(-1.0f);
+  const auto is_boundary = [&](const int x, const int y, const int last) {
+    return x == 0 || y == 0 || x == last || y == last;
+  };
+
+  /* Changed grids are extracted fully, others only on their boundaries. */
+  Array<float3> data(key.grid_area * 2, sentinel);
+  fill_positions_grids_partial(key, grids, false, grid_indices, dirty_grids, data);
+  for (const int i : grid_indices.index_range()) {
+    for (const int y : IndexRange(key.grid_size)) {
+      for (const int x : IndexRange(key.grid_size)) {
+        const int offset = y * key.grid_size + x;
+        const float3 &value = data[i * key.grid_area + offset];
+        if (dirty_grids.contains(i) || is_boundary(x, y, key.grid_size - 1)) {
+          EXPECT_EQ(value, CCG_elem_offset_co(key, grids[grid_indices[i]], offset));
+        }
+        else {
+          EXPECT_EQ(value, sentinel);
+        }
+      }
+    }
+  }
+
+  /* With the flat layout, the four corners of each quad are stored. */
+  const int grid_size_1 = key.grid_size - 1;
+  const int verts_per_grid = grid_size_1 * grid_size_1 * 4;
+  Array<float3> flat_data(verts_per_grid * 2, sentinel);
+  fill_positions_grids_partial(key, grids, true, grid_indices, dirty_grids, flat_data);
+  for (const int i : grid_indices.index_range()) {
+    CCGElem *grid = grids[grid_indices[i]];
+    for (const int y : IndexRange(grid_size_1)) {
+      for (const int x : IndexRange(grid_size_1)) {
+        const float3 *quad = &flat_data[i * verts_per_grid + (y * grid_size_1 + x) * 4];
+        if (dirty_grids.contains(i) || is_boundary(x, y, grid_size_1 - 1)) {
+          EXPECT_EQ(quad[0], CCG_grid_elem_co(key, grid, x, y));
+          EXPECT_EQ(quad[1], CCG_grid_elem_co(key, grid, x + 1, y));
+          EXPECT_EQ(quad[2], CCG_grid_elem_co(key, grid, x + 1, y + 1));
+          EXPECT_EQ(quad[3], CCG_grid_elem_co(key, grid, x, y + 1));
+        }
+        else {
+          EXPECT_EQ(quad[0], sentinel);
+          EXPECT_EQ(quad[3], sentinel);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace blender::draw::pbvh::tests
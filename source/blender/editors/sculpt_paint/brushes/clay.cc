@@ -241,7 +241,7 @@ void do_clay_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> nod
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -251,6 +251,7 @@ void do_clay_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> nod
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, test_plane, bstrength, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -296,7 +296,7 @@ void do_clay_strips_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -306,6 +306,7 @@ void do_clay_strips_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, mat, plane, strength, flip, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
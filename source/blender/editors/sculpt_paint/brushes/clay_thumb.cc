@@ -273,7 +273,7 @@ void do_clay_thumb_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -283,6 +283,7 @@ void do_clay_thumb_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, brush, plane_tilt, clay_strength, *nodes[i], object, tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
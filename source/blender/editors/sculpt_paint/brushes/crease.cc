@@ -280,7 +280,7 @@ static void do_crease_or_blob_brush(const Scene &scene,
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -290,6 +290,7 @@ static void do_crease_or_blob_brush(const Scene &scene,
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, offset, strength, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
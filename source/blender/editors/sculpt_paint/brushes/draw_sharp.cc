@@ -192,7 +192,7 @@ static void offset_positions(const Sculpt &sd,
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_faces(sd, brush, offset, positions_eval, *nodes[i], object, tls, positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -202,6 +202,7 @@ static void offset_positions(const Sculpt &sd,
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, offset, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -233,7 +233,7 @@ void do_draw_vector_displacement_brush(const Sculpt &sd,
         for (const int i : range) {
           calc_faces(
               sd, brush, positions_eval, vert_normals, *nodes[i], object, tls, positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -243,6 +243,7 @@ void do_draw_vector_displacement_brush(const Sculpt &sd,
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -246,7 +246,7 @@ void do_elastic_deform_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::N
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -256,6 +256,7 @@ void do_elastic_deform_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::N
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, params, grab_delta, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -330,7 +330,7 @@ void do_enhance_details_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -340,6 +340,7 @@ void do_enhance_details_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, translations, strength, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
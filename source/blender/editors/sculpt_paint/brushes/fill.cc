@@ -228,7 +228,7 @@ void do_fill_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> nod
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -238,6 +238,7 @@ void do_fill_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> nod
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, plane, ss.cache->bstrength, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
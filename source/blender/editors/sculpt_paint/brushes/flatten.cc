@@ -221,7 +221,7 @@ void do_flatten_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *>
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -231,6 +231,7 @@ void do_flatten_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *>
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, plane, ss.cache->bstrength, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -224,7 +224,7 @@ void do_grab_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> nod
         for (const int i : range) {
           calc_faces(
               sd, brush, grab_delta, positions_eval, *nodes[i], object, tls, positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -234,6 +234,7 @@ void do_grab_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> nod
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, grab_delta, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -206,7 +206,7 @@ void do_inflate_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *>
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -216,6 +216,7 @@ void do_inflate_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *>
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, scale, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -654,7 +654,7 @@ void do_multiplane_scrape_brush(const Sculpt &sd,
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -672,6 +672,7 @@ void do_multiplane_scrape_brush(const Sculpt &sd,
                      *nodes[i],
                      object,
                      tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
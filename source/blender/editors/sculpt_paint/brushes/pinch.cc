@@ -267,7 +267,7 @@ void do_pinch_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> no
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -277,6 +277,7 @@ void do_pinch_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> no
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, stroke_xz, ss.cache->bstrength, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -220,7 +220,7 @@ void do_rotate_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> n
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_faces(sd, brush, angle, positions_eval, *nodes[i], object, tls, positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -230,6 +230,7 @@ void do_rotate_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> n
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, angle, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
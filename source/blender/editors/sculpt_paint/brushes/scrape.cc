@@ -229,7 +229,7 @@ void do_scrape_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> n
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -239,6 +239,7 @@ void do_scrape_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> n
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, plane, ss.cache->bstrength, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -399,7 +399,7 @@ void do_snake_hook_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node
                      *nodes[i],
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -409,6 +409,7 @@ void do_snake_hook_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, &spvc, grab_delta, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -196,7 +196,7 @@ void do_thumb_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> no
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_faces(sd, brush, offset, positions_eval, *nodes[i], object, tls, positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -206,6 +206,7 @@ void do_thumb_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::Node *> no
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, offset, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
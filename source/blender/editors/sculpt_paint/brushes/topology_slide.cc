@@ -339,7 +339,7 @@ void do_topology_slide_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::N
                      object,
                      tls,
                      positions_orig);
-          BKE_pbvh_node_mark_positions_update(nodes[i]);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -349,6 +349,7 @@ void do_topology_slide_brush(const Sculpt &sd, Object &object, Span<bke::pbvh::N
         LocalData &tls = all_tls.local();
         for (const int i : range) {
           calc_grids(sd, object, brush, *nodes[i], tls);
+          mark_positions_update(*nodes[i], tls.translations);
         }
       });
       break;
@@ -390,6 +390,13 @@ void write_translations(const Sculpt &sd,
                         MutableSpan<float3> translations,
                         MutableSpan<float3> positions_orig);
 
+/**
+ * Tag the node's positions as changed, recording the range of vertices with non-zero
+ * translations so that drawing only extracts their data again. The translations are in the order
+ * of #bke::pbvh::node_unique_verts or of the elements of #bke::pbvh::node_grid_indices.
+ */
+void mark_positions_update(bke::pbvh::Node &node, Span<float3> translations);
+
 /**
  * Creates OffsetIndices based on each node's unique vertex count, allowing for easy slicing of a
  * new array.
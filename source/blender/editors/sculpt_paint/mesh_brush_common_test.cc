@@ -0,0 +1,321 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup edsculpt
+ */
+
+#include "BLI_array.hh"
+#include "BLI_math_base.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_rand.hh"
+
+#include "BKE_brush.hh"
+#include "BKE_paint.hh"
+
+#include "mesh_brush_common.hh"
+
+#include "testing/testing.h"
+
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::ed::sculpt_paint::test {
+
+/* Not a multiple of four, so both the vectorized loops and the remainder are tested. */
+static const int elems_num = 1027;
+
+static Array<float3> random_positions(const int size, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float3> positions(size);
+  for (float3 &position : positions) {
+    position = float3(rng.get_float(), rng.get_float(), rng.get_float()) * 2.0f - 1.0f;
+  }
+  return positions;
+}
+
+static Array<float> random_factors(const int size, const uint32_t seed)
+{
+  RandomNumberGenerator rng(seed);
+  Array<float> factors(size);
+  for (float &factor : factors) {
+    factor = rng.get_float();
+  }
+  return factors;
+}
+
+/** Every other vertex in reverse order, like the vertices of a node referencing mesh data. */
+static Array<int> shuffled_indices(const int size)
+{
+  Array<int> indices(size / 2);
+  for (const int i : indices.index_range()) {
+    indices[i] = size - 1 - i * 2;
+  }
+  return indices;
+}
+
+TEST(mesh_brush_common, CalcBrushDistances)
+{
+  const Array<float3> positions = random_positions(elems_num, 0);
+  const Array<int> verts = shuffled_indices(elems_num);
+
+  SculptSession ss;
+  ss.cursor_location = float3(0.1f, -0.2f, 0.3f);
+
+  Array<float> distances(elems_num);
+  calc_brush_distances(ss, positions, PAINT_FALLOFF_SHAPE_SPHERE, distances);
+  for (const int i : positions.index_range()) {
+    EXPECT_FLOAT_EQ(distances[i], math::distance(ss.cursor_location, positions[i]));
+  }
+
+  Array<float> vert_distances(verts.size());
+  calc_brush_distances(ss, positions, verts, PAINT_FALLOFF_SHAPE_SPHERE, vert_distances);
+  for (const int i : verts.index_range()) {
+    EXPECT_FLOAT_EQ(vert_distances[i], math::distance(ss.cursor_location, positions[verts[i]]));
+  }
+}
+
+TEST(mesh_brush_common, FilterDistancesWithRadius)
+{
+  Array<float> distances = random_factors(elems_num, 0);
+  distances[0] = 0.5f;
+  const Array<float> factors_orig = random_factors(elems_num, 1);
+
+  Array<float> factors = factors_orig;
+  filter_distances_with_radius(0.5f, distances, factors);
+  for (const int i : factors.index_range()) {
+    EXPECT_EQ(factors[i], distances[i] > 0.5f ? 0.0f : factors_orig[i]);
+  }
+}
+
+TEST(mesh_brush_common, ApplyHardnessToDistances)
+{
+  const float radius = 0.8f;
+  const float hardness = 0.3f;
+  const Array<float> distances_orig = random_factors(elems_num, 0);
+
+  Array<float> distances = distances_orig;
+  apply_hardness_to_distances(radius, hardness, distances);
+  for (const int i : distances.index_range()) {
+    const float distance = distances_orig[i];
+    const float expected = distance < hardness * radius ?
+                               0.0f :
+                               (distance / radius - hardness) / (1.0f - hardness) * radius;
+    EXPECT_NEAR(distances[i], expected, 1e-6f);
+  }
+}
+
+TEST(mesh_brush_common, CalcFrontFace)
+{
+  const float3 view_normal = math::normalize(float3(0.3f, -0.5f, 0.8f));
+  Array<float3> normals = random_positions(elems_num, 0);
+  for (float3 &normal : normals) {
+    normal = math::normalize(normal);
+  }
+  const Array<int> verts = shuffled_indices(elems_num);
+  const Array<float> factors_orig = random_factors(elems_num, 1);
+
+  Array<float> factors = factors_orig;
+  calc_front_face(view_normal, normals, factors);
+  for (const int i : factors.index_range()) {
+    const float expected = factors_orig[i] * std::max(math::dot(view_normal, normals[i]), 0.0f);
+    EXPECT_FLOAT_EQ(factors[i], expected);
+  }
+
+  Array<float> vert_factors = factors_orig.as_span().take_front(verts.size());
+  calc_front_face(view_normal, normals, verts, vert_factors);
+  for (const int i : verts.index_range()) {
+    const float dot = math::dot(view_normal, normals[verts[i]]);
+    EXPECT_FLOAT_EQ(vert_factors[i], factors_orig[i] * std::max(dot, 0.0f));
+  }
+}
+
+TEST(mesh_brush_common, Translations)
+{
+  const float3 offset(0.25f, -1.5f, 3.0f);
+  const Array<float> factors = random_factors(elems_num, 0);
+
+  Array<float3> translations(elems_num);
+  translations_from_offset_and_factors(offset, factors, translations);
+  for (const int i : translations.index_range()) {
+    EXPECT_EQ(translations[i], offset * factors[i]);
+  }
+
+  const Array<float> scale = random_factors(elems_num, 1);
+  scale_translations(translations, scale);
+  for (const int i : translations.index_range()) {
+    EXPECT_EQ(translations[i], offset * factors[i] * scale[i]);
+  }
+}
+
+TEST(mesh_brush_common, CalcCurveFactors)
+{
+  const float radius = 0.7f;
+  Array<float> distances = random_factors(elems_num, 0);
+  distances[0] = radius;
+  distances[1] = 0.0f;
+
+  for (const eBrushCurvePreset preset : {BRUSH_CURVE_SMOOTH,
+                                         BRUSH_CURVE_SPHERE,
+                                         BRUSH_CURVE_ROOT,
+                                         BRUSH_CURVE_SHARP,
+                                         BRUSH_CURVE_LIN,
+                                         BRUSH_CURVE_POW4,
+                                         BRUSH_CURVE_INVSQUARE,
+                                         BRUSH_CURVE_CONSTANT,
+                                         BRUSH_CURVE_SMOOTHER})
+  {
+    Array<float> factors(elems_num, 1.0f);
+    BKE_brush_calc_curve_factors(preset, nullptr, distances, radius, factors);
+    for (const int i : factors.index_range()) {
+      const float expected = preset == BRUSH_CURVE_CONSTANT ?
+                                 1.0f :
+                                 BKE_brush_curve_strength(preset, nullptr, distances[i], radius);
+      EXPECT_NEAR(factors[i], expected, 1e-5f) << "preset " << int(preset) << " at " << i;
+    }
+  }
+}
+
+TEST(mesh_brush_common, NeighborAverage)
+{
+  const Array<float3> positions = random_positions(elems_num, 0);
+  const Array<int> verts = shuffled_indices(elems_num);
+
+  /* Neighbor counts differ between vertices processed together, and some vertices are loose. */
+  RandomNumberGenerator rng(0);
+  Array<Vector<int>> vert_neighbors(verts.size());
+  for (const int i : vert_neighbors.index_range()) {
+    const int neighbors_num = i % 11 == 0 ? 0 : 2 + rng.get_int32(6);
+    for ([[maybe_unused]] const int j : IndexRange(neighbors_num)) {
+      vert_neighbors[i].append(rng.get_int32(elems_num));
+    }
+  }
+
+  const auto expected_average = [&](const int i) {
+    const Span<int> neighbors = vert_neighbors[i];
+    if (neighbors.is_empty()) {
+      return positions[verts[i]];
+    }
+    float3 sum(0);
+    for (const int neighbor : neighbors) {
+      sum += positions[neighbor] * math::rcp(float(neighbors.size()));
+    }
+    return sum;
+  };
+
+  Array<float3> averages(verts.size());
+  smooth::neighbor_data_average_mesh_check_loose<float3>(
+      positions, verts, vert_neighbors, averages);
+  for (const int i : averages.index_range()) {
+    EXPECT_V3_NEAR(averages[i], expected_average(i), 1e-6f);
+  }
+
+  /* Without loose vertices. */
+  for (const int i : vert_neighbors.index_range()) {
+    if (vert_neighbors[i].is_empty()) {
+      vert_neighbors[i].append(verts[i]);
+    }
+  }
+  smooth::neighbor_data_average_mesh<float3>(positions, vert_neighbors, averages);
+  for (const int i : averages.index_range()) {
+    EXPECT_V3_NEAR(averages[i], expected_average(i), 1e-6f);
+  }
+}
+
+#if DO_PERF_TESTS
+
+/**
+ * Replay a stroke of the draw brush over a dense point cloud, split into chunks the size of PBVH
+ * leaf nodes, comparing the scalar math the brush helpers used before with the helpers.
+ */
+TEST(mesh_brush_common, DrawStroke_Performance)
+{
+  const int verts_num = 4'000'000;
+  const int node_size = 10'000;
+  const int dabs_num = 100;
+  const float radius = 0.5f;
+  const float3 view_normal = math::normalize(float3(0.0f, -1.0f, 0.5f));
+  const Array<float3> positions_orig = random_positions(verts_num, 0);
+  Array<float3> normals = random_positions(verts_num, 1);
+  for (float3 &normal : normals) {
+    normal = math::normalize(normal);
+  }
+  Array<int> verts(verts_num);
+  for (const int i : verts.index_range()) {
+    verts[i] = (i * 7919) % verts_num;
+  }
+
+  Array<float3> dab_locations(dabs_num);
+  for (const int i : dab_locations.index_range()) {
+    const float t = float(i) / dabs_num;
+    dab_locations[i] = float3(t * 1.6f - 0.8f, math::sin(t * 6.0f) * 0.5f, 0.0f);
+  }
+
+  Array<float> factors(node_size);
+  Array<float> distances(node_size);
+  Array<float3> translations(node_size);
+  const auto replay_stroke = [&](const char *name, const auto &calc_node) {
+    Array<float3> positions = positions_orig;
+    SCOPED_TIMER(name);
+    for (const float3 &location : dab_locations) {
+      for (int start = 0; start < verts_num; start += node_size) {
+        calc_node(location, verts.as_span().slice(start, node_size), positions);
+      }
+    }
+  };
+
+  replay_stroke("draw scalar",
+                [&](const float3 &location, const Span<int> node_verts, MutableSpan<float3> dst) {
+                  factors.fill(1.0f);
+                  for (const int i : node_verts.index_range()) {
+                    const float dot = math::dot(view_normal, normals[node_verts[i]]);
+                    factors[i] *= std::max(dot, 0.0f);
+                  }
+                  for (const int i : node_verts.index_range()) {
+                    distances[i] = math::distance(location, dst[node_verts[i]]);
+                  }
+                  for (const int i : node_verts.index_range()) {
+                    if (distances[i] > radius) {
+                      factors[i] = 0.0f;
+                    }
+                  }
+                  for (const int i : node_verts.index_range()) {
+                    if (distances[i] >= radius) {
+                      factors[i] = 0.0f;
+                      continue;
+                    }
+                    const float factor = 1.0f - distances[i] / radius;
+                    factors[i] *= 3.0f * factor * factor - 2.0f * factor * factor * factor;
+                  }
+                  for (const int i : node_verts.index_range()) {
+                    translations[i] = view_normal * 0.01f * factors[i];
+                  }
+                  for (const int i : node_verts.index_range()) {
+                    dst[node_verts[i]] += translations[i];
+                  }
+                });
+
+  SculptSession ss;
+  replay_stroke("draw kernels",
+                [&](const float3 &location, const Span<int> node_verts, MutableSpan<float3> dst) {
+                  ss.cursor_location = location;
+                  factors.fill(1.0f);
+                  calc_front_face(view_normal, normals, node_verts, factors);
+                  calc_brush_distances(
+                      ss, dst, node_verts, PAINT_FALLOFF_SHAPE_SPHERE, distances);
+                  filter_distances_with_radius(radius, distances, factors);
+                  BKE_brush_calc_curve_factors(
+                      BRUSH_CURVE_SMOOTH, nullptr, distances, radius, factors);
+                  translations_from_offset_and_factors(view_normal * 0.01f, factors, translations);
+                  apply_translations(translations, node_verts, dst);
+                });
+}
+
+#endif
+
+}  // namespace blender::ed::sculpt_paint::test
@@ -28,6 +28,7 @@
 #include "BLI_math_matrix.hh"
 #include "BLI_math_rotation.h"
 #include "BLI_set.hh"
+#include "BLI_simd.hh"
 #include "BLI_span.hh"
 #include "BLI_task.h"
 #include "BLI_task.hh"
@@ -3603,8 +3604,9 @@ static void push_undo_nodes(Object &ob, const Brush &brush, const Span<bke::pbvh
 
   if (need_coords) {
     undo::push_nodes(ob, nodes, undo::Type::Position);
+    /* Brushes record the vertices they move with #mark_positions_update. */
     for (bke::pbvh::Node *node : nodes) {
-      BKE_pbvh_node_mark_positions_update(node);
+      BKE_pbvh_node_mark_positions_pending(node);
     }
   }
 }
@@ -3887,6 +3889,10 @@ static void do_brush_action(const Scene &scene,
     else {
       do_smooth_brush(sd, ob, nodes, brush.autosmooth_factor);
     }
+    /* Smoothing doesn't record the vertices it moves. */
+    for (bke::pbvh::Node *node : nodes) {
+      BKE_pbvh_node_mark_positions_update(node);
+    }
   }
 
   if (sculpt_brush_use_topology_rake(ss, brush)) {
@@ -6844,6 +6850,135 @@ void fill_factor_from_hide_and_mask(const SubdivCCG &subdiv_ccg,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Vectorized Brush Kernels
+ *
+ * The per-vertex work shared by most brushes is done four vertices at a time with SSE2 (or NEON
+ * through sse2neon), using the same operations as the scalar code that handles the remainder.
+ * Gathered vectors are transposed to one register per axis so that no horizontal operations are
+ * needed. The callbacks return the vector for an index in the span of processed elements, which
+ * makes the same kernel usable for indexed and contiguous data.
+ * \{ */
+
+#if BLI_HAVE_SSE2
+
+struct Float3SSE2 {
+  __m128 x;
+  __m128 y;
+  __m128 z;
+};
+
+BLI_INLINE Float3SSE2 load_float3_sse2(const float3 &a,
+                                       const float3 &b,
+                                       const float3 &c,
+                                       const float3 &d)
+{
+  return {_mm_setr_ps(a.x, b.x, c.x, d.x),
+          _mm_setr_ps(a.y, b.y, c.y, d.y),
+          _mm_setr_ps(a.z, b.z, c.z, d.z)};
+}
+
+template<typename GetFn> BLI_INLINE Float3SSE2 load_float3_sse2(const GetFn get_fn, const int i)
+{
+  return load_float3_sse2(get_fn(i), get_fn(i + 1), get_fn(i + 2), get_fn(i + 3));
+}
+
+BLI_INLINE __m128 dot_sse2(const Float3SSE2 &a, const Float3SSE2 &b)
+{
+  return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)),
+                    _mm_mul_ps(a.z, b.z));
+}
+
+BLI_INLINE Float3SSE2 broadcast_float3_sse2(const float3 &value)
+{
+  return {_mm_set1_ps(value.x), _mm_set1_ps(value.y), _mm_set1_ps(value.z)};
+}
+
+/**
+ * Spread four factors to match the memory layout of four consecutive #float3 values, as three
+ * registers of (0, 0, 0, 1), (1, 1, 2, 2) and (2, 3, 3, 3).
+ */
+BLI_INLINE void spread_factors_sse2(const __m128 factors, __m128 r_spread[3])
+{
+  r_spread[0] = _mm_shuffle_ps(factors, factors, _MM_SHUFFLE(1, 0, 0, 0));
+  r_spread[1] = _mm_shuffle_ps(factors, factors, _MM_SHUFFLE(2, 2, 1, 1));
+  r_spread[2] = _mm_shuffle_ps(factors, factors, _MM_SHUFFLE(3, 3, 3, 2));
+}
+
+#endif
+
+template<typename GetNormalFn>
+static void calc_front_face_factors(const float3 &view_normal,
+                                    const GetNormalFn get_normal,
+                                    const MutableSpan<float> factors)
+{
+  int i = 0;
+#if BLI_HAVE_SSE2
+  const Float3SSE2 view_normal_4 = broadcast_float3_sse2(view_normal);
+  for (; i + 4 <= factors.size(); i += 4) {
+    const __m128 dot = dot_sse2(view_normal_4, load_float3_sse2(get_normal, i));
+    const __m128 factor = _mm_mul_ps(_mm_loadu_ps(&factors[i]), _mm_max_ps(dot, _mm_setzero_ps()));
+    _mm_storeu_ps(&factors[i], factor);
+  }
+#endif
+  for (; i < factors.size(); i++) {
+    const float dot = math::dot(view_normal, get_normal(i));
+    factors[i] *= std::max(dot, 0.0f);
+  }
+}
+
+template<typename GetPositionFn>
+static void calc_sphere_distances(const float3 &location,
+                                  const GetPositionFn get_position,
+                                  const MutableSpan<float> r_distances)
+{
+  int i = 0;
+#if BLI_HAVE_SSE2
+  const Float3SSE2 location_4 = broadcast_float3_sse2(location);
+  for (; i + 4 <= r_distances.size(); i += 4) {
+    const Float3SSE2 position = load_float3_sse2(get_position, i);
+    const Float3SSE2 offset = {_mm_sub_ps(location_4.x, position.x),
+                               _mm_sub_ps(location_4.y, position.y),
+                               _mm_sub_ps(location_4.z, position.z)};
+    _mm_storeu_ps(&r_distances[i], _mm_sqrt_ps(dot_sse2(offset, offset)));
+  }
+#endif
+  for (; i < r_distances.size(); i++) {
+    r_distances[i] = math::distance(location, get_position(i));
+  }
+}
+
+/** Distances to the location after projecting positions on the plane, for the tube falloff. */
+template<typename GetPositionFn>
+static void calc_tube_distances(const float3 &location,
+                                const float4 &plane,
+                                const GetPositionFn get_position,
+                                const MutableSpan<float> r_distances)
+{
+  int i = 0;
+#if BLI_HAVE_SSE2
+  const Float3SSE2 location_4 = broadcast_float3_sse2(location);
+  const Float3SSE2 normal_4 = broadcast_float3_sse2(plane.xyz());
+  const __m128 plane_w = _mm_set1_ps(plane.w);
+  for (; i + 4 <= r_distances.size(); i += 4) {
+    const Float3SSE2 position = load_float3_sse2(get_position, i);
+    const __m128 side = _mm_add_ps(dot_sse2(position, normal_4), plane_w);
+    const Float3SSE2 offset = {
+        _mm_sub_ps(_mm_sub_ps(position.x, _mm_mul_ps(normal_4.x, side)), location_4.x),
+        _mm_sub_ps(_mm_sub_ps(position.y, _mm_mul_ps(normal_4.y, side)), location_4.y),
+        _mm_sub_ps(_mm_sub_ps(position.z, _mm_mul_ps(normal_4.z, side)), location_4.z)};
+    _mm_storeu_ps(&r_distances[i], _mm_sqrt_ps(dot_sse2(offset, offset)));
+  }
+#endif
+  for (; i < r_distances.size(); i++) {
+    float3 projected;
+    closest_to_plane_normalized_v3(projected, plane, get_position(i));
+    r_distances[i] = math::distance(projected, location);
+  }
+}
+
+/** \} */
+
 void calc_front_face(const float3 &view_normal,
                      const Span<float3> vert_normals,
                      const Span<int> verts,
@@ -6851,10 +6986,8 @@ void calc_front_face(const float3 &view_normal,
 {
   BLI_assert(verts.size() == factors.size());
 
-  for (const int i : verts.index_range()) {
-    const float dot = math::dot(view_normal, vert_normals[verts[i]]);
-    factors[i] *= std::max(dot, 0.0f);
-  }
+  calc_front_face_factors(
+      view_normal, [&](const int i) -> const float3 & { return vert_normals[verts[i]]; }, factors);
 }
 
 void calc_front_face(const float3 &view_normal,
@@ -6863,10 +6996,8 @@ void calc_front_face(const float3 &view_normal,
 {
   BLI_assert(normals.size() == factors.size());
 
-  for (const int i : normals.index_range()) {
-    const float dot = math::dot(view_normal, normals[i]);
-    factors[i] *= std::max(dot, 0.0f);
-  }
+  calc_front_face_factors(
+      view_normal, [&](const int i) -> const float3 & { return normals[i]; }, factors);
 }
 void calc_front_face(const float3 &view_normal,
                      const SubdivCCG &subdiv_ccg,
@@ -6984,16 +7115,17 @@ void calc_brush_distances(const SculptSession &ss,
     const float3 &view_normal = ss.cache ? ss.cache->view_normal : ss.filter_cache->view_normal;
     float4 test_plane;
     plane_from_point_normal_v3(test_plane, test_location, view_normal);
-    for (const int i : verts.index_range()) {
-      float3 projected;
-      closest_to_plane_normalized_v3(projected, test_plane, positions[verts[i]]);
-      r_distances[i] = math::distance(projected, test_location);
-    }
+    calc_tube_distances(
+        test_location,
+        test_plane,
+        [&](const int i) -> const float3 & { return positions[verts[i]]; },
+        r_distances);
   }
   else {
-    for (const int i : verts.index_range()) {
-      r_distances[i] = math::distance(test_location, positions[verts[i]]);
-    }
+    calc_sphere_distances(
+        test_location,
+        [&](const int i) -> const float3 & { return positions[verts[i]]; },
+        r_distances);
   }
 }
 
@@ -7010,16 +7142,15 @@ void calc_brush_distances(const SculptSession &ss,
     const float3 &view_normal = ss.cache ? ss.cache->view_normal : ss.filter_cache->view_normal;
     float4 test_plane;
     plane_from_point_normal_v3(test_plane, test_location, view_normal);
-    for (const int i : positions.index_range()) {
-      float3 projected;
-      closest_to_plane_normalized_v3(projected, test_plane, positions[i]);
-      r_distances[i] = math::distance(projected, test_location);
-    }
+    calc_tube_distances(
+        test_location,
+        test_plane,
+        [&](const int i) -> const float3 & { return positions[i]; },
+        r_distances);
   }
   else {
-    for (const int i : positions.index_range()) {
-      r_distances[i] = math::distance(test_location, positions[i]);
-    }
+    calc_sphere_distances(
+        test_location, [&](const int i) -> const float3 & { return positions[i]; }, r_distances);
   }
 }
 
@@ -7027,7 +7158,17 @@ void filter_distances_with_radius(const float radius,
                                   const Span<float> distances,
                                   const MutableSpan<float> factors)
 {
-  for (const int i : distances.index_range()) {
+  BLI_assert(distances.size() == factors.size());
+
+  int i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 radius_4 = _mm_set1_ps(radius);
+  for (; i + 4 <= distances.size(); i += 4) {
+    const __m128 outside = _mm_cmpgt_ps(_mm_loadu_ps(&distances[i]), radius_4);
+    _mm_storeu_ps(&factors[i], _mm_andnot_ps(outside, _mm_loadu_ps(&factors[i])));
+  }
+#endif
+  for (; i < distances.size(); i++) {
     if (distances[i] > radius) {
       factors[i] = 0.0f;
     }
@@ -7106,7 +7247,22 @@ void apply_hardness_to_distances(const float radius,
   const float threshold = hardness * radius;
   const float radius_inv = math::rcp(radius);
   const float hardness_inv_rcp = math::rcp(1.0f - hardness);
-  for (const int i : distances.index_range()) {
+  int i = 0;
+#if BLI_HAVE_SSE2
+  const __m128 threshold_4 = _mm_set1_ps(threshold);
+  const __m128 radius_4 = _mm_set1_ps(radius);
+  const __m128 radius_inv_4 = _mm_set1_ps(radius_inv);
+  const __m128 hardness_4 = _mm_set1_ps(hardness);
+  const __m128 hardness_inv_rcp_4 = _mm_set1_ps(hardness_inv_rcp);
+  for (; i + 4 <= distances.size(); i += 4) {
+    const __m128 distance = _mm_loadu_ps(&distances[i]);
+    const __m128 inside = _mm_cmplt_ps(distance, threshold_4);
+    const __m128 radius_factor = _mm_mul_ps(
+        _mm_sub_ps(_mm_mul_ps(distance, radius_inv_4), hardness_4), hardness_inv_rcp_4);
+    _mm_storeu_ps(&distances[i], _mm_andnot_ps(inside, _mm_mul_ps(radius_factor, radius_4)));
+  }
+#endif
+  for (; i < distances.size(); i++) {
     if (distances[i] < threshold) {
       distances[i] = 0.0f;
     }
@@ -7388,9 +7544,36 @@ void write_translations(const Sculpt &sd,
   apply_translations_to_shape_keys(object, verts, translations, positions_orig);
 }
 
+void mark_positions_update(bke::pbvh::Node &node, const Span<float3> translations)
+{
+  const auto is_moved = [](const float3 &translation) { return !math::is_zero(translation); };
+  const auto first = std::find_if(translations.begin(), translations.end(), is_moved);
+  if (first == translations.end()) {
+    BKE_pbvh_node_mark_positions_update(&node, IndexRange());
+    return;
+  }
+  const auto last = std::find_if(translations.rbegin(), translations.rend(), is_moved);
+  BKE_pbvh_node_mark_positions_update(
+      &node,
+      IndexRange::from_begin_end(first - translations.begin(), translations.rend() - last));
+}
+
 void scale_translations(const MutableSpan<float3> translations, const Span<float> factors)
 {
-  for (const int i : translations.index_range()) {
+  BLI_assert(translations.size() == factors.size());
+
+  int i = 0;
+#if BLI_HAVE_SSE2
+  for (; i + 4 <= translations.size(); i += 4) {
+    __m128 spread[3];
+    spread_factors_sse2(_mm_loadu_ps(&factors[i]), spread);
+    float *dst = &translations[i].x;
+    _mm_storeu_ps(dst + 0, _mm_mul_ps(_mm_loadu_ps(dst + 0), spread[0]));
+    _mm_storeu_ps(dst + 4, _mm_mul_ps(_mm_loadu_ps(dst + 4), spread[1]));
+    _mm_storeu_ps(dst + 8, _mm_mul_ps(_mm_loadu_ps(dst + 8), spread[2]));
+  }
+#endif
+  for (; i < translations.size(); i++) {
     translations[i] *= factors[i];
   }
 }
@@ -7430,7 +7613,22 @@ void translations_from_offset_and_factors(const float3 &offset,
 {
   BLI_assert(r_translations.size() == factors.size());
 
-  for (const int i : factors.index_range()) {
+  int i = 0;
+#if BLI_HAVE_SSE2
+  /* The offset repeated to match the layout of consecutive vectors, see #spread_factors_sse2. */
+  const __m128 offset_0 = _mm_setr_ps(offset.x, offset.y, offset.z, offset.x);
+  const __m128 offset_1 = _mm_setr_ps(offset.y, offset.z, offset.x, offset.y);
+  const __m128 offset_2 = _mm_setr_ps(offset.z, offset.x, offset.y, offset.z);
+  for (; i + 4 <= factors.size(); i += 4) {
+    __m128 spread[3];
+    spread_factors_sse2(_mm_loadu_ps(&factors[i]), spread);
+    float *dst = &r_translations[i].x;
+    _mm_storeu_ps(dst + 0, _mm_mul_ps(offset_0, spread[0]));
+    _mm_storeu_ps(dst + 4, _mm_mul_ps(offset_1, spread[1]));
+    _mm_storeu_ps(dst + 8, _mm_mul_ps(offset_2, spread[2]));
+  }
+#endif
+  for (; i < factors.size(); i++) {
     r_translations[i] = offset * factors[i];
   }
 }
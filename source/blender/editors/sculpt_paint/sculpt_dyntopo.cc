@@ -26,7 +26,12 @@
 #include "BKE_pointcache.h"
 #include "BKE_scene.hh"
 
+#include "BLI_array_utils.hh"
+#include "BLI_bounds.hh"
 #include "BLI_index_range.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_sort.hh"
+#include "BLI_task.hh"
 
 #include "DEG_depsgraph.hh"
 
@@ -71,6 +76,82 @@ void triangulate(BMesh *bm)
   }
 }
 
+/** Interleave the lower ten bits of the integer with two zero bits each. */
+static uint32_t morton_spread_bits(uint32_t x)
+{
+  x &= 0x3ff;
+  x = (x | (x << 16)) & 0x030000ff;
+  x = (x | (x << 8)) & 0x0300f00f;
+  x = (x | (x << 4)) & 0x030c30c3;
+  x = (x | (x << 2)) & 0x09249249;
+  return x;
+}
+
+/** Position along a Z-order curve through the bounds, with ten bits of precision per axis. */
+static uint32_t morton_code(const float3 &position, const Bounds<float3> &bounds)
+{
+  const float3 size = math::max(bounds.max - bounds.min, float3(FLT_EPSILON));
+  const float3 factor = (position - bounds.min) / size;
+  uint32_t code = 0;
+  for (const int axis : IndexRange(3)) {
+    const uint32_t cell = uint32_t(std::clamp(int(factor[axis] * 1024.0f), 0, 1023));
+    code |= morton_spread_bits(cell) << axis;
+  }
+  return code;
+}
+
+static Array<int> indices_sorted_by_code(const Span<uint32_t> codes)
+{
+  Array<int> indices(codes.size());
+  array_utils::fill_index_range<int>(indices);
+  parallel_sort(indices.begin(), indices.end(), [&](const int a, const int b) {
+    return codes[a] < codes[b] || (codes[a] == codes[b] && a < b);
+  });
+  return indices;
+}
+
+/**
+ * Store the vertices and faces in the order of a space filling curve through their positions.
+ * Dynamic topology operates on the #BMesh elements directly, and the elements of a
+ * #bke::pbvh::Tree leaf node are spatially close. This way they are mostly close in memory too,
+ * which makes brush loops over the nodes much more cache friendly than with the order of the
+ * original mesh.
+ *
+ * \return The original index of every vertex and face in the new order.
+ */
+static std::pair<Array<int>, Array<int>> sort_elems_spatially(BMesh &bm)
+{
+  Array<float3> positions(bm.totvert);
+  BM_mesh_vert_coords_get(&bm, positions);
+  const std::optional<Bounds<float3>> bounds = bounds::min_max(positions.as_span());
+  if (!bounds) {
+    return {};
+  }
+
+  Array<uint32_t> vert_codes(bm.totvert);
+  threading::parallel_for(positions.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      vert_codes[i] = morton_code(positions[i], *bounds);
+    }
+  });
+
+  BM_mesh_elem_table_ensure(&bm, BM_FACE);
+  const Span<BMFace *> faces(bm.ftable, bm.totface);
+  Array<uint32_t> face_codes(bm.totface);
+  threading::parallel_for(faces.index_range(), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      float3 center;
+      BM_face_calc_center_median(faces[i], center);
+      face_codes[i] = morton_code(center, *bounds);
+    }
+  });
+
+  Array<int> vert_order = indices_sorted_by_code(vert_codes);
+  Array<int> face_order = indices_sorted_by_code(face_codes);
+  BM_mesh_rebuild_in_order(&bm, vert_order, {}, face_order);
+  return {std::move(vert_order), std::move(face_order)};
+}
+
 void enable_ex(Main &bmain, Depsgraph &depsgraph, Object &ob)
 {
   SculptSession &ss = *ob.sculpt;
@@ -102,11 +183,16 @@ void enable_ex(Main &bmain, Depsgraph &depsgraph, Object &ob)
     BM_mesh_normals_update(ss.bm);
   }
 
+  /* Store nearby elements close together in memory. */
+  const auto [vert_order, face_order] = sort_elems_spatially(*ss.bm);
+
   /* Enable dynamic topology. */
   mesh->flag |= ME_SCULPT_DYNAMIC_TOPOLOGY;
 
-  /* Enable logging for undo/redo. */
-  ss.bm_log = BM_log_create(ss.bm);
+  /* Enable logging for undo/redo. The element IDs follow the original order, so that the order is
+   * restored when the #BMesh is written back to the mesh. */
+  ss.bm_log = vert_order.is_empty() ? BM_log_create(ss.bm) :
+                                      BM_log_create(ss.bm, vert_order, face_order);
 
   /* Update dependency graph, so modifiers that depend on dyntopo being enabled
    * are re-evaluated and the bke::pbvh::Tree is re-created. */
@@ -10,6 +10,7 @@
 
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.h"
+#include "BLI_simd.hh"
 #include "BLI_task.h"
 
 #include "DNA_brush_types.h"
@@ -22,8 +23,10 @@
 
 #include "bmesh.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <type_traits>
 
 namespace blender::ed::sculpt_paint::smooth {
 
@@ -37,6 +40,57 @@ template<typename T> T calc_average(const Span<T> positions, const Span<int> ind
   return result;
 }
 
+#if BLI_HAVE_SSE2
+
+/**
+ * Same as #calc_average for four vertices at once, with one register per axis and a lane per
+ * vertex. Lanes of vertices with fewer neighbors add zero, so the result is the same as for the
+ * scalar code. None of the vertices may be loose.
+ */
+static void calc_average_sse2(const Span<float3> positions,
+                              const Span<Vector<int>> vert_neighbors,
+                              const MutableSpan<float3> dst)
+{
+  BLI_assert(vert_neighbors.size() == 4 && dst.size() == 4);
+  const Span<int> neighbors[4] = {
+      vert_neighbors[0], vert_neighbors[1], vert_neighbors[2], vert_neighbors[3]};
+  const int neighbors_num = std::max({neighbors[0].size(),
+                                      neighbors[1].size(),
+                                      neighbors[2].size(),
+                                      neighbors[3].size()});
+  BLI_assert(std::none_of(neighbors, neighbors + 4, [](const Span<int> span) {
+    return span.is_empty();
+  }));
+
+  const __m128 factor = _mm_setr_ps(math::rcp(float(neighbors[0].size())),
+                                    math::rcp(float(neighbors[1].size())),
+                                    math::rcp(float(neighbors[2].size())),
+                                    math::rcp(float(neighbors[3].size())));
+  const float3 zero(0);
+  __m128 x = _mm_setzero_ps();
+  __m128 y = _mm_setzero_ps();
+  __m128 z = _mm_setzero_ps();
+  for (int i = 0; i < neighbors_num; i++) {
+    const float3 &a = i < neighbors[0].size() ? positions[neighbors[0][i]] : zero;
+    const float3 &b = i < neighbors[1].size() ? positions[neighbors[1][i]] : zero;
+    const float3 &c = i < neighbors[2].size() ? positions[neighbors[2][i]] : zero;
+    const float3 &d = i < neighbors[3].size() ? positions[neighbors[3][i]] : zero;
+    x = _mm_add_ps(x, _mm_mul_ps(_mm_setr_ps(a.x, b.x, c.x, d.x), factor));
+    y = _mm_add_ps(y, _mm_mul_ps(_mm_setr_ps(a.y, b.y, c.y, d.y), factor));
+    z = _mm_add_ps(z, _mm_mul_ps(_mm_setr_ps(a.z, b.z, c.z, d.z), factor));
+  }
+
+  alignas(16) float result[3][4];
+  _mm_store_ps(result[0], x);
+  _mm_store_ps(result[1], y);
+  _mm_store_ps(result[2], z);
+  for (const int i : dst.index_range()) {
+    dst[i] = float3(result[0][i], result[1][i], result[2][i]);
+  }
+}
+
+#endif
+
 template<typename T>
 void neighbor_data_average_mesh_check_loose(const Span<T> src,
                                             const Span<int> verts,
@@ -46,7 +100,7 @@ void neighbor_data_average_mesh_check_loose(const Span<T> src,
   BLI_assert(verts.size() == dst.size());
   BLI_assert(vert_neighbors.size() == dst.size());
 
-  for (const int i : vert_neighbors.index_range()) {
+  const auto average_vert = [&](const int i) {
     const Span<int> neighbors = vert_neighbors[i];
     if (neighbors.is_empty()) {
       dst[i] = src[verts[i]];
@@ -54,6 +108,30 @@ void neighbor_data_average_mesh_check_loose(const Span<T> src,
     else {
       dst[i] = calc_average(src, neighbors);
     }
+  };
+
+  int i = 0;
+#if BLI_HAVE_SSE2
+  /* Positions for the smooth brush. Loose vertices are rare, so groups containing them just use
+   * the scalar code. */
+  if constexpr (std::is_same_v<T, float3>) {
+    for (; i + 4 <= vert_neighbors.size(); i += 4) {
+      const IndexRange group(i, 4);
+      if (std::any_of(group.begin(), group.end(), [&](const int j) {
+            return vert_neighbors[j].is_empty();
+          }))
+      {
+        for (const int j : group) {
+          average_vert(j);
+        }
+        continue;
+      }
+      calc_average_sse2(src, vert_neighbors.slice(group), dst.slice(group));
+    }
+  }
+#endif
+  for (; i < vert_neighbors.size(); i++) {
+    average_vert(i);
   }
 }
 
@@ -73,7 +151,15 @@ void neighbor_data_average_mesh(const Span<T> src,
 {
   BLI_assert(vert_neighbors.size() == dst.size());
 
-  for (const int i : vert_neighbors.index_range()) {
+  int i = 0;
+#if BLI_HAVE_SSE2
+  if constexpr (std::is_same_v<T, float3>) {
+    for (; i + 4 <= vert_neighbors.size(); i += 4) {
+      calc_average_sse2(src, vert_neighbors.slice(i, 4), dst.slice(i, 4));
+    }
+  }
+#endif
+  for (; i < vert_neighbors.size(); i++) {
     BLI_assert(!vert_neighbors[i].is_empty());
     dst[i] = calc_average(src, vert_neighbors[i]);
   }
@@ -996,6 +996,10 @@ void uiTemplateImageSettings(uiLayout *layout, PointerRNA *imfptr, bool color_ma
     uiItemR(col, imfptr, "exr_codec", UI_ITEM_NONE, nullptr, ICON_NONE);
   }
 
+  if (imf->imtype == R_IMF_IMTYPE_MULTILAYER) {
+    uiItemR(col, imfptr, "use_exr_multipart", UI_ITEM_NONE, nullptr, ICON_NONE);
+  }
+
   if (is_render_out && ELEM(imf->imtype, R_IMF_IMTYPE_OPENEXR, R_IMF_IMTYPE_MULTILAYER)) {
     uiItemR(col, imfptr, "use_preview", UI_ITEM_NONE, nullptr, ICON_NONE);
   }
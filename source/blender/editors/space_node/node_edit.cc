@@ -260,6 +260,10 @@ static void compo_initjob(void *cjv)
     cj->re = RE_NewInteractiveCompositorRender(scene);
     RE_system_gpu_context_ensure(cj->re);
   }
+  else if (USER_EXPERIMENTAL_TEST(&U, use_realtime_compositor_cpu)) {
+    /* The realtime compositor needs a render to evaluate on the CPU, but no GPU context. */
+    cj->re = RE_NewInteractiveCompositorRender(scene);
+  }
 }
 
 /* Called before redraw notifiers, it moves finished previews over. */
@@ -89,10 +89,17 @@ void ED_sequencer_special_preview_clear()
   sequencer_special_update_set(nullptr);
 }
 
-ImBuf *sequencer_ibuf_get(const bContext *C,
-                          int timeline_frame,
-                          int frame_ofs,
-                          const char *viewname)
+/**
+ * \param use_display_space: Get an 8-bit image already transformed to the display space when
+ * the sequencer caches such images, see #SEQ_render_give_display_ibuf.
+ * \param r_is_display_space: Set to true when the returned image is in display space.
+ */
+static ImBuf *sequencer_ibuf_get_ex(const bContext *C,
+                                    int timeline_frame,
+                                    int frame_ofs,
+                                    const char *viewname,
+                                    const bool use_display_space,
+                                    bool *r_is_display_space)
 {
   Main *bmain = CTX_data_main(C);
   ARegion *region = CTX_wm_region(C);
@@ -143,12 +150,21 @@ ImBuf *sequencer_ibuf_get(const bContext *C,
     GPU_framebuffer_restore();
   }
 
+  *r_is_display_space = false;
   if (ED_sequencer_special_preview_get()) {
     ibuf = SEQ_render_give_ibuf_direct(
         &context, timeline_frame + frame_ofs, ED_sequencer_special_preview_get());
   }
   else {
-    ibuf = SEQ_render_give_ibuf(&context, timeline_frame + frame_ofs, sseq->chanshown);
+    ibuf = use_display_space ? SEQ_render_give_display_ibuf(
+                                   &context, timeline_frame + frame_ofs, sseq->chanshown) :
+                               nullptr;
+    if (ibuf) {
+      *r_is_display_space = true;
+    }
+    else {
+      ibuf = SEQ_render_give_ibuf(&context, timeline_frame + frame_ofs, sseq->chanshown);
+    }
   }
 
   if (viewport) {
@@ -167,6 +183,15 @@ ImBuf *sequencer_ibuf_get(const bContext *C,
   return ibuf;
 }
 
+ImBuf *sequencer_ibuf_get(const bContext *C,
+                          int timeline_frame,
+                          int frame_ofs,
+                          const char *viewname)
+{
+  bool is_display_space;
+  return sequencer_ibuf_get_ex(C, timeline_frame, frame_ofs, viewname, false, &is_display_space);
+}
+
 static ImBuf *sequencer_make_scope(Scene *scene,
                                    ImBuf *ibuf,
                                    ImBuf *(*make_scope_fn)(const ImBuf *ibuf))
@@ -302,6 +327,7 @@ static void seq_prefetch_wm_notify(const bContext *C, Scene *scene)
 
 static void *sequencer_OCIO_transform_ibuf(const bContext *C,
                                            ImBuf *ibuf,
+                                           const bool is_display_space,
                                            bool *r_glsl_used,
                                            eGPUTextureFormat *r_format,
                                            eGPUDataFormat *r_data,
@@ -317,6 +343,11 @@ static void *sequencer_OCIO_transform_ibuf(const bContext *C,
   *r_format = GPU_RGBA8;
   *r_data = GPU_DATA_UBYTE;
 
+  /* The sequencer already applied the display transform, upload the pixels as they are. */
+  if (is_display_space) {
+    return ibuf->byte_buffer.data;
+  }
+
   /* Fallback to CPU based color space conversion. */
   if (force_fallback) {
     *r_glsl_used = false;
@@ -432,6 +463,7 @@ static void sequencer_draw_display_buffer(const bContext *C,
                                           ARegion *region,
                                           SpaceSeq *sseq,
                                           ImBuf *ibuf,
+                                          const bool is_display_space,
                                           bool draw_overlay,
                                           bool draw_backdrop)
 {
@@ -452,7 +484,7 @@ static void sequencer_draw_display_buffer(const bContext *C,
       imm_format, "texCoord", GPU_COMP_F32, 2, GPU_FETCH_FLOAT);
 
   void *display_buffer = sequencer_OCIO_transform_ibuf(
-      C, ibuf, &glsl_used, &format, &data, &buffer_cache_handle);
+      C, ibuf, is_display_space, &glsl_used, &format, &data, &buffer_cache_handle);
 
   if (draw_backdrop) {
     GPU_matrix_push();
@@ -1103,8 +1135,15 @@ void sequencer_draw_preview(const bContext *C,
     preview_frame = sequencer_draw_get_transform_preview_frame(scene);
   }
 
-  /* Get image. */
-  ibuf = sequencer_ibuf_get(C, preview_frame, offset, names[sseq->multiview_eye]);
+  /* Get image. Scopes and sampling need the original image, only the image preview can use
+   * display space images. */
+  bool is_display_space = false;
+  ibuf = sequencer_ibuf_get_ex(C,
+                               preview_frame,
+                               offset,
+                               names[sseq->multiview_eye],
+                               sseq->mainb == SEQ_DRAW_IMG_IMBUF && sseq->zebra == 0,
+                               &is_display_space);
 
   /* Setup off-screen buffers. */
   GPUViewport *viewport = WM_draw_region_get_viewport(region);
@@ -1142,7 +1181,8 @@ void sequencer_draw_preview(const bContext *C,
     }
     else {
       /* Draw image. */
-      sequencer_draw_display_buffer(C, scene, region, sseq, ibuf, draw_overlay, draw_backdrop);
+      sequencer_draw_display_buffer(
+          C, scene, region, sseq, ibuf, is_display_space, draw_overlay, draw_backdrop);
     }
 
     /* Draw metadata. */
@@ -1677,10 +1677,10 @@ static bool draw_cache_view_iter_fn(void *userdata,
 
   bool dev_ui = (U.flag & USER_DEVELOPER_UI);
 
-  if ((cache_type & SEQ_CACHE_STORE_FINAL_OUT) &&
+  if ((cache_type & (SEQ_CACHE_STORE_FINAL_OUT | SEQ_CACHE_STORE_DISPLAY)) &&
       (drawdata->cache_flag & SEQ_CACHE_SHOW_FINAL_OUT))
   {
-    /* Draw the final cache on top of the timeline */
+    /* Draw the final cache on top of the timeline, display space images are final frames too. */
     stripe_top = v2d->cur.ymax - (UI_TIME_SCRUB_MARGIN_Y / UI_view2d_scale_get_y(v2d));
     stripe_bot = stripe_top - (UI_TIME_CACHE_MARGIN_Y / UI_view2d_scale_get_y(v2d));
     col = col_final;
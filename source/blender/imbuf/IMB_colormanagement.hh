@@ -285,6 +285,15 @@ unsigned char *IMB_display_buffer_acquire(ImBuf *ibuf,
  * Same as #IMB_display_buffer_acquire but gets view and display settings from context.
  */
 unsigned char *IMB_display_buffer_acquire_ctx(const bContext *C, ImBuf *ibuf, void **cache_handle);
+/**
+ * Compute the display buffer for given image buffer into \a display_buffer, which has room for
+ * `ibuf->x * ibuf->y` RGBA pixels. Unlike #IMB_display_buffer_acquire, the result is not stored in
+ * the display buffer cache of the image buffer, so the caller fully owns it.
+ */
+void IMB_display_buffer_transform_ibuf(ImBuf *ibuf,
+                                       unsigned char *display_buffer,
+                                       const ColorManagedViewSettings *view_settings,
+                                       const ColorManagedDisplaySettings *display_settings);
 
 void IMB_display_buffer_transform_apply(unsigned char *display_buffer,
                                         float *linear_buffer,
@@ -357,6 +357,13 @@ ImBuf *IMB_anim_absolute(ImBufAnim *anim,
                          IMB_Timecode_Type tc /* = 1 = IMB_TC_RECORD_RUN */,
                          IMB_Proxy_Size preview_size /* = 0 = IMB_PROXY_NONE */);
 
+/**
+ * Decode up to \a max_frames frames following sequentially requested frames in a background
+ * task, so they are ready by the time they are requested. Decoding is serialized with the
+ * background task internally. Zero disables read-ahead and frees the frames decoded so far.
+ */
+void IMB_anim_set_read_ahead(ImBufAnim *anim, int max_frames);
+
 /**
  * fetches a define preview-frame, usually half way into the movie.
  */
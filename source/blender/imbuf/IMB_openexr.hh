@@ -19,6 +19,7 @@
 #define EXR_PASS_MAXCHAN 24
 
 struct StampData;
+struct rcti;
 
 void *IMB_exr_get_handle();
 void *IMB_exr_get_handle_name(const char *name);
@@ -44,13 +45,17 @@ bool IMB_exr_begin_read(
     void *handle, const char *filepath, int *width, int *height, bool parse_channels);
 /**
  * Used for output files (from #RenderResult) (single and multi-layer, single and multi-view).
+ *
+ * \param multipart: Store the channels of each layer and view in a separate part, so that
+ * reading a single layer does not need to decompress the others.
  */
 bool IMB_exr_begin_write(void *handle,
                          const char *filepath,
                          int width,
                          int height,
                          int compress,
-                         const StampData *stamp);
+                         const StampData *stamp,
+                         bool multipart);
 /**
  * Only used for writing temp. render results (not image files)
  * (FSA and Save Buffers).
@@ -75,6 +80,13 @@ float *IMB_exr_channel_rect(void *handle,
                             const char *view);
 
 void IMB_exr_read_channels(void *handle);
+/**
+ * Read only a region of the image into the channels, with coordinates in pixels from the bottom
+ * left corner and exclusive maximum. Channel buffers and strides are relative to the region, and
+ * channels without a buffer are skipped, as are file parts without any channel to read. Only the
+ * scan-lines overlapping the region are decompressed.
+ */
+void IMB_exr_read_channels_region(void *handle, const rcti *region);
 void IMB_exr_write_channels(void *handle);
 /**
  * Temporary function, used for FSA and Save Buffers.
@@ -23,6 +23,8 @@ struct SwsContext;
 
 struct IDProperty;
 struct ImBufAnimIndex;
+struct ImBufAnimReadAhead;
+struct ImBufAnimSeekIndexBuilder;
 
 struct ImBufAnim {
   enum class State { Uninitialized, Failed, Valid };
@@ -59,6 +61,10 @@ struct ImBufAnim {
   AVPacket *cur_packet;
 
   bool seek_before_decode;
+
+  /* Frames decoded in the background ahead of sequential requests, see #IMB_anim_set_read_ahead.
+   * Null when read-ahead is disabled. */
+  ImBufAnimReadAhead *read_ahead;
 #endif
 
   char index_dir[768];
@@ -70,6 +76,11 @@ struct ImBufAnim {
   ImBufAnimIndex *record_run;
   ImBufAnimIndex *no_gaps;
 
+  /* Key frames used for seeking without time-code index, see #IMB_anim_open_seek_index. */
+  ImBufAnimIndex *seek_index;
+  ImBufAnimSeekIndexBuilder *seek_index_builder;
+  bool seek_index_tried;
+
   char colorspace[64];
   char suffix[64]; /* MAX_NAME - multiview */
 
@@ -112,3 +112,15 @@ void colorspace_set_default_role(char *colorspace, int size, int role);
 
 void colormanage_imbuf_set_default_spaces(ImBuf *ibuf);
 void colormanage_imbuf_make_linear(ImBuf *ibuf, const char *from_colorspace);
+
+/* ** Pixel conversion kernels ** */
+
+/**
+ * Convert between straight alpha RGBA byte and float pixels, with results identical to
+ * #rgba_uchar_to_float and #rgba_float_to_uchar. Several pixels are converted at once when SSE2
+ * (or its NEON emulation) is available.
+ */
+void colormanage_rgba_uchar_to_float(float *dst, const uchar *src, int64_t pixels_num);
+void colormanage_rgba_float_to_uchar(uchar *dst, const float *src, int64_t pixels_num);
+/** Premultiply RGBA float pixels in place, identical to #straight_to_premul_v4. */
+void colormanage_straight_to_premul_rgba(float *buffer, int64_t pixels_num);
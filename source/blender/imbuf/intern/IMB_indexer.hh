@@ -90,6 +90,11 @@ uint64_t IMB_indexer_get_seek_pos_pts(ImBufAnimIndex *idx, int frame_index);
 uint64_t IMB_indexer_get_seek_pos_dts(ImBufAnimIndex *idx, int frame_index);
 
 int IMB_indexer_get_frame_index(ImBufAnimIndex *idx, int frameno);
+/**
+ * Get the index of the last entry with a PTS not after the given one, which is the frame shown at
+ * that time.
+ */
+int IMB_indexer_get_frame_index_by_pts(ImBufAnimIndex *idx, int64_t pts);
 uint64_t IMB_indexer_get_pts(ImBufAnimIndex *idx, int frame_index);
 int IMB_indexer_get_duration(ImBufAnimIndex *idx);
 
@@ -101,6 +106,12 @@ void IMB_free_indices(ImBufAnim *anim);
 
 ImBufAnim *IMB_anim_open_proxy(ImBufAnim *anim, IMB_Proxy_Size preview_size);
 ImBufAnimIndex *IMB_anim_open_index(ImBufAnim *anim, IMB_Timecode_Type tc);
+/**
+ * Get the index with the key frame of every frame, used for seeking when no time-code index is
+ * used. The first call starts building the index in the background when it does not exist yet,
+ * null is returned until it is done.
+ */
+ImBufAnimIndex *IMB_anim_open_seek_index(ImBufAnim *anim);
 
 int IMB_proxy_size_to_array_index(IMB_Proxy_Size pr_size);
 int IMB_timecode_to_array_index(IMB_Timecode_Type tc);
@@ -11,6 +11,7 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <mutex>
 #include <sys/types.h>
 #ifndef _WIN32
 #  include <dirent.h>
@@ -18,8 +19,10 @@
 #  include <io.h>
 #endif
 
+#include "BLI_map.hh"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -55,6 +58,8 @@ extern "C" {
 
 #ifdef WITH_FFMPEG
 static void free_anim_ffmpeg(ImBufAnim *anim);
+static void read_ahead_free(ImBufAnim *anim);
+static void read_ahead_reset(ImBufAnim *anim);
 #endif
 
 void IMB_free_anim(ImBufAnim *anim)
@@ -65,6 +70,7 @@ void IMB_free_anim(ImBufAnim *anim)
   }
 
 #ifdef WITH_FFMPEG
+  read_ahead_free(anim);
   free_anim_ffmpeg(anim);
 #endif
   IMB_free_indices(anim);
@@ -88,6 +94,10 @@ void IMB_close_anim_proxies(ImBufAnim *anim)
     return;
   }
 
+#ifdef WITH_FFMPEG
+  /* The background decoding uses the indices. */
+  read_ahead_reset(anim);
+#endif
   IMB_free_indices(anim);
 }
 
@@ -997,21 +1007,33 @@ static int ffmpeg_seek_to_key_frame(ImBufAnim *anim,
   int64_t seek_pos;
   int ret;
 
+  /* Without time-code index, use the key frames of the seek index. Positions are still mapped to
+   * timestamps the same way, the index is only used to find the key frame to decode from. */
+  ImBufAnimIndex *index = tc_index;
+  int new_frame_index = 0;
+  int old_frame_index = 0;
   if (tc_index) {
-    /* We can use timestamps generated from our indexer to seek. */
-    int new_frame_index = IMB_indexer_get_frame_index(tc_index, position);
-    int old_frame_index = IMB_indexer_get_frame_index(tc_index, anim->cur_position);
+    new_frame_index = IMB_indexer_get_frame_index(tc_index, position);
+    old_frame_index = IMB_indexer_get_frame_index(tc_index, anim->cur_position);
+  }
+  else if ((index = IMB_anim_open_seek_index(anim))) {
+    new_frame_index = IMB_indexer_get_frame_index_by_pts(index, pts_to_search);
+    old_frame_index = IMB_indexer_get_frame_index_by_pts(
+        index, ffmpeg_get_pts_to_search(anim, nullptr, anim->cur_position));
+  }
 
-    if (IMB_indexer_can_scan(tc_index, old_frame_index, new_frame_index)) {
+  if (index) {
+    /* We can use timestamps generated from our indexer to seek. */
+    if (IMB_indexer_can_scan(index, old_frame_index, new_frame_index)) {
       /* No need to seek, return early. */
       return 0;
     }
     uint64_t pts;
     uint64_t dts;
 
-    seek_pos = IMB_indexer_get_seek_pos(tc_index, new_frame_index);
-    pts = IMB_indexer_get_seek_pos_pts(tc_index, new_frame_index);
-    dts = IMB_indexer_get_seek_pos_dts(tc_index, new_frame_index);
+    seek_pos = IMB_indexer_get_seek_pos(index, new_frame_index);
+    pts = IMB_indexer_get_seek_pos_pts(index, new_frame_index);
+    dts = IMB_indexer_get_seek_pos_dts(index, new_frame_index);
 
     anim->cur_key_frame_pts = timestamp_from_pts_or_dts(pts, dts);
 
@@ -1177,6 +1199,154 @@ static void free_anim_ffmpeg(ImBufAnim *anim)
   anim->duration_in_frames = 0;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Read-Ahead
+ *
+ * During playback frames are requested in order, so the frames following the last requested one
+ * are decoded by a background task while the caller processes the current frame. The decoder is
+ * not thread safe, so all decoding happens while holding the mutex. The task decodes a single
+ * frame and pushes a new task for the next one, giving requests a chance to take the mutex in
+ * between.
+ * \{ */
+
+struct ImBufAnimReadAhead {
+  std::mutex mutex;
+  TaskPool *task_pool = nullptr;
+
+  /** Maximum number of decoded frames waiting to be requested. */
+  int max_frames = 0;
+  /** Time-code the frames are decoded with, frames are discarded when it changes. */
+  IMB_Timecode_Type tc = IMB_TC_NONE;
+  /** Position of the last requested frame and of the next frame to decode. */
+  int last_position = -1;
+  int next_position = -1;
+  blender::Map<int, ImBuf *> frames;
+
+  bool is_task_scheduled = false;
+  bool stop = false;
+};
+
+static void read_ahead_clear_frames(ImBufAnimReadAhead &read_ahead)
+{
+  for (ImBuf *ibuf : read_ahead.frames.values()) {
+    IMB_freeImBuf(ibuf);
+  }
+  read_ahead.frames.clear();
+}
+
+static bool read_ahead_needs_decode(const ImBufAnim *anim, const ImBufAnimReadAhead &read_ahead)
+{
+  return !read_ahead.stop && read_ahead.frames.size() < read_ahead.max_frames &&
+         read_ahead.next_position >= 0 && read_ahead.next_position < anim->duration_in_frames;
+}
+
+static void read_ahead_task(TaskPool *__restrict pool, void * /*taskdata*/);
+
+/* Must be called while holding the mutex. */
+static void read_ahead_schedule(ImBufAnim *anim)
+{
+  ImBufAnimReadAhead &read_ahead = *anim->read_ahead;
+  if (read_ahead.is_task_scheduled || !read_ahead_needs_decode(anim, read_ahead)) {
+    return;
+  }
+  read_ahead.is_task_scheduled = true;
+  BLI_task_pool_push(read_ahead.task_pool, read_ahead_task, nullptr, false, nullptr);
+}
+
+static void read_ahead_task(TaskPool *__restrict pool, void * /*taskdata*/)
+{
+  ImBufAnim *anim = static_cast<ImBufAnim *>(BLI_task_pool_user_data(pool));
+  ImBufAnimReadAhead &read_ahead = *anim->read_ahead;
+
+  std::lock_guard lock(read_ahead.mutex);
+  read_ahead.is_task_scheduled = false;
+  if (!read_ahead_needs_decode(anim, read_ahead)) {
+    return;
+  }
+
+  const int position = read_ahead.next_position++;
+  ImBuf *ibuf = ffmpeg_fetchibuf(anim, position, read_ahead.tc);
+  if (ibuf) {
+    read_ahead.frames.add_overwrite(position, ibuf);
+  }
+  read_ahead_schedule(anim);
+}
+
+/* Same as #ffmpeg_fetchibuf, but returns frames decoded in the background when available and
+ * schedules decoding of the following frames for sequential requests. */
+static ImBuf *ffmpeg_fetchibuf_read_ahead(ImBufAnim *anim, int position, IMB_Timecode_Type tc)
+{
+  ImBufAnimReadAhead &read_ahead = *anim->read_ahead;
+  std::lock_guard lock(read_ahead.mutex);
+
+  if (read_ahead.tc != tc) {
+    read_ahead_clear_frames(read_ahead);
+    read_ahead.tc = tc;
+    read_ahead.next_position = -1;
+  }
+
+  ImBuf *ibuf = read_ahead.frames.pop_default(position, nullptr);
+
+  /* Frames before the requested one are not going to be requested when playing forward. Frames
+   * after it stay valid as long as they directly follow it. */
+  read_ahead.frames.remove_if([&](const auto item) {
+    if (item.key < position || (ibuf == nullptr && item.key > position)) {
+      IMB_freeImBuf(item.value);
+      return true;
+    }
+    return false;
+  });
+
+  if (ibuf == nullptr) {
+    ibuf = ffmpeg_fetchibuf(anim, position, tc);
+    read_ahead.next_position = position + 1;
+  }
+
+  /* Only read ahead during sequential playback, random access would waste the decoded frames. */
+  const bool is_sequential = position == read_ahead.last_position + 1;
+  read_ahead.last_position = position;
+  if (is_sequential) {
+    read_ahead_schedule(anim);
+  }
+
+  return ibuf;
+}
+
+/* Wait for the background task to finish and free all decoded frames. */
+static void read_ahead_reset(ImBufAnim *anim)
+{
+  if (anim->read_ahead == nullptr) {
+    return;
+  }
+
+  ImBufAnimReadAhead &read_ahead = *anim->read_ahead;
+  {
+    std::lock_guard lock(read_ahead.mutex);
+    read_ahead.stop = true;
+  }
+  BLI_task_pool_work_and_wait(read_ahead.task_pool);
+
+  std::lock_guard lock(read_ahead.mutex);
+  read_ahead_clear_frames(read_ahead);
+  read_ahead.stop = false;
+  read_ahead.last_position = -1;
+  read_ahead.next_position = -1;
+}
+
+static void read_ahead_free(ImBufAnim *anim)
+{
+  if (anim->read_ahead == nullptr) {
+    return;
+  }
+
+  read_ahead_reset(anim);
+  BLI_task_pool_free(anim->read_ahead->task_pool);
+  MEM_delete(anim->read_ahead);
+  anim->read_ahead = nullptr;
+}
+
+/** \} */
+
 #endif
 
 /**
@@ -1270,6 +1440,9 @@ ImBuf *IMB_anim_absolute(ImBufAnim *anim,
 
     if (proxy) {
       position = IMB_anim_index_get_frame_index(anim, tc, position);
+#ifdef WITH_FFMPEG
+      IMB_anim_set_read_ahead(proxy, anim->read_ahead ? anim->read_ahead->max_frames : 0);
+#endif
 
       return IMB_anim_absolute(proxy, position, IMB_TC_NONE, IMB_PROXY_NONE);
     }
@@ -1277,19 +1450,49 @@ ImBuf *IMB_anim_absolute(ImBufAnim *anim,
 
 #ifdef WITH_FFMPEG
   if (anim->state == ImBufAnim::State::Valid) {
-    ibuf = ffmpeg_fetchibuf(anim, position, tc);
-    if (ibuf) {
-      anim->cur_position = position;
+    if (anim->read_ahead) {
+      /* The decoder position is managed by the read-ahead, which may already be past the
+       * requested frame. */
+      ibuf = ffmpeg_fetchibuf_read_ahead(anim, position, tc);
+    }
+    else {
+      ibuf = ffmpeg_fetchibuf(anim, position, tc);
+      if (ibuf) {
+        anim->cur_position = position;
+      }
     }
   }
 #endif
 
   if (ibuf) {
-    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, anim->cur_position + 1);
+    SNPRINTF(ibuf->filepath, "%s.%04d", anim->filepath, position + 1);
   }
   return ibuf;
 }
 
+void IMB_anim_set_read_ahead(ImBufAnim *anim, const int max_frames)
+{
+#ifdef WITH_FFMPEG
+  if (anim == nullptr) {
+    return;
+  }
+  if (max_frames <= 0) {
+    read_ahead_free(anim);
+    return;
+  }
+
+  if (anim->read_ahead == nullptr) {
+    anim->read_ahead = MEM_new<ImBufAnimReadAhead>(__func__);
+    anim->read_ahead->task_pool = BLI_task_pool_create_background(anim, TASK_PRIORITY_LOW);
+  }
+
+  std::lock_guard lock(anim->read_ahead->mutex);
+  anim->read_ahead->max_frames = max_frames;
+#else
+  UNUSED_VARS(anim, max_frames);
+#endif
+}
+
 /***/
 
 int IMB_anim_get_duration(ImBufAnim *anim, IMB_Timecode_Type tc)
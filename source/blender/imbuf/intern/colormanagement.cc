@@ -11,6 +11,8 @@
 
 #include <cmath>
 #include <cstring>
+#include <memory>
+#include <string>
 
 #include "DNA_color_types.h"
 #include "DNA_image_types.h"
@@ -29,9 +31,12 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_hash.hh"
+#include "BLI_map.hh"
 #include "BLI_math_color.h"
 #include "BLI_math_color.hh"
 #include "BLI_rect.h"
+#include "BLI_simd.hh"
 #include "BLI_string.h"
 #include "BLI_task.h"
 #include "BLI_task.hh"
@@ -97,9 +102,10 @@ float imbuf_aces_to_scene_linear[3][3] = {{0.0f}};
 static pthread_mutex_t processor_lock = BLI_MUTEX_INITIALIZER;
 
 struct ColormanageProcessor {
-  OCIO_ConstCPUProcessorRcPtr *cpu_processor;
-  CurveMapping *curve_mapping;
-  bool is_data_result;
+  /* Shared with the processor cache, see #cpu_processor_cache_lookup. */
+  std::shared_ptr<OCIO_ConstCPUProcessorRcPtr> cpu_processor;
+  CurveMapping *curve_mapping = nullptr;
+  bool is_data_result = false;
 };
 
 static struct global_gpu_state {
@@ -122,6 +128,201 @@ static struct global_color_picking_state {
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name CPU Processor Cache
+ * \{ */
+
+/* Cache of the CPU processors used by #ColormanageProcessor, so that the same display or color
+ * space transform is not created from scratch every time, which is expensive for configurations
+ * with large lookup tables. Processors are shared with the pixel processors using them, so
+ * evicting an entry does not invalidate processors which are still in use. */
+
+struct CPUProcessorCacheKey {
+  std::string look;
+  std::string view_transform;
+  std::string display;
+  std::string from_colorspace;
+  std::string to_colorspace;
+  float exposure = 0.0f;
+  float gamma = 1.0f;
+  float temperature = 0.0f;
+  float tint = 0.0f;
+  bool use_white_balance = false;
+
+  uint64_t hash() const
+  {
+    return blender::get_default_hash(
+        blender::get_default_hash(look, view_transform, display, from_colorspace),
+        blender::get_default_hash(to_colorspace, exposure, gamma, temperature),
+        blender::get_default_hash(tint, use_white_balance));
+  }
+
+  friend bool operator==(const CPUProcessorCacheKey &a, const CPUProcessorCacheKey &b)
+  {
+    return a.look == b.look && a.view_transform == b.view_transform && a.display == b.display &&
+           a.from_colorspace == b.from_colorspace && a.to_colorspace == b.to_colorspace &&
+           a.exposure == b.exposure && a.gamma == b.gamma && a.temperature == b.temperature &&
+           a.tint == b.tint && a.use_white_balance == b.use_white_balance;
+  }
+};
+
+struct CPUProcessorCacheItem {
+  std::shared_ptr<OCIO_ConstCPUProcessorRcPtr> cpu_processor;
+  uint64_t last_used;
+};
+
+/* Enough for the views, looks and color space conversions used at the same time, while keeping
+ * the memory of lookup tables bounded when tweaking exposure or gamma interactively. */
+#define CPU_PROCESSOR_CACHE_MAX_ITEMS 32
+
+static struct CPUProcessorCache {
+  blender::Map<CPUProcessorCacheKey, CPUProcessorCacheItem> items;
+  uint64_t use_counter = 0;
+} *cpu_processor_cache = nullptr;
+
+/**
+ * Get the CPU processor for the given key from the cache, or create it with the given function
+ * and add it to the cache. Returns an empty pointer when the processor could not be created.
+ */
+template<typename CreateFn>
+static std::shared_ptr<OCIO_ConstCPUProcessorRcPtr> cpu_processor_cache_lookup(
+    const CPUProcessorCacheKey &key, const CreateFn &create_fn)
+{
+  BLI_mutex_lock(&processor_lock);
+
+  if (cpu_processor_cache == nullptr) {
+    cpu_processor_cache = MEM_new<CPUProcessorCache>(__func__);
+  }
+
+  if (CPUProcessorCacheItem *item = cpu_processor_cache->items.lookup_ptr(key)) {
+    item->last_used = ++cpu_processor_cache->use_counter;
+    std::shared_ptr<OCIO_ConstCPUProcessorRcPtr> cpu_processor = item->cpu_processor;
+    BLI_mutex_unlock(&processor_lock);
+    return cpu_processor;
+  }
+
+  /* Create the processor while holding the lock, so the same processor is not created several
+   * times when many threads request it at once. */
+  OCIO_ConstCPUProcessorRcPtr *new_cpu_processor = create_fn();
+  if (new_cpu_processor == nullptr) {
+    BLI_mutex_unlock(&processor_lock);
+    return {};
+  }
+
+  if (cpu_processor_cache->items.size() >= CPU_PROCESSOR_CACHE_MAX_ITEMS) {
+    const CPUProcessorCacheKey *least_recently_used = nullptr;
+    uint64_t least_recently_used_time = UINT64_MAX;
+    for (const auto item : cpu_processor_cache->items.items()) {
+      if (item.value.last_used < least_recently_used_time) {
+        least_recently_used = &item.key;
+        least_recently_used_time = item.value.last_used;
+      }
+    }
+    cpu_processor_cache->items.remove(*least_recently_used);
+  }
+
+  std::shared_ptr<OCIO_ConstCPUProcessorRcPtr> cpu_processor(new_cpu_processor,
+                                                             OCIO_cpuProcessorRelease);
+  cpu_processor_cache->items.add_new(key, {cpu_processor, ++cpu_processor_cache->use_counter});
+
+  BLI_mutex_unlock(&processor_lock);
+  return cpu_processor;
+}
+
+static void cpu_processor_cache_free()
+{
+  MEM_delete(cpu_processor_cache);
+  cpu_processor_cache = nullptr;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Pixel Conversion Kernels
+ * \{ */
+
+void colormanage_rgba_uchar_to_float(float *dst, const uchar *src, const int64_t pixels_num)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  /* Four pixels at a time: widen the 16 bytes to 32 bit integers, then convert to floats. */
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+  for (; i + 4 <= pixels_num; i += 4) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+    const __m128i shorts_lo = _mm_unpacklo_epi8(bytes, zero);
+    const __m128i shorts_hi = _mm_unpackhi_epi8(bytes, zero);
+    float *dst_pixels = dst + i * 4;
+    _mm_storeu_ps(dst_pixels + 0,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(shorts_lo, zero)), scale));
+    _mm_storeu_ps(dst_pixels + 4,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(shorts_lo, zero)), scale));
+    _mm_storeu_ps(dst_pixels + 8,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(shorts_hi, zero)), scale));
+    _mm_storeu_ps(dst_pixels + 12,
+                  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(shorts_hi, zero)), scale));
+  }
+#endif
+  for (; i < pixels_num; i++) {
+    rgba_uchar_to_float(dst + i * 4, src + i * 4);
+  }
+}
+
+#if BLI_HAVE_SSE2
+/* Same rounding as #unit_float_to_uchar_clamp: values in the [0, 1] range are scaled, offset by
+ * one half and truncated, values outside of the range are clamped and NaN becomes zero. */
+BLI_INLINE __m128i unit_float_to_int_clamp_sse2(const __m128 value)
+{
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  return _mm_cvttps_epi32(
+      _mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+}
+#endif
+
+void colormanage_rgba_float_to_uchar(uchar *dst, const float *src, const int64_t pixels_num)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  /* Four pixels at a time, the saturating packs are exact since values are in the byte range. */
+  for (; i + 4 <= pixels_num; i += 4) {
+    const float *src_pixels = src + i * 4;
+    const __m128i ints_0 = unit_float_to_int_clamp_sse2(_mm_loadu_ps(src_pixels + 0));
+    const __m128i ints_1 = unit_float_to_int_clamp_sse2(_mm_loadu_ps(src_pixels + 4));
+    const __m128i ints_2 = unit_float_to_int_clamp_sse2(_mm_loadu_ps(src_pixels + 8));
+    const __m128i ints_3 = unit_float_to_int_clamp_sse2(_mm_loadu_ps(src_pixels + 12));
+    const __m128i shorts_lo = _mm_packs_epi32(ints_0, ints_1);
+    const __m128i shorts_hi = _mm_packs_epi32(ints_2, ints_3);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),
+                     _mm_packus_epi16(shorts_lo, shorts_hi));
+  }
+#endif
+  for (; i < pixels_num; i++) {
+    rgba_float_to_uchar(dst + i * 4, src + i * 4);
+  }
+}
+
+void colormanage_straight_to_premul_rgba(float *buffer, const int64_t pixels_num)
+{
+  int64_t i = 0;
+#if BLI_HAVE_SSE2
+  /* Multiply by (alpha, alpha, alpha, 1), which leaves alpha itself untouched. */
+  const __m128 rgb_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  const __m128 alpha_one = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+  for (; i < pixels_num; i++) {
+    float *pixel = buffer + i * 4;
+    const __m128 color = _mm_loadu_ps(pixel);
+    const __m128 alpha = _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128 factor = _mm_or_ps(_mm_and_ps(alpha, rgb_mask), alpha_one);
+    _mm_storeu_ps(pixel, _mm_mul_ps(color, factor));
+  }
+#endif
+  for (; i < pixels_num; i++) {
+    straight_to_premul_v4(buffer + i * 4);
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Color Managed Cache
  * \{ */
@@ -657,6 +858,9 @@ static void colormanage_free_config()
   BLI_listbase_clear(&global_displays);
   global_tot_display = 0;
 
+  /* Free cached processors, the ones still used by pixel processors stay valid. */
+  cpu_processor_cache_free();
+
   /* free views */
   BLI_freelistN(&global_views);
   global_tot_view = 0;
@@ -1654,24 +1858,24 @@ static void display_buffer_apply_get_linear_buffer(DisplayBufferThread *handle,
     const char *from_colorspace = handle->byte_colorspace;
     const char *to_colorspace = global_role_scene_linear;
 
-    float *fp;
-    uchar *cp;
-    const size_t i_last = size_t(width) * height;
-    size_t i;
-
     /* first convert byte buffer to float, keep in image space */
-    for (i = 0, fp = linear_buffer, cp = byte_buffer; i != i_last;
-         i++, fp += channels, cp += channels)
-    {
-      if (channels == 3) {
+    if (channels == 4) {
+      colormanage_rgba_uchar_to_float(linear_buffer, byte_buffer, int64_t(width) * height);
+    }
+    else if (channels == 3) {
+      float *fp;
+      uchar *cp;
+      const size_t i_last = size_t(width) * height;
+      size_t i;
+
+      for (i = 0, fp = linear_buffer, cp = byte_buffer; i != i_last;
+           i++, fp += channels, cp += channels)
+      {
         rgb_uchar_to_float(fp, cp);
       }
-      else if (channels == 4) {
-        rgba_uchar_to_float(fp, cp);
-      }
-      else {
-        BLI_assert_msg(0, "Buffers of 3 or 4 channels are only supported here");
-      }
+    }
+    else {
+      BLI_assert_msg(0, "Buffers of 3 or 4 channels are only supported here");
     }
 
     if (!is_data && !is_data_display) {
@@ -1791,13 +1995,7 @@ static void *do_display_buffer_apply_thread(void *handle_v)
       memcpy(display_buffer, linear_buffer, size_t(width) * height * channels * sizeof(float));
 
       if (is_straight_alpha && channels == 4) {
-        const size_t i_last = size_t(width) * height;
-        size_t i;
-        float *fp;
-
-        for (i = 0, fp = display_buffer; i != i_last; i++, fp += channels) {
-          straight_to_premul_v4(fp);
-        }
+        colormanage_straight_to_premul_rgba(display_buffer, int64_t(width) * height);
       }
     }
 
@@ -2897,6 +3095,20 @@ uchar *IMB_display_buffer_acquire_ctx(const bContext *C, ImBuf *ibuf, void **cac
   return IMB_display_buffer_acquire(ibuf, view_settings, display_settings, cache_handle);
 }
 
+void IMB_display_buffer_transform_ibuf(ImBuf *ibuf,
+                                       uchar *display_buffer,
+                                       const ColorManagedViewSettings *view_settings,
+                                       const ColorManagedDisplaySettings *display_settings)
+{
+  ColorManagedViewSettings default_view_settings;
+  if (view_settings == nullptr) {
+    IMB_colormanagement_init_default_view_settings(&default_view_settings, display_settings);
+    view_settings = &default_view_settings;
+  }
+
+  colormanage_display_buffer_process(ibuf, display_buffer, view_settings, display_settings);
+}
+
 void IMB_display_buffer_transform_apply(uchar *display_buffer,
                                         float *linear_buffer,
                                         int width,
@@ -3978,7 +4190,7 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(
   const ColorManagedViewSettings *applied_view_settings;
   ColorSpace *display_space;
 
-  cm_processor = MEM_cnew<ColormanageProcessor>("colormanagement processor");
+  cm_processor = MEM_new<ColormanageProcessor>("colormanagement processor");
 
   if (view_settings) {
     applied_view_settings = view_settings;
@@ -3993,17 +4205,27 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(
     cm_processor->is_data_result = display_space->is_data;
   }
 
-  const bool use_white_balance = applied_view_settings->flag & COLORMANAGE_VIEW_USE_WHITE_BALANCE;
-  cm_processor->cpu_processor = create_display_buffer_processor(
-      applied_view_settings->look,
-      applied_view_settings->view_transform,
-      display_settings->display_device,
-      applied_view_settings->exposure,
-      applied_view_settings->gamma,
-      applied_view_settings->temperature,
-      applied_view_settings->tint,
-      use_white_balance,
-      global_role_scene_linear);
+  CPUProcessorCacheKey key;
+  key.look = applied_view_settings->look;
+  key.view_transform = applied_view_settings->view_transform;
+  key.display = display_settings->display_device;
+  key.from_colorspace = global_role_scene_linear;
+  key.exposure = applied_view_settings->exposure;
+  key.gamma = applied_view_settings->gamma;
+  key.temperature = applied_view_settings->temperature;
+  key.tint = applied_view_settings->tint;
+  key.use_white_balance = applied_view_settings->flag & COLORMANAGE_VIEW_USE_WHITE_BALANCE;
+  cm_processor->cpu_processor = cpu_processor_cache_lookup(key, [&]() {
+    return create_display_buffer_processor(key.look.c_str(),
+                                           key.view_transform.c_str(),
+                                           key.display.c_str(),
+                                           key.exposure,
+                                           key.gamma,
+                                           key.temperature,
+                                           key.tint,
+                                           key.use_white_balance,
+                                           key.from_colorspace.c_str());
+  });
 
   if (applied_view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) {
     cm_processor->curve_mapping = BKE_curvemapping_copy(applied_view_settings->curve_mapping);
@@ -4018,15 +4240,23 @@ ColormanageProcessor *IMB_colormanagement_colorspace_processor_new(const char *f
 {
   ColormanageProcessor *cm_processor;
 
-  cm_processor = MEM_cnew<ColormanageProcessor>("colormanagement processor");
+  cm_processor = MEM_new<ColormanageProcessor>("colormanagement processor");
   cm_processor->is_data_result = IMB_colormanagement_space_name_is_data(to_colorspace);
 
-  OCIO_ConstProcessorRcPtr *processor = create_colorspace_transform_processor(from_colorspace,
-                                                                              to_colorspace);
-  if (processor != nullptr) {
-    cm_processor->cpu_processor = OCIO_processorGetCPUProcessor(processor);
-  }
-  OCIO_processorRelease(processor);
+  CPUProcessorCacheKey key;
+  key.from_colorspace = from_colorspace;
+  key.to_colorspace = to_colorspace;
+  cm_processor->cpu_processor = cpu_processor_cache_lookup(
+      key, [&]() -> OCIO_ConstCPUProcessorRcPtr * {
+        OCIO_ConstProcessorRcPtr *processor = create_colorspace_transform_processor(
+            from_colorspace, to_colorspace);
+        if (processor == nullptr) {
+          return nullptr;
+        }
+        OCIO_ConstCPUProcessorRcPtr *cpu_processor = OCIO_processorGetCPUProcessor(processor);
+        OCIO_processorRelease(processor);
+        return cpu_processor;
+      });
 
   return cm_processor;
 }
@@ -4053,7 +4283,7 @@ bool IMB_colormanagement_processor_is_noop(ColormanageProcessor *cm_processor)
     return true;
   }
 
-  return OCIO_cpuProcessorIsNoOp(cm_processor->cpu_processor);
+  return OCIO_cpuProcessorIsNoOp(cm_processor->cpu_processor.get());
 }
 
 void IMB_colormanagement_processor_apply_v4(ColormanageProcessor *cm_processor, float pixel[4])
@@ -4063,7 +4293,7 @@ void IMB_colormanagement_processor_apply_v4(ColormanageProcessor *cm_processor,
   }
 
   if (cm_processor->cpu_processor) {
-    OCIO_cpuProcessorApplyRGBA(cm_processor->cpu_processor, pixel);
+    OCIO_cpuProcessorApplyRGBA(cm_processor->cpu_processor.get(), pixel);
   }
 }
 
@@ -4075,7 +4305,7 @@ void IMB_colormanagement_processor_apply_v4_predivide(ColormanageProcessor *cm_p
   }
 
   if (cm_processor->cpu_processor) {
-    OCIO_cpuProcessorApplyRGBA_predivide(cm_processor->cpu_processor, pixel);
+    OCIO_cpuProcessorApplyRGBA_predivide(cm_processor->cpu_processor.get(), pixel);
   }
 }
 
@@ -4086,7 +4316,7 @@ void IMB_colormanagement_processor_apply_v3(ColormanageProcessor *cm_processor,
   }
 
   if (cm_processor->cpu_processor) {
-    OCIO_cpuProcessorApplyRGB(cm_processor->cpu_processor, pixel);
+    OCIO_cpuProcessorApplyRGB(cm_processor->cpu_processor.get(), pixel);
   }
 }
 
@@ -4144,10 +4374,10 @@ void IMB_colormanagement_processor_apply(ColormanageProcessor *cm_processor,
                                           size_t(channels) * sizeof(float) * width);
 
     if (predivide) {
-      OCIO_cpuProcessorApply_predivide(cm_processor->cpu_processor, img);
+      OCIO_cpuProcessorApply_predivide(cm_processor->cpu_processor.get(), img);
     }
     else {
-      OCIO_cpuProcessorApply(cm_processor->cpu_processor, img);
+      OCIO_cpuProcessorApply(cm_processor->cpu_processor.get(), img);
     }
 
     OCIO_PackedImageDescRelease(img);
@@ -4161,15 +4391,17 @@ void IMB_colormanagement_processor_apply_byte(
    * but for now it's not so important.
    */
   BLI_assert(channels == 4);
-  float pixel[4];
+  /* Process a row at a time, so the processor can work on many pixels at once instead of being
+   * invoked for every pixel. */
+  float *row_buffer = static_cast<float *>(
+      MEM_mallocN(sizeof(float) * channels * width, "colormanagement byte row"));
   for (int y = 0; y < height; y++) {
-    for (int x = 0; x < width; x++) {
-      size_t offset = channels * (size_t(y) * width + x);
-      rgba_uchar_to_float(pixel, buffer + offset);
-      IMB_colormanagement_processor_apply_v4(cm_processor, pixel);
-      rgba_float_to_uchar(buffer + offset, pixel);
-    }
+    uchar *row = buffer + size_t(channels) * y * width;
+    colormanage_rgba_uchar_to_float(row_buffer, row, width);
+    IMB_colormanagement_processor_apply(cm_processor, row_buffer, width, 1, channels, false);
+    colormanage_rgba_float_to_uchar(row, row_buffer, width);
   }
+  MEM_freeN(row_buffer);
 }
 
 void IMB_colormanagement_processor_free(ColormanageProcessor *cm_processor)
@@ -4177,11 +4409,8 @@ void IMB_colormanagement_processor_free(ColormanageProcessor *cm_processor)
   if (cm_processor->curve_mapping) {
     BKE_curvemapping_free(cm_processor->curve_mapping);
   }
-  if (cm_processor->cpu_processor) {
-    OCIO_cpuProcessorRelease(cm_processor->cpu_processor);
-  }
 
-  MEM_freeN(cm_processor);
+  MEM_delete(cm_processor);
 }
 
 /* **** OpenGL drawing routines using GLSL for color space transform ***** */
@@ -0,0 +1,132 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_color.h"
+#include "BLI_rand.hh"
+
+#include "IMB_colormanagement_intern.hh"
+
+#define DO_PERF_TESTS 0
+
+#if DO_PERF_TESTS
+#  include "BLI_timeit.hh"
+#endif
+
+namespace blender::imbuf::tests {
+
+/* Odd number of pixels, so both the vectorized loops and the remainder are tested. */
+static const int64_t pixels_num = 1027;
+
+TEST(colormanagement, RGBAUcharToFloat)
+{
+  Array<uchar> src(pixels_num * 4);
+  for (const int64_t i : src.index_range()) {
+    src[i] = uchar(i % 256);
+  }
+
+  Array<float> result(pixels_num * 4);
+  colormanage_rgba_uchar_to_float(result.data(), src.data(), pixels_num);
+
+  for (const int64_t i : IndexRange(pixels_num)) {
+    float expected[4];
+    rgba_uchar_to_float(expected, &src[i * 4]);
+    for (const int channel : IndexRange(4)) {
+      EXPECT_EQ(result[i * 4 + channel], expected[channel]) << "at " << i;
+    }
+  }
+}
+
+TEST(colormanagement, RGBAFloatToUchar)
+{
+  RandomNumberGenerator rng(0);
+  Array<float> src(pixels_num * 4);
+  for (float &value : src) {
+    /* Include values outside of the unit range to test clamping. */
+    value = rng.get_float() * 1.4f - 0.2f;
+  }
+  /* Values right at the rounding and clamping thresholds. */
+  src[0] = 0.0f;
+  src[1] = 1.0f;
+  src[2] = 1.0f - 0.5f / 255.0f;
+  src[3] = 0.5f / 255.0f;
+  src[4] = -0.0f;
+  src[5] = 100.0f;
+
+  Array<uchar> result(pixels_num * 4);
+  colormanage_rgba_float_to_uchar(result.data(), src.data(), pixels_num);
+
+  for (const int64_t i : IndexRange(pixels_num)) {
+    uchar expected[4];
+    rgba_float_to_uchar(expected, &src[i * 4]);
+    for (const int channel : IndexRange(4)) {
+      EXPECT_EQ(result[i * 4 + channel], expected[channel]) << "at " << i;
+    }
+  }
+}
+
+TEST(colormanagement, StraightToPremulRGBA)
+{
+  RandomNumberGenerator rng(0);
+  Array<float> buffer(pixels_num * 4);
+  for (float &value : buffer) {
+    value = rng.get_float();
+  }
+  Array<float> expected = buffer;
+
+  colormanage_straight_to_premul_rgba(buffer.data(), pixels_num);
+
+  for (const int64_t i : IndexRange(pixels_num)) {
+    straight_to_premul_v4(&expected[i * 4]);
+    for (const int channel : IndexRange(4)) {
+      EXPECT_EQ(buffer[i * 4 + channel], expected[i * 4 + channel]) << "at " << i;
+    }
+  }
+}
+
+#if DO_PERF_TESTS
+
+TEST(colormanagement, ConversionKernels_Performance)
+{
+  const int64_t size = 4096 * 2160;
+  Array<uchar> bytes(size * 4, 128);
+  Array<float> floats(size * 4);
+
+  {
+    SCOPED_TIMER("rgba_uchar_to_float scalar");
+    for (const int64_t i : IndexRange(size)) {
+      rgba_uchar_to_float(&floats[i * 4], &bytes[i * 4]);
+    }
+  }
+  {
+    SCOPED_TIMER("rgba_uchar_to_float kernel");
+    colormanage_rgba_uchar_to_float(floats.data(), bytes.data(), size);
+  }
+  {
+    SCOPED_TIMER("straight_to_premul_v4 scalar");
+    for (const int64_t i : IndexRange(size)) {
+      straight_to_premul_v4(&floats[i * 4]);
+    }
+  }
+  {
+    SCOPED_TIMER("straight_to_premul_v4 kernel");
+    colormanage_straight_to_premul_rgba(floats.data(), size);
+  }
+  {
+    SCOPED_TIMER("rgba_float_to_uchar scalar");
+    for (const int64_t i : IndexRange(size)) {
+      rgba_float_to_uchar(&bytes[i * 4], &floats[i * 4]);
+    }
+  }
+  {
+    SCOPED_TIMER("rgba_float_to_uchar kernel");
+    colormanage_rgba_float_to_uchar(bytes.data(), floats.data(), size);
+  }
+}
+
+#endif
+
+}  // namespace blender::imbuf::tests
@@ -185,9 +185,7 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
           }
         }
         else {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            rgba_float_to_uchar(to, from);
-          }
+          colormanage_rgba_float_to_uchar(to, from, width);
         }
       }
       else if (profile_to == IB_PROFILE_SRGB) {
@@ -371,9 +369,7 @@ void IMB_buffer_float_from_byte(float *rect_to,
 
     if (profile_to == profile_from) {
       /* no color space conversion */
-      for (x = 0; x < width; x++, from += 4, to += 4) {
-        rgba_uchar_to_float(to, from);
-      }
+      colormanage_rgba_uchar_to_float(to, from, width);
     }
     else if (profile_to == IB_PROFILE_LINEAR_RGB) {
       /* convert sRGB to linear */
@@ -6,7 +6,11 @@
  * \ingroup imbuf
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <mutex>
+#include <string>
 
 #include "MEM_guardedalloc.h"
 
@@ -17,11 +21,14 @@
 #include "BLI_ghash.h"
 #include "BLI_math_base.h"
 #include "BLI_path_util.h"
+#include "BLI_set.hh"
 #include "BLI_string.h"
 #include "BLI_string_utils.hh"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_time.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #ifdef _WIN32
 #  include "BLI_winstuff.h"
@@ -52,12 +59,15 @@ static const float proxy_fac[] = {0.25, 0.50, 0.75, 1.00};
  * - time code index functions
  * ---------------------------------------------------------------------- */
 
-anim_index_builder *IMB_index_builder_create(const char *filepath)
+/* Indices built automatically don't report their progress, see #IMB_anim_open_seek_index. */
+static anim_index_builder *index_builder_create(const char *filepath, const bool verbose)
 {
 
   anim_index_builder *rv = MEM_cnew<anim_index_builder>("index builder");
 
-  fprintf(stderr, "Starting work on index: %s\n", filepath);
+  if (verbose) {
+    fprintf(stderr, "Starting work on index: %s\n", filepath);
+  }
 
   STRNCPY(rv->filepath, filepath);
 
@@ -69,10 +79,12 @@ anim_index_builder *IMB_index_builder_create(const char *filepath)
   rv->fp = BLI_fopen(rv->filepath_temp, "wb");
 
   if (!rv->fp) {
-    fprintf(stderr,
-            "Couldn't open index target: %s! "
-            "Index build broken!\n",
-            rv->filepath_temp);
+    if (verbose) {
+      fprintf(stderr,
+              "Couldn't open index target: %s! "
+              "Index build broken!\n",
+              rv->filepath_temp);
+    }
     MEM_freeN(rv);
     return nullptr;
   }
@@ -86,6 +98,11 @@ anim_index_builder *IMB_index_builder_create(const char *filepath)
   return rv;
 }
 
+anim_index_builder *IMB_index_builder_create(const char *filepath)
+{
+  return index_builder_create(filepath, true);
+}
+
 void IMB_index_builder_add_entry(anim_index_builder *fp,
                                  int frameno,
                                  uint64_t seek_pos,
@@ -291,6 +308,20 @@ int IMB_indexer_get_frame_index(ImBufAnimIndex *idx, int frameno)
   return first;
 }
 
+int IMB_indexer_get_frame_index_by_pts(ImBufAnimIndex *idx, int64_t pts)
+{
+  /* Timestamps are stored unsigned, but can be negative. */
+  const anim_index_entry *entries_begin = idx->entries;
+  const anim_index_entry *entries_end = idx->entries + idx->num_entries;
+  const anim_index_entry *entry = std::upper_bound(
+      entries_begin, entries_end, pts, [](const int64_t value, const anim_index_entry &entry) {
+        return value < int64_t(entry.pts);
+      });
+
+  /* Timestamps before the first entry use the first entry. */
+  return std::max(int(entry - entries_begin) - 1, 0);
+}
+
 uint64_t IMB_indexer_get_pts(ImBufAnimIndex *idx, int frame_index)
 {
   if (frame_index < 0) {
@@ -1218,6 +1249,236 @@ static bool indexer_need_to_build_proxy(FFmpegIndexBuilderContext *context)
   return true;
 }
 
+/* ----------------------------------------------------------------------
+ * - seek index builder
+ * ---------------------------------------------------------------------- */
+
+/* The seek index stores the key frame needed to decode every frame of a movie, so seeking can
+ * jump straight to it instead of guessing how far back the key frame is. It is built in the
+ * background the first time a movie is read without a time-code index, by reading the packets of
+ * the video stream without decoding them, and uses the same file format as time-code indices. */
+
+struct ImBufAnimSeekIndexBuilder {
+  char filepath[FILE_MAX];
+  char index_filepath[FILE_MAX];
+  int streamindex;
+
+  TaskPool *task_pool;
+  std::atomic<bool> stop = false;
+  std::atomic<bool> finished = false;
+};
+
+/* Index files being built, so multiple movies using the same file don't write the same index. */
+static std::mutex seek_index_build_mutex;
+static blender::Set<std::string> seek_index_build_filepaths;
+
+static void get_seek_index_filepath(ImBufAnim *anim, char *filepath)
+{
+  char index_dir[FILE_MAXDIR];
+  char stream_suffix[20];
+  char index_name[256];
+
+  stream_suffix[0] = 0;
+
+  if (anim->streamindex > 0) {
+    SNPRINTF(stream_suffix, "_st%d", anim->streamindex);
+  }
+
+  SNPRINTF(index_name, "seek_index%s%s.blen_tc", stream_suffix, anim->suffix);
+
+  get_index_dir(anim, index_dir, sizeof(index_dir));
+
+  BLI_path_join(filepath, FILE_MAXFILE + FILE_MAXDIR, index_dir, index_name);
+}
+
+struct SeekIndexPacket {
+  int64_t timestamp;
+  int64_t pts;
+  int64_t dts;
+  int64_t pos;
+  bool is_key_frame;
+};
+
+struct SeekIndexFrame {
+  int64_t timestamp;
+  /* Index of the packet of the key frame decoding has to start from. */
+  int key_frame_packet;
+};
+
+static int seek_index_find_video_stream(const AVFormatContext *format_ctx, int streamindex)
+{
+  for (int i = 0; i < format_ctx->nb_streams; i++) {
+    if (format_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+      if (streamindex > 0) {
+        streamindex--;
+        continue;
+      }
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void seek_index_build(ImBufAnimSeekIndexBuilder *builder)
+{
+  AVFormatContext *format_ctx = nullptr;
+  if (avformat_open_input(&format_ctx, builder->filepath, nullptr, nullptr) != 0) {
+    return;
+  }
+
+  const int video_stream = avformat_find_stream_info(format_ctx, nullptr) < 0 ?
+                               -1 :
+                               seek_index_find_video_stream(format_ctx, builder->streamindex);
+  if (video_stream == -1) {
+    avformat_close_input(&format_ctx);
+    return;
+  }
+
+  /* Only packets of the video stream are needed, let the demuxer skip the others. */
+  for (int i = 0; i < format_ctx->nb_streams; i++) {
+    if (i != video_stream) {
+      format_ctx->streams[i]->discard = AVDISCARD_ALL;
+    }
+  }
+
+  blender::Vector<SeekIndexPacket> packets;
+  AVPacket *packet = av_packet_alloc();
+  while (!builder->stop && av_read_frame(format_ctx, packet) >= 0) {
+    const int64_t timestamp = timestamp_from_pts_or_dts(packet->pts, packet->dts);
+    if (packet->stream_index == video_stream && timestamp != AV_NOPTS_VALUE) {
+      packets.append({timestamp,
+                      packet->pts,
+                      packet->dts,
+                      packet->pos,
+                      (packet->flags & AV_PKT_FLAG_KEY) != 0});
+    }
+    av_packet_unref(packet);
+  }
+  av_packet_free(&packet);
+
+  /* Packets are in decoding order. Frames shown before the key frame they follow in decoding
+   * order (leading frames of open GOPs) need the previous key frame, like in
+   * #index_rebuild_ffmpeg_proc_decoded_frame. */
+  blender::Vector<SeekIndexFrame> frames;
+  int key_frame = -1;
+  int previous_key_frame = -1;
+  for (const int i : packets.index_range()) {
+    if (packets[i].is_key_frame) {
+      previous_key_frame = key_frame;
+      key_frame = i;
+    }
+    if (key_frame == -1) {
+      /* Frames before the first key frame can not be decoded. */
+      continue;
+    }
+    const bool is_leading = packets[i].timestamp < packets[key_frame].timestamp &&
+                            previous_key_frame != -1;
+    frames.append({packets[i].timestamp, is_leading ? previous_key_frame : key_frame});
+  }
+
+  std::stable_sort(frames.begin(),
+                   frames.end(),
+                   [](const SeekIndexFrame &a, const SeekIndexFrame &b) {
+                     return a.timestamp < b.timestamp;
+                   });
+
+  anim_index_builder *index_builder = (builder->stop || frames.is_empty()) ?
+                                          nullptr :
+                                          index_builder_create(builder->index_filepath, false);
+  if (index_builder) {
+    AVStream *stream = format_ctx->streams[video_stream];
+    const double frame_rate = av_q2d(av_guess_frame_rate(format_ctx, stream, nullptr));
+    const double pts_time_base = av_q2d(stream->time_base);
+    const int64_t start_pts = frames.first().timestamp;
+
+    for (const SeekIndexFrame &frame : frames) {
+      const SeekIndexPacket &key_frame_packet = packets[frame.key_frame_packet];
+      const int frameno = floor((frame.timestamp - start_pts) * pts_time_base * frame_rate + 0.5);
+      IMB_index_builder_add_entry(index_builder,
+                                  frameno,
+                                  key_frame_packet.pos,
+                                  key_frame_packet.pts,
+                                  key_frame_packet.dts,
+                                  frame.timestamp);
+    }
+    IMB_index_builder_finish(index_builder, builder->stop);
+  }
+
+  avformat_close_input(&format_ctx);
+}
+
+static void seek_index_build_task(TaskPool *__restrict pool, void * /*taskdata*/)
+{
+  ImBufAnimSeekIndexBuilder *builder = static_cast<ImBufAnimSeekIndexBuilder *>(
+      BLI_task_pool_user_data(pool));
+
+  seek_index_build(builder);
+
+  {
+    std::lock_guard lock(seek_index_build_mutex);
+    seek_index_build_filepaths.remove(builder->index_filepath);
+  }
+  builder->finished = true;
+}
+
+/* Intra-only codecs can seek to any frame, so there is nothing to gain from the seek index. */
+static bool seek_index_is_useful(const ImBufAnim *anim)
+{
+  if (anim->pCodecCtx == nullptr) {
+    return false;
+  }
+  const AVCodecDescriptor *descriptor = avcodec_descriptor_get(anim->pCodecCtx->codec_id);
+  return descriptor == nullptr || (descriptor->props & AV_CODEC_PROP_INTRA_ONLY) == 0;
+}
+
+/* Whether the index file can be created, the directories it is in may not exist yet. */
+static bool seek_index_filepath_is_writable(const char *index_filepath)
+{
+  char dir[FILE_MAX];
+  BLI_path_split_dir_part(index_filepath, dir, sizeof(dir));
+  while (!BLI_is_dir(dir)) {
+    if (!BLI_path_parent_dir(dir)) {
+      return false;
+    }
+  }
+  return BLI_file_is_writable(dir);
+}
+
+/* Returns false when the index is already being built for another movie using the same file. */
+static bool seek_index_build_start(ImBufAnim *anim, const char *index_filepath)
+{
+  {
+    std::lock_guard lock(seek_index_build_mutex);
+    if (!seek_index_build_filepaths.add(index_filepath)) {
+      return false;
+    }
+  }
+
+  ImBufAnimSeekIndexBuilder *builder = MEM_new<ImBufAnimSeekIndexBuilder>(__func__);
+  STRNCPY(builder->filepath, anim->filepath);
+  STRNCPY(builder->index_filepath, index_filepath);
+  builder->streamindex = anim->streamindex;
+  builder->task_pool = BLI_task_pool_create_background(builder, TASK_PRIORITY_LOW);
+  BLI_task_pool_push(builder->task_pool, seek_index_build_task, nullptr, false, nullptr);
+
+  anim->seek_index_builder = builder;
+  return true;
+}
+
+static void seek_index_builder_free(ImBufAnim *anim)
+{
+  ImBufAnimSeekIndexBuilder *builder = anim->seek_index_builder;
+  if (builder == nullptr) {
+    return;
+  }
+
+  builder->stop = true;
+  BLI_task_pool_work_and_wait(builder->task_pool);
+  BLI_task_pool_free(builder->task_pool);
+  MEM_delete(builder);
+  anim->seek_index_builder = nullptr;
+}
+
 #endif
 
 /* ----------------------------------------------------------------------
@@ -1344,8 +1605,17 @@ void IMB_free_indices(ImBufAnim *anim)
     anim->no_gaps = nullptr;
   }
 
+#ifdef WITH_FFMPEG
+  seek_index_builder_free(anim);
+#endif
+  if (anim->seek_index) {
+    IMB_indexer_close(anim->seek_index);
+    anim->seek_index = nullptr;
+  }
+
   anim->proxies_tried = 0;
   anim->indices_tried = 0;
+  anim->seek_index_tried = false;
 }
 
 void IMB_anim_set_index_dir(ImBufAnim *anim, const char *dir)
@@ -1414,6 +1684,46 @@ ImBufAnimIndex *IMB_anim_open_index(ImBufAnim *anim, IMB_Timecode_Type tc)
   return *index;
 }
 
+ImBufAnimIndex *IMB_anim_open_seek_index(ImBufAnim *anim)
+{
+#ifdef WITH_FFMPEG
+  if (anim->seek_index || anim->seek_index_tried) {
+    return anim->seek_index;
+  }
+
+  const bool has_built = anim->seek_index_builder != nullptr;
+  if (has_built) {
+    if (!anim->seek_index_builder->finished) {
+      return nullptr;
+    }
+    seek_index_builder_free(anim);
+  }
+
+  char filepath[FILE_MAX];
+  get_seek_index_filepath(anim, filepath);
+  anim->seek_index = IMB_indexer_open(filepath);
+  if (anim->seek_index && anim->seek_index->num_entries == 0) {
+    IMB_indexer_close(anim->seek_index);
+    anim->seek_index = nullptr;
+  }
+
+  /* Only build once, even when building failed. */
+  if (anim->seek_index || has_built || !seek_index_is_useful(anim) ||
+      !seek_index_filepath_is_writable(filepath))
+  {
+    anim->seek_index_tried = true;
+    return anim->seek_index;
+  }
+
+  /* When another movie is building the same index, try to open it again on the next call. */
+  seek_index_build_start(anim, filepath);
+  return nullptr;
+#else
+  UNUSED_VARS(anim);
+  return nullptr;
+#endif
+}
+
 int IMB_anim_index_get_frame_index(ImBufAnim *anim, IMB_Timecode_Type tc, int position)
 {
   ImBufAnimIndex *idx = IMB_anim_open_index(anim, tc);
@@ -79,6 +79,7 @@
 #include "BLI_fileops.h"
 #include "BLI_math_color.h"
 #include "BLI_mmap.h"
+#include "BLI_rect.h"
 #include "BLI_threads.h"
 
 #include "BKE_idprop.hh"
@@ -98,6 +99,9 @@ using namespace Imath;
 static struct ExrPass *imb_exr_get_pass(ListBase *lb, char *passname);
 static bool exr_has_multiview(MultiPartInputFile &file);
 static bool exr_has_multipart_file(MultiPartInputFile &file);
+static bool exr_is_blender_multipart_file(const MultiPartInputFile &file);
+static std::vector<MultiViewChannelName> exr_channels_in_multi_part_file(
+    const MultiPartInputFile &file);
 static bool exr_has_alpha(MultiPartInputFile &file);
 static void exr_printf(const char *__restrict fmt, ...);
 static void imb_exr_type_by_channels(ChannelList &channels,
@@ -684,13 +688,14 @@ struct ExrHandle {
 struct ExrChannel {
   ExrChannel *next, *prev;
 
-  char name[EXR_TOT_MAXNAME + 1]; /* full name with everything */
-  MultiViewChannelName *m;        /* struct to store all multipart channel info */
-  int xstride, ystride;           /* step to next pixel, to next scan-line. */
-  float *rect;                    /* first pointer to write in */
-  char chan_id;                   /* quick lookup of channel char */
-  int view_id;                    /* quick lookup of channel view */
-  bool use_half_float;            /* when saving use half float for file storage */
+  char name[EXR_TOT_MAXNAME + 1];       /* full name with everything */
+  char layer_name[EXR_LAY_MAXNAME + 1]; /* layer, used to split layers into parts on save */
+  MultiViewChannelName *m;              /* struct to store all multipart channel info */
+  int xstride, ystride;                 /* step to next pixel, to next scan-line. */
+  float *rect;                          /* first pointer to write in */
+  char chan_id;                         /* quick lookup of channel char */
+  int view_id;                          /* quick lookup of channel view */
+  bool use_half_float;                  /* when saving use half float for file storage */
 };
 
 /* hierarchical; layers -> passes -> channels[] */
@@ -857,6 +862,7 @@ void IMB_exr_add_channel(void *handle,
     STRNCPY(echan->name, echan->m->name.c_str());
   }
 
+  STRNCPY(echan->layer_name, layname ? layname : "");
   echan->xstride = xstride;
   echan->ystride = ystride;
   echan->rect = rect;
@@ -875,7 +881,8 @@ bool IMB_exr_begin_write(void *handle,
                          int width,
                          int height,
                          int compress,
-                         const StampData *stamp)
+                         const StampData *stamp,
+                         const bool multipart)
 {
   ExrHandle *data = (ExrHandle *)handle;
   Header header(width, height);
@@ -897,11 +904,39 @@ bool IMB_exr_begin_write(void *handle,
   imb_exr_type_by_channels(
       header.channels(), *data->multiView, &is_singlelayer, &is_multilayer, &is_multiview);
 
-  if (is_multilayer) {
+  /* Also needed to recognize the channel naming of multi-part files when reading. */
+  if (is_multilayer || multipart) {
     header.insert("BlenderMultiChannel", StringAttribute("Blender V2.55.1 and newer"));
   }
 
-  if (is_multiview) {
+  /* One part for every layer and view. Channel names are the same as in single part files, and
+   * the view is also stored in the part header as expected by other applications. */
+  std::vector<Header> part_headers;
+  if (multipart) {
+    std::vector<std::string> part_names;
+    LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+      std::string part_name = echan->layer_name[0] ? echan->layer_name : "Default";
+      if (is_multiview) {
+        part_name += "." + echan->m->view;
+      }
+
+      auto part_name_it = std::find(part_names.begin(), part_names.end(), part_name);
+      echan->m->part_number = part_name_it - part_names.begin();
+      if (part_name_it == part_names.end()) {
+        part_names.push_back(part_name);
+        part_headers.push_back(header);
+        part_headers.back().channels() = ChannelList();
+        part_headers.back().setName(part_name);
+        part_headers.back().setType(SCANLINEIMAGE);
+        if (is_multiview) {
+          part_headers.back().setView(echan->m->view);
+        }
+      }
+      part_headers[echan->m->part_number].channels().insert(
+          echan->name, Channel(echan->use_half_float ? Imf::HALF : Imf::FLOAT));
+    }
+  }
+  else if (is_multiview) {
     addMultiView(header, *data->multiView);
   }
 
@@ -909,28 +944,38 @@ bool IMB_exr_begin_write(void *handle,
   /* manually create ofstream, so we can handle utf-8 filepaths on windows */
   try {
     data->ofile_stream = new OFileStream(filepath);
-    data->ofile = new OutputFile(*(data->ofile_stream), header);
+    if (multipart) {
+      data->mpofile = new MultiPartOutputFile(
+          *(data->ofile_stream), part_headers.data(), part_headers.size());
+    }
+    else {
+      data->ofile = new OutputFile(*(data->ofile_stream), header);
+    }
   }
   catch (const std::exception &exc) {
     std::cerr << "IMB_exr_begin_write: ERROR: " << exc.what() << std::endl;
 
     delete data->ofile;
+    delete data->mpofile;
     delete data->ofile_stream;
 
     data->ofile = nullptr;
+    data->mpofile = nullptr;
     data->ofile_stream = nullptr;
   }
   catch (...) { /* Catch-all for edge cases or compiler bugs. */
     std::cerr << "IMB_exr_begin_write: UNKNOWN ERROR" << std::endl;
 
     delete data->ofile;
+    delete data->mpofile;
     delete data->ofile_stream;
 
     data->ofile = nullptr;
+    data->mpofile = nullptr;
     data->ofile_stream = nullptr;
   }
 
-  return (data->ofile != nullptr);
+  return (data->ofile != nullptr || data->mpofile != nullptr);
 }
 
 void IMB_exrtile_begin_write(
@@ -1040,7 +1085,12 @@ bool IMB_exr_begin_read(
     imb_exr_get_views(*data->ifile, *data->multiView);
 
     std::vector<MultiViewChannelName> channels;
-    GetChannelsInMultiPartFile(*data->ifile, channels);
+    if (exr_is_blender_multipart_file(*data->ifile)) {
+      channels = exr_channels_in_multi_part_file(*data->ifile);
+    }
+    else {
+      GetChannelsInMultiPartFile(*data->ifile, channels);
+    }
 
     for (const MultiViewChannelName &channel : channels) {
       IMB_exr_add_channel(
@@ -1142,9 +1192,10 @@ void IMB_exr_clear_channels(void *handle)
 void IMB_exr_write_channels(void *handle)
 {
   ExrHandle *data = (ExrHandle *)handle;
-  FrameBuffer frameBuffer;
 
   if (data->channels.first) {
+    /* A frame buffer for every part, there is only one for single part files. */
+    std::vector<FrameBuffer> frame_buffers(data->mpofile ? data->mpofile->parts() : 1);
     const size_t num_pixels = size_t(data->width) * data->height;
     half *rect_half = nullptr, *current_rect_half = nullptr;
 
@@ -1156,6 +1207,8 @@ void IMB_exr_write_channels(void *handle)
     }
 
     LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+      FrameBuffer &frameBuffer = frame_buffers[data->mpofile ? echan->m->part_number : 0];
+
       /* Writing starts from last scan-line, stride negative. */
       if (echan->use_half_float) {
         float *rect = echan->rect;
@@ -1179,9 +1232,18 @@ void IMB_exr_write_channels(void *handle)
       }
     }
 
-    data->ofile->setFrameBuffer(frameBuffer);
     try {
-      data->ofile->writePixels(data->height);
+      if (data->mpofile) {
+        for (int part = 0; part < data->mpofile->parts(); part++) {
+          OutputPart out(*data->mpofile, part);
+          out.setFrameBuffer(frame_buffers[part]);
+          out.writePixels(data->height);
+        }
+      }
+      else {
+        data->ofile->setFrameBuffer(frame_buffers[0]);
+        data->ofile->writePixels(data->height);
+      }
     }
     catch (const std::exception &exc) {
       std::cerr << "OpenEXR-writePixels: ERROR: " << exc.what() << std::endl;
@@ -1251,10 +1313,28 @@ void IMB_exrtile_write_channels(
 }
 
 void IMB_exr_read_channels(void *handle)
+{
+  ExrHandle *data = (ExrHandle *)handle;
+  rcti region;
+  BLI_rcti_init(&region, 0, data->width, 0, data->height);
+  IMB_exr_read_channels_region(handle, &region);
+}
+
+void IMB_exr_read_channels_region(void *handle, const rcti *region)
 {
   ExrHandle *data = (ExrHandle *)handle;
   int numparts = data->ifile->parts();
 
+  const int region_width = BLI_rcti_size_x(region);
+  const int region_height = BLI_rcti_size_y(region);
+  if (region_width <= 0 || region_height <= 0) {
+    return;
+  }
+
+  /* Scan-lines are always decoded for the full width of the data window, so channels are read
+   * into temporary full width buffers when only a part of the width is needed. */
+  const bool is_cropped_x = region->xmin != 0 || region->xmax != data->width;
+
   /* Check if EXR was saved with previous versions of blender which flipped images. */
   const StringAttribute *ta = data->ifile->header(0).findTypedAttribute<StringAttribute>(
       "BlenderMultiChannel");
@@ -1271,13 +1351,40 @@ void IMB_exr_read_channels(void *handle)
       "internal_name");
 
   for (int i = 0; i < numparts; i++) {
+    /* Parts without any channel to read are skipped, so they are not decompressed. */
+    bool has_channels_to_read = false;
+    LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
+      if (echan->m->part_number == i && echan->rect) {
+        has_channels_to_read = true;
+        break;
+      }
+    }
+    if (!has_channels_to_read) {
+      continue;
+    }
+
     /* Read part header. */
     InputPart in(*data->ifile, i);
     Header header = in.header();
     Box2i dw = header.dataWindow();
 
+    /* Scan-lines overlapping the region, files are stored from top to bottom unless flipped. */
+    int ymin, ymax;
+    if (!flip) {
+      ymin = std::max(dw.min.y + data->height - region->ymax, dw.min.y);
+      ymax = std::min(dw.min.y + data->height - 1 - region->ymin, dw.max.y);
+    }
+    else {
+      ymin = std::max(dw.min.y + region->ymin, dw.min.y);
+      ymax = std::min(dw.min.y + region->ymax - 1, dw.max.y);
+    }
+    if (ymin > ymax) {
+      continue;
+    }
+
     /* Insert all matching channel into frame-buffer. */
     FrameBuffer frameBuffer;
+    std::vector<std::pair<ExrChannel *, float *>> cropped_channels;
 
     LISTBASE_FOREACH (ExrChannel *, echan, &data->channels) {
       if (echan->m->part_number != i) {
@@ -1292,38 +1399,68 @@ void IMB_exr_read_channels(void *handle)
 
       if (echan->rect) {
         float *rect = echan->rect;
-        size_t xstride = echan->xstride * sizeof(float);
-        size_t ystride = echan->ystride * sizeof(float);
+        int64_t xstride = echan->xstride;
+        int64_t ystride = echan->ystride;
+        int xmin = region->xmin;
+
+        if (is_cropped_x) {
+          rect = (float *)MEM_callocN(sizeof(float) * data->width * region_height,
+                                      "exr cropped channel");
+          cropped_channels.emplace_back(echan, rect);
+          xstride = 1;
+          ystride = data->width;
+          xmin = 0;
+        }
 
+        /* Offset the buffer such that data-window coordinates land on the region. */
+        rect -= xstride * (dw.min.x + xmin);
         if (!flip) {
-          /* Inverse correct first pixel for data-window coordinates. */
-          rect -= echan->xstride * (dw.min.x - dw.min.y * data->width);
           /* Move to last scan-line to flip to Blender convention. */
-          rect += echan->xstride * (data->height - 1) * data->width;
+          rect += ystride * (dw.min.y + data->height - 1 - region->ymin);
           ystride = -ystride;
         }
         else {
-          /* Inverse correct first pixel for data-window coordinates. */
-          rect -= echan->xstride * (dw.min.x + dw.min.y * data->width);
+          rect -= ystride * (dw.min.y + region->ymin);
         }
 
         frameBuffer.insert(echan->m->internal_name,
-                           Slice(Imf::FLOAT, (char *)rect, xstride, ystride));
+                           Slice(Imf::FLOAT,
+                                 (char *)rect,
+                                 xstride * sizeof(float),
+                                 ystride * int64_t(sizeof(float))));
       }
     }
 
     /* Read pixels. */
+    bool success = true;
     try {
       in.setFrameBuffer(frameBuffer);
-      exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", i, dw.min.y, dw.max.y);
-      in.readPixels(dw.min.y, dw.max.y);
+      exr_printf("readPixels:readPixels[%d]: min.y: %d, max.y: %d\n", i, ymin, ymax);
+      in.readPixels(ymin, ymax);
     }
     catch (const std::exception &exc) {
       std::cerr << "OpenEXR-readPixels: ERROR: " << exc.what() << std::endl;
-      break;
+      success = false;
     }
     catch (...) { /* Catch-all for edge cases or compiler bugs. */
       std::cerr << "OpenEXR-readPixels: UNKNOWN ERROR: " << std::endl;
+      success = false;
+    }
+
+    for (const std::pair<ExrChannel *, float *> &item : cropped_channels) {
+      ExrChannel *echan = item.first;
+      const float *cropped_rect = item.second;
+      for (int y = 0; y < region_height; y++) {
+        const float *src = cropped_rect + size_t(y) * data->width + region->xmin;
+        float *dst = echan->rect + size_t(y) * echan->ystride;
+        for (int x = 0; x < region_width; x++) {
+          dst[size_t(x) * echan->xstride] = src[x];
+        }
+      }
+      MEM_freeN(item.second);
+    }
+
+    if (!success) {
       break;
     }
   }
@@ -1620,6 +1757,14 @@ static bool exr_has_xyz_channels(ExrHandle *exr_handle)
   return x_found && y_found && z_found;
 }
 
+/* Multi-part files written by Blender use the same channel names as single part files in every
+ * part, with the view stored in the part header. */
+static bool exr_is_blender_multipart_file(const MultiPartInputFile &file)
+{
+  return file.parts() > 1 &&
+         file.header(0).findTypedAttribute<StringAttribute>("BlenderMultiChannel") != nullptr;
+}
+
 /* Replacement for OpenEXR GetChannelsInMultiPartFile, that also handles the
  * case where parts are used for passes instead of multiview. */
 static std::vector<MultiViewChannelName> exr_channels_in_multi_part_file(
@@ -1637,6 +1782,9 @@ static std::vector<MultiViewChannelName> exr_channels_in_multi_part_file(
     }
   }
 
+  /* The part name is not a layer or pass name in multi-part files written by Blender. */
+  const bool is_blender_multipart = exr_is_blender_multipart_file(file);
+
   /* Get channels from each part. */
   for (int p = 0; p < file.parts(); p++) {
     const ChannelList &c = file.header(p).channels();
@@ -1659,12 +1807,16 @@ static std::vector<MultiViewChannelName> exr_channels_in_multi_part_file(
         m.view = viewFromChannelName(m.name, multiview);
         m.name = removeViewName(m.internal_name, m.view);
       }
+      else if (is_blender_multipart && !part_view.empty()) {
+        m.view = part_view;
+        m.name = removeViewName(m.internal_name, m.view);
+      }
       else {
         m.view = part_view;
       }
 
       /* Prepend part name as potential layer or pass name. */
-      if (!part_name.empty()) {
+      if (!part_name.empty() && !is_blender_multipart) {
         m.name = part_name + "." + m.name;
       }
 
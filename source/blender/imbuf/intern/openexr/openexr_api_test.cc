@@ -0,0 +1,194 @@
+/* SPDX-FileCopyrightText: 2024 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <array>
+#include <string>
+
+#include "BLI_array.hh"
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_rect.h"
+#include "BLI_tempfile.h"
+#include "BLI_utildefines.h"
+
+#include "DNA_scene_types.h"
+
+#include "IMB_openexr.hh"
+
+namespace blender::imbuf::tests {
+
+/* Big enough for ZIP compression to store the scan-lines in several blocks. */
+static constexpr int width = 13;
+static constexpr int height = 40;
+
+struct TestChannel {
+  const char *layer;
+  const char *pass;
+};
+
+/* Two layers, which are stored in separate parts of a multi-part file. */
+static const TestChannel test_channels[] = {
+    {"LayerA", "Combined.R"},
+    {"LayerA", "Combined.G"},
+    {"LayerB", "Depth.Z"},
+};
+static constexpr int test_channels_num = ARRAY_SIZE(test_channels);
+
+static float test_pixel_value(const int channel, const int x, const int y)
+{
+  return channel * 1000.0f + y * width + x;
+}
+
+class OpenEXRMultiPartTest : public testing::Test {
+ protected:
+  std::string filepath_;
+
+  void SetUp() override
+  {
+    char temp_dir[FILE_MAX];
+    BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+    filepath_ = std::string(temp_dir) + "imbuf_openexr_multipart_test.exr";
+
+    Array<Array<float>> rects(test_channels_num);
+    void *handle = IMB_exr_get_handle();
+    for (const int channel : IndexRange(test_channels_num)) {
+      rects[channel].reinitialize(width * height);
+      for (const int y : IndexRange(height)) {
+        for (const int x : IndexRange(width)) {
+          rects[channel][y * width + x] = test_pixel_value(channel, x, y);
+        }
+      }
+      IMB_exr_add_channel(handle,
+                          test_channels[channel].layer,
+                          test_channels[channel].pass,
+                          "",
+                          1,
+                          width,
+                          rects[channel].data(),
+                          false);
+    }
+    ASSERT_TRUE(IMB_exr_begin_write(
+        handle, filepath_.c_str(), width, height, R_IMF_EXR_CODEC_ZIP, nullptr, true));
+    IMB_exr_write_channels(handle);
+    IMB_exr_close(handle);
+  }
+
+  void TearDown() override
+  {
+    BLI_delete(filepath_.c_str(), false, false);
+  }
+
+  /**
+   * Read the given channels of the region from the file, channels which are not read stay
+   * empty. Every channel is stored in its own buffer with the size of the region.
+   */
+  Array<Array<float>> read_region(const rcti &region, const Span<bool> read_channels)
+  {
+    const int region_width = BLI_rcti_size_x(&region);
+    const int region_height = BLI_rcti_size_y(&region);
+
+    void *handle = IMB_exr_get_handle();
+    int file_width, file_height;
+    EXPECT_TRUE(
+        IMB_exr_begin_read(handle, filepath_.c_str(), &file_width, &file_height, false));
+    EXPECT_EQ(file_width, width);
+    EXPECT_EQ(file_height, height);
+
+    Array<Array<float>> rects(test_channels_num);
+    for (const int channel : IndexRange(test_channels_num)) {
+      if (!read_channels[channel]) {
+        continue;
+      }
+      rects[channel] = Array<float>(region_width * region_height, -1.0f);
+      const std::string name = std::string(test_channels[channel].layer) + "." +
+                               test_channels[channel].pass;
+      EXPECT_TRUE(IMB_exr_set_channel(
+          handle, nullptr, name.c_str(), 1, region_width, rects[channel].data()));
+    }
+    IMB_exr_read_channels_region(handle, &region);
+    IMB_exr_close(handle);
+    return rects;
+  }
+};
+
+TEST_F(OpenEXRMultiPartTest, ReadAll)
+{
+  void *handle = IMB_exr_get_handle();
+  int file_width, file_height;
+  ASSERT_TRUE(IMB_exr_begin_read(handle, filepath_.c_str(), &file_width, &file_height, true));
+  EXPECT_TRUE(IMB_exr_has_multilayer(handle));
+
+  Array<Array<float>> rects(test_channels_num);
+  for (const int channel : IndexRange(test_channels_num)) {
+    rects[channel].reinitialize(width * height);
+    EXPECT_TRUE(IMB_exr_set_channel(handle,
+                                    test_channels[channel].layer,
+                                    test_channels[channel].pass,
+                                    1,
+                                    width,
+                                    rects[channel].data()));
+  }
+  IMB_exr_read_channels(handle);
+  IMB_exr_close(handle);
+
+  for (const int channel : IndexRange(test_channels_num)) {
+    for (const int y : IndexRange(height)) {
+      for (const int x : IndexRange(width)) {
+        EXPECT_EQ(rects[channel][y * width + x], test_pixel_value(channel, x, y));
+      }
+    }
+  }
+}
+
+TEST_F(OpenEXRMultiPartTest, ReadRegion)
+{
+  const std::array<bool, test_channels_num> all_channels = {true, true, true};
+  rcti full;
+  BLI_rcti_init(&full, 0, width, 0, height);
+  const Array<Array<float>> full_rects = this->read_region(full, all_channels);
+
+  /* Regions covering the full width, which are read directly into the channel buffers, and
+   * regions cropped in x, which are read through temporary buffers. */
+  rcti regions[4];
+  BLI_rcti_init(&regions[0], 0, width, 5, 30);
+  BLI_rcti_init(&regions[1], 3, 10, 5, 30);
+  BLI_rcti_init(&regions[2], 0, 1, height - 1, height);
+  BLI_rcti_init(&regions[3], width - 4, width, 0, 17);
+
+  for (const rcti &region : regions) {
+    const int region_width = BLI_rcti_size_x(&region);
+    const int region_height = BLI_rcti_size_y(&region);
+    const Array<Array<float>> rects = this->read_region(region, all_channels);
+    for (const int channel : IndexRange(test_channels_num)) {
+      for (const int y : IndexRange(region_height)) {
+        for (const int x : IndexRange(region_width)) {
+          const int full_index = (region.ymin + y) * width + region.xmin + x;
+          EXPECT_EQ(rects[channel][y * region_width + x], full_rects[channel][full_index]);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(OpenEXRMultiPartTest, ReadSinglePart)
+{
+  rcti region;
+  BLI_rcti_init(&region, 2, 9, 10, 20);
+  const std::array<bool, test_channels_num> layer_b_channels = {false, false, true};
+  const Array<Array<float>> rects = this->read_region(region, layer_b_channels);
+
+  EXPECT_TRUE(rects[0].is_empty());
+  EXPECT_TRUE(rects[1].is_empty());
+  const int region_width = BLI_rcti_size_x(&region);
+  for (const int y : IndexRange(BLI_rcti_size_y(&region))) {
+    for (const int x : IndexRange(region_width)) {
+      EXPECT_EQ(rects[2][y * region_width + x],
+                test_pixel_value(2, region.xmin + x, region.ymin + y));
+    }
+  }
+}
+
+}  // namespace blender::imbuf::tests
@@ -42,7 +42,8 @@ bool IMB_exr_begin_write(void * /*handle*/,
                          int /*width*/,
                          int /*height*/,
                          int /*compress*/,
-                         const StampData * /*stamp*/)
+                         const StampData * /*stamp*/,
+                         bool /*multipart*/)
 {
   return false;
 }
@@ -74,6 +75,7 @@ float *IMB_exr_channel_rect(void * /*handle*/,
 }
 
 void IMB_exr_read_channels(void * /*handle*/) {}
+void IMB_exr_read_channels_region(void * /*handle*/, const rcti * /*region*/) {}
 void IMB_exr_write_channels(void * /*handle*/) {}
 void IMB_exrtile_write_channels(void * /*handle*/,
                                 int /*partx*/,
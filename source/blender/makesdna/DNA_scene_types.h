@@ -484,6 +484,8 @@ enum {
 enum {
   // R_IMF_FLAG_ZBUF = 1 << 0, /* DEPRECATED, and cleared. */
   R_IMF_FLAG_PREVIEW_JPG = 1 << 1,
+  /** Store each layer and view of multi-layer OpenEXR files in a separate part. */
+  R_IMF_FLAG_EXR_MULTIPART = 1 << 2,
 };
 
 /*  */
@@ -311,6 +311,12 @@ typedef struct SeqTimelineChannel {
 typedef struct EditingRuntime {
   struct SequenceLookup *sequence_lookup;
   MediaPresence *media_presence;
+  /** Frames shown and skipped by the current or last playback, see #SEQ_render_give_ibuf. */
+  int playback_frames_displayed;
+  int playback_frames_dropped;
+  int playback_last_frame;
+  char playback_is_active;
+  char _pad[3];
 } EditingRuntime;
 
 typedef struct Editing {
@@ -822,10 +828,6 @@ enum {
   SEQ_CACHE_STORE_COMPOSITE = (1 << 2),
   SEQ_CACHE_STORE_FINAL_OUT = (1 << 3),
 
-  /* For lookup purposes */
-  SEQ_CACHE_ALL_TYPES = SEQ_CACHE_STORE_RAW | SEQ_CACHE_STORE_PREPROCESSED |
-                        SEQ_CACHE_STORE_COMPOSITE | SEQ_CACHE_STORE_FINAL_OUT,
-
   SEQ_CACHE_OVERRIDE = (1 << 4),
 
   SEQ_CACHE_UNUSED_5 = (1 << 5),
@@ -837,6 +839,16 @@ enum {
   SEQ_CACHE_PREFETCH_ENABLE = (1 << 10),
   SEQ_CACHE_DISK_CACHE_ENABLE = (1 << 11),
   SEQ_CACHE_STORE_THUMBNAIL = (1 << 12),
+  /**
+   * Final frames transformed to the display space as 8-bit images, only used by the preview.
+   * Not stored in the disk cache, and invalidated when the display settings change.
+   */
+  SEQ_CACHE_STORE_DISPLAY = (1 << 13),
+
+  /* For lookup purposes */
+  SEQ_CACHE_ALL_TYPES = SEQ_CACHE_STORE_RAW | SEQ_CACHE_STORE_PREPROCESSED |
+                        SEQ_CACHE_STORE_COMPOSITE | SEQ_CACHE_STORE_FINAL_OUT |
+                        SEQ_CACHE_STORE_DISPLAY,
 };
 
 /** #Sequence.color_tag. */
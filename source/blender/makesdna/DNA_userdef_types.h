@@ -757,7 +757,8 @@ typedef struct UserDef_Experimental {
   char use_shader_node_previews;
   char use_animation_baklava;
   char use_docking;
-  char _pad[2];
+  char use_realtime_compositor_cpu;
+  char _pad[1];
   /** `makesdna` does not allow empty structs. */
 } UserDef_Experimental;
 
@@ -971,6 +972,13 @@ typedef struct UserDef {
   int prefetchframes;
   /** Control the rotation step of the view when PAD2, PAD4, PAD6&PAD8 is use. */
   float pad_rot_angle;
+  /** Memory limit of the compositor result cache in megabytes, zero disables the cache. */
+  int compositor_cache_limit;
+  /**
+   * Memory limit in megabytes of the intermediate results of chains of pixel operations in the
+   * compositor, above which they are rendered in bands.
+   */
+  int compositor_streaming_limit;
   char _pad12[4];
   /** Rotating view icon size. */
   short rvisize;
@@ -6312,6 +6312,14 @@ static void rna_def_scene_image_format_data(BlenderRNA *brna)
   RNA_def_property_enum_funcs(prop, nullptr, nullptr, "rna_ImageFormatSettings_exr_codec_itemf");
   RNA_def_property_ui_text(prop, "Codec", "Codec settings for OpenEXR");
   RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, nullptr);
+
+  prop = RNA_def_property(srna, "use_exr_multipart", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flag", R_IMF_FLAG_EXR_MULTIPART);
+  RNA_def_property_ui_text(prop,
+                           "Multi-Part",
+                           "Store each layer and view in a separate part of the file, so that "
+                           "reading a single layer does not require decompressing all of them");
+  RNA_def_property_update(prop, NC_SCENE | ND_RENDER_OPTIONS, nullptr);
 #  endif
 
 #  ifdef WITH_OPENJPEG
@@ -1257,6 +1257,22 @@ static void rna_SequenceEditor_overlay_frame_set(PointerRNA *ptr, int value)
   }
 }
 
+static float rna_SequenceEditor_disk_cache_read_speed_get(PointerRNA *ptr)
+{
+  Scene *scene = (Scene *)ptr->owner_id;
+  double read_speed, write_speed;
+  SEQ_cache_disk_throughput_get(scene, &read_speed, &write_speed);
+  return float(read_speed / (1024.0 * 1024.0));
+}
+
+static float rna_SequenceEditor_disk_cache_write_speed_get(PointerRNA *ptr)
+{
+  Scene *scene = (Scene *)ptr->owner_id;
+  double read_speed, write_speed;
+  SEQ_cache_disk_throughput_get(scene, &read_speed, &write_speed);
+  return float(write_speed / (1024.0 * 1024.0));
+}
+
 static void rna_SequenceEditor_display_stack(ID *id,
                                              Editing *ed,
                                              ReportList *reports,
@@ -2523,6 +2539,15 @@ static void rna_def_editor(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_STORE_FINAL_OUT);
   RNA_def_property_ui_text(prop, "Cache Final", "Cache final image for each frame");
 
+  prop = RNA_def_property(srna, "use_cache_display", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_STORE_DISPLAY);
+  RNA_def_property_ui_text(prop,
+                           "Cache Display",
+                           "Cache final images converted to the display space as 8-bit images, "
+                           "for faster playback in the preview using less memory than float "
+                           "images. Changing the color management settings clears this cache");
+  RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
+
   prop = RNA_def_property(srna, "use_prefetch", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "cache_flag", SEQ_CACHE_PREFETCH_ENABLE);
   RNA_def_property_ui_text(
@@ -2531,6 +2556,40 @@ static void rna_def_editor(BlenderRNA *brna)
       "Render frames ahead of current frame in the background for faster playback");
   RNA_def_property_update(prop, NC_SCENE | ND_SEQUENCER, nullptr);
 
+  prop = RNA_def_property(srna, "playback_frames_displayed", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "runtime.playback_frames_displayed");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop,
+                           "Displayed Frames",
+                           "Number of frames displayed by the current or last playback");
+
+  prop = RNA_def_property(srna, "playback_frames_dropped", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "runtime.playback_frames_dropped");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(
+      prop,
+      "Dropped Frames",
+      "Number of frames skipped by the current or last playback, because they could not be "
+      "rendered in time");
+
+  prop = RNA_def_property(srna, "disk_cache_read_speed", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_float_funcs(
+      prop, "rna_SequenceEditor_disk_cache_read_speed_get", nullptr, nullptr);
+  RNA_def_property_ui_text(prop,
+                           "Disk Cache Read Speed",
+                           "Average speed of reading images from the disk cache, in megabytes of "
+                           "uncompressed image data per second");
+
+  prop = RNA_def_property(srna, "disk_cache_write_speed", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_float_funcs(
+      prop, "rna_SequenceEditor_disk_cache_write_speed_get", nullptr, nullptr);
+  RNA_def_property_ui_text(prop,
+                           "Disk Cache Write Speed",
+                           "Average speed of compressing and writing images to the disk cache, in "
+                           "megabytes of uncompressed image data per second");
+
   /* functions */
 
   func = RNA_def_function(srna, "display_stack", "rna_SequenceEditor_display_stack");
@@ -6063,6 +6063,24 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "compositor_cache_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "compositor_cache_limit");
+  RNA_def_property_range(prop, 0, max_memory_in_megabytes_int());
+  RNA_def_property_ui_text(prop,
+                           "Compositor Cache Limit",
+                           "Memory used to keep compositor results between executions, so that "
+                           "only nodes affected by an edit are recomputed (in megabytes, zero "
+                           "disables the cache)");
+
+  prop = RNA_def_property(srna, "compositor_streaming_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "compositor_streaming_limit");
+  RNA_def_property_range(prop, 1, max_memory_in_megabytes_int());
+  RNA_def_property_ui_text(prop,
+                           "Compositor Streaming Limit",
+                           "Memory used by the intermediate results of chains of per-pixel "
+                           "compositor operations, chains needing more are computed in several "
+                           "bands (in megabytes)");
+
   /* Sequencer disk cache */
 
   prop = RNA_def_property(srna, "use_sequencer_disk_cache", PROP_BOOLEAN, PROP_NONE);
@@ -7470,6 +7488,13 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
       "The new 'layered' Action can contain the animation for multiple data-blocks at once");
   RNA_def_property_update(prop, 0, "rna_userdef_update");
 
+  prop = RNA_def_property(srna, "use_realtime_compositor_cpu", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(prop,
+                           "Realtime Compositor on CPU",
+                           "Evaluate the CPU compositor using the realtime compositor, node trees "
+                           "with nodes that are not yet supported on the CPU are evaluated using "
+                           "the existing CPU compositor");
+
   prop = RNA_def_property(srna, "use_docking", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(prop,
                            "Interactive Editor Docking",
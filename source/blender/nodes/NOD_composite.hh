@@ -66,6 +66,9 @@ void ntreeCompositUpdateRLayers(bNodeTree *ntree);
 
 void ntreeCompositClearTags(bNodeTree *ntree);
 
+/** Free results the compositor keeps between executions, see #COM_clear_caches. */
+void ntreeCompositClearCaches();
+
 bNodeSocket *ntreeCompositOutputFileAddSocket(bNodeTree *ntree,
                                               bNode *node,
                                               const char *name,
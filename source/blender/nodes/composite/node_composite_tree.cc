@@ -254,3 +254,10 @@ void ntreeCompositTagNeedExec(bNode *node)
 {
   node->runtime->need_exec = true;
 }
+
+void ntreeCompositClearCaches()
+{
+#ifdef WITH_COMPOSITOR_CPU
+  COM_clear_caches();
+#endif
+}
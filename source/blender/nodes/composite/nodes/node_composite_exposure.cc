@@ -6,6 +6,10 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_math_base.hh"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_material.hh"
 
 #include "COM_shader_node.hh"
@@ -38,6 +42,18 @@ class ExposureShaderNode : public ShaderNode {
 
     GPU_stack_link(material, &bnode(), "node_composite_exposure", inputs, outputs);
   }
+
+  bool is_cpu_supported() const override
+  {
+    return true;
+  }
+
+  void evaluate_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    const float4 color = inputs[0];
+    const float exposure = inputs[1].x;
+    outputs[0] = float4(color.xyz() * math::pow(2.0f, exposure), color.w);
+  }
 };
 
 static ShaderNode *get_compositor_shader_node(DNode node)
@@ -6,6 +6,9 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_material.hh"
 
 #include "COM_shader_node.hh"
@@ -43,6 +46,26 @@ class GammaShaderNode : public ShaderNode {
 
     GPU_stack_link(material, &bnode(), "node_composite_gamma", inputs, outputs);
   }
+
+  bool is_cpu_supported() const override
+  {
+    return true;
+  }
+
+  void evaluate_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    const float4 color = inputs[0];
+    const float gamma = inputs[1].x;
+
+    /* Keep the channels for which the power is undefined, like fallback_pow in the shader. */
+    float4 result = color;
+    for (int i = 0; i < 3; i++) {
+      if (color[i] > 0.0f || (color[i] == 0.0f && gamma > 0.0f)) {
+        result[i] = math::pow(color[i], gamma);
+      }
+    }
+    outputs[0] = result;
+  }
 };
 
 static ShaderNode *get_compositor_shader_node(DNode node)
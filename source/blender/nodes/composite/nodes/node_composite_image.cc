@@ -9,6 +9,7 @@
 #include "node_composite_util.hh"
 
 #include "BLI_linklist.h"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_rect.h"
 #include "BLI_string.h"
@@ -694,6 +695,11 @@ class RenderLayerOperation : public NodeOperation {
     const Scene *scene = reinterpret_cast<const Scene *>(bnode().id);
     const int view_layer = bnode().custom1;
 
+    if (!context().use_gpu()) {
+      execute_cpu(scene, view_layer);
+      return;
+    }
+
     Result &image_result = get_result("Image");
     Result &alpha_result = get_result("Alpha");
 
@@ -778,6 +784,91 @@ class RenderLayerOperation : public NodeOperation {
     GPU_texture_unbind(pass_texture);
     result.unbind_as_image();
   }
+
+  /* Same as execute but for contexts that do not use the GPU, where the passes are read from CPU
+   * buffers instead of textures. */
+  void execute_cpu(const Scene *scene, const int view_layer)
+  {
+    Result &image_result = get_result("Image");
+    Result &alpha_result = get_result("Alpha");
+
+    if (image_result.should_compute() || alpha_result.should_compute()) {
+      int channels_count = 0;
+      const float *combined_buffer = context().get_input_buffer(
+          scene, view_layer, RE_PASSNAME_COMBINED, &channels_count);
+      if (image_result.should_compute()) {
+        execute_pass_cpu(image_result, combined_buffer, channels_count, false);
+      }
+      if (alpha_result.should_compute()) {
+        execute_pass_cpu(alpha_result, combined_buffer, channels_count, true);
+      }
+    }
+
+    for (const bNodeSocket *output : this->node()->output_sockets()) {
+      if (STR_ELEM(output->identifier, "Image", "Alpha")) {
+        continue;
+      }
+
+      Result &result = get_result(output->identifier);
+      if (!result.should_compute()) {
+        continue;
+      }
+
+      context().populate_meta_data_for_pass(
+          scene, view_layer, output->identifier, result.meta_data);
+
+      int channels_count = 0;
+      const float *pass_buffer = context().get_input_buffer(
+          scene, view_layer, output->identifier, &channels_count);
+      execute_pass_cpu(result, pass_buffer, channels_count, false);
+    }
+  }
+
+  /* Same as execute_pass but reads the compositing region of the given pass buffer of the render
+   * size. Missing channels are zero, except for alpha, which is one, and pixels outside of the
+   * pass are clamped to its boundary, like texture loads in the read input shaders. If read_alpha
+   * is true, the alpha of the pass is read into all channels of the result. */
+  void execute_pass_cpu(Result &result,
+                        const float *pass_buffer,
+                        const int channels_count,
+                        const bool read_alpha)
+  {
+    if (pass_buffer == nullptr) {
+      /* Pass not rendered yet, or not supported by viewport. */
+      result.allocate_invalid();
+      context().set_info_message("Viewport compositor setup not fully supported");
+      return;
+    }
+
+    if (!context().is_valid_compositing_region()) {
+      result.allocate_invalid();
+      return;
+    }
+
+    const rcti compositing_region = context().get_compositing_region();
+    const int2 lower_bound = int2(compositing_region.xmin, compositing_region.ymin);
+    const int2 render_size = context().get_render_size();
+
+    const int2 compositing_region_size = context().get_compositing_region_size();
+    result.allocate_texture(Domain(compositing_region_size));
+
+    parallel_for(compositing_region_size, [&](const int2 texel) {
+      const int2 input_texel = math::clamp(texel + lower_bound, int2(0), render_size - int2(1));
+      const int64_t index = int64_t(input_texel.y) * render_size.x + input_texel.x;
+      const float *input = pass_buffer + index * channels_count;
+
+      float4 pixel = float4(0.0f, 0.0f, 0.0f, 1.0f);
+      for (const int i : IndexRange(channels_count)) {
+        pixel[i] = input[i];
+      }
+      result.store_pixel(texel, read_alpha ? float4(pixel.w) : pixel);
+    });
+  }
+
+  bool is_cpu_supported() const override
+  {
+    return true;
+  }
 };
 
 static NodeOperation *get_compositor_operation(Context &context, DNode node)
@@ -6,6 +6,9 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_material.hh"
 
 #include "COM_shader_node.hh"
@@ -95,7 +98,51 @@ class MathShaderNode : public ShaderNode {
              &get_output("Value").link);
   }
 
-  NodeMathOperation get_operation()
+  bool is_cpu_supported() const override
+  {
+    return true;
+  }
+
+  void evaluate_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    const float a = inputs[0].x;
+    const float b = inputs[1].x;
+    const float c = inputs[2].x;
+
+    float result = evaluate_operation(a, b, c);
+
+    if (get_should_clamp()) {
+      result = math::clamp(result, 0.0f, 1.0f);
+    }
+    outputs[0] = float4(result, 0.0f, 0.0f, 0.0f);
+  }
+
+  float evaluate_operation(const float a, const float b, const float c) const
+  {
+    float result = 0.0f;
+    const int operation = get_operation();
+    if (try_dispatch_float_math_fl_to_fl(
+            operation, [&](auto /*exec_preset*/, auto function, const FloatMathOperationInfo &) {
+              result = function(a);
+            }))
+    {
+      return result;
+    }
+    if (try_dispatch_float_math_fl_fl_to_fl(
+            operation, [&](auto /*exec_preset*/, auto function, const FloatMathOperationInfo &) {
+              result = function(a, b);
+            }))
+    {
+      return result;
+    }
+    try_dispatch_float_math_fl_fl_fl_to_fl(
+        operation, [&](auto /*exec_preset*/, auto function, const FloatMathOperationInfo &) {
+          result = function(a, b, c);
+        });
+    return result;
+  }
+
+  NodeMathOperation get_operation() const
   {
     return (NodeMathOperation)bnode().custom1;
   }
@@ -105,7 +152,7 @@ class MathShaderNode : public ShaderNode {
     return get_float_math_operation_info(get_operation())->shader_name.c_str();
   }
 
-  bool get_should_clamp()
+  bool get_should_clamp() const
   {
     return bnode().custom2 & SHD_MATH_CLAMP;
   }
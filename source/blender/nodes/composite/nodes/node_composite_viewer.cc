@@ -6,6 +6,8 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
 
 #include "BKE_global.hh"
@@ -61,6 +63,11 @@ class ViewerOperation : public NodeOperation {
       return;
     }
 
+    if (!context().use_gpu()) {
+      execute_cpu();
+      return;
+    }
+
     const Result &image = get_input("Image");
     const Result &alpha = get_input("Alpha");
 
@@ -227,6 +234,71 @@ class ViewerOperation : public NodeOperation {
     GPU_shader_unbind();
   }
 
+  /* Same as execute but for contexts that do not use the GPU, where the pixels are written to the
+   * viewer output buffer directly. The alpha is handled like in the GPU code paths above. */
+  void execute_cpu()
+  {
+    const Result &image = get_input("Image");
+    const Result &alpha = get_input("Alpha");
+
+    const Domain domain = compute_domain();
+    float *output_buffer = context().get_viewer_output_buffer(domain,
+                                                              image.meta_data.is_non_color_data);
+    if (!output_buffer) {
+      return;
+    }
+
+    const bool is_opaque = ignore_alpha();
+    const bool use_alpha_input = !is_opaque &&
+                                 node().input_by_identifier("Alpha")->is_logically_linked();
+    auto compute_color = [&](const int2 &texel) {
+      float4 color = image.load_pixel(texel);
+      if (is_opaque) {
+        color.w = 1.0f;
+      }
+      else if (use_alpha_input) {
+        color.w = alpha.load_pixel(texel).x;
+      }
+      return color;
+    };
+
+    /* A dedicated viewer buffer has the size of the domain, otherwise, the viewer is written into
+     * the compositing region of a buffer of the render size, see get_viewer_output_buffer. */
+    const int2 output_size = context().use_composite_output() ? domain.size :
+                                                                context().get_render_size();
+    auto store_color = [&](const int2 &output_texel, const float4 &color) {
+      const int64_t index = int64_t(output_texel.y) * output_size.x + output_texel.x;
+      copy_v4_v4(output_buffer + index * 4, color);
+    };
+
+    /* Single values clear the entire output, see execute_clear. */
+    if (image.is_single_value() && alpha.is_single_value()) {
+      const float4 color = compute_color(int2(0));
+      parallel_for(output_size, [&](const int2 texel) { store_color(texel, color); });
+      return;
+    }
+
+    int2 lower_bound = int2(0);
+    int2 upper_bound = output_size;
+    if (!context().use_composite_output()) {
+      const rcti compositing_region = context().get_compositing_region();
+      lower_bound = int2(compositing_region.xmin, compositing_region.ymin);
+      upper_bound = math::min(int2(compositing_region.xmax, compositing_region.ymax),
+                              output_size);
+    }
+    parallel_for(domain.size, [&](const int2 texel) {
+      const int2 output_texel = texel + lower_bound;
+      if (output_texel.x < upper_bound.x && output_texel.y < upper_bound.y) {
+        store_color(output_texel, compute_color(texel));
+      }
+    });
+  }
+
+  bool is_cpu_supported() const override
+  {
+    return true;
+  }
+
   /* If true, the alpha channel of the image is set to 1, that is, it becomes opaque. If false, the
    * alpha channel of the image is retained, but only if the alpha input is not linked. If the
    * alpha input is linked, it the value of that input will be used as the alpha of the image. */
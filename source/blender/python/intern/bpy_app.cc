@@ -41,6 +41,7 @@
 #include "BKE_blender_version.h"
 #include "BKE_global.hh"
 #include "BKE_main.hh"
+#include "BKE_subdiv_topology.hh"
 
 #include "DNA_ID.h"
 
@@ -618,6 +619,36 @@ static PyObject *bpy_app_help_text(PyObject * /*self*/, PyObject *args, PyObject
   return result;
 }
 
+PyDoc_STRVAR(
+    /* Wrap. */
+    bpy_app_subdivision_topology_cache_stats_doc,
+    ".. staticmethod:: subdivision_topology_cache_stats()\n"
+    "\n"
+    "   Statistics of the cache which shares subdivision topology refiners between meshes with "
+    "identical topology.\n"
+    "\n"
+    "   :return: Dictionary with the number of cache ``hits`` and ``misses``, the number of "
+    "cached ``refiners`` and the number of ``users`` of those refiners.\n"
+    "   :rtype: dict[str, int]\n");
+static PyObject *bpy_app_subdivision_topology_cache_stats(PyObject * /*self*/)
+{
+  const blender::bke::subdiv::TopologyCacheStats stats =
+      blender::bke::subdiv::topology_cache_stats_get();
+  PyObject *result = PyDict_New();
+  const std::pair<const char *, int64_t> items[] = {
+      {"hits", stats.hits},
+      {"misses", stats.misses},
+      {"refiners", stats.refiners_num},
+      {"users", stats.users_num},
+  };
+  for (const std::pair<const char *, int64_t> &item : items) {
+    PyObject *value = PyLong_FromLongLong(item.second);
+    PyDict_SetItemString(result, item.first, value);
+    Py_DECREF(value);
+  }
+  return result;
+}
+
 #if (defined(__GNUC__) && !defined(__clang__))
 #  pragma GCC diagnostic push
 #  pragma GCC diagnostic ignored "-Wcast-function-type"
@@ -632,6 +663,10 @@ static PyMethodDef bpy_app_methods[] = {
      (PyCFunction)bpy_app_help_text,
      METH_VARARGS | METH_KEYWORDS | METH_STATIC,
      bpy_app_help_text_doc},
+    {"subdivision_topology_cache_stats",
+     (PyCFunction)bpy_app_subdivision_topology_cache_stats,
+     METH_NOARGS | METH_STATIC,
+     bpy_app_subdivision_topology_cache_stats_doc},
     {nullptr, nullptr, 0, nullptr},
 };
 
@@ -22,14 +22,17 @@ struct Scene;
  *
  * Implementation of the compositor for final rendering, as opposed to the viewport compositor
  * that is part of the draw manager. The input and output of this is pre-existing RenderResult
- * buffers in scenes, that are uploaded to and read back from the GPU. */
+ * buffers in scenes, that are uploaded to and read back from the GPU, or used directly if the
+ * compositor is evaluated on the CPU. */
 
 namespace blender::render {
 class RealtimeCompositor;
 }
 
-/* Execute compositor. */
-void RE_compositor_execute(Render &render,
+/* Execute compositor. Returns false if the compositor is evaluated on the CPU and the node tree
+ * has nodes that are not supported on the CPU, in which case, nothing was written to the render
+ * result and the caller should evaluate the node tree using the CPU compositor instead. */
+bool RE_compositor_execute(Render &render,
                            const Scene &scene,
                            const RenderData &render_data,
                            const bNodeTree &node_tree,
@@ -163,9 +163,25 @@ class Context : public realtime_compositor::Context {
   /* Cached textures that the compositor took ownership of. */
   Vector<GPUTexture *> textures_;
 
+  /* True if the compositor is evaluated on the GPU, otherwise, the CPU buffers below are used
+   * instead of the textures above. */
+  const bool use_gpu_;
+
+  /* Output combined buffer and its size, used when evaluating on the CPU. */
+  float *output_buffer_ = nullptr;
+  int2 output_buffer_size_ = int2(0);
+
+  /* Viewer output buffer and its size, used when evaluating on the CPU. */
+  float *viewer_output_buffer_ = nullptr;
+  int2 viewer_output_buffer_size_ = int2(0);
+
+  /* Image buffers of the render passes read by the compositor on the CPU, referenced until the
+   * evaluation ends. */
+  Vector<ImBuf *> input_buffers_;
+
  public:
-  Context(const ContextInputData &input_data, TexturePool &texture_pool)
-      : realtime_compositor::Context(texture_pool), input_data_(input_data)
+  Context(const ContextInputData &input_data, TexturePool &texture_pool, const bool use_gpu)
+      : realtime_compositor::Context(texture_pool), input_data_(input_data), use_gpu_(use_gpu)
   {
   }
 
@@ -176,6 +192,9 @@ class Context : public realtime_compositor::Context {
     for (GPUTexture *texture : textures_) {
       GPU_texture_free(texture);
     }
+    MEM_SAFE_FREE(output_buffer_);
+    MEM_SAFE_FREE(viewer_output_buffer_);
+    release_input_buffers();
   }
 
   void update_input_data(const ContextInputData &input_data)
@@ -277,6 +296,14 @@ class Context : public realtime_compositor::Context {
           nullptr);
     }
 
+    update_viewer_image(domain, is_data);
+
+    return viewer_output_texture_;
+  }
+
+  /* Sets the backdrop offset and view settings of the viewer image for the given viewer domain. */
+  void update_viewer_image(const realtime_compositor::Domain &domain, const bool is_data)
+  {
     Image *image = BKE_image_ensure_viewer(G.main, IMA_TYPE_COMPOSITE, "Viewer Node");
     const float2 translation = domain.transformation.location();
     image->runtime.backdrop_offset[0] = translation.x;
@@ -288,8 +315,41 @@ class Context : public realtime_compositor::Context {
     else {
       image->flag |= IMA_VIEW_AS_RENDER;
     }
+  }
 
-    return viewer_output_texture_;
+  float *get_output_buffer() override
+  {
+    const int2 size = get_render_size();
+    if (output_buffer_ && output_buffer_size_ != size) {
+      MEM_SAFE_FREE(output_buffer_);
+    }
+
+    if (output_buffer_ == nullptr) {
+      output_buffer_ = static_cast<float *>(
+          MEM_calloc_arrayN(size_t(size.x) * size.y * 4, sizeof(float), __func__));
+      output_buffer_size_ = size;
+    }
+
+    return output_buffer_;
+  }
+
+  float *get_viewer_output_buffer(realtime_compositor::Domain domain, const bool is_data) override
+  {
+    /* Re-create buffer if the viewer size changes. */
+    const int2 size = domain.size;
+    if (viewer_output_buffer_ && viewer_output_buffer_size_ != size) {
+      MEM_SAFE_FREE(viewer_output_buffer_);
+    }
+
+    if (viewer_output_buffer_ == nullptr) {
+      viewer_output_buffer_ = static_cast<float *>(
+          MEM_calloc_arrayN(size_t(size.x) * size.y * 4, sizeof(float), __func__));
+      viewer_output_buffer_size_ = size;
+    }
+
+    update_viewer_image(domain, is_data);
+
+    return viewer_output_buffer_;
   }
 
   GPUTexture *get_input_texture(const Scene *scene,
@@ -332,6 +392,63 @@ class Context : public realtime_compositor::Context {
     return input_texture;
   }
 
+  const float *get_input_buffer(const Scene *scene,
+                                int view_layer_id,
+                                const char *pass_name,
+                                int *r_channels_count) override
+  {
+    Render *re = RE_GetSceneRender(scene);
+    RenderResult *rr = nullptr;
+    const float *input_buffer = nullptr;
+
+    if (re) {
+      rr = RE_AcquireResultRead(re);
+    }
+
+    if (rr) {
+      ViewLayer *view_layer = (ViewLayer *)BLI_findlink(&scene->view_layers, view_layer_id);
+      if (view_layer) {
+        RenderLayer *rl = RE_GetRenderLayer(rr, view_layer->name);
+        if (rl) {
+          RenderPass *rpass = RE_pass_find_by_name(rl, pass_name, get_view_name().data());
+
+          /* Unlike textures, buffers do not carry their size, so they are read assuming the
+           * render size, which might not be the case for stale render results. */
+          if (rpass && rpass->ibuf && rpass->ibuf->float_buffer.data &&
+              int2(rpass->rectx, rpass->recty) == get_render_size())
+          {
+            /* Don't assume render keeps the buffer around, add our own reference. */
+            IMB_refImBuf(rpass->ibuf);
+            input_buffers_.append(rpass->ibuf);
+            input_buffer = rpass->ibuf->float_buffer.data;
+            *r_channels_count = rpass->channels;
+          }
+        }
+      }
+    }
+
+    if (re) {
+      RE_ReleaseResult(re);
+      re = nullptr;
+    }
+
+    return input_buffer;
+  }
+
+  /* Releases the references to the render pass buffers acquired during evaluation. */
+  void release_input_buffers()
+  {
+    for (ImBuf *buffer : input_buffers_) {
+      IMB_freeImBuf(buffer);
+    }
+    input_buffers_.clear();
+  }
+
+  bool use_gpu() const override
+  {
+    return use_gpu_;
+  }
+
   StringRef get_view_name() const override
   {
     return input_data_.view_name;
@@ -456,7 +573,7 @@ class Context : public realtime_compositor::Context {
 
   void output_to_render_result()
   {
-    if (!output_texture_) {
+    if (!output_texture_ && !output_buffer_) {
       return;
     }
 
@@ -466,8 +583,17 @@ class Context : public realtime_compositor::Context {
     if (rr) {
       RenderView *rv = RE_RenderViewGetByName(rr, input_data_.view_name.c_str());
 
-      GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
-      float *output_buffer = (float *)GPU_texture_read(output_texture_, GPU_DATA_FLOAT, 0);
+      float *output_buffer = nullptr;
+      if (use_gpu_) {
+        GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
+        output_buffer = (float *)GPU_texture_read(output_texture_, GPU_DATA_FLOAT, 0);
+      }
+      else {
+        /* Hand the buffer over to the render result, a new one is allocated for the next
+         * evaluation. */
+        output_buffer = output_buffer_;
+        output_buffer_ = nullptr;
+      }
 
       if (output_buffer) {
         ImBuf *ibuf = RE_RenderViewEnsureImBuf(rr, rv);
@@ -493,7 +619,7 @@ class Context : public realtime_compositor::Context {
 
   void viewer_output_to_viewer_image()
   {
-    if (!viewer_output_texture_) {
+    if (!viewer_output_texture_ && !viewer_output_buffer_) {
       return;
     }
 
@@ -514,8 +640,9 @@ class Context : public realtime_compositor::Context {
     void *lock;
     ImBuf *image_buffer = BKE_image_acquire_ibuf(image, &image_user, &lock);
 
-    const int2 size = int2(GPU_texture_width(viewer_output_texture_),
-                           GPU_texture_height(viewer_output_texture_));
+    const int2 size = use_gpu_ ? int2(GPU_texture_width(viewer_output_texture_),
+                                      GPU_texture_height(viewer_output_texture_)) :
+                                 viewer_output_buffer_size_;
     if (image_buffer->x != size.x || image_buffer->y != size.y) {
       imb_freerectImBuf(image_buffer);
       imb_freerectfloatImBuf(image_buffer);
@@ -528,13 +655,21 @@ class Context : public realtime_compositor::Context {
     BKE_image_release_ibuf(image, image_buffer, lock);
     BLI_thread_unlock(LOCK_DRAW_IMAGE);
 
-    GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
-    float *output_buffer = (float *)GPU_texture_read(viewer_output_texture_, GPU_DATA_FLOAT, 0);
+    if (use_gpu_) {
+      GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
+      float *output_buffer = (float *)GPU_texture_read(
+          viewer_output_texture_, GPU_DATA_FLOAT, 0);
 
-    std::memcpy(
-        image_buffer->float_buffer.data, output_buffer, size.x * size.y * 4 * sizeof(float));
+      std::memcpy(
+          image_buffer->float_buffer.data, output_buffer, size.x * size.y * 4 * sizeof(float));
 
-    MEM_freeN(output_buffer);
+      MEM_freeN(output_buffer);
+    }
+    else {
+      std::memcpy(image_buffer->float_buffer.data,
+                  viewer_output_buffer_,
+                  size_t(size.x) * size.y * 4 * sizeof(float));
+    }
 
     BKE_image_partial_update_mark_full_update(image);
     if (input_data_.node_tree->runtime->update_draw) {
@@ -562,7 +697,7 @@ class Context : public realtime_compositor::Context {
      * once, and we can't cancel work that was already submitted to the GPU. This does have a
      * performance penalty, but in practice, the improved interactivity is worth it according to
      * user feedback. */
-    if (!this->render_context()) {
+    if (!this->render_context() && use_gpu_) {
       GPU_finish();
     }
   }
@@ -578,15 +713,26 @@ class RealtimeCompositor {
   std::unique_ptr<TexturePool> texture_pool_;
   std::unique_ptr<Context> context_;
 
+  /* True if the compositor is evaluated on the GPU, false if it is evaluated on the CPU, in which
+   * case, no GPU context is needed. */
+  const bool use_gpu_;
+
  public:
-  RealtimeCompositor(Render &render, const ContextInputData &input_data) : render_(render)
+  RealtimeCompositor(Render &render, const ContextInputData &input_data, const bool use_gpu)
+      : render_(render), use_gpu_(use_gpu)
   {
     texture_pool_ = std::make_unique<TexturePool>();
-    context_ = std::make_unique<Context>(input_data, *texture_pool_);
+    context_ = std::make_unique<Context>(input_data, *texture_pool_, use_gpu);
   }
 
   ~RealtimeCompositor()
   {
+    if (!use_gpu_) {
+      context_.reset();
+      texture_pool_.reset();
+      return;
+    }
+
     /* Free resources with GPU context enabled. Cleanup may happen from the
      * main thread, and we must use the main context there. */
     if (BLI_thread_is_main()) {
@@ -607,9 +753,20 @@ class RealtimeCompositor {
     }
   }
 
-  /* Evaluate the compositor and output to the scene render result. */
-  void execute(const ContextInputData &input_data)
+  bool use_gpu() const
+  {
+    return use_gpu_;
+  }
+
+  /* Evaluate the compositor and output to the scene render result. Returns false if the
+   * compositor is evaluated on the CPU and the node tree has nodes that are not supported on the
+   * CPU, in which case, nothing is written to the render result, see execute_cpu. */
+  bool execute(const ContextInputData &input_data)
   {
+    if (!use_gpu_) {
+      return execute_cpu(input_data);
+    }
+
     /* For main thread rendering in background mode, blocking rendering, or when we do not have a
      * render system GPU context, use the DRW context directly, while for threaded rendering when
      * we have a render system GPU context, use the render's system GPU context to avoid blocking
@@ -650,12 +807,39 @@ class RealtimeCompositor {
       void *re_system_gpu_context = RE_system_gpu_context_get(&render_);
       WM_system_gpu_context_release(re_system_gpu_context);
     }
+
+    return true;
+  }
+
+  /* Same as execute but evaluates the compositor on the CPU, so no GPU context is enabled. If the
+   * node tree has nodes that are not supported on the CPU, nothing is evaluated and false is
+   * returned, such that the caller can fall back to the CPU compositor instead of writing empty
+   * outputs. */
+  bool execute_cpu(const ContextInputData &input_data)
+  {
+    context_->update_input_data(input_data);
+
+    bool is_cpu_supported;
+    {
+      realtime_compositor::Evaluator evaluator(*context_);
+      evaluator.evaluate();
+      is_cpu_supported = evaluator.is_cpu_supported();
+    }
+
+    context_->release_input_buffers();
+    if (!is_cpu_supported) {
+      return false;
+    }
+
+    context_->output_to_render_result();
+    context_->viewer_output_to_viewer_image();
+    return true;
   }
 };
 
 }  // namespace blender::render
 
-void Render::compositor_execute(const Scene &scene,
+bool Render::compositor_execute(const Scene &scene,
                                 const RenderData &render_data,
                                 const bNodeTree &node_tree,
                                 const char *view_name,
@@ -667,11 +851,20 @@ void Render::compositor_execute(const Scene &scene,
   blender::render::ContextInputData input_data(
       scene, render_data, node_tree, view_name, render_context, profiler);
 
+  /* The compositor is evaluated on the CPU if the CPU device is selected, which is only the case
+   * if the realtime compositor is enabled for the CPU, see COM_execute. Re-create the compositor
+   * if the device changes, since its cached resources are specific to the device. */
+  const bool use_gpu = scene.r.compositor_device == SCE_COMPOSITOR_DEVICE_GPU;
+  if (gpu_compositor != nullptr && gpu_compositor->use_gpu() != use_gpu) {
+    delete gpu_compositor;
+    gpu_compositor = nullptr;
+  }
+
   if (gpu_compositor == nullptr) {
-    gpu_compositor = new blender::render::RealtimeCompositor(*this, input_data);
+    gpu_compositor = new blender::render::RealtimeCompositor(*this, input_data, use_gpu);
   }
 
-  gpu_compositor->execute(input_data);
+  return gpu_compositor->execute(input_data);
 }
 
 void Render::compositor_free()
@@ -684,7 +877,7 @@ void Render::compositor_free()
   }
 }
 
-void RE_compositor_execute(Render &render,
+bool RE_compositor_execute(Render &render,
                            const Scene &scene,
                            const RenderData &render_data,
                            const bNodeTree &node_tree,
@@ -692,7 +885,8 @@ void RE_compositor_execute(Render &render,
                            blender::realtime_compositor::RenderContext *render_context,
                            blender::realtime_compositor::Profiler *profiler)
 {
-  render.compositor_execute(scene, render_data, node_tree, view_name, render_context, profiler);
+  return render.compositor_execute(
+      scene, render_data, node_tree, view_name, render_context, profiler);
 }
 
 void RE_compositor_free(Render &render)
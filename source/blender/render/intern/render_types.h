@@ -46,8 +46,9 @@ struct BaseRender {
    * highlight. */
   virtual blender::render::TilesHighlight *get_tile_highlight() = 0;
 
-  /* GPU/realtime compositor. */
-  virtual void compositor_execute(const Scene &scene,
+  /* GPU/realtime compositor. Returns false if the compositor was not evaluated because it runs on
+   * the CPU and the node tree has nodes that are not supported on the CPU. */
+  virtual bool compositor_execute(const Scene &scene,
                                   const RenderData &render_data,
                                   const bNodeTree &node_tree,
                                   const char *view_name,
@@ -99,13 +100,14 @@ struct ViewRender : public BaseRender {
     return nullptr;
   }
 
-  void compositor_execute(const Scene & /*scene*/,
+  bool compositor_execute(const Scene & /*scene*/,
                           const RenderData & /*render_data*/,
                           const bNodeTree & /*node_tree*/,
                           const char * /*view_name*/,
                           blender::realtime_compositor::RenderContext * /*render_context*/,
                           blender::realtime_compositor::Profiler * /*profiler*/) override
   {
+    return true;
   }
   void compositor_free() override {}
 
@@ -144,7 +146,7 @@ struct Render : public BaseRender {
     return &tile_highlight;
   }
 
-  void compositor_execute(const Scene &scene,
+  bool compositor_execute(const Scene &scene,
                           const RenderData &render_data,
                           const bNodeTree &node_tree,
                           const char *view_name,
@@ -54,6 +54,12 @@ void SEQ_relations_check_uids_unique_and_report(const Scene *scene);
 void SEQ_relations_session_uid_generate(Sequence *sequence);
 
 void SEQ_cache_cleanup(Scene *scene);
+/**
+ * Average throughput of the disk cache in bytes of uncompressed image data per second.
+ */
+void SEQ_cache_disk_throughput_get(Scene *scene,
+                                   double *r_read_bytes_per_second,
+                                   double *r_write_bytes_per_second);
 void SEQ_cache_iterate(
     Scene *scene,
     void *userdata,
@@ -63,6 +63,18 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
 ImBuf *SEQ_render_give_ibuf_direct(const SeqRenderData *context,
                                    float timeline_frame,
                                    Sequence *seq);
+/**
+ * Like #SEQ_render_give_ibuf, but the result is an 8-bit image already transformed to the view
+ * and display settings of the scene, which can be drawn without further color management.
+ *
+ * \return The image buffer or NULL when #SEQ_CACHE_STORE_DISPLAY is disabled or nothing is
+ * shown, in which case #SEQ_render_give_ibuf should be used.
+ *
+ * \note The returned #ImBuf has its reference increased, free after usage!
+ */
+ImBuf *SEQ_render_give_display_ibuf(const SeqRenderData *context,
+                                    float timeline_frame,
+                                    int chanshown);
 /**
  * Render the series of thumbnails and store in cache.
  */
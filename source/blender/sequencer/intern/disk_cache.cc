@@ -6,9 +6,18 @@
  * \ingroup sequencer
  */
 
+#include <atomic>
 #include <cstddef>
 #include <ctime>
+#include <fcntl.h>
 #include <memory.h>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+
+#include <zstd.h>
 
 #include "MEM_guardedalloc.h"
 
@@ -25,8 +34,13 @@
 #include "BLI_fileops.h"
 #include "BLI_fileops_types.h"
 #include "BLI_listbase.h"
+#include "BLI_mmap.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_time.h"
+#include "BLI_vector.hh"
 
 #include "BKE_main.hh"
 
@@ -44,8 +58,10 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * ZLIB compression with user definable level can be used to compress image data(per image)
- * Images are written in order in which they are rendered.
+ * ZSTD compression with user definable level can be used to compress image data(per image).
+ * Bytes of float images are shuffled before compression, see #byte_shuffle.
+ * Images are compressed and written by background tasks, in order in which they are rendered.
+ * Files are memory-mapped for reading.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
  * size specified in user preferences.
@@ -57,11 +73,20 @@
  * `<cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf`. */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_CURRENT_VERSION 3
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in IMB intern. */
+/* Write synchronously when this many writes are pending, so memory is not exhausted by images
+ * waiting to be written when the disk can't keep up. */
+#define DCACHE_MAX_PENDING_WRITES 8
+
+/** #DiskCacheHeaderEntry.flag */
+enum {
+  DCACHE_ENTRY_BYTE_SHUFFLE = (1 << 0),
+};
 
 struct DiskCacheHeaderEntry {
   uchar encoding;
+  uchar flag;
   uint64_t frameno;
   uint64_t size_compressed;
   uint64_t size_raw;
@@ -74,11 +99,21 @@ struct DiskCacheHeader {
 };
 
 struct SeqDiskCache {
-  Main *bmain;
-  int64_t timestamp;
-  ListBase files;
+  Main *bmain = nullptr;
+  int64_t timestamp = 0;
+  ListBase files = {nullptr, nullptr};
   ThreadMutex read_write_mutex;
-  size_t size_total;
+  size_t size_total = 0;
+
+  /** Compression and writing of images happens in background tasks. */
+  TaskPool *write_pool = nullptr;
+  std::atomic<int> pending_writes = 0;
+
+  /** Uncompressed bytes and time spent for throughput statistics, protected by the mutex. */
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+  double time_read = 0.0;
+  double time_written = 0.0;
 };
 
 struct DiskCacheFile {
@@ -403,6 +438,9 @@ void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
   int start;
   int end;
 
+  /* Pending writes could otherwise store outdated images after invalidation. */
+  BLI_task_pool_work_and_wait(disk_cache->write_pool);
+
   BLI_mutex_lock(&disk_cache->read_write_mutex);
 
   start = SEQ_time_left_handle_frame_get(scene, seq_changed) - DCACHE_IMAGES_PER_FILE;
@@ -413,53 +451,141 @@ void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
-static size_t deflate_imbuf_to_file(ImBuf *ibuf,
-                                    FILE *file,
-                                    int level,
-                                    DiskCacheHeaderEntry *header_entry)
+/**
+ * Group the bytes of 32-bit values by significance. Neighboring float pixels usually share their
+ * exponent and high mantissa bits, so this creates long runs of similar bytes that compress much
+ * better than interleaved values.
+ */
+static void byte_shuffle(const uchar *src, uchar *dst, const size_t size)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
+  const int64_t values_num = size / 4;
+  blender::threading::parallel_for(
+      blender::IndexRange(values_num), 65536, [&](const blender::IndexRange range) {
+        for (const int64_t i : range) {
+          for (const int64_t byte : blender::IndexRange(4)) {
+            dst[byte * values_num + i] = src[i * 4 + byte];
+          }
+        }
+      });
+}
 
-  /* Apply compression if wanted, otherwise just write directly to the file. */
-  if (level > 0) {
-    return BLI_file_zstd_from_mem_at_pos(
-        data, header_entry->size_raw, file, header_entry->offset, level);
-  }
+static void byte_unshuffle(const uchar *src, uchar *dst, const size_t size)
+{
+  const int64_t values_num = size / 4;
+  blender::threading::parallel_for(
+      blender::IndexRange(values_num), 65536, [&](const blender::IndexRange range) {
+        for (const int64_t i : range) {
+          for (const int64_t byte : blender::IndexRange(4)) {
+            dst[i * 4 + byte] = src[byte * values_num + i];
+          }
+        }
+      });
+}
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fwrite(data, 1, header_entry->size_raw, file);
+static void *imbuf_pixels_get(ImBuf *ibuf)
+{
+  return (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
+                                               (void *)ibuf->float_buffer.data;
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+static uint64_t imbuf_pixels_size_get(const ImBuf *ibuf)
 {
-  void *data = (ibuf->byte_buffer.data != nullptr) ? (void *)ibuf->byte_buffer.data :
-                                                     (void *)ibuf->float_buffer.data;
-  char header[4];
-  fseek(file, header_entry->offset, SEEK_SET);
-  if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
-    return 0;
+  if (ibuf->byte_buffer.data) {
+    return int64_t(ibuf->x) * ibuf->y * ibuf->channels;
   }
+  return int64_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
+}
 
-  /* Check if the data is compressed or raw. */
-  if (BLI_file_magic_is_zstd(header)) {
-    return BLI_file_unzstd_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
+/**
+ * Compress the pixels of the image into memory, so this can happen without holding the lock.
+ * Returns an empty vector if the pixels are to be stored uncompressed.
+ */
+static blender::Vector<uchar> compress_imbuf(ImBuf *ibuf, const int level, uchar *r_flag)
+{
+  *r_flag = 0;
+  if (level <= 0) {
+    return {};
+  }
+
+  const uchar *data = static_cast<const uchar *>(imbuf_pixels_get(ibuf));
+  const size_t size_raw = imbuf_pixels_size_get(ibuf);
+
+  blender::Vector<uchar> shuffled;
+  if (ibuf->byte_buffer.data == nullptr) {
+    shuffled.resize(size_raw);
+    byte_shuffle(data, shuffled.data(), size_raw);
+    data = shuffled.data();
+  }
+
+  blender::Vector<uchar> compressed(ZSTD_compressBound(size_raw));
+  const size_t size_compressed = ZSTD_compress(
+      compressed.data(), compressed.size(), data, size_raw, level);
+  if (ZSTD_isError(size_compressed)) {
+    return {};
   }
 
+  compressed.resize(size_compressed);
+  if (!shuffled.is_empty()) {
+    *r_flag |= DCACHE_ENTRY_BYTE_SHUFFLE;
+  }
+  return compressed;
+}
+
+static size_t write_imbuf_to_file(ImBuf *ibuf,
+                                  FILE *file,
+                                  const blender::Span<uchar> compressed,
+                                  DiskCacheHeaderEntry *header_entry)
+{
   fseek(file, header_entry->offset, SEEK_SET);
-  return fread(data, 1, header_entry->size_raw, file);
+  if (!compressed.is_empty()) {
+    return fwrite(compressed.data(), 1, compressed.size(), file);
+  }
+  return fwrite(imbuf_pixels_get(ibuf), 1, header_entry->size_raw, file);
 }
 
-static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
+static bool read_imbuf_from_mmap(ImBuf *ibuf,
+                                 BLI_mmap_file *mmap_file,
+                                 const DiskCacheHeaderEntry *header_entry)
 {
-  BLI_fseek(file, 0LL, SEEK_SET);
-  const size_t num_items_read = fread(header, sizeof(*header), 1, file);
-  if (num_items_read < 1) {
-    BLI_assert_msg(0, "unable to read disk cache header");
-    perror("unable to read disk cache header");
+  const uchar *memory = static_cast<const uchar *>(BLI_mmap_get_pointer(mmap_file));
+  const size_t size_raw = header_entry->size_raw;
+  const size_t size_compressed = header_entry->size_compressed;
+  if (header_entry->offset + size_compressed > BLI_mmap_get_length(mmap_file) ||
+      size_compressed < 4)
+  {
+    return false;
+  }
+
+  uchar *data = static_cast<uchar *>(imbuf_pixels_get(ibuf));
+
+  /* Check if the data is compressed or raw. */
+  const char *header = reinterpret_cast<const char *>(memory + header_entry->offset);
+  if (!BLI_file_magic_is_zstd(header)) {
+    return size_compressed == size_raw &&
+           BLI_mmap_read(mmap_file, data, header_entry->offset, size_raw);
+  }
+
+  blender::Vector<uchar> shuffled;
+  uchar *decompressed = data;
+  if (header_entry->flag & DCACHE_ENTRY_BYTE_SHUFFLE) {
+    shuffled.resize(size_raw);
+    decompressed = shuffled.data();
+  }
+
+  const size_t size_decompressed = ZSTD_decompress(
+      decompressed, size_raw, memory + header_entry->offset, size_compressed);
+  if (ZSTD_isError(size_decompressed) || size_decompressed != size_raw) {
     return false;
   }
 
+  if (header_entry->flag & DCACHE_ENTRY_BYTE_SHUFFLE) {
+    byte_unshuffle(shuffled.data(), data, size_raw);
+  }
+  return true;
+}
+
+static void seq_disk_cache_header_endian_switch(DiskCacheHeader *header)
+{
   for (int i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
     if ((ENDIAN_ORDER == B_ENDIAN) && header->entry[i].encoding == 0) {
       BLI_endian_switch_uint64(&header->entry[i].frameno);
@@ -468,7 +594,19 @@ static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
       BLI_endian_switch_uint64(&header->entry[i].size_raw);
     }
   }
+}
 
+static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
+{
+  BLI_fseek(file, 0LL, SEEK_SET);
+  const size_t num_items_read = fread(header, sizeof(*header), 1, file);
+  if (num_items_read < 1) {
+    BLI_assert_msg(0, "unable to read disk cache header");
+    perror("unable to read disk cache header");
+    return false;
+  }
+
+  seq_disk_cache_header_endian_switch(header);
   return true;
 }
 
@@ -478,7 +616,9 @@ static size_t seq_disk_cache_write_header(FILE *file, const DiskCacheHeader *hea
   return fwrite(header, sizeof(*header), 1, file);
 }
 
-static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCacheHeader *header)
+static int seq_disk_cache_add_header_entry(const uint64_t frameno,
+                                           ImBuf *ibuf,
+                                           DiskCacheHeader *header)
 {
   int i;
   uint64_t offset = sizeof(*header);
@@ -510,17 +650,18 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
     header->entry[i].encoding = 0;
   }
 
+  header->entry[i].flag = 0;
   header->entry[i].offset = offset;
-  header->entry[i].frameno = key->frame_index;
+  header->entry[i].frameno = frameno;
+
+  header->entry[i].size_raw = imbuf_pixels_size_get(ibuf);
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
   if (ibuf->byte_buffer.data) {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels;
     colorspace_name = IMB_colormanagement_get_rect_colorspace(ibuf);
   }
   else {
-    header->entry[i].size_raw = int64_t(ibuf->x) * ibuf->y * ibuf->channels * 4;
     colorspace_name = IMB_colormanagement_get_float_colorspace(ibuf);
   }
   STRNCPY(header->entry[i].colorspace_name, colorspace_name);
@@ -539,13 +680,24 @@ static int seq_disk_cache_get_header_entry(SeqCacheKey *key, const DiskCacheHead
   return -1;
 }
 
-bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+struct DiskCacheWriteData {
+  char filepath[FILE_MAX];
+  uint64_t frameno;
+  ImBuf *ibuf;
+};
+
+static bool seq_disk_cache_write_data(SeqDiskCache *disk_cache, const DiskCacheWriteData &data)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  const double time_start = BLI_time_now_seconds();
 
-  char filepath[FILE_MAX];
+  /* Compress before taking the lock, so multiple images can be compressed at once. */
+  uchar flag;
+  const blender::Vector<uchar> compressed = compress_imbuf(
+      data.ibuf, seq_disk_cache_compression_level(), &flag);
 
-  seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+
+  const char *filepath = data.filepath;
   BLI_file_ensure_parent_dir_exists(filepath);
 
   /* Touch the file. */
@@ -570,10 +722,11 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return false;
   }
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
+  int entry_index = seq_disk_cache_add_header_entry(data.frameno, data.ibuf, &header);
+  header.entry[entry_index].flag = flag;
 
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
+  size_t bytes_written = write_imbuf_to_file(
+      data.ibuf, file, compressed, &header.entry[entry_index]);
 
   if (bytes_written != 0) {
     /* Last step is writing header, as image data can be overwritten,
@@ -584,40 +737,92 @@ bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf
     seq_disk_cache_update_file(disk_cache, filepath);
     fclose(file);
 
+    disk_cache->bytes_written += header.entry[entry_index].size_raw;
+    disk_cache->time_written += BLI_time_now_seconds() - time_start;
+
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return true;
   }
 
+  fclose(file);
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
   return false;
 }
 
+static void seq_disk_cache_write_task(TaskPool *__restrict pool, void *taskdata)
+{
+  SeqDiskCache *disk_cache = static_cast<SeqDiskCache *>(BLI_task_pool_user_data(pool));
+  const DiskCacheWriteData *data = static_cast<const DiskCacheWriteData *>(taskdata);
+
+  seq_disk_cache_write_data(disk_cache, *data);
+  seq_disk_cache_enforce_limits(disk_cache);
+  disk_cache->pending_writes--;
+}
+
+static void seq_disk_cache_write_data_free(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  DiskCacheWriteData *data = static_cast<DiskCacheWriteData *>(taskdata);
+  IMB_freeImBuf(data->ibuf);
+  MEM_delete(data);
+}
+
+bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  DiskCacheWriteData data;
+  seq_disk_cache_get_file_path(disk_cache, key, data.filepath, sizeof(data.filepath));
+  data.frameno = key->frame_index;
+  data.ibuf = ibuf;
+
+  if (disk_cache->pending_writes >= DCACHE_MAX_PENDING_WRITES) {
+    const bool success = seq_disk_cache_write_data(disk_cache, data);
+    seq_disk_cache_enforce_limits(disk_cache);
+    return success;
+  }
+
+  /* The image is not modified once it is in the cache, so it's safe to write it later. */
+  IMB_refImBuf(ibuf);
+  disk_cache->pending_writes++;
+  BLI_task_pool_push(disk_cache->write_pool,
+                     seq_disk_cache_write_task,
+                     MEM_new<DiskCacheWriteData>(__func__, data),
+                     true,
+                     seq_disk_cache_write_data_free);
+  return true;
+}
+
 ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
 {
-  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  const double time_start = BLI_time_now_seconds();
 
   char filepath[FILE_MAX];
-  DiskCacheHeader header;
-
   seq_disk_cache_get_file_path(disk_cache, key, filepath, sizeof(filepath));
-  BLI_file_ensure_parent_dir_exists(filepath);
 
-  FILE *file = BLI_fopen(filepath, "rb");
-  if (!file) {
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+
+  const int file = BLI_open(filepath, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
 
-  if (!seq_disk_cache_read_header(file, &header)) {
-    fclose(file);
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file);
+  DiskCacheHeader header;
+  if (mmap_file == nullptr || !BLI_mmap_read(mmap_file, &header, 0, sizeof(header))) {
+    if (mmap_file) {
+      BLI_mmap_free(mmap_file);
+    }
+    close(file);
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
+  seq_disk_cache_header_endian_switch(&header);
+
   int entry_index = seq_disk_cache_get_header_entry(key, &header);
 
   /* Item not found. */
   if (entry_index < 0) {
-    fclose(file);
+    BLI_mmap_free(mmap_file);
+    close(file);
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
@@ -625,49 +830,63 @@ ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
   ImBuf *ibuf;
   uint64_t size_char = uint64_t(key->context.rectx) * key->context.recty * 4;
   uint64_t size_float = uint64_t(key->context.rectx) * key->context.recty * 16;
-  size_t expected_size;
 
   if (header.entry[entry_index].size_raw == size_char) {
-    expected_size = size_char;
     ibuf = IMB_allocImBuf(
         key->context.rectx, key->context.recty, 32, IB_rect | IB_uninitialized_pixels);
     IMB_colormanagement_assign_byte_colorspace(ibuf, header.entry[entry_index].colorspace_name);
   }
   else if (header.entry[entry_index].size_raw == size_float) {
-    expected_size = size_float;
     ibuf = IMB_allocImBuf(
         key->context.rectx, key->context.recty, 32, IB_rectfloat | IB_uninitialized_pixels);
     IMB_colormanagement_assign_float_colorspace(ibuf, header.entry[entry_index].colorspace_name);
   }
   else {
-    fclose(file);
+    BLI_mmap_free(mmap_file);
+    close(file);
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
+  const bool success = read_imbuf_from_mmap(ibuf, mmap_file, &header.entry[entry_index]);
+  BLI_mmap_free(mmap_file);
+  close(file);
 
-  /* Sanity check. */
-  if (bytes_read != expected_size) {
-    fclose(file);
+  if (!success) {
     IMB_freeImBuf(ibuf);
     BLI_mutex_unlock(&disk_cache->read_write_mutex);
     return nullptr;
   }
   BLI_file_touch(filepath);
   seq_disk_cache_update_file(disk_cache, filepath);
-  fclose(file);
+
+  disk_cache->bytes_read += header.entry[entry_index].size_raw;
+  disk_cache->time_read += BLI_time_now_seconds() - time_start;
 
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
   return ibuf;
 }
 
+void seq_disk_cache_throughput_get(SeqDiskCache *disk_cache,
+                                   double *r_read_bytes_per_second,
+                                   double *r_write_bytes_per_second)
+{
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  *r_read_bytes_per_second = disk_cache->time_read > 0.0 ?
+                                 disk_cache->bytes_read / disk_cache->time_read :
+                                 0.0;
+  *r_write_bytes_per_second = disk_cache->time_written > 0.0 ?
+                                  disk_cache->bytes_written / disk_cache->time_written :
+                                  0.0;
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+}
+
 SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
 {
-  SeqDiskCache *disk_cache = static_cast<SeqDiskCache *>(
-      MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache"));
+  SeqDiskCache *disk_cache = MEM_new<SeqDiskCache>("SeqDiskCache");
   disk_cache->bmain = bmain;
   BLI_mutex_init(&disk_cache->read_write_mutex);
+  disk_cache->write_pool = BLI_task_pool_create_background(disk_cache, TASK_PRIORITY_LOW);
   seq_disk_cache_handle_versioning(disk_cache);
   seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
   disk_cache->timestamp = scene->ed->disk_cache_timestamp;
@@ -677,7 +896,9 @@ SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene)
 
 void seq_disk_cache_free(SeqDiskCache *disk_cache)
 {
+  BLI_task_pool_work_and_wait(disk_cache->write_pool);
+  BLI_task_pool_free(disk_cache->write_pool);
   BLI_freelistN(&disk_cache->files);
   BLI_mutex_end(&disk_cache->read_write_mutex);
-  MEM_freeN(disk_cache);
+  MEM_delete(disk_cache);
 }
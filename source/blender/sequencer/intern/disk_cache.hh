@@ -23,6 +23,10 @@ SeqDiskCache *seq_disk_cache_create(Main *bmain, Scene *scene);
 void seq_disk_cache_free(SeqDiskCache *disk_cache);
 bool seq_disk_cache_is_enabled(Main *bmain);
 ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key);
+/**
+ * Queue the image to be compressed and written in the background. The image is written
+ * synchronously when too many writes are pending already.
+ */
 bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf);
 bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache);
 void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
@@ -30,3 +34,10 @@ void seq_disk_cache_invalidate(SeqDiskCache *disk_cache,
                                Sequence *seq,
                                Sequence *seq_changed,
                                int invalidate_types);
+/**
+ * Average throughput of reads and writes in bytes of uncompressed image data per second, zero
+ * when nothing was read or written yet.
+ */
+void seq_disk_cache_throughput_get(SeqDiskCache *disk_cache,
+                                   double *r_read_bytes_per_second,
+                                   double *r_write_bytes_per_second);
@@ -12,6 +12,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "DNA_color_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h" /* for FILE_MAX. */
@@ -22,6 +23,7 @@
 #include "BLI_fileops_types.h"
 #include "BLI_ghash.h"
 #include "BLI_mempool.h"
+#include "BLI_string.h"
 #include "BLI_threads.h"
 
 #include "BKE_main.hh"
@@ -59,6 +61,10 @@
  * entries one by one in reverse order to their creation.
  *
  * User can exclude caching of some images. Such entries will have is_temp_cache set.
+ *
+ * #SEQ_CACHE_STORE_DISPLAY entries are final frames already transformed to the display space.
+ * They are not linked to other entries, never written to disk cache and are all freed when the
+ * view or display settings of the scene no longer match the ones they were created with.
  */
 
 #define THUMB_CACHE_LIMIT 5000
@@ -72,6 +78,10 @@ struct SeqCache {
   SeqCacheKey *last_key;
   SeqDiskCache *disk_cache;
   int thumbnail_count;
+  /* Settings used to create #SEQ_CACHE_STORE_DISPLAY entries. */
+  ColorManagedViewSettings display_view_settings;
+  ColorManagedDisplaySettings display_settings;
+  int display_curve_timestamp;
 };
 
 struct SeqCacheItem {
@@ -206,7 +216,7 @@ static int get_stored_types_flag(Scene *scene, SeqCacheKey *key)
   }
 
   /* SEQ_CACHE_STORE_FINAL_OUT can not be overridden by strip cache */
-  flag |= (scene->ed->cache_flag & SEQ_CACHE_STORE_FINAL_OUT);
+  flag |= (scene->ed->cache_flag & (SEQ_CACHE_STORE_FINAL_OUT | SEQ_CACHE_STORE_DISPLAY));
 
   return flag;
 }
@@ -246,7 +256,7 @@ static void seq_cache_put_ex(Scene *scene, SeqCacheKey *key, ImBuf *ibuf)
   }
 
   /* Reset linking. */
-  if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
+  if (ELEM(key->type, SEQ_CACHE_STORE_FINAL_OUT, SEQ_CACHE_STORE_DISPLAY)) {
     cache->last_key = nullptr;
   }
 }
@@ -608,6 +618,21 @@ void seq_cache_cleanup_all(Main *bmain)
     SEQ_cache_cleanup(scene);
   }
 }
+void SEQ_cache_disk_throughput_get(Scene *scene,
+                                   double *r_read_bytes_per_second,
+                                   double *r_write_bytes_per_second)
+{
+  *r_read_bytes_per_second = 0.0;
+  *r_write_bytes_per_second = 0.0;
+
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+  if (cache == nullptr || cache->disk_cache == nullptr) {
+    return;
+  }
+  seq_disk_cache_throughput_get(
+      cache->disk_cache, r_read_bytes_per_second, r_write_bytes_per_second);
+}
+
 void SEQ_cache_cleanup(Scene *scene)
 {
   SEQ_prefetch_stop(scene);
@@ -650,6 +675,11 @@ void seq_cache_cleanup_sequence(Scene *scene,
     seq_disk_cache_invalidate(cache->disk_cache, scene, seq, seq_changed, invalidate_types);
   }
 
+  /* Display space images are derived from final images. */
+  if (invalidate_types & SEQ_CACHE_STORE_FINAL_OUT) {
+    invalidate_types |= SEQ_CACHE_STORE_DISPLAY;
+  }
+
   seq_cache_lock(scene);
 
   const int range_start_seq_changed = seq_cache_timeline_frame_to_frame_index(
@@ -670,7 +700,8 @@ void seq_cache_cleanup_sequence(Scene *scene,
     range_end = min_ii(range_end, range_end_seq);
   }
 
-  int invalidate_composite = invalidate_types & SEQ_CACHE_STORE_FINAL_OUT;
+  int invalidate_composite = invalidate_types &
+                             (SEQ_CACHE_STORE_FINAL_OUT | SEQ_CACHE_STORE_DISPLAY);
   int invalidate_source = invalidate_types & (SEQ_CACHE_STORE_RAW | SEQ_CACHE_STORE_PREPROCESSED |
                                               SEQ_CACHE_STORE_COMPOSITE);
 
@@ -783,7 +814,7 @@ ImBuf *seq_cache_get(const SeqRenderData *context, Sequence *seq, float timeline
   }
 
   /* Try disk cache: */
-  if (seq_disk_cache_is_enabled(context->bmain)) {
+  if (seq_disk_cache_is_enabled(context->bmain) && type != SEQ_CACHE_STORE_DISPLAY) {
     if (cache->disk_cache == nullptr) {
       cache->disk_cache = seq_disk_cache_create(context->bmain, context->scene);
     }
@@ -896,18 +927,83 @@ void seq_cache_put(
   seq_cache_put_ex(scene, key, i);
   seq_cache_unlock(scene);
 
-  if (!key->is_temp_cache) {
+  if (!key->is_temp_cache && type != SEQ_CACHE_STORE_DISPLAY) {
     if (seq_disk_cache_is_enabled(context->bmain)) {
       if (cache->disk_cache == nullptr) {
         seq_disk_cache_create(context->bmain, context->scene);
       }
 
       seq_disk_cache_write_file(cache->disk_cache, key, i);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
     }
   }
 }
 
+static bool seq_cache_display_settings_equal(const SeqCache *cache, const Scene *scene)
+{
+  const ColorManagedViewSettings &a = cache->display_view_settings;
+  const ColorManagedViewSettings &b = scene->view_settings;
+  const int curve_timestamp = b.curve_mapping ? b.curve_mapping->changed_timestamp : 0;
+
+  return a.flag == b.flag && STREQ(a.look, b.look) && STREQ(a.view_transform, b.view_transform) &&
+         a.exposure == b.exposure && a.gamma == b.gamma && a.temperature == b.temperature &&
+         a.tint == b.tint && cache->display_curve_timestamp == curve_timestamp &&
+         STREQ(cache->display_settings.display_device, scene->display_settings.display_device);
+}
+
+void seq_cache_display_settings_validate(const SeqRenderData *context)
+{
+  Scene *scene = context->scene;
+  if (!scene->ed->cache) {
+    seq_cache_create(context->bmain, scene);
+  }
+
+  seq_cache_lock(scene);
+  SeqCache *cache = seq_cache_get_from_scene(scene);
+
+  if (!seq_cache_display_settings_equal(cache, scene)) {
+    GHashIterator gh_iter;
+    BLI_ghashIterator_init(&gh_iter, cache->hash);
+    while (!BLI_ghashIterator_done(&gh_iter)) {
+      SeqCacheKey *key = static_cast<SeqCacheKey *>(BLI_ghashIterator_getKey(&gh_iter));
+      BLI_ghashIterator_step(&gh_iter);
+      BLI_assert(key->cache_owner == cache);
+
+      if (key->type == SEQ_CACHE_STORE_DISPLAY) {
+        seq_cache_key_unlink(key);
+        BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
+      }
+    }
+    cache->last_key = nullptr;
+
+    cache->display_view_settings = scene->view_settings;
+    cache->display_view_settings.curve_mapping = nullptr;
+    cache->display_curve_timestamp = scene->view_settings.curve_mapping ?
+                                         scene->view_settings.curve_mapping->changed_timestamp :
+                                         0;
+    STRNCPY(cache->display_settings.display_device, scene->display_settings.display_device);
+  }
+
+  seq_cache_unlock(scene);
+}
+
+bool seq_cache_display_settings_match(const SeqRenderData *context)
+{
+  const Scene *scene = context->scene;
+  if (context->is_prefetch_render) {
+    context = seq_prefetch_get_original_context(context);
+  }
+
+  SeqCache *cache = seq_cache_get_from_scene(context->scene);
+  if (!cache) {
+    return false;
+  }
+
+  seq_cache_lock(context->scene);
+  const bool is_equal = seq_cache_display_settings_equal(cache, scene);
+  seq_cache_unlock(context->scene);
+  return is_equal;
+}
+
 void SEQ_cache_iterate(
     Scene *scene,
     void *userdata,
@@ -930,7 +1026,7 @@ void SEQ_cache_iterate(
     BLI_ghashIterator_step(&gh_iter);
     BLI_assert(key->cache_owner == cache);
     int timeline_frame;
-    if (key->type & SEQ_CACHE_STORE_FINAL_OUT) {
+    if (key->type & (SEQ_CACHE_STORE_FINAL_OUT | SEQ_CACHE_STORE_DISPLAY)) {
       timeline_frame = key->timeline_frame;
     }
     else {
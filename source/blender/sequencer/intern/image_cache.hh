@@ -59,3 +59,14 @@ void seq_cache_cleanup_sequence(Scene *scene,
 void seq_cache_thumbnail_cleanup(Scene *scene, rctf *r_view_area_safe);
 bool seq_cache_is_full();
 float seq_cache_frame_index_to_timeline_frame(Sequence *seq, float frame_index);
+/**
+ * Free all #SEQ_CACHE_STORE_DISPLAY entries when the view or display settings of the scene
+ * changed since they were created. Must be called from the main thread before looking up
+ * display space images.
+ */
+void seq_cache_display_settings_validate(const SeqRenderData *context);
+/**
+ * Check whether display space images created with the settings of the context scene can be
+ * stored in the cache. This is not the case when prefetching runs with outdated settings.
+ */
+bool seq_cache_display_settings_match(const SeqRenderData *context);
@@ -25,6 +25,7 @@
 #include "BLI_math_vector_types.hh"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_task.hh"
 
 #include "BKE_anim_data.hh"
 #include "BKE_animsys.h"
@@ -1168,6 +1169,23 @@ static IMB_Timecode_Type seq_render_movie_strip_timecode_get(Sequence *seq)
                                                IMB_TC_NONE);
 }
 
+/**
+ * Number of frames decoded ahead of the requested one during playback. Decoding of the next
+ * frames then overlaps with compositing of the current frame.
+ */
+#define SEQ_MOVIE_READ_AHEAD_FRAMES 2
+
+static int seq_render_movie_strip_read_ahead_get(const SeqRenderData *context,
+                                                 const Sequence *seq)
+{
+  /* Reversed strips request frames backwards, so frames after the requested one are useless. */
+  if ((!context->is_playing && !context->is_prefetch_render) || (seq->flag & SEQ_REVERSE_FRAMES))
+  {
+    return 0;
+  }
+  return SEQ_MOVIE_READ_AHEAD_FRAMES;
+}
+
 /**
  * Render individual view for multi-view or single (default view) for mono-view.
  */
@@ -1182,6 +1200,8 @@ static ImBuf *seq_render_movie_strip_view(const SeqRenderData *context,
   const int frame_index = round_fl_to_int(
       SEQ_give_frame_index(context->scene, seq, timeline_frame));
 
+  IMB_anim_set_read_ahead(sanim->anim, seq_render_movie_strip_read_ahead_get(context, seq));
+
   if (SEQ_can_use_proxy(context, seq, psize)) {
     /* Try to get a proxy image.
      * Movie proxies are handled by ImBuf module with exception of `custom file` setting. */
@@ -1994,6 +2014,71 @@ static bool is_opaque_alpha_over(const Sequence *seq)
   return true;
 }
 
+static bool seq_can_render_strip_in_parallel(const Sequence *seq)
+{
+  if (!ELEM(seq->type, SEQ_TYPE_MOVIE, SEQ_TYPE_IMAGE)) {
+    return false;
+  }
+  LISTBASE_FOREACH (const SequenceModifierData *, smd, &seq->modifiers) {
+    /* Mask inputs render other strips and data-blocks. */
+    if (smd->mask_sequence != nullptr || smd->mask_id != nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Render the strips of the stack that read media from disk in parallel, so decoding of multiple
+ * movies and images overlaps. The results end up in the cache, from where they are used when
+ * the stack is composited in order by #seq_render_strip_stack.
+ */
+static void seq_render_strip_stack_inputs_parallel(const SeqRenderData *context,
+                                                   const Span<Sequence *> strips,
+                                                   const float timeline_frame)
+{
+  if (context->skip_cache || context->is_proxy_render) {
+    return;
+  }
+
+  ImBuf *composite = seq_cache_get(
+      context, strips.last(), timeline_frame, SEQ_CACHE_STORE_COMPOSITE);
+  if (composite != nullptr) {
+    IMB_freeImBuf(composite);
+    return;
+  }
+
+  /* Gather strips from top to bottom until the first strip that hides the ones below, mirroring
+   * the early outs of the stack rendering loop. */
+  Vector<Sequence *> inputs;
+  for (int64_t i = strips.size() - 1; i >= 0; i--) {
+    Sequence *seq = strips[i];
+    const bool is_replace = seq->blend_mode == SEQ_BLEND_REPLACE;
+    if (!is_replace && seq_get_early_out_for_blend_mode(seq) == StripEarlyOut::UseInput1) {
+      continue;
+    }
+    if (seq_can_render_strip_in_parallel(seq)) {
+      inputs.append(seq);
+    }
+    /* Movies are assumed to have no alpha, they are usually opaque. */
+    if (is_replace || (seq->type == SEQ_TYPE_MOVIE && is_opaque_alpha_over(seq))) {
+      break;
+    }
+  }
+
+  if (inputs.size() < 2) {
+    return;
+  }
+
+  threading::parallel_for(inputs.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      SeqRenderState state;
+      ImBuf *ibuf = seq_render_strip(context, &state, inputs[i], timeline_frame);
+      IMB_freeImBuf(ibuf);
+    }
+  });
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *channels,
@@ -2007,6 +2092,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     return nullptr;
   }
 
+  seq_render_strip_stack_inputs_parallel(context, strips, timeline_frame);
+
   OpaqueQuadTracker opaques;
 
   int64_t i;
@@ -2109,6 +2196,76 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
   return out;
 }
 
+/**
+ * Count frames displayed and skipped during playback. Frames are skipped when rendering can not
+ * keep up with the frame rate.
+ */
+static void seq_render_playback_stats_update(const SeqRenderData *context,
+                                             Editing *ed,
+                                             const float timeline_frame)
+{
+  if (context->is_prefetch_render) {
+    return;
+  }
+
+  EditingRuntime &runtime = ed->runtime;
+  if (!context->is_playing) {
+    runtime.playback_is_active = false;
+    return;
+  }
+
+  const int frame = int(timeline_frame);
+  if (!runtime.playback_is_active) {
+    runtime.playback_is_active = true;
+    runtime.playback_frames_displayed = 0;
+    runtime.playback_frames_dropped = 0;
+  }
+  else if (frame > runtime.playback_last_frame + 1) {
+    runtime.playback_frames_dropped += frame - runtime.playback_last_frame - 1;
+  }
+  runtime.playback_frames_displayed++;
+  runtime.playback_last_frame = frame;
+}
+
+/**
+ * Create a copy of a final image transformed to the display space of the scene, which can be
+ * drawn without any further color management.
+ */
+static ImBuf *seq_render_display_ibuf_create(const SeqRenderData *context, ImBuf *ibuf)
+{
+  Scene *scene = context->scene;
+  ImBuf *display_ibuf = IMB_allocImBuf(ibuf->x, ibuf->y, 32, IB_rect | IB_uninitialized_pixels);
+  IMB_display_buffer_transform_ibuf(ibuf,
+                                    display_ibuf->byte_buffer.data,
+                                    &scene->view_settings,
+                                    &scene->display_settings);
+  IMB_metadata_copy(display_ibuf, ibuf);
+  return display_ibuf;
+}
+
+/**
+ * Store the display space version of a final image rendered by prefetching, so playback does not
+ * need to transform it again. Nothing is stored when the color management settings changed since
+ * prefetching started.
+ */
+static void seq_render_prefetch_display_ibuf_put(const SeqRenderData *context,
+                                                 Sequence *seq,
+                                                 const float timeline_frame,
+                                                 ImBuf *ibuf)
+{
+  /* Display images are only created here by the prefetch job, the main thread only does so
+   * for frames that were not prefetched. */
+  BLI_assert(context->is_prefetch_render);
+
+  if (ibuf == nullptr || !seq_cache_display_settings_match(context)) {
+    return;
+  }
+
+  ImBuf *display_ibuf = seq_render_display_ibuf_create(context, ibuf);
+  seq_cache_put(context, seq, timeline_frame, SEQ_CACHE_STORE_DISPLAY, display_ibuf);
+  IMB_freeImBuf(display_ibuf);
+}
+
 ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame, int chanshown)
 {
   Scene *scene = context->scene;
@@ -2131,14 +2288,33 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
     channels = ed->displayed_channels;
   }
 
+  seq_render_playback_stats_update(context, ed, timeline_frame);
+
   SeqRenderState state;
   ImBuf *out = nullptr;
 
   Vector<Sequence *> strips = seq_get_shown_sequences(
       scene, channels, seqbasep, timeline_frame, chanshown);
 
+  /* When prefetching for a preview which uses display space images, final images may not be kept
+   * in the cache, so look for the display space image first. Cache flags are cleared in the
+   * evaluated scene of the prefetch job, so they are read from the original scene. */
+  const bool prefetch_display_ibuf =
+      context->is_prefetch_render &&
+      (seq_prefetch_get_original_context(context)->scene->ed->cache_flag &
+       SEQ_CACHE_STORE_DISPLAY) != 0;
+  if (!strips.is_empty() && prefetch_display_ibuf) {
+    out = seq_cache_get(context, strips.last(), timeline_frame, SEQ_CACHE_STORE_DISPLAY);
+    if (out) {
+      return out;
+    }
+  }
+
   if (!strips.is_empty()) {
     out = seq_cache_get(context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT);
+    if (out && prefetch_display_ibuf) {
+      seq_render_prefetch_display_ibuf_put(context, strips.last(), timeline_frame, out);
+    }
   }
 
   seq_cache_free_temp_cache(context->scene, context->task_id, timeline_frame);
@@ -2151,6 +2327,9 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
 
     if (context->is_prefetch_render) {
       seq_cache_put(context, strips.last(), timeline_frame, SEQ_CACHE_STORE_FINAL_OUT, out);
+      if (prefetch_display_ibuf) {
+        seq_render_prefetch_display_ibuf_put(context, strips.last(), timeline_frame, out);
+      }
     }
     else {
       seq_cache_put_if_possible(
@@ -2164,6 +2343,47 @@ ImBuf *SEQ_render_give_ibuf(const SeqRenderData *context, float timeline_frame,
   return out;
 }
 
+ImBuf *SEQ_render_give_display_ibuf(const SeqRenderData *context,
+                                    float timeline_frame,
+                                    int chanshown)
+{
+  Scene *scene = context->scene;
+  Editing *ed = SEQ_editing_get(scene);
+
+  if (ed == nullptr || (ed->cache_flag & SEQ_CACHE_STORE_DISPLAY) == 0 ||
+      context->skip_cache || (chanshown < 0 && !BLI_listbase_is_empty(&ed->metastack)))
+  {
+    return nullptr;
+  }
+
+  Vector<Sequence *> strips = seq_get_shown_sequences(
+      scene, ed->displayed_channels, ed->seqbasep, timeline_frame, chanshown);
+  if (strips.is_empty()) {
+    return nullptr;
+  }
+
+  seq_cache_display_settings_validate(context);
+
+  ImBuf *display_ibuf = seq_cache_get(
+      context, strips.last(), timeline_frame, SEQ_CACHE_STORE_DISPLAY);
+  if (display_ibuf) {
+    seq_render_playback_stats_update(context, ed, timeline_frame);
+    seq_prefetch_start(context, timeline_frame);
+    return display_ibuf;
+  }
+
+  ImBuf *ibuf = SEQ_render_give_ibuf(context, timeline_frame, chanshown);
+  if (ibuf == nullptr) {
+    return nullptr;
+  }
+
+  display_ibuf = seq_render_display_ibuf_create(context, ibuf);
+  IMB_freeImBuf(ibuf);
+  seq_cache_put_if_possible(
+      context, strips.last(), timeline_frame, SEQ_CACHE_STORE_DISPLAY, display_ibuf);
+  return display_ibuf;
+}
+
 ImBuf *seq_render_give_ibuf_seqbase(const SeqRenderData *context,
                                     float timeline_frame,
                                     int chan_shown,
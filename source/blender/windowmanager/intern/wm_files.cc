@@ -666,6 +666,8 @@ static void wm_file_read_pre(bool use_data, bool /*use_userdef*/)
 {
   if (use_data) {
     BLI_timer_on_file_load();
+    /* Compositor results of the previous file are never used again. */
+    ntreeCompositClearCaches();
   }
 
   /* Always do this as both startup and preferences may have loaded in many font's